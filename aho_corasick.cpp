@@ -0,0 +1,176 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: An Aho-Corasick multi-pattern matcher (see aho_corasick.h).
+*/
+ #include "aho_corasick.h"
+
+ //A flag in AHO_CORASICK.vec_dense_moves: the node that the move leads to has an output link, so the scan doesn't have to look it up.
+ #define AHO_CORASICK_OUTPUT 0x80000000
+
+ //This will return the node that the scan moves to from ui32_node on the byte, following failure links as needed.
+ static inline uint32_t get_aho_corasick_move ( const AHO_CORASICK &automaton, uint32_t ui32_node, uint8_t ui8_symbol )
+{{
+ //Failure links lead to shallower nodes, and so to lower positions, until one has a dense row.
+ while ( ui32_node >= automaton .ui32_dense_count ) {
+   uint32_t ui32_child = find_trie_child ( automaton .trie, ui32_node, ui8_symbol );
+   if ( ui32_child != TRIE_NONE ) {
+     return ui32_child;
+   }
+   ui32_node = automaton .vec_failures [ ui32_node ];
+ }
+
+ return automaton .vec_dense_moves [ (size_t) ui32_node * automaton .ui32_class_count + automaton .ary_classes [ ui8_symbol ] ] & ~AHO_CORASICK_OUTPUT;
+}}
+
+/*
+ This will build the automaton of st_count patterns (lpary_patterns [ i ] holds lpary_lengths [ i ]
+ bytes, which can be anything, including zeroes, and which must total less than 2 GB),
+ replacing whatever it held before. Empty patterns never match.
+*/
+ void generate_aho_corasick ( AHO_CORASICK &automaton, const char **lpary_patterns, const size_t *lpary_lengths, size_t st_count )
+{{
+ TRIE &trie = automaton .trie;
+ generate_keyword_trie ( trie, lpary_patterns, lpary_lengths, st_count );
+ const uint32_t ui32_node_count = (uint32_t) trie .vec_nodes .size (  );
+ automaton .vec_failures .assign ( ui32_node_count, TRIE_ROOT );
+ automaton .vec_outputs .assign ( ui32_node_count, TRIE_NONE );
+
+ //Every byte in the patterns gets its own class; class 0 is for the rest, which always lead back to the root.
+ int32_t ary_class_symbols [ 257 ]; //A byte of each class, or -1 for class 0.
+ memset ( automaton .ary_classes, 0, sizeof ( automaton .ary_classes ) );
+ automaton .ui32_class_count = 1;
+ ary_class_symbols [ 0 ] = -1;
+ for ( std::string::const_iterator it_symbol = trie .str_text .cbegin (  ); it_symbol != trie .str_text .cend (  ); it_symbol ++ ) {
+   if ( ! automaton .ary_classes [ (uint8_t) *it_symbol ] ) {
+     ary_class_symbols [ automaton .ui32_class_count ] = (uint8_t) *it_symbol;
+     automaton .ary_classes [ (uint8_t) *it_symbol ] = (uint8_t) automaton .ui32_class_count ++;
+   }
+ }
+ //With all 256 bytes in the patterns, class 0 would never be used (and the last class wouldn't fit in a byte), so each byte is its own class.
+ if ( automaton .ui32_class_count == 257 ) {
+   for ( uint32_t ui32_symbol = 0; ui32_symbol < 256; ui32_symbol ++ ) {
+     automaton .ary_classes [ ui32_symbol ] = (uint8_t) ui32_symbol;
+     ary_class_symbols [ ui32_symbol ] = (int32_t) ui32_symbol;
+   }
+   automaton .ui32_class_count = 256;
+ }
+ size_t st_dense_count = AHO_CORASICK_DENSE_BYTES_MAX / (automaton .ui32_class_count * sizeof ( uint32_t ));
+ automaton .ui32_dense_count = st_dense_count < 1 ? 1 : st_dense_count < ui32_node_count ? (uint32_t) st_dense_count : ui32_node_count;
+ automaton .vec_dense_moves .assign ( (size_t) automaton .ui32_dense_count * automaton .ui32_class_count, TRIE_ROOT );
+
+ /*
+  A node's failure link is shorter than its path, so it comes before the node in
+  breadth-first order, which is the order of the nodes, and so does every row and link
+  that setting a node's failure link depends on. The root's children fail to the root.
+  The patterns must total less than 2 GB, so node positions leave AHO_CORASICK_OUTPUT free
+  for a flag.
+ */
+ uint32_t ary_children [ TRIE_TERMINATOR + 1 ];
+ for ( uint32_t ui32_node = 0; ui32_node < ui32_node_count; ui32_node ++ ) {
+   uint32_t ui32_count = get_trie_children ( trie, ui32_node, ary_children );
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+     uint32_t ui32_child = ary_children [ ui32_i ];
+     if ( ui32_node != TRIE_ROOT ) {
+       uint8_t ui8_symbol = (uint8_t) trie .str_text [ trie .vec_nodes [ ui32_child ] .ui32_start ];
+       automaton .vec_failures [ ui32_child ] = get_aho_corasick_move ( automaton, automaton .vec_failures [ ui32_node ], ui8_symbol );
+     }
+     automaton .vec_outputs [ ui32_child ] = trie .vec_nodes [ ui32_child ] .ui32_leaf_count ?
+       ui32_child :
+       automaton .vec_outputs [ automaton .vec_failures [ ui32_child ] ];
+   }
+
+   //(After the children, whose output links the row needs.)
+   if ( ui32_node < automaton .ui32_dense_count ) {
+     uint32_t *lp_moves = automaton .vec_dense_moves .data (  ) + (size_t) ui32_node * automaton .ui32_class_count;
+     const uint32_t *lp_failure_moves = automaton .vec_dense_moves .data (  ) + (size_t) automaton .vec_failures [ ui32_node ] * automaton .ui32_class_count;
+     for ( uint32_t ui32_class = 0; ui32_class < automaton .ui32_class_count; ui32_class ++ ) {
+       uint32_t ui32_child = ary_class_symbols [ ui32_class ] < 0 ?
+         TRIE_NONE :
+         find_trie_child ( trie, ui32_node, (uint8_t) ary_class_symbols [ ui32_class ] );
+       if ( ui32_child != TRIE_NONE ) {
+         lp_moves [ ui32_class ] = ui32_child | (automaton .vec_outputs [ ui32_child ] != TRIE_NONE ? AHO_CORASICK_OUTPUT : 0);
+       }
+       else if ( ui32_node != TRIE_ROOT ) {
+         lp_moves [ ui32_class ] = lp_failure_moves [ ui32_class ];
+       }
+     }
+   }
+ }
+}}
+
+ //This will get the stream ready to scan from its start.
+ void reset_aho_corasick_stream ( AHO_CORASICK_STREAM &stream )
+{{
+ stream .ui32_state = TRIE_ROOT;
+ stream .ui64_offset = 0;
+}}
+
+/*
+ This will scan the next st_length bytes of the stream, add every match that ends in them to
+ vec_matches (in the order that they end, with longer patterns first at each offset), and
+ return how many there were.
+*/
+ size_t scan_aho_corasick_stream (
+   const AHO_CORASICK &automaton,
+   AHO_CORASICK_STREAM &stream,
+   const char *lp_data,
+   size_t st_length,
+   std::vector<AHO_CORASICK_MATCH> &vec_matches
+ )
+{{
+ const TRIE &trie = automaton .trie;
+ const uint8_t *lp_symbols = (const uint8_t *) lp_data;
+ const uint32_t *lp_outputs = automaton .vec_outputs .data (  );
+ const uint32_t *lp_dense_moves = automaton .vec_dense_moves .data (  );
+ const uint8_t *lp_classes = automaton .ary_classes;
+ const uint32_t ui32_dense_count = automaton .ui32_dense_count, ui32_class_count = automaton .ui32_class_count;
+ size_t st_found = vec_matches .size (  );
+ uint32_t ui32_state = stream .ui32_state;
+
+ for ( size_t st_i = 0; st_i < st_length; st_i ++ ) {
+   if ( ui32_state < ui32_dense_count ) {
+     ui32_state = lp_dense_moves [ (size_t) ui32_state * ui32_class_count + lp_classes [ lp_symbols [ st_i ] ] ];
+     if ( ! (ui32_state & AHO_CORASICK_OUTPUT) ) {
+       continue;
+     }
+     ui32_state &= ~AHO_CORASICK_OUTPUT;
+   }
+   else {
+     ui32_state = get_aho_corasick_move ( automaton, ui32_state, lp_symbols [ st_i ] );
+   }
+
+   for ( uint32_t ui32_output = lp_outputs [ ui32_state ]; ui32_output != TRIE_NONE; ui32_output = lp_outputs [ automaton .vec_failures [ ui32_output ] ] ) {
+     const TRIE_NODE &node = trie .vec_nodes [ ui32_output ];
+     AHO_CORASICK_MATCH match;
+     match .ui64_end = stream .ui64_offset + st_i + 1;
+     for ( uint32_t ui32_leaf = node .ui32_first_leaf; ui32_leaf < node .ui32_first_leaf + node .ui32_leaf_count; ui32_leaf ++ ) {
+       match .ui32_pattern = trie .vec_leaves [ ui32_leaf ];
+       vec_matches .push_back ( match );
+     }
+   }
+ }
+
+ stream .ui32_state = ui32_state;
+ stream .ui64_offset += st_length;
+
+ return vec_matches .size (  ) - st_found;
+}}
+
+ //This will scan one buffer as a whole stream (see scan_aho_corasick_stream).
+ size_t scan_aho_corasick ( const AHO_CORASICK &automaton, const char *lp_data, size_t st_length, std::vector<AHO_CORASICK_MATCH> &vec_matches )
+{{
+ AHO_CORASICK_STREAM stream;
+ reset_aho_corasick_stream ( stream );
+
+ return scan_aho_corasick_stream ( automaton, stream, lp_data, st_length, vec_matches );
+}}
+
+ //This will return how many bytes the automaton holds (by capacity, since that's what's allocated).
+ size_t get_aho_corasick_memory_usage ( const AHO_CORASICK &automaton )
+{{
+ return sizeof ( AHO_CORASICK ) - sizeof ( TRIE ) +
+   get_trie_memory_usage ( automaton .trie ) +
+   automaton .vec_failures .capacity (  ) * sizeof ( uint32_t ) +
+   automaton .vec_outputs .capacity (  ) * sizeof ( uint32_t ) +
+   automaton .vec_dense_moves .capacity (  ) * sizeof ( uint32_t );
+}}
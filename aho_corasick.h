@@ -0,0 +1,79 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To find every occurrence of thousands of fixed patterns in one pass over a buffer
+ or a stream, rather than searching for each pattern separately.
+
+ generate_aho_corasick builds a keyword trie of the patterns (generate_keyword_trie in
+ suffix_tree.h, with the suffix tree's nodes and child containers), and then gives every
+ node two links, in breadth-first order:
+  A failure link: the node for the longest proper suffix of the node's path that's also a
+  path in the trie. When the next byte has no child, the scan follows failure links until
+  one of them has it (or it reaches the root), so it never backs up in the input.
+  An output link: the first node on the failure chain (starting with the node itself) where
+  a pattern ends, or TRIE_NONE. Following output links from there lists every pattern that
+  ends at the current byte, without walking the nodes on the chain that don't end one.
+ Following failure links costs a child lookup for each, so the shallowest nodes (which a
+ scan spends most of its time in; the keyword trie numbers its nodes in breadth-first
+ order) also get a dense row of moves, with the failure links already followed: one entry
+ per byte class, where the bytes in a class are the ones that every pattern treats alike
+ (each byte that occurs in a pattern gets its own class, and the rest share one). The
+ rows take up to AHO_CORASICK_DENSE_BYTES_MAX bytes, and always cover the root.
+
+ The scan takes linear time in the input plus the number of matches. It keeps its state
+ in an AHO_CORASICK_STREAM, so a stream can be scanned in chunks of any size, and matches
+ that span chunks are still found.
+
+ Usage:
+ const char *lpary_patterns [  ] = { "he", "she", "his", "hers" };
+ size_t ary_lengths [  ] = { 2, 3, 3, 4 };
+ AHO_CORASICK automaton;
+ generate_aho_corasick ( automaton, lpary_patterns, ary_lengths, 4 );
+ std::vector<AHO_CORASICK_MATCH> vec_matches;
+ scan_aho_corasick ( automaton, "ushers", 6, vec_matches ); //(1, 4), (0, 4), (3, 6)
+
+ See aho_corasick_benchmark.cpp for measurements.
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_array.cpp aho_corasick.cpp aho_corasick_benchmark.cpp -o aho_corasick_benchmark
+*/
+#ifndef AHO_CORASICK_HEADER_DEFINED
+#define AHO_CORASICK_HEADER_DEFINED 1
+ #include "suffix_tree.h"
+
+ #ifndef AHO_CORASICK_DENSE_BYTES_MAX
+   #define AHO_CORASICK_DENSE_BYTES_MAX (32 << 20)
+ #endif
+
+typedef struct AHO_CORASICK_MATCH {
+  uint32_t ui32_pattern; //The pattern's position in the list that the automaton was built from.
+  uint64_t ui64_end; //The offset (in the stream) just past the match's last byte.
+} AHO_CORASICK_MATCH;
+
+typedef struct AHO_CORASICK_STREAM {
+  uint32_t ui32_state; //The node for the longest suffix of what has been scanned that's a path in the trie.
+  uint64_t ui64_offset; //How many bytes have been scanned.
+} AHO_CORASICK_STREAM;
+
+typedef struct AHO_CORASICK {
+  TRIE trie; //The keyword trie of the patterns.
+  std::vector<uint32_t> vec_failures; //Each node's failure link.
+  std::vector<uint32_t> vec_outputs; //Each node's output link.
+  uint8_t ary_classes [ 256 ]; //Each byte's class (0 for the bytes that no pattern has).
+  uint32_t ui32_class_count;
+  uint32_t ui32_dense_count; //How many nodes (the first ones) have dense rows.
+  std::vector<uint32_t> vec_dense_moves; //ui32_class_count moves per row.
+} AHO_CORASICK;
+
+ void generate_aho_corasick ( AHO_CORASICK &automaton, const char **lpary_patterns, const size_t *lpary_lengths, size_t st_count );
+ void reset_aho_corasick_stream ( AHO_CORASICK_STREAM &stream );
+ size_t scan_aho_corasick_stream (
+   const AHO_CORASICK &automaton,
+   AHO_CORASICK_STREAM &stream,
+   const char *lp_data,
+   size_t st_length,
+   std::vector<AHO_CORASICK_MATCH> &vec_matches
+ );
+ size_t scan_aho_corasick ( const AHO_CORASICK &automaton, const char *lp_data, size_t st_length, std::vector<AHO_CORASICK_MATCH> &vec_matches );
+ size_t get_aho_corasick_memory_usage ( const AHO_CORASICK &automaton );
+
+#endif
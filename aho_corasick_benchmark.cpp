@@ -0,0 +1,137 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure the Aho-Corasick matcher (see aho_corasick.h): how long the automaton
+ takes to build, how much memory it takes, and how many GB/s it scans, for 10 to 100,000
+ patterns, next to searching for each pattern separately.
+
+ The text is English-like. Most patterns are random runs of lowercase letters (which share
+ prefixes with the text's words, but seldom match all the way), and one in 50 is a piece
+ of the text. Every match is checked against the text, and the number of matches against
+ the sum of each pattern's count in a suffix array of the text, so none can be missing.
+ The text is scanned again in 64 KB chunks, which must give the same matches.
+
+ Usage: aho_corasick_benchmark [text size in MB] (default: 32)
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_array.cpp aho_corasick.cpp aho_corasick_benchmark.cpp -o aho_corasick_benchmark
+*/
+ #include "aho_corasick.h"
+ #include "suffix_array.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_CHUNK_SIZE 65536
+ #define BENCHMARK_SEPARATE_PATTERNS_MAX 100 //Above this, searching for each pattern separately takes too long to show.
+
+ static void run_aho_corasick_benchmark ( const std::string &str_text, const SUFFIX_ARRAY &suffix_array, size_t st_pattern_count, uint64_t *lpui64_state )
+{{
+ std::vector<std::string> vec_patterns ( st_pattern_count );
+ std::vector<const char *> vec_pointers ( st_pattern_count );
+ std::vector<size_t> vec_lengths ( st_pattern_count );
+ for ( size_t st_i = 0; st_i < st_pattern_count; st_i ++ ) {
+   if ( st_i % 50 == 49 ) {
+     size_t st_length = 8 + get_benchmark_random ( lpui64_state ) % 17;
+     vec_patterns [ st_i ] = str_text .substr ( get_benchmark_random ( lpui64_state ) % (str_text .size (  ) - st_length), st_length );
+   }
+   else {
+     size_t st_length = 5 + get_benchmark_random ( lpui64_state ) % 12;
+     vec_patterns [ st_i ] .resize ( st_length );
+     for ( size_t st_j = 0; st_j < st_length; st_j ++ ) {
+       vec_patterns [ st_i ] [ st_j ] = (char) ('a' + get_benchmark_random ( lpui64_state ) % 26);
+     }
+   }
+   vec_pointers [ st_i ] = vec_patterns [ st_i ] .data (  );
+   vec_lengths [ st_i ] = vec_patterns [ st_i ] .size (  );
+ }
+
+ AHO_CORASICK automaton;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_aho_corasick ( automaton, vec_pointers .data (  ), vec_lengths .data (  ), st_pattern_count );
+ double dbl_build = get_benchmark_seconds (  ) - dbl_start;
+
+ std::vector<AHO_CORASICK_MATCH> vec_matches;
+ dbl_start = get_benchmark_seconds (  );
+ scan_aho_corasick ( automaton, str_text .data (  ), str_text .size (  ), vec_matches );
+ double dbl_scan = get_benchmark_seconds (  ) - dbl_start;
+
+ std::vector<AHO_CORASICK_MATCH> vec_chunk_matches;
+ AHO_CORASICK_STREAM stream;
+ reset_aho_corasick_stream ( stream );
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_offset = 0; st_offset < str_text .size (  ); st_offset += BENCHMARK_CHUNK_SIZE ) {
+   size_t st_length = str_text .size (  ) - st_offset < BENCHMARK_CHUNK_SIZE ? str_text .size (  ) - st_offset : BENCHMARK_CHUNK_SIZE;
+   scan_aho_corasick_stream ( automaton, stream, str_text .data (  ) + st_offset, st_length, vec_chunk_matches );
+ }
+ double dbl_chunks = get_benchmark_seconds (  ) - dbl_start;
+
+ //Searching for each pattern separately, for comparison.
+ double dbl_separate = 0;
+ size_t st_separate_matches = 0;
+ if ( st_pattern_count <= BENCHMARK_SEPARATE_PATTERNS_MAX ) {
+   dbl_start = get_benchmark_seconds (  );
+   for ( size_t st_i = 0; st_i < st_pattern_count; st_i ++ ) {
+     for ( size_t st_found = str_text .find ( vec_patterns [ st_i ] ); st_found != std::string::npos; st_found = str_text .find ( vec_patterns [ st_i ], st_found + 1 ) ) {
+       st_separate_matches ++;
+     }
+   }
+   dbl_separate = get_benchmark_seconds (  ) - dbl_start;
+ }
+
+ //Every match must be real, and there must be as many as the suffix array counts.
+ size_t st_expected = 0;
+ for ( size_t st_i = 0; st_i < st_pattern_count; st_i ++ ) {
+   st_expected += count_suffix_array_substrings ( suffix_array, vec_pointers [ st_i ], vec_lengths [ st_i ] );
+ }
+ uint8_t b_correct = vec_matches .size (  ) == st_expected && vec_chunk_matches .size (  ) == st_expected &&
+   (st_pattern_count > BENCHMARK_SEPARATE_PATTERNS_MAX || st_separate_matches == st_expected);
+ for ( size_t st_i = 0; b_correct && st_i < vec_matches .size (  ); st_i ++ ) {
+   const AHO_CORASICK_MATCH &match = vec_matches [ st_i ];
+   size_t st_length = vec_lengths [ match .ui32_pattern ];
+   b_correct = match .ui64_end >= st_length &&
+     ! memcmp ( str_text .data (  ) + match .ui64_end - st_length, vec_pointers [ match .ui32_pattern ], st_length ) &&
+     (! st_i || vec_matches [ st_i - 1 ] .ui64_end <= match .ui64_end) &&
+     vec_chunk_matches [ st_i ] .ui32_pattern == match .ui32_pattern &&
+     vec_chunk_matches [ st_i ] .ui64_end == match .ui64_end;
+ }
+
+ fprintf (
+   stdout,
+   "  %6zu patterns: build %7.3f s, %8.1f KB (%7zu nodes); scan %6.3f GB/s, in chunks %6.3f GB/s; %9zu matches",
+   st_pattern_count,
+   dbl_build,
+   get_aho_corasick_memory_usage ( automaton ) / 1024.0,
+   automaton .trie .vec_nodes .size (  ),
+   str_text .size (  ) / dbl_scan / 1e9,
+   str_text .size (  ) / dbl_chunks / 1e9,
+   vec_matches .size (  )
+ );
+ if ( st_pattern_count <= BENCHMARK_SEPARATE_PATTERNS_MAX ) {
+   fprintf ( stdout, "; separately %6.3f GB/s", str_text .size (  ) / dbl_separate / 1e9 );
+ }
+ fprintf ( stdout, "%s\n", b_correct ? "" : " (INCORRECT RESULTS)" );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ size_t st_size = 32000000;
+ if ( argc > 1 ) {
+   st_size = (size_t) (strtod ( argv [ 1 ], 0 ) * 1e6);
+ }
+ if ( st_size < 64 || st_size >= INT32_MAX ) {
+   fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+   return 1;
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text;
+ generate_english_text ( str_text, st_size, &ui64_state );
+ SUFFIX_ARRAY suffix_array;
+ generate_suffix_array ( suffix_array, str_text .data (  ), str_text .size (  ) );
+
+ fprintf ( stdout, "English, %.1f MB:\n", st_size / 1e6 );
+ static const size_t ary_pattern_counts [  ] = { 10, 100, 1000, 10000, 100000 };
+ for ( size_t st_i = 0; st_i < sizeof ( ary_pattern_counts ) / sizeof ( ary_pattern_counts [ 0 ] ); st_i ++ ) {
+   run_aho_corasick_benchmark ( str_text, suffix_array, ary_pattern_counts [ st_i ], &ui64_state );
+ }
+
+ return 0;
+}}
@@ -0,0 +1,103 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: The timer, random number generator, and generated texts that the benchmarks share,
+ so that every benchmark measures and generates its data the same way.
+
+ Everything is static inline, so a benchmark only has to include this header; there's
+ nothing else to compile. The text generators use std::string, so they're only there for C++.
+*/
+#ifndef BENCHMARK_HEADER_DEFINED
+#define BENCHMARK_HEADER_DEFINED 1
+#ifdef _WIN32
+ #include "windows.h"
+#else
+ #include "time.h"
+#endif
+ #include "stdint.h"
+ #include "stddef.h"
+#ifdef __cplusplus
+ #include <string>
+#endif
+
+ //This will return a monotonic time in seconds for measuring intervals.
+ static inline double get_benchmark_seconds ( void )
+{{
+#ifdef _WIN32
+ LARGE_INTEGER li_counter, li_frequency;
+ QueryPerformanceCounter ( &li_counter );
+ QueryPerformanceFrequency ( &li_frequency );
+
+ return (double) li_counter .QuadPart / (double) li_frequency .QuadPart;
+#else
+ struct timespec ts_now;
+ clock_gettime ( CLOCK_MONOTONIC, &ts_now );
+
+ return (double) ts_now .tv_sec + (double) ts_now .tv_nsec / 1e9;
+#endif
+}}
+
+ //A small xorshift generator, so that every run generates the same data from the same seed.
+ static inline uint64_t get_benchmark_random ( uint64_t *lpui64_state )
+{{
+ uint64_t x = *lpui64_state;
+ x ^= x << 13;
+ x ^= x >> 7;
+ x ^= x << 17;
+
+ return *lpui64_state = x;
+}}
+
+#ifdef __cplusplus
+ //Random DNA: 4 symbols, so a suffix tree of it is deep and narrow.
+ static inline void generate_dna_text ( std::string &str_text, size_t st_length, uint64_t *lpui64_state )
+{{
+ static const char sz_bases [  ] = "ACGT";
+ str_text .resize ( st_length );
+ for ( size_t st_i = 0; st_i < st_length; st_i ++ ) {
+   str_text [ st_i ] = sz_bases [ get_benchmark_random ( lpui64_state ) & 3 ];
+ }
+}}
+
+ //Random words from a small vocabulary, separated by spaces and the occasional line break.
+ static inline void generate_english_text ( std::string &str_text, size_t st_length, uint64_t *lpui64_state )
+{{
+ static const char *lpsz_words [  ] = {
+   "the", "of", "and", "to", "a", "in", "is", "it", "you", "that", "he", "was", "for", "on",
+   "are", "with", "as", "his", "they", "be", "at", "one", "have", "this", "from", "or", "had",
+   "by", "word", "but", "what", "some", "we", "can", "out", "other", "were", "all", "there",
+   "when", "up", "use", "your", "how", "said", "an", "each", "she", "which", "do", "their",
+   "time", "if", "will", "way", "about", "many", "then", "them", "write", "would", "like",
+   "so", "these", "her", "long", "make", "thing", "see", "him", "two", "has", "look", "more",
+   "day", "could", "go", "come", "did", "number", "sound", "no", "most", "people", "my",
+   "over", "know", "water", "than", "call", "first", "who", "may", "down", "side", "been",
+   "now", "find", "tree", "suffix", "substring", "match", "node", "edge", "branch", "leaf"
+ };
+ const size_t st_word_count = sizeof ( lpsz_words ) / sizeof ( lpsz_words [ 0 ] );
+
+ str_text .clear (  );
+ str_text .reserve ( st_length + 16 );
+ while ( str_text .size (  ) < st_length ) {
+   //Favor the first (most common) words, like real text does.
+   uint64_t ui64_random = get_benchmark_random ( lpui64_state );
+   size_t st_word = (size_t) ((ui64_random % st_word_count) * ((ui64_random >> 32) % st_word_count) / st_word_count);
+   str_text += lpsz_words [ st_word ];
+   str_text += (ui64_random >> 60) ? ' ' : '\n';
+ }
+ str_text .resize ( st_length );
+}}
+
+ //Bytes of every value, where about a third of the bytes are in runs of zeroes (like executables have).
+ static inline void generate_binary_text ( std::string &str_text, size_t st_length, uint64_t *lpui64_state )
+{{
+ str_text .resize ( st_length );
+ for ( size_t st_i = 0; st_i < st_length; ) {
+   uint64_t ui64_random = get_benchmark_random ( lpui64_state );
+   size_t st_run = 1 + (ui64_random >> 8) % 16;
+   for ( ; st_run && st_i < st_length; st_run --, st_i ++ ) {
+     str_text [ st_i ] = (ui64_random & 3) ? (char) get_benchmark_random ( lpui64_state ) : 0;
+   }
+ }
+}}
+#endif
+
+#endif
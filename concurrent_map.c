@@ -0,0 +1,545 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the thread-safe map described in concurrent_map.h.
+ Keys are hashed with the same function as the map in map.c.
+
+ To compile (with the benchmark):
+   gcc -O2 -pthread map.c concurrent_map.c concurrent_map_benchmark.c -o concurrent_map_benchmark
+*/
+ #include "concurrent_map.h"
+ #include "map.h"
+
+ //The user-data is stored right after the node's header, and the key right after that.
+ #define CONCURRENT_MAP_NODE_HEADER_SIZE ( (sizeof ( CONCURRENT_MAP_NODE ) + 15) & ~(size_t) 15 )
+ //The buckets are stored right after the table's header.
+ #define CONCURRENT_MAP_TABLE_HEADER_SIZE ( (sizeof ( CONCURRENT_MAP_TABLE ) + 15) & ~(size_t) 15 )
+
+#ifdef _WIN32
+ #define initialize_concurrent_map_lock(L) InitializeSRWLock ( L )
+ #define lock_concurrent_map_lock(L) AcquireSRWLockExclusive ( L )
+ #define unlock_concurrent_map_lock(L) ReleaseSRWLockExclusive ( L )
+ #define destroy_concurrent_map_lock(L)
+#else
+ #define initialize_concurrent_map_lock(L) pthread_mutex_init ( L, 0 )
+ #define lock_concurrent_map_lock(L) pthread_mutex_lock ( L )
+ #define unlock_concurrent_map_lock(L) pthread_mutex_unlock ( L )
+ #define destroy_concurrent_map_lock(L) pthread_mutex_destroy ( L )
+#endif
+
+ static CONCURRENT_MAP_TABLE *new_concurrent_map_table ( uint32_t ui32_bucket_count )
+{{
+ CONCURRENT_MAP_TABLE *lp_table = (CONCURRENT_MAP_TABLE *) calloc (
+   1, CONCURRENT_MAP_TABLE_HEADER_SIZE + (size_t) ui32_bucket_count * sizeof ( *lp_table ->lpary_buckets )
+ );
+ if ( ! lp_table ) {
+   return 0;
+ }
+
+ lp_table ->lpary_buckets = (_Atomic(CONCURRENT_MAP_NODE *) *) ((char *) lp_table + CONCURRENT_MAP_TABLE_HEADER_SIZE);
+ lp_table ->ui32_bucket_count = ui32_bucket_count;
+
+ return lp_table;
+}}
+
+ uint8_t initialize_concurrent_map (
+   CONCURRENT_MAP *lpm_map,
+   uint32_t ui32_capacity, //how many keys the map is expected to hold; this sets the bucket count.
+   uint32_t ui32_data_size,
+   uint8_t (*lpfn_free)(void*)
+ )
+{{
+ if ( ! lpm_map || ! lpfn_free ) {
+   return 0;
+ }
+
+ memset ( lpm_map, 0, sizeof ( CONCURRENT_MAP ) );
+
+ //One bucket per expected key keeps the chains short without having to grow.
+ uint32_t ui32_bucket_count = CONCURRENT_MAP_MINIMUM_BUCKETS;
+ while ( ui32_bucket_count < ui32_capacity && ui32_bucket_count < 0x80000000 ) {
+   ui32_bucket_count <<= 1;
+ }
+
+ CONCURRENT_MAP_TABLE *lp_table = new_concurrent_map_table ( ui32_bucket_count );
+ if ( ! lp_table ) {
+   return 0;
+ }
+
+ atomic_init ( &lpm_map ->lp_table, lp_table );
+ lpm_map ->ui32_data_size = ui32_data_size;
+ lpm_map ->lpfn_free = lpfn_free;
+ atomic_init ( &lpm_map ->ui32_count, 0 );
+ atomic_init ( &lpm_map ->ui64_epoch, 1 );
+
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_LOCK_STRIPES; ui32_i ++ ) {
+   initialize_concurrent_map_lock ( &lpm_map ->stripes [ ui32_i ] .lock );
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_MAXIMUM_READERS; ui32_i ++ ) {
+   atomic_init ( &lpm_map ->readers [ ui32_i ] .ui64_epoch, 0 );
+   atomic_init ( &lpm_map ->readers [ ui32_i ] .b_joined, 0 );
+ }
+ initialize_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ return 1;
+}}
+
+/*
+ This will claim a reader slot for the calling thread. The returned number is passed
+ to find_concurrent_map_node_data and, once the thread is done with the map, to
+ leave_concurrent_map. Returns CONCURRENT_MAP_NO_READER, if every slot is taken.
+*/
+ uint32_t join_concurrent_map ( CONCURRENT_MAP *lpm_map )
+{{
+ if ( ! lpm_map ) {
+   return CONCURRENT_MAP_NO_READER;
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_MAXIMUM_READERS; ui32_i ++ ) {
+   uint_fast8_t b_expected = 0;
+   if ( atomic_compare_exchange_strong ( &lpm_map ->readers [ ui32_i ] .b_joined, &b_expected, 1 ) ) {
+     return ui32_i;
+   }
+ }
+
+ return CONCURRENT_MAP_NO_READER;
+}}
+
+ void leave_concurrent_map ( CONCURRENT_MAP *lpm_map, uint32_t ui32_reader )
+{{
+ if ( ! lpm_map || ui32_reader >= CONCURRENT_MAP_MAXIMUM_READERS ) {
+   return ;
+ }
+
+ atomic_store ( &lpm_map ->readers [ ui32_reader ] .ui64_epoch, 0 );
+ atomic_store ( &lpm_map ->readers [ ui32_reader ] .b_joined, 0 );
+}}
+
+ static _Atomic(CONCURRENT_MAP_NODE *) *get_concurrent_map_bucket ( CONCURRENT_MAP_TABLE *lp_table, uint64_t ui64_hash )
+{{
+ return &lp_table ->lpary_buckets [ (uint32_t) ui64_hash & (lp_table ->ui32_bucket_count - 1) ];
+}}
+
+ //There are never fewer buckets than stripes, so a key's stripe doesn't change when the table is doubled.
+ static CONCURRENT_MAP_LOCK *get_concurrent_map_stripe_lock ( CONCURRENT_MAP *lpm_map, uint64_t ui64_hash )
+{{
+ return &lpm_map ->stripes [ (uint32_t) ui64_hash & (CONCURRENT_MAP_LOCK_STRIPES - 1) ] .lock;
+}}
+
+/*
+ This will copy the user-data stored for the key into lpv_data (which must have room for
+ ui32_data_size bytes). It never blocks: the reader's slot announces the epoch in which
+ it started, so no node that it could see is freed until it's done.
+ Returns 1, if the key was found; 0, otherwise.
+*/
+ uint8_t find_concurrent_map_node_data (
+   CONCURRENT_MAP *lpm_map,
+   uint32_t ui32_reader,
+   const char *lpsz_key,
+   void *lpv_data
+ )
+{{
+ if ( ! lpm_map || ! lpsz_key || ! *lpsz_key || ! lpv_data ) {
+   return 0;
+ }
+ if ( ui32_reader >= CONCURRENT_MAP_MAXIMUM_READERS ) {
+   return 0;
+ }
+
+ uint64_t ui64_hash = get_map_key_hash ( lpsz_key );
+ CONCURRENT_MAP_READER *lp_reader = &lpm_map ->readers [ ui32_reader ];
+
+ //Announce the epoch before reading any node; the fence makes sure that a reclaiming
+ //writer either sees this announcement or we see every node that it unlinked.
+ atomic_store_explicit ( &lp_reader ->ui64_epoch, atomic_load ( &lpm_map ->ui64_epoch ), memory_order_relaxed );
+ atomic_thread_fence ( memory_order_seq_cst );
+
+ uint8_t b_found = 0;
+ CONCURRENT_MAP_TABLE *lp_table = atomic_load_explicit ( &lpm_map ->lp_table, memory_order_acquire );
+ CONCURRENT_MAP_NODE *node = atomic_load_explicit ( get_concurrent_map_bucket ( lp_table, ui64_hash ), memory_order_acquire );
+ for ( ; node; node = atomic_load_explicit ( &node ->lp_next, memory_order_acquire ) ) {
+   if ( node ->ui64_hash == ui64_hash && ! strcmp ( node ->lpsz_key, lpsz_key ) ) {
+     memcpy ( lpv_data, node ->lpv_data, lpm_map ->ui32_data_size );
+     b_found = 1;
+     break;
+   }
+ }
+
+ atomic_store_explicit ( &lp_reader ->ui64_epoch, 0, memory_order_release );
+
+ return b_found;
+}}
+
+ static CONCURRENT_MAP_NODE *new_concurrent_map_node (
+   CONCURRENT_MAP *lpm_map,
+   const char *lpsz_key,
+   uint64_t ui64_hash,
+   const void *lpv_data
+ )
+{{
+ size_t st_key_size = strlen ( lpsz_key ) + 1;
+ CONCURRENT_MAP_NODE *node = (CONCURRENT_MAP_NODE *) malloc (
+   CONCURRENT_MAP_NODE_HEADER_SIZE + lpm_map ->ui32_data_size + st_key_size
+ );
+ if ( ! node ) {
+   return 0;
+ }
+
+ node ->lpv_data = (char *) node + CONCURRENT_MAP_NODE_HEADER_SIZE;
+ node ->lpsz_key = (char *) node ->lpv_data + lpm_map ->ui32_data_size;
+ memcpy ( node ->lpv_data, lpv_data, lpm_map ->ui32_data_size );
+ memcpy ( node ->lpsz_key, lpsz_key, st_key_size );
+ node ->ui64_hash = ui64_hash;
+ node ->lp_next_retired = 0;
+ node ->ui64_retired_epoch = 0;
+ atomic_init ( &node ->lp_next, 0 );
+
+ return node;
+}}
+
+ static void free_concurrent_map_node_block ( CONCURRENT_MAP *lpm_map, CONCURRENT_MAP_NODE *node )
+{{
+ lpm_map ->lpfn_free ( node ->lpv_data );
+ free ( node );
+}}
+
+ //This will free a table and the nodes in its chains, which share their user-data with the nodes of another table, so lpfn_free isn't called.
+ static void free_concurrent_map_table_copies ( CONCURRENT_MAP_TABLE *lp_table )
+{{
+ for ( uint32_t ui32_i = 0; ui32_i < lp_table ->ui32_bucket_count; ui32_i ++ ) {
+   CONCURRENT_MAP_NODE *node = atomic_load_explicit ( &lp_table ->lpary_buckets [ ui32_i ], memory_order_relaxed );
+   while ( node ) {
+     CONCURRENT_MAP_NODE *next = atomic_load_explicit ( &node ->lp_next, memory_order_relaxed );
+     free ( node );
+     node = next;
+   }
+ }
+
+ free ( lp_table );
+}}
+
+/*
+ This will free every retired node that no reader can still be looking at, and return
+ how many were freed. Writers call this on their own every CONCURRENT_MAP_RECLAIM_THRESHOLD
+ retirements, but it can be called at any time.
+*/
+ uint64_t reclaim_concurrent_map_nodes ( CONCURRENT_MAP *lpm_map )
+{{
+ if ( ! lpm_map ) {
+   return 0;
+ }
+
+ //Readers that start from now on will announce a later epoch than any node retired so far.
+ //Nodes retired after this (in the new epoch or later) have to wait for the next attempt,
+ //since a reader that we don't see below may have started in the new epoch.
+ uint64_t ui64_oldest_epoch = atomic_fetch_add ( &lpm_map ->ui64_epoch, 1 ) + 1;
+ atomic_thread_fence ( memory_order_seq_cst );
+
+ //Find the oldest epoch that's still being read in.
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_MAXIMUM_READERS; ui32_i ++ ) {
+   uint64_t ui64_epoch = atomic_load ( &lpm_map ->readers [ ui32_i ] .ui64_epoch );
+   if ( ui64_epoch && ui64_epoch < ui64_oldest_epoch ) {
+     ui64_oldest_epoch = ui64_epoch;
+   }
+ }
+
+ //A node (or table) retired in epoch E can only be seen by readers that announced E or earlier.
+ CONCURRENT_MAP_NODE *lp_reclaimable = 0;
+ CONCURRENT_MAP_TABLE *lp_reclaimable_tables = 0;
+ lock_concurrent_map_lock ( &lpm_map ->retired_lock );
+ CONCURRENT_MAP_NODE **lplp_node = &lpm_map ->lp_retired_nodes;
+ while ( *lplp_node ) {
+   CONCURRENT_MAP_NODE *node = *lplp_node;
+   if ( node ->ui64_retired_epoch < ui64_oldest_epoch ) {
+     *lplp_node = node ->lp_next_retired;
+     node ->lp_next_retired = lp_reclaimable;
+     lp_reclaimable = node;
+   }
+   else {
+     lplp_node = &node ->lp_next_retired;
+   }
+ }
+ CONCURRENT_MAP_TABLE **lplp_table = &lpm_map ->lp_retired_tables;
+ while ( *lplp_table ) {
+   CONCURRENT_MAP_TABLE *lp_table = *lplp_table;
+   if ( lp_table ->ui64_retired_epoch < ui64_oldest_epoch ) {
+     *lplp_table = lp_table ->lp_next_retired;
+     lp_table ->lp_next_retired = lp_reclaimable_tables;
+     lp_reclaimable_tables = lp_table;
+   }
+   else {
+     lplp_table = &lp_table ->lp_next_retired;
+   }
+ }
+ lpm_map ->ui32_retired_since_reclaim = 0;
+ unlock_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ while ( lp_reclaimable_tables ) {
+   CONCURRENT_MAP_TABLE *lp_table = lp_reclaimable_tables;
+   lp_reclaimable_tables = lp_table ->lp_next_retired;
+   free_concurrent_map_table_copies ( lp_table );
+ }
+
+ //The user-defined free function is called outside of the lock.
+ uint64_t ui64_reclaimed = 0;
+ while ( lp_reclaimable ) {
+   CONCURRENT_MAP_NODE *node = lp_reclaimable;
+   lp_reclaimable = node ->lp_next_retired;
+   free_concurrent_map_node_block ( lpm_map, node );
+   ui64_reclaimed ++;
+ }
+
+ lock_concurrent_map_lock ( &lpm_map ->retired_lock );
+ lpm_map ->ui64_reclaimed_count += ui64_reclaimed;
+ unlock_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ return ui64_reclaimed;
+}}
+
+ //This will queue a node that has just been unlinked to be freed once no reader can see it.
+ static void retire_concurrent_map_node ( CONCURRENT_MAP *lpm_map, CONCURRENT_MAP_NODE *node )
+{{
+ //The fence makes sure that any reader announcing a later epoch than this won't see the node.
+ atomic_thread_fence ( memory_order_seq_cst );
+
+ lock_concurrent_map_lock ( &lpm_map ->retired_lock );
+ node ->ui64_retired_epoch = atomic_load ( &lpm_map ->ui64_epoch );
+ node ->lp_next_retired = lpm_map ->lp_retired_nodes;
+ lpm_map ->lp_retired_nodes = node;
+ lpm_map ->ui64_retired_count ++;
+ uint8_t b_reclaim = ++ lpm_map ->ui32_retired_since_reclaim >= CONCURRENT_MAP_RECLAIM_THRESHOLD;
+ unlock_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ if ( b_reclaim ) {
+   reclaim_concurrent_map_nodes ( lpm_map );
+ }
+}}
+
+/*
+ This will double the table, if it still holds more than CONCURRENT_MAP_MAXIMUM_LOAD keys per
+ bucket once every stripe is locked. Every node is copied into the new table, since a reader may
+ be walking the old chains while this runs; the old table is retired along with its nodes, and
+ their user-data (which now belongs to the copies) isn't passed to lpfn_free.
+ Returns 0, if memory couldn't be allocated; the map keeps its old table, then.
+*/
+ static uint8_t grow_concurrent_map ( CONCURRENT_MAP *lpm_map )
+{{
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_LOCK_STRIPES; ui32_i ++ ) {
+   lock_concurrent_map_lock ( &lpm_map ->stripes [ ui32_i ] .lock );
+ }
+
+ //Another writer may have grown it while we were waiting.
+ CONCURRENT_MAP_TABLE *lp_old_table = atomic_load_explicit ( &lpm_map ->lp_table, memory_order_relaxed );
+ if ( (uint64_t) atomic_load ( &lpm_map ->ui32_count ) <= (uint64_t) lp_old_table ->ui32_bucket_count * CONCURRENT_MAP_MAXIMUM_LOAD ||
+      lp_old_table ->ui32_bucket_count >= 0x80000000
+    ) {
+   for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_LOCK_STRIPES; ui32_i ++ ) {
+     unlock_concurrent_map_lock ( &lpm_map ->stripes [ ui32_i ] .lock );
+   }
+   return 1;
+ }
+
+ uint8_t b_success = 1;
+ CONCURRENT_MAP_TABLE *lp_new_table = new_concurrent_map_table ( lp_old_table ->ui32_bucket_count << 1 );
+ if ( ! lp_new_table ) {
+   b_success = 0;
+ }
+
+ //Nothing else can see the new table yet, so relaxed stores will do.
+ for ( uint32_t ui32_i = 0; b_success && ui32_i < lp_old_table ->ui32_bucket_count; ui32_i ++ ) {
+   CONCURRENT_MAP_NODE *node = atomic_load_explicit ( &lp_old_table ->lpary_buckets [ ui32_i ], memory_order_relaxed );
+   for ( ; node; node = atomic_load_explicit ( &node ->lp_next, memory_order_relaxed ) ) {
+     CONCURRENT_MAP_NODE *lp_copy = new_concurrent_map_node ( lpm_map, node ->lpsz_key, node ->ui64_hash, node ->lpv_data );
+     if ( ! lp_copy ) {
+       b_success = 0;
+       break;
+     }
+     _Atomic(CONCURRENT_MAP_NODE *) *lp_bucket = get_concurrent_map_bucket ( lp_new_table, node ->ui64_hash );
+     atomic_store_explicit ( &lp_copy ->lp_next, atomic_load_explicit ( lp_bucket, memory_order_relaxed ), memory_order_relaxed );
+     atomic_store_explicit ( lp_bucket, lp_copy, memory_order_relaxed );
+   }
+ }
+
+ if ( b_success ) {
+   atomic_store_explicit ( &lpm_map ->lp_table, lp_new_table, memory_order_release );
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_LOCK_STRIPES; ui32_i ++ ) {
+   unlock_concurrent_map_lock ( &lpm_map ->stripes [ ui32_i ] .lock );
+ }
+
+ if ( ! b_success ) {
+   if ( lp_new_table ) {
+     free_concurrent_map_table_copies ( lp_new_table );
+   }
+   return 0;
+ }
+
+ //Retire the old table the same way as a single node (see retire_concurrent_map_node).
+ //No writer will change its chains again, so its nodes are freed along with it.
+ atomic_thread_fence ( memory_order_seq_cst );
+
+ lock_concurrent_map_lock ( &lpm_map ->retired_lock );
+ lp_old_table ->ui64_retired_epoch = atomic_load ( &lpm_map ->ui64_epoch );
+ lp_old_table ->lp_next_retired = lpm_map ->lp_retired_tables;
+ lpm_map ->lp_retired_tables = lp_old_table;
+ lpm_map ->ui32_resize_count ++;
+ unlock_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ //The old table is as big as the map, so it isn't left to wait for CONCURRENT_MAP_RECLAIM_THRESHOLD more retirements.
+ reclaim_concurrent_map_nodes ( lpm_map );
+
+ return 1;
+}}
+
+/*
+ This will add the key with a copy of the user-data, or replace the user-data of the key,
+ if it already exists. Replacing links a new node in place of the old one, so that readers
+ always see either the old user-data or the new, never a mix of the two. Adding a key can
+ double the table (see grow_concurrent_map).
+ Returns 0, if memory couldn't be allocated.
+*/
+ uint8_t set_concurrent_map_node ( CONCURRENT_MAP *lpm_map, const char *lpsz_key, const void *lpv_data )
+{{
+ if ( ! lpm_map || ! lpsz_key || ! *lpsz_key || ! lpv_data ) {
+   return 0;
+ }
+ if ( ! atomic_load ( &lpm_map ->lp_table ) ) {
+   return 0;
+ }
+
+ uint64_t ui64_hash = get_map_key_hash ( lpsz_key );
+ CONCURRENT_MAP_NODE *lp_new_node = new_concurrent_map_node ( lpm_map, lpsz_key, ui64_hash, lpv_data );
+ if ( ! lp_new_node ) {
+   return 0;
+ }
+
+ CONCURRENT_MAP_LOCK *lp_lock = get_concurrent_map_stripe_lock ( lpm_map, ui64_hash );
+ CONCURRENT_MAP_NODE *lp_old_node = 0;
+ uint8_t b_grow = 0;
+
+ lock_concurrent_map_lock ( lp_lock );
+
+ //The table can't be replaced, and no other writer can change this bucket, while we hold its stripe, so relaxed loads will do.
+ CONCURRENT_MAP_TABLE *lp_table = atomic_load_explicit ( &lpm_map ->lp_table, memory_order_relaxed );
+ _Atomic(CONCURRENT_MAP_NODE *) *lp_bucket = get_concurrent_map_bucket ( lp_table, ui64_hash );
+ _Atomic(CONCURRENT_MAP_NODE *) *lp_link = lp_bucket;
+ CONCURRENT_MAP_NODE *node;
+ while ( (node = atomic_load_explicit ( lp_link, memory_order_relaxed )) ) {
+   if ( node ->ui64_hash == ui64_hash && ! strcmp ( node ->lpsz_key, lpsz_key ) ) {
+     lp_old_node = node;
+     break;
+   }
+   lp_link = &node ->lp_next;
+ }
+
+ if ( lp_old_node ) {
+   //Take the old node's place in the chain.
+   atomic_store_explicit ( &lp_new_node ->lp_next, atomic_load_explicit ( &lp_old_node ->lp_next, memory_order_relaxed ), memory_order_relaxed );
+   atomic_store_explicit ( lp_link, lp_new_node, memory_order_release );
+ }
+ else {
+   //Add the new node to the front of the chain.
+   atomic_store_explicit ( &lp_new_node ->lp_next, atomic_load_explicit ( lp_bucket, memory_order_relaxed ), memory_order_relaxed );
+   atomic_store_explicit ( lp_bucket, lp_new_node, memory_order_release );
+   uint64_t ui64_count = (uint64_t) atomic_fetch_add ( &lpm_map ->ui32_count, 1 ) + 1;
+   b_grow = ui64_count > (uint64_t) lp_table ->ui32_bucket_count * CONCURRENT_MAP_MAXIMUM_LOAD;
+ }
+
+ unlock_concurrent_map_lock ( lp_lock );
+
+ if ( lp_old_node ) {
+   retire_concurrent_map_node ( lpm_map, lp_old_node );
+ }
+ //The key is in the map either way, so a table that couldn't grow only means longer chains.
+ if ( b_grow ) {
+   grow_concurrent_map ( lpm_map );
+ }
+
+ return 1;
+}}
+
+//This will remove the key from the map. Its user-data is freed (with lpfn_free) once no reader can see it.
+//Returns 0, if the key doesn't exist.
+ uint8_t free_concurrent_map_node ( CONCURRENT_MAP *lpm_map, const char *lpsz_key )
+{{
+ if ( ! lpm_map || ! lpsz_key || ! *lpsz_key ) {
+   return 0;
+ }
+ if ( ! atomic_load ( &lpm_map ->lp_table ) ) {
+   return 0;
+ }
+
+ uint64_t ui64_hash = get_map_key_hash ( lpsz_key );
+ CONCURRENT_MAP_LOCK *lp_lock = get_concurrent_map_stripe_lock ( lpm_map, ui64_hash );
+ CONCURRENT_MAP_NODE *lp_old_node = 0;
+
+ lock_concurrent_map_lock ( lp_lock );
+
+ _Atomic(CONCURRENT_MAP_NODE *) *lp_link = get_concurrent_map_bucket ( atomic_load_explicit ( &lpm_map ->lp_table, memory_order_relaxed ), ui64_hash );
+ CONCURRENT_MAP_NODE *node;
+ while ( (node = atomic_load_explicit ( lp_link, memory_order_relaxed )) ) {
+   if ( node ->ui64_hash == ui64_hash && ! strcmp ( node ->lpsz_key, lpsz_key ) ) {
+     lp_old_node = node;
+     break;
+   }
+   lp_link = &node ->lp_next;
+ }
+
+ //A reader that's already on this node can still follow its lp_next, which is left as it was.
+ if ( lp_old_node ) {
+   atomic_store_explicit ( lp_link, atomic_load_explicit ( &lp_old_node ->lp_next, memory_order_relaxed ), memory_order_release );
+   atomic_fetch_sub ( &lpm_map ->ui32_count, 1 );
+ }
+
+ unlock_concurrent_map_lock ( lp_lock );
+
+ if ( ! lp_old_node ) {
+   return 0;
+ }
+
+ retire_concurrent_map_node ( lpm_map, lp_old_node );
+
+ return 1;
+}}
+
+/*
+ This will free every node (retired or not) and everything else that the map allocated.
+ No other thread may be using the map when this is called.
+*/
+ uint8_t free_concurrent_map ( CONCURRENT_MAP *lpm_map )
+{{
+ CONCURRENT_MAP_TABLE *lp_table = lpm_map ? atomic_load ( &lpm_map ->lp_table ) : 0;
+ if ( ! lp_table ) {
+   return 0;
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < lp_table ->ui32_bucket_count; ui32_i ++ ) {
+   CONCURRENT_MAP_NODE *node = atomic_load ( &lp_table ->lpary_buckets [ ui32_i ] );
+   while ( node ) {
+     CONCURRENT_MAP_NODE *next = atomic_load ( &node ->lp_next );
+     free_concurrent_map_node_block ( lpm_map, node );
+     node = next;
+   }
+ }
+
+ while ( lpm_map ->lp_retired_nodes ) {
+   CONCURRENT_MAP_NODE *node = lpm_map ->lp_retired_nodes;
+   lpm_map ->lp_retired_nodes = node ->lp_next_retired;
+   free_concurrent_map_node_block ( lpm_map, node );
+ }
+ while ( lpm_map ->lp_retired_tables ) {
+   CONCURRENT_MAP_TABLE *lp_retired_table = lpm_map ->lp_retired_tables;
+   lpm_map ->lp_retired_tables = lp_retired_table ->lp_next_retired;
+   free_concurrent_map_table_copies ( lp_retired_table );
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < CONCURRENT_MAP_LOCK_STRIPES; ui32_i ++ ) {
+   destroy_concurrent_map_lock ( &lpm_map ->stripes [ ui32_i ] .lock );
+ }
+ destroy_concurrent_map_lock ( &lpm_map ->retired_lock );
+
+ free ( lp_table );
+ memset ( lpm_map, 0, sizeof ( CONCURRENT_MAP ) );
+
+ return 1;
+}}
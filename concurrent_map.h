@@ -0,0 +1,140 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: A variant of the map in map.h that many threads can use at once,
+ without wrapping every call in one global mutex.
+
+ Writers (set_concurrent_map_node, free_concurrent_map_node) only lock the
+ stripe of buckets that their key hashes to, so writers of different keys
+ rarely wait on each other. Readers never lock anything: they walk the
+ bucket chains while the writers swap nodes in and out of them atomically.
+ A node is never changed once it's been published, so updating a key links
+ in a new copy of its node and retires the old one.
+
+ Retired nodes are reclaimed with epochs (a simple form of RCU). Each reader
+ announces the epoch in which it started reading, and a retired node (and the
+ user-data in it, via lpfn_free) is only freed once every reader that could
+ have seen it has finished. So, lpfn_free is called when a node is reclaimed,
+ not when it's replaced or removed.
+
+ Each thread that reads from the map has to join it, first, to get a reader
+ slot for announcing its epoch (see join_concurrent_map).
+
+ initialize_concurrent_map's capacity hint sets the starting number of buckets.
+ Once the map holds more keys than it has buckets, the writer that added the last
+ key doubles the table: it locks every stripe (so writers wait, but readers don't),
+ copies every node into a new table, and publishes the new table in one store.
+ The old table and its nodes are retired like any other node, so a reader that's
+ still walking them is safe; their user-data now belongs to the copies, so lpfn_free
+ isn't called on it.
+
+ This header uses C11 atomics, so it's meant to be used from C.
+ See concurrent_map.c for the implementation and
+ concurrent_map_benchmark.c for performance measurements.
+*/
+#ifndef CONCURRENT_MAP_HEADER_DEFINED
+#define CONCURRENT_MAP_HEADER_DEFINED 1
+ #include "stdio.h"
+ #include "stdlib.h"
+ #include "stdint.h"
+ #include "inttypes.h"
+ #include "stdatomic.h"
+#ifndef _WIN32
+ #include "string.h"
+ #include "pthread.h"
+#else
+ #include "windows.h"
+#endif
+
+ //Writers lock one of this many stripes (it must be a power of two); bucket I belongs to stripe I % CONCURRENT_MAP_LOCK_STRIPES,
+ //which stays the same when the table is doubled.
+ #define CONCURRENT_MAP_LOCK_STRIPES 64
+ //How many threads can be joined to (reading from) a map at the same time.
+ #define CONCURRENT_MAP_MAXIMUM_READERS 64
+ //Writers try to reclaim retired nodes once this many have been retired since the last attempt.
+ #define CONCURRENT_MAP_RECLAIM_THRESHOLD 128
+ //The smallest number of buckets that a map will have (it must be a power of two, and at least CONCURRENT_MAP_LOCK_STRIPES).
+ #define CONCURRENT_MAP_MINIMUM_BUCKETS CONCURRENT_MAP_LOCK_STRIPES
+ //The table is doubled once it holds more than this many keys per bucket.
+ #define CONCURRENT_MAP_MAXIMUM_LOAD 1
+ //join_concurrent_map returns this, if every reader slot is taken.
+ #define CONCURRENT_MAP_NO_READER 0xFFFFFFFF
+ //Stripes and reader slots are padded to this many bytes, so that threads using different ones don't share cache lines.
+ #define CONCURRENT_MAP_CACHE_LINE_SIZE 64
+
+#ifdef _WIN32
+ typedef SRWLOCK CONCURRENT_MAP_LOCK;
+#else
+ typedef pthread_mutex_t CONCURRENT_MAP_LOCK;
+#endif
+
+ //Like the map's nodes, each one is a single block holding this header, the user-data, and then the key.
+ typedef struct CONCURRENT_MAP_NODE {
+   _Atomic(struct CONCURRENT_MAP_NODE *) lp_next; //The next node in the same bucket.
+   struct CONCURRENT_MAP_NODE *lp_next_retired; //The next node waiting to be reclaimed, once this one has been retired.
+   uint64_t ui64_hash; //The full hash of lpsz_key (see get_map_key_hash).
+   uint64_t ui64_retired_epoch; //The epoch in which this node was unlinked from its bucket.
+   char *lpsz_key;
+   void *lpv_data;
+ } CONCURRENT_MAP_NODE;
+
+ //The buckets are in the same block, right after this header.
+ typedef struct CONCURRENT_MAP_TABLE {
+   struct CONCURRENT_MAP_TABLE *lp_next_retired; //The next table waiting to be reclaimed, once this one has been replaced.
+   uint64_t ui64_retired_epoch; //The epoch in which this table was replaced.
+   uint32_t ui32_bucket_count; //Always a power of two.
+   _Atomic(CONCURRENT_MAP_NODE *) *lpary_buckets; //CONCURRENT_MAP_NODE*[ui32_bucket_count]
+ } CONCURRENT_MAP_TABLE;
+
+ typedef struct CONCURRENT_MAP_STRIPE {
+   CONCURRENT_MAP_LOCK lock;
+   char pad [ CONCURRENT_MAP_CACHE_LINE_SIZE ];
+ } CONCURRENT_MAP_STRIPE;
+
+ typedef struct CONCURRENT_MAP_READER {
+   atomic_uint_fast64_t ui64_epoch; //The epoch in which this reader's current lookup started; 0 = not reading.
+   atomic_uint_fast8_t b_joined; //1 = this slot belongs to a thread.
+   char pad [ CONCURRENT_MAP_CACHE_LINE_SIZE - sizeof ( atomic_uint_fast64_t ) - sizeof ( atomic_uint_fast8_t ) ];
+ } CONCURRENT_MAP_READER;
+
+ typedef struct CONCURRENT_MAP {
+   _Atomic(CONCURRENT_MAP_TABLE *) lp_table; //Replaced (never changed) when the map grows.
+   uint32_t ui32_data_size; //The size of the user-data stored in every node.
+   uint8_t (*lpfn_free)(void *lpv_data); //user-defined free function, called on a node's user-data when the node is reclaimed.
+   atomic_uint_fast32_t ui32_count; //Count of all keys in the map.
+
+   CONCURRENT_MAP_STRIPE stripes [ CONCURRENT_MAP_LOCK_STRIPES ];
+
+   atomic_uint_fast64_t ui64_epoch; //The global epoch; starts at 1 and is advanced each time reclamation is attempted.
+   CONCURRENT_MAP_READER readers [ CONCURRENT_MAP_MAXIMUM_READERS ];
+
+   CONCURRENT_MAP_LOCK retired_lock; //Guards everything below.
+   CONCURRENT_MAP_NODE *lp_retired_nodes; //Nodes that have been unlinked but may still be seen by a reader, newest first.
+   CONCURRENT_MAP_TABLE *lp_retired_tables; //Tables (and the nodes in them) that have been replaced but may still be seen by a reader, newest first.
+   uint32_t ui32_retired_since_reclaim;
+   uint64_t ui64_retired_count; //How many nodes have been retired, in total.
+   uint64_t ui64_reclaimed_count; //How many of those have been freed.
+   uint32_t ui32_resize_count; //How many times the table has been doubled.
+ } CONCURRENT_MAP;
+
+ uint8_t initialize_concurrent_map (
+   CONCURRENT_MAP *lpm_map,
+   uint32_t ui32_capacity, //how many keys the map is expected to hold; this sets the starting bucket count.
+   uint32_t ui32_data_size,
+   uint8_t (*lpfn_free)(void*)
+ );
+
+ uint32_t join_concurrent_map ( CONCURRENT_MAP *lpm_map );
+ void leave_concurrent_map ( CONCURRENT_MAP *lpm_map, uint32_t ui32_reader );
+
+ uint8_t find_concurrent_map_node_data (
+   CONCURRENT_MAP *lpm_map,
+   uint32_t ui32_reader,
+   const char *lpsz_key,
+   void *lpv_data
+ );
+ uint8_t set_concurrent_map_node ( CONCURRENT_MAP *lpm_map, const char *lpsz_key, const void *lpv_data );
+ uint8_t free_concurrent_map_node ( CONCURRENT_MAP *lpm_map, const char *lpsz_key );
+ uint64_t reclaim_concurrent_map_nodes ( CONCURRENT_MAP *lpm_map );
+ uint8_t free_concurrent_map ( CONCURRENT_MAP *lpm_map );
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To compare the concurrent map against the map in map.c wrapped in a single
+ global mutex, with 1 to 16 threads, for a read-mostly mix (90% lookups, 10% updates),
+ a write-heavy mix (50% lookups, 25% updates, and 25% deletions that are each followed
+ by putting the key back), and a growing mix (the write-heavy one, on maps that start
+ empty and with no capacity hint, so the concurrent map doubles its table while the
+ other threads are reading and writing).
+
+ After each run, the map is checked: it has to hold every key (or, for the growing
+ mix, exactly the keys that can be found), and, once the concurrent map has been
+ freed, lpfn_free has to have been called once for every value that was set.
+
+ Usage: concurrent_map_benchmark [key count (default: 100000)] [operations per thread (default: 200000)]
+
+ To compile:
+   gcc -O2 -pthread map.c concurrent_map.c concurrent_map_benchmark.c -o concurrent_map_benchmark
+*/
+ #include "concurrent_map.h"
+ #include "map.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_KEY_LENGTH 32
+ #define BENCHMARK_MAXIMUM_THREADS 16
+
+#ifdef _WIN32
+ #define BENCHMARK_THREAD_RETURN DWORD WINAPI
+#else
+ #define BENCHMARK_THREAD_RETURN void *
+#endif
+
+ typedef struct BENCHMARK_MIX {
+   const char *lpsz_name;
+   uint32_t ui32_update_percent; //These are out of 100; whatever is left over is lookups.
+   uint32_t ui32_delete_percent;
+   uint8_t b_start_empty; //1 = the maps start empty, instead of holding every key in a table sized for them.
+ } BENCHMARK_MIX;
+
+ typedef struct BENCHMARK_THREAD {
+   uint8_t b_concurrent; //1 = use the concurrent map; 0 = use the map behind the global mutex.
+   CONCURRENT_MAP *lpm_concurrent_map;
+   MAP *lpm_map;
+#ifdef _WIN32
+   SRWLOCK *lp_global_lock;
+#else
+   pthread_mutex_t *lp_global_lock;
+#endif
+   const char *lpsz_keys;
+   uint32_t ui32_key_count;
+   uint32_t ui32_operations;
+   const BENCHMARK_MIX *lp_mix;
+   uint64_t ui64_seed;
+   uint64_t ui64_found; //Only kept so that the lookups can't be optimized away.
+   uint64_t ui64_sets; //How many values this thread set in the concurrent map.
+ } BENCHMARK_THREAD;
+
+ //How many times the concurrent map has called count_freed_benchmark_data.
+ static atomic_uint_fast64_t ui64_freed_data;
+
+///user-defined callbacks.
+ static uint8_t free_benchmark_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1; //There's nothing inside of a uint64_t to free.
+}}
+
+ //The concurrent map's free function, which counts the values, so that we can tell if one was freed twice or never.
+ static uint8_t count_freed_benchmark_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ atomic_fetch_add ( &ui64_freed_data, 1 );
+ return 1;
+}}
+
+ static int8_t compare_benchmark_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0;
+}}
+
+ static BENCHMARK_THREAD_RETURN run_benchmark_thread ( void *lpv_thread )
+{{
+ BENCHMARK_THREAD *lp_thread = (BENCHMARK_THREAD *) lpv_thread;
+ uint64_t ui64_state = lp_thread ->ui64_seed;
+ uint32_t ui32_reader = CONCURRENT_MAP_NO_READER;
+
+ if ( lp_thread ->b_concurrent ) {
+   ui32_reader = join_concurrent_map ( lp_thread ->lpm_concurrent_map );
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < lp_thread ->ui32_operations; ui32_i ++ ) {
+   uint64_t ui64_random = get_benchmark_random ( &ui64_state );
+   const char *lpsz_key = lp_thread ->lpsz_keys + (size_t) (ui64_random % lp_thread ->ui32_key_count) * BENCHMARK_KEY_LENGTH;
+   uint32_t ui32_percent = (uint32_t) (ui64_random >> 40) % 100;
+   uint64_t ui64_data = ui64_random;
+
+   if ( lp_thread ->b_concurrent ) {
+     if ( ui32_percent < lp_thread ->lp_mix ->ui32_delete_percent ) {
+       free_concurrent_map_node ( lp_thread ->lpm_concurrent_map, lpsz_key );
+       lp_thread ->ui64_sets += set_concurrent_map_node ( lp_thread ->lpm_concurrent_map, lpsz_key, &ui64_data );
+     }
+     else if ( ui32_percent < lp_thread ->lp_mix ->ui32_delete_percent + lp_thread ->lp_mix ->ui32_update_percent ) {
+       lp_thread ->ui64_sets += set_concurrent_map_node ( lp_thread ->lpm_concurrent_map, lpsz_key, &ui64_data );
+     }
+     else {
+       lp_thread ->ui64_found += find_concurrent_map_node_data ( lp_thread ->lpm_concurrent_map, ui32_reader, lpsz_key, &ui64_data );
+     }
+     continue;
+   }
+
+#ifdef _WIN32
+   AcquireSRWLockExclusive ( lp_thread ->lp_global_lock );
+#else
+   pthread_mutex_lock ( lp_thread ->lp_global_lock );
+#endif
+   if ( ui32_percent < lp_thread ->lp_mix ->ui32_delete_percent ) {
+     free_map_node ( lp_thread ->lpm_map, lpsz_key );
+     SET_MAP_NODE ( *lp_thread ->lpm_map, lpsz_key, ui64_data );
+   }
+   else if ( ui32_percent < lp_thread ->lp_mix ->ui32_delete_percent + lp_thread ->lp_mix ->ui32_update_percent ) {
+     SET_MAP_NODE ( *lp_thread ->lpm_map, lpsz_key, ui64_data );
+   }
+   else {
+     uint64_t *lpui64_data = (uint64_t *) find_map_node_data ( lp_thread ->lpm_map, lpsz_key );
+     if ( lpui64_data ) {
+       ui64_data = *lpui64_data;
+       lp_thread ->ui64_found ++;
+     }
+   }
+#ifdef _WIN32
+   ReleaseSRWLockExclusive ( lp_thread ->lp_global_lock );
+#else
+   pthread_mutex_unlock ( lp_thread ->lp_global_lock );
+#endif
+ }
+
+ if ( lp_thread ->b_concurrent ) {
+   leave_concurrent_map ( lp_thread ->lpm_concurrent_map, ui32_reader );
+ }
+
+ return 0;
+}}
+
+/*
+ This will fill a map (concurrent or not) with ui32_key_count keys (unless the mix starts
+ empty), run ui32_thread_count threads of ui32_operations each against it, check it (see
+ the top of this file), and return the total throughput in millions of operations per second.
+ *lpui32_resize_count is set to how many times the concurrent map doubled its table.
+*/
+ static double run_concurrent_map_benchmark (
+   uint8_t b_concurrent,
+   const BENCHMARK_MIX *lp_mix,
+   uint32_t ui32_thread_count,
+   const char *lpsz_keys,
+   uint32_t ui32_key_count,
+   uint32_t ui32_operations,
+   uint32_t *lpui32_resize_count
+ )
+{{
+ CONCURRENT_MAP concurrent_map;
+ MAP map;
+#ifdef _WIN32
+ SRWLOCK global_lock;
+ InitializeSRWLock ( &global_lock );
+ HANDLE threads [ BENCHMARK_MAXIMUM_THREADS ];
+#else
+ pthread_mutex_t global_lock;
+ pthread_mutex_init ( &global_lock, 0 );
+ pthread_t threads [ BENCHMARK_MAXIMUM_THREADS ];
+#endif
+ BENCHMARK_THREAD thread_information [ BENCHMARK_MAXIMUM_THREADS ];
+
+ uint64_t ui64_data = 0;
+ uint64_t ui64_sets = 0;
+ uint32_t ui32_fill_count = lp_mix ->b_start_empty ? 0 : ui32_key_count;
+ if ( b_concurrent ) {
+   atomic_store ( &ui64_freed_data, 0 );
+   initialize_concurrent_map ( &concurrent_map, ui32_fill_count, sizeof ( uint64_t ), count_freed_benchmark_data );
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_fill_count; ui32_i ++ ) {
+     ui64_sets += set_concurrent_map_node ( &concurrent_map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, &ui64_data );
+   }
+ }
+ else {
+   initialize_map_with_capacity ( &map, ui32_fill_count, sizeof ( uint64_t ), 0, compare_benchmark_data, free_benchmark_data );
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_fill_count; ui32_i ++ ) {
+     SET_MAP_NODE ( map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui64_data );
+   }
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_thread_count; ui32_i ++ ) {
+   thread_information [ ui32_i ] .b_concurrent = b_concurrent;
+   thread_information [ ui32_i ] .lpm_concurrent_map = &concurrent_map;
+   thread_information [ ui32_i ] .lpm_map = &map;
+   thread_information [ ui32_i ] .lp_global_lock = &global_lock;
+   thread_information [ ui32_i ] .lpsz_keys = lpsz_keys;
+   thread_information [ ui32_i ] .ui32_key_count = ui32_key_count;
+   thread_information [ ui32_i ] .ui32_operations = ui32_operations;
+   thread_information [ ui32_i ] .lp_mix = lp_mix;
+   thread_information [ ui32_i ] .ui64_seed = 0x2545f4914f6cdd1dULL * (ui32_i + 1);
+   thread_information [ ui32_i ] .ui64_found = 0;
+   thread_information [ ui32_i ] .ui64_sets = 0;
+ }
+
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_thread_count; ui32_i ++ ) {
+#ifdef _WIN32
+   threads [ ui32_i ] = CreateThread ( 0, 0, run_benchmark_thread, &thread_information [ ui32_i ], 0, 0 );
+#else
+   pthread_create ( &threads [ ui32_i ], 0, run_benchmark_thread, &thread_information [ ui32_i ] );
+#endif
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_thread_count; ui32_i ++ ) {
+#ifdef _WIN32
+   WaitForSingleObject ( threads [ ui32_i ], INFINITE );
+   CloseHandle ( threads [ ui32_i ] );
+#else
+   pthread_join ( threads [ ui32_i ], 0 );
+#endif
+ }
+ double dbl_elapsed = get_benchmark_seconds (  ) - dbl_start;
+
+ //Every deletion puts its key back, so every key should still be there (if the map started with every key).
+ uint32_t ui32_count = b_concurrent ? (uint32_t) atomic_load ( &concurrent_map .ui32_count ) : map .ui32_count;
+ uint32_t ui32_expected_count = ui32_key_count;
+ if ( lp_mix ->b_start_empty ) {
+   uint32_t ui32_reader = b_concurrent ? join_concurrent_map ( &concurrent_map ) : CONCURRENT_MAP_NO_READER;
+   ui32_expected_count = 0;
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_key_count; ui32_i ++ ) {
+     const char *lpsz_key = lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH;
+     ui32_expected_count += b_concurrent ? find_concurrent_map_node_data ( &concurrent_map, ui32_reader, lpsz_key, &ui64_data ) : find_map_node_data ( &map, lpsz_key ) != 0;
+   }
+   if ( b_concurrent ) {
+     leave_concurrent_map ( &concurrent_map, ui32_reader );
+   }
+ }
+ if ( ui32_count != ui32_expected_count ) {
+   fprintf ( stderr, "Error: The map holds %" PRIu32 " keys instead of %" PRIu32 ".\n", ui32_count, ui32_expected_count );
+ }
+
+ if ( b_concurrent ) {
+   *lpui32_resize_count = concurrent_map .ui32_resize_count;
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_thread_count; ui32_i ++ ) {
+     ui64_sets += thread_information [ ui32_i ] .ui64_sets;
+   }
+
+   //Every value that was set is freed exactly once: when it's replaced, deleted, or the map is freed.
+   free_concurrent_map ( &concurrent_map );
+   uint64_t ui64_freed = atomic_load ( &ui64_freed_data );
+   if ( ui64_freed != ui64_sets ) {
+     fprintf ( stderr, "Error: lpfn_free was called %" PRIu64 " times for %" PRIu64 " values.\n", ui64_freed, ui64_sets );
+   }
+ }
+ else {
+   free_map ( &map );
+ }
+#ifndef _WIN32
+ pthread_mutex_destroy ( &global_lock );
+#endif
+
+ return (double) ui32_thread_count * ui32_operations / dbl_elapsed / 1e6;
+}}
+
+ int main ( int argc, char **argv )
+{{
+ uint32_t ui32_key_count = 100000;
+ uint32_t ui32_operations = 200000;
+ if ( argc > 1 ) {
+   ui32_key_count = (uint32_t) strtoul ( argv [ 1 ], 0, 10 );
+ }
+ if ( argc > 2 ) {
+   ui32_operations = (uint32_t) strtoul ( argv [ 2 ], 0, 10 );
+ }
+ if ( ! ui32_key_count ) {
+   fprintf ( stderr, "Error: The key count must be at least one.\n" );
+   return 1;
+ }
+
+ char *lpsz_keys = (char *) malloc ( (size_t) ui32_key_count * BENCHMARK_KEY_LENGTH );
+ if ( ! lpsz_keys ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_key_count );
+   return 1;
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_key_count; ui32_i ++ ) {
+   snprintf ( lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, BENCHMARK_KEY_LENGTH, "user:session:%010" PRIu32, ui32_i );
+ }
+
+ const BENCHMARK_MIX mixes [  ] = {
+   { "read-mostly", 10, 0, 0 },
+   { "write-heavy", 25, 25, 0 },
+   { "growing", 25, 25, 1 }
+ };
+
+ for ( uint32_t ui32_mix = 0; ui32_mix < sizeof ( mixes ) / sizeof ( mixes [ 0 ] ); ui32_mix ++ ) {
+   for ( uint32_t ui32_threads = 1; ui32_threads <= BENCHMARK_MAXIMUM_THREADS; ui32_threads <<= 1 ) {
+     uint32_t ui32_resize_count = 0;
+     double dbl_global_lock = run_concurrent_map_benchmark ( 0, &mixes [ ui32_mix ], ui32_threads, lpsz_keys, ui32_key_count, ui32_operations, &ui32_resize_count );
+     double dbl_concurrent = run_concurrent_map_benchmark ( 1, &mixes [ ui32_mix ], ui32_threads, lpsz_keys, ui32_key_count, ui32_operations, &ui32_resize_count );
+
+     fprintf (
+       stdout,
+       "%-11s %2" PRIu32 " threads: map + global mutex %8.3f Mops/s; concurrent map %8.3f Mops/s (%2" PRIu32 " table doublings)\n",
+       mixes [ ui32_mix ] .lpsz_name,
+       ui32_threads,
+       dbl_global_lock,
+       dbl_concurrent,
+       ui32_resize_count
+     );
+   }
+ }
+
+ free ( lpsz_keys );
+
+ return 0;
+}}
@@ -0,0 +1,193 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To index a growing collection of documents (see document_index.h).
+*/
+ #include "document_index.h"
+ #include <utility>
+
+ //This will return the size of a segment, for deciding when to merge it: its bytes and terminators.
+ static inline size_t get_document_segment_size ( const SUFFIX_ARRAY &segment )
+{{
+ return segment .str_text .size (  ) + segment .vec_document_starts .size (  );
+}}
+
+ //This will rebuild the last two segments as one.
+ static void merge_document_segments ( DOCUMENT_INDEX &index )
+{{
+ SUFFIX_ARRAY &first = index .vec_segments [ index .vec_segments .size (  ) - 2 ];
+ const SUFFIX_ARRAY &second = index .vec_segments .back (  );
+
+ std::string str_text;
+ str_text .reserve ( first .str_text .size (  ) + second .str_text .size (  ) );
+ str_text = first .str_text;
+ str_text += second .str_text;
+ std::vector<uint32_t> vec_document_starts ( first .vec_document_starts );
+ for ( std::vector<uint32_t>::const_iterator it_start = second .vec_document_starts .cbegin (  ); it_start != second .vec_document_starts .cend (  ); it_start ++ ) {
+   vec_document_starts .push_back ( (uint32_t) first .str_text .size (  ) + *it_start );
+ }
+
+ //Free both before building, so that the old arrays and the new one aren't all held at once.
+ SUFFIX_ARRAY old_first, old_second;
+ std::swap ( first, old_first );
+ std::swap ( index .vec_segments .back (  ), old_second );
+ old_first .vec_suffixes .clear (  );
+ old_first .vec_suffixes .shrink_to_fit (  );
+ old_second .vec_suffixes .clear (  );
+ old_second .vec_suffixes .shrink_to_fit (  );
+ old_first .vec_lcp .clear (  );
+ old_first .vec_lcp .shrink_to_fit (  );
+ old_second .vec_lcp .clear (  );
+ old_second .vec_lcp .shrink_to_fit (  );
+ index .vec_segments .pop_back (  );
+ index .vec_first_documents .pop_back (  );
+
+ generate_document_suffix_array (
+   index .vec_segments .back (  ),
+   str_text .data (  ),
+   str_text .size (  ),
+   vec_document_starts .data (  ),
+   vec_document_starts .size (  )
+ );
+}}
+
+/*
+ This will add st_count documents (lpary_documents [ i ] holds lpary_lengths [ i ] bytes, which
+ can be anything, including zeroes) and return the ID of the first; the rest follow in order.
+ Adding documents in batches is faster than one at a time, since each batch is sorted once.
+*/
+ uint32_t add_indexed_documents ( DOCUMENT_INDEX &index, const char **lpary_documents, const size_t *lpary_lengths, size_t st_count )
+{{
+ uint32_t ui32_first_document = get_document_count ( index );
+ if ( ! st_count ) {
+   return ui32_first_document;
+ }
+
+ std::string str_text;
+ std::vector<uint32_t> vec_document_starts ( st_count );
+ for ( size_t st_i = 0; st_i < st_count; st_i ++ ) {
+   vec_document_starts [ st_i ] = (uint32_t) str_text .size (  );
+   str_text .append ( lpary_documents [ st_i ], lpary_lengths [ st_i ] );
+ }
+
+ index .vec_segments .push_back ( SUFFIX_ARRAY (  ) );
+ index .vec_first_documents .push_back ( ui32_first_document );
+ generate_document_suffix_array (
+   index .vec_segments .back (  ),
+   str_text .data (  ),
+   str_text .size (  ),
+   vec_document_starts .data (  ),
+   st_count
+ );
+
+ while ( index .vec_segments .size (  ) >= 2 &&
+         get_document_segment_size ( index .vec_segments .back (  ) ) * DOCUMENT_INDEX_MERGE_FACTOR >=
+         get_document_segment_size ( index .vec_segments [ index .vec_segments .size (  ) - 2 ] ) ) {
+   merge_document_segments ( index );
+ }
+
+ return ui32_first_document;
+}}
+
+ uint32_t add_indexed_document ( DOCUMENT_INDEX &index, const char *lp_document, size_t st_length )
+{{
+ return add_indexed_documents ( index, &lp_document, &st_length, 1 );
+}}
+
+ //This will merge every segment into one, so that each query only searches one suffix array.
+ void compact_document_index ( DOCUMENT_INDEX &index )
+{{
+ while ( index .vec_segments .size (  ) >= 2 ) {
+   merge_document_segments ( index );
+ }
+}}
+
+ uint32_t get_document_count ( const DOCUMENT_INDEX &index )
+{{
+ if ( index .vec_segments .empty (  ) ) {
+   return 0;
+ }
+
+ return index .vec_first_documents .back (  ) + (uint32_t) index .vec_segments .back (  ) .vec_document_starts .size (  );
+}}
+
+/*
+ This will add a hit for every occurrence of the pattern to vec_hits (grouped by segment,
+ in no particular order otherwise) and return how many there were.
+*/
+ size_t find_document_substrings ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length, std::vector<DOCUMENT_HIT> &vec_hits )
+{{
+ size_t st_total = 0;
+ for ( size_t st_segment = 0; st_segment < index .vec_segments .size (  ); st_segment ++ ) {
+   const SUFFIX_ARRAY &segment = index .vec_segments [ st_segment ];
+   uint32_t ui32_first;
+   size_t st_count = find_suffix_array_range ( segment, lp_pattern, st_length, &ui32_first );
+   for ( size_t st_i = 0; st_i < st_count; st_i ++ ) {
+     uint32_t ui32_position = segment .vec_suffixes [ ui32_first + st_i ];
+     uint32_t ui32_document = get_suffix_array_document ( segment, ui32_position );
+     DOCUMENT_HIT hit;
+     hit .ui32_document = index .vec_first_documents [ st_segment ] + ui32_document;
+     hit .ui32_offset = ui32_position - segment .vec_document_starts [ ui32_document ];
+     vec_hits .push_back ( hit );
+   }
+   st_total += st_count;
+ }
+
+ return st_total;
+}}
+
+ //This will return how many times the pattern occurs in every document put together.
+ size_t count_document_substrings ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length )
+{{
+ size_t st_total = 0;
+ for ( std::vector<SUFFIX_ARRAY>::const_iterator it_segment = index .vec_segments .cbegin (  ); it_segment != index .vec_segments .cend (  ); it_segment ++ ) {
+   st_total += count_suffix_array_substrings ( *it_segment, lp_pattern, st_length );
+ }
+
+ return st_total;
+}}
+
+ //This will return how many documents hold the pattern (the document frequency).
+ size_t count_document_frequency ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length )
+{{
+ size_t st_total = 0;
+ for ( std::vector<SUFFIX_ARRAY>::const_iterator it_segment = index .vec_segments .cbegin (  ); it_segment != index .vec_segments .cend (  ); it_segment ++ ) {
+   st_total += count_suffix_array_documents ( *it_segment, lp_pattern, st_length );
+ }
+
+ return st_total;
+}}
+
+/*
+ This will find the longest substring that occurs in at least ui32_min_documents (at least 2)
+ different documents, set *lp_hit to one of its occurrences, and return its length (0, if
+ no substring is shared by that many). The documents that share it may be in different
+ segments, so the segments' sorted suffixes are merged as they're scanned (see
+ find_suffix_arrays_longest_common_substring); the index itself isn't changed.
+*/
+ size_t find_longest_common_substring ( const DOCUMENT_INDEX &index, uint32_t ui32_min_documents, DOCUMENT_HIT *lp_hit )
+{{
+ lp_hit ->ui32_document = 0;
+ lp_hit ->ui32_offset = 0;
+
+ size_t st_segment;
+ uint32_t ui32_position;
+ size_t st_length = find_suffix_arrays_longest_common_substring ( index .vec_segments, ui32_min_documents, &st_segment, &ui32_position );
+ if ( st_length ) {
+   const SUFFIX_ARRAY &segment = index .vec_segments [ st_segment ];
+   uint32_t ui32_document = get_suffix_array_document ( segment, ui32_position );
+   lp_hit ->ui32_document = index .vec_first_documents [ st_segment ] + ui32_document;
+   lp_hit ->ui32_offset = ui32_position - segment .vec_document_starts [ ui32_document ];
+ }
+
+ return st_length;
+}}
+
+ size_t get_document_index_memory_usage ( const DOCUMENT_INDEX &index )
+{{
+ size_t st_bytes = sizeof ( DOCUMENT_INDEX ) + index .vec_first_documents .capacity (  ) * sizeof ( uint32_t );
+ for ( std::vector<SUFFIX_ARRAY>::const_iterator it_segment = index .vec_segments .cbegin (  ); it_segment != index .vec_segments .cend (  ); it_segment ++ ) {
+   st_bytes += get_suffix_array_memory_usage ( *it_segment );
+ }
+
+ return st_bytes;
+}}
@@ -0,0 +1,56 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To search a collection of documents that keeps growing, with hits that say which
+ document matched and where.
+
+ The documents are indexed by generalized suffix arrays (see generate_document_suffix_array
+ in suffix_array.h), where every document ends with its own terminator. Rebuilding one
+ array every time a document is added would take quadratic time, so the index is a list
+ of segments (each a generalized suffix array over some of the documents, in the order
+ that they were added), from largest to smallest. Each call to add_indexed_documents adds
+ a segment, and merges the last two segments (by rebuilding them as one) for as long as
+ the last is at least 1/DOCUMENT_INDEX_MERGE_FACTOR the size of the one before it. That
+ keeps O(log n) segments, and each byte is rebuilt O(log n) times, like a binary counter.
+ Queries search each segment.
+
+ Usage:
+ DOCUMENT_INDEX index;
+ add_indexed_document ( index, "the first document", 18 );
+ add_indexed_document ( index, "the second document", 19 );
+ std::vector<DOCUMENT_HIT> vec_hits;
+ find_document_substrings ( index, "document", 8, vec_hits );
+
+ See document_index_benchmark.cpp for measurements.
+
+ To compile:
+   g++ -O2 suffix_array.cpp document_index.cpp document_index_benchmark.cpp -o document_index_benchmark
+*/
+#ifndef DOCUMENT_INDEX_HEADER_DEFINED
+#define DOCUMENT_INDEX_HEADER_DEFINED 1
+ #include "suffix_array.h"
+
+ #ifndef DOCUMENT_INDEX_MERGE_FACTOR
+   #define DOCUMENT_INDEX_MERGE_FACTOR 2
+ #endif
+
+typedef struct DOCUMENT_HIT {
+  uint32_t ui32_document; //The document's ID (the order that it was added in, counting from 0).
+  uint32_t ui32_offset; //Where the match starts in the document.
+} DOCUMENT_HIT;
+
+typedef struct DOCUMENT_INDEX {
+  std::vector<SUFFIX_ARRAY> vec_segments;
+  std::vector<uint32_t> vec_first_documents; //The ID of each segment's first document.
+} DOCUMENT_INDEX;
+
+ uint32_t add_indexed_documents ( DOCUMENT_INDEX &index, const char **lpary_documents, const size_t *lpary_lengths, size_t st_count );
+ uint32_t add_indexed_document ( DOCUMENT_INDEX &index, const char *lp_document, size_t st_length );
+ void compact_document_index ( DOCUMENT_INDEX &index );
+ uint32_t get_document_count ( const DOCUMENT_INDEX &index );
+ size_t find_document_substrings ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length, std::vector<DOCUMENT_HIT> &vec_hits );
+ size_t count_document_substrings ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length );
+ size_t count_document_frequency ( const DOCUMENT_INDEX &index, const char *lp_pattern, size_t st_length );
+ size_t find_longest_common_substring ( const DOCUMENT_INDEX &index, uint32_t ui32_min_documents, DOCUMENT_HIT *lp_hit );
+ size_t get_document_index_memory_usage ( const DOCUMENT_INDEX &index );
+
+#endif
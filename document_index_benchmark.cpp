@@ -0,0 +1,223 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure the document index (see document_index.h) over many short documents:
+ building it all at once and one document at a time, its memory, and how quickly it finds
+ hits and document frequencies.
+
+ The documents are English-like, 20 to 300 bytes each. Every answer is checked: the index
+ that was built one document at a time must give the same answers as the one built all at
+ once, and a sample of the queries is checked against a scan of every document. A substring
+ is planted in a few documents, to check the longest common substring.
+
+ Usage: document_index_benchmark [document count] (default: 200000)
+
+ To compile:
+   g++ -O2 suffix_array.cpp document_index.cpp document_index_benchmark.cpp -o document_index_benchmark
+*/
+ #include "document_index.h"
+ #include "benchmark.h"
+ #include <algorithm>
+
+ #define BENCHMARK_QUERY_COUNT 20000
+ #define BENCHMARK_CHECKED_QUERY_COUNT 200 //How many queries are checked against a scan of every document.
+ #define BENCHMARK_PLANTED_DOCUMENT_COUNT 5
+
+//What an index answered for every query, so that two can be compared.
+typedef struct BENCHMARK_ANSWERS {
+  std::vector<size_t> vec_counts;
+  std::vector<size_t> vec_frequencies;
+  std::vector<std::vector<DOCUMENT_HIT> > vec_hits; //Sorted, for the comparison.
+} BENCHMARK_ANSWERS;
+
+ static bool compare_document_hits ( const DOCUMENT_HIT &hit1, const DOCUMENT_HIT &hit2 )
+{{
+ return hit1 .ui32_document != hit2 .ui32_document ? hit1 .ui32_document < hit2 .ui32_document : hit1 .ui32_offset < hit2 .ui32_offset;
+}}
+
+ static bool is_same_document_hit ( const DOCUMENT_HIT &hit1, const DOCUMENT_HIT &hit2 )
+{{
+ return hit1 .ui32_document == hit2 .ui32_document && hit1 .ui32_offset == hit2 .ui32_offset;
+}}
+
+ static void run_document_queries ( const char *lpsz_name, const DOCUMENT_INDEX &index, const std::vector<std::string> &vec_queries, BENCHMARK_ANSWERS &answers )
+{{
+ const size_t st_query_count = vec_queries .size (  );
+ answers .vec_counts .resize ( st_query_count );
+ answers .vec_frequencies .resize ( st_query_count );
+ answers .vec_hits .assign ( st_query_count, std::vector<DOCUMENT_HIT> (  ) );
+
+ double dbl_start = get_benchmark_seconds (  );
+ size_t st_hits = 0;
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   st_hits += find_document_substrings ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ), answers .vec_hits [ st_i ] );
+ }
+ double dbl_hits = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   answers .vec_counts [ st_i ] = count_document_substrings ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_count = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   answers .vec_frequencies [ st_i ] = count_document_frequency ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_frequency = get_benchmark_seconds (  ) - dbl_start;
+
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   std::sort ( answers .vec_hits [ st_i ] .begin (  ), answers .vec_hits [ st_i ] .end (  ), compare_document_hits );
+ }
+
+ fprintf (
+   stdout,
+   "  %-22s %2zu segments; hits %6.3f (%.1f per query), count %6.3f, document frequency %6.3f Mops/s\n",
+   lpsz_name,
+   index .vec_segments .size (  ),
+   st_query_count / dbl_hits / 1e6,
+   (double) st_hits / st_query_count,
+   st_query_count / dbl_count / 1e6,
+   st_query_count / dbl_frequency / 1e6
+ );
+}}
+
+ //This will check one query's answers against a scan of every document.
+ static uint8_t check_document_answers ( const std::vector<std::string> &vec_documents, const std::string &str_query, const BENCHMARK_ANSWERS &answers, size_t st_query )
+{{
+ std::vector<DOCUMENT_HIT> vec_hits;
+ size_t st_frequency = 0;
+ for ( size_t st_document = 0; st_document < vec_documents .size (  ); st_document ++ ) {
+   size_t st_offset = vec_documents [ st_document ] .find ( str_query );
+   if ( st_offset != std::string::npos ) {
+     st_frequency ++;
+   }
+   for ( ; st_offset != std::string::npos; st_offset = vec_documents [ st_document ] .find ( str_query, st_offset + 1 ) ) {
+     DOCUMENT_HIT hit;
+     hit .ui32_document = (uint32_t) st_document;
+     hit .ui32_offset = (uint32_t) st_offset;
+     vec_hits .push_back ( hit );
+   }
+ }
+
+ return st_frequency == answers .vec_frequencies [ st_query ] &&
+   vec_hits .size (  ) == answers .vec_counts [ st_query ] &&
+   vec_hits .size (  ) == answers .vec_hits [ st_query ] .size (  ) &&
+   std::equal ( vec_hits .begin (  ), vec_hits .end (  ), answers .vec_hits [ st_query ] .begin (  ), is_same_document_hit );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ size_t st_document_count = 200000;
+ if ( argc > 1 ) {
+   st_document_count = (size_t) strtod ( argv [ 1 ], 0 );
+ }
+ if ( st_document_count < 2 * BENCHMARK_PLANTED_DOCUMENT_COUNT || st_document_count > 10000000 ) {
+   fprintf ( stderr, "Error: The document count must be between %d and 10000000.\n", 2 * BENCHMARK_PLANTED_DOCUMENT_COUNT );
+   return 1;
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::vector<std::string> vec_documents ( st_document_count );
+ size_t st_bytes = 0;
+ for ( size_t st_i = 0; st_i < st_document_count; st_i ++ ) {
+   generate_english_text ( vec_documents [ st_i ], 20 + get_benchmark_random ( &ui64_state ) % 281, &ui64_state );
+   st_bytes += vec_documents [ st_i ] .size (  );
+ }
+
+ //A substring that the generator can't produce (it has no digits), in a few documents spread across the collection.
+ const std::string str_planted = "planted 0123456789 substring";
+ for ( size_t st_i = 0; st_i < BENCHMARK_PLANTED_DOCUMENT_COUNT; st_i ++ ) {
+   std::string &str_document = vec_documents [ (st_i * 2 + 1) * st_document_count / (2 * BENCHMARK_PLANTED_DOCUMENT_COUNT) ];
+   str_document .insert ( (size_t) (get_benchmark_random ( &ui64_state ) % str_document .size (  )), str_planted );
+   st_bytes += str_planted .size (  );
+ }
+ fprintf ( stdout, "%zu documents, %.1f MB:\n", st_document_count, st_bytes / 1e6 );
+
+ std::vector<const char *> vec_pointers ( st_document_count );
+ std::vector<size_t> vec_lengths ( st_document_count );
+ for ( size_t st_i = 0; st_i < st_document_count; st_i ++ ) {
+   vec_pointers [ st_i ] = vec_documents [ st_i ] .data (  );
+   vec_lengths [ st_i ] = vec_documents [ st_i ] .size (  );
+ }
+
+ DOCUMENT_INDEX batch_index;
+ double dbl_start = get_benchmark_seconds (  );
+ add_indexed_documents ( batch_index, vec_pointers .data (  ), vec_lengths .data (  ), st_document_count );
+ double dbl_batch = get_benchmark_seconds (  ) - dbl_start;
+ fprintf (
+   stdout,
+   "  all at once:           build %7.2f s; %5.1f bytes per input byte\n",
+   dbl_batch,
+   (double) get_document_index_memory_usage ( batch_index ) / st_bytes
+ );
+
+ DOCUMENT_INDEX incremental_index;
+ uint8_t b_correct = 1;
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_document_count; st_i ++ ) {
+   b_correct = b_correct && add_indexed_document ( incremental_index, vec_pointers [ st_i ], vec_lengths [ st_i ] ) == st_i;
+ }
+ double dbl_incremental = get_benchmark_seconds (  ) - dbl_start;
+ fprintf (
+   stdout,
+   "  one at a time:         build %7.2f s (%.1f us per document); %5.1f bytes per input byte\n",
+   dbl_incremental,
+   dbl_incremental / st_document_count * 1e6,
+   (double) get_document_index_memory_usage ( incremental_index ) / st_bytes
+ );
+
+ //Half of the queries are substrings of a document, and half are runs of words (which mostly occur, when they are short).
+ std::vector<std::string> vec_queries ( BENCHMARK_QUERY_COUNT );
+ std::string str_words;
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   if ( st_i & 1 ) {
+     generate_english_text ( str_words, 8 + get_benchmark_random ( &ui64_state ) % 17, &ui64_state );
+     vec_queries [ st_i ] = str_words;
+   }
+   else {
+     const std::string &str_document = vec_documents [ get_benchmark_random ( &ui64_state ) % st_document_count ];
+     size_t st_query_length = 8 + get_benchmark_random ( &ui64_state ) % 13; //Every document has at least 20 bytes.
+     vec_queries [ st_i ] = str_document .substr ( get_benchmark_random ( &ui64_state ) % (str_document .size (  ) - st_query_length + 1), st_query_length );
+   }
+ }
+
+ BENCHMARK_ANSWERS batch_answers, incremental_answers;
+ run_document_queries ( "all at once:", batch_index, vec_queries, batch_answers );
+ run_document_queries ( "one at a time:", incremental_index, vec_queries, incremental_answers );
+ b_correct = b_correct &&
+   batch_answers .vec_counts == incremental_answers .vec_counts &&
+   batch_answers .vec_frequencies == incremental_answers .vec_frequencies;
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   b_correct = b_correct && std::equal (
+     batch_answers .vec_hits [ st_i ] .begin (  ),
+     batch_answers .vec_hits [ st_i ] .end (  ),
+     incremental_answers .vec_hits [ st_i ] .begin (  ),
+     is_same_document_hit
+   );
+ }
+ for ( size_t st_i = 0; st_i < BENCHMARK_CHECKED_QUERY_COUNT; st_i ++ ) {
+   size_t st_query = st_i * (BENCHMARK_QUERY_COUNT / BENCHMARK_CHECKED_QUERY_COUNT);
+   b_correct = b_correct && check_document_answers ( vec_documents, vec_queries [ st_query ], batch_answers, st_query );
+ }
+
+ //The planted substring is the longest one that all of its documents share (nothing else is shared by that many, at that length).
+ DOCUMENT_HIT hit;
+ dbl_start = get_benchmark_seconds (  );
+ size_t st_common = find_longest_common_substring ( incremental_index, BENCHMARK_PLANTED_DOCUMENT_COUNT, &hit );
+ double dbl_common = get_benchmark_seconds (  ) - dbl_start;
+ uint8_t b_common = st_common >= str_planted .size (  ) &&
+   vec_documents [ hit .ui32_document ] .substr ( hit .ui32_offset, st_common ) .find ( str_planted ) != std::string::npos;
+ fprintf (
+   stdout,
+   "  longest substring in %d documents: %zu bytes, in document %" PRIu32 " at %" PRIu32 " (%.2f s)%s\n",
+   BENCHMARK_PLANTED_DOCUMENT_COUNT,
+   st_common,
+   hit .ui32_document,
+   hit .ui32_offset,
+   dbl_common,
+   b_common ? "" : " (INCORRECT RESULT)"
+ );
+ fprintf ( stdout, "  %s\n", b_correct ? "Every answer matched." : "INCORRECT RESULTS" );
+
+ return 0;
+}}
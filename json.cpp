@@ -188,6 +188,8 @@
 */
  void VARIABLE::clear ( void )
 {{
+ this ->clear_conversion_cache (  );
+
  if ( ! this ->m_lpv_data )
      {
       this ->m_ul_type = VARIABLE_TYPE_INVALID;
@@ -282,6 +284,7 @@
 //This will allow a value to be assigned later with VARIABLE::at and VARIABLE::add (the vector/array version).
  VARIABLE::VARIABLE ( void )
 {{
+ this ->m_lp_conversion_cache = 0;
  this ->m_lpv_data = 0;
  this ->m_ul_type = VARIABLE_TYPE_INVALID;
 }}
@@ -289,6 +292,7 @@
 //This will instantiate the class with a string type and copy of the passed string stored in this ->m_lpv_data.
  VARIABLE::VARIABLE ( std::string str )
 {{
+ this ->m_lp_conversion_cache = 0;
  this ->m_lpv_data = (void *) new std::string ( str );
  this ->m_ul_type = VARIABLE_TYPE_STRING;
 }}
@@ -296,6 +300,7 @@
 //This will instantiate the class with a int64_t type and copy of the passed integer stored in this ->m_lpv_data.
  VARIABLE::VARIABLE ( int64_t i64_x )
 {{
+ this ->m_lp_conversion_cache = 0;
  this ->m_lpv_data = (void *) new int64_t;
  *((int64_t *) this ->m_lpv_data) = i64_x;
  this ->m_ul_type = VARIABLE_TYPE_INT64;
@@ -303,6 +308,7 @@
 
  VARIABLE::VARIABLE ( double dbl_x )
 {{
+ this ->m_lp_conversion_cache = 0;
  this ->m_lpv_data = (void *) new double;
  *((double *) this ->m_lpv_data) = dbl_x;
  this ->m_ul_type = VARIABLE_TYPE_DOUBLE;
@@ -313,6 +319,7 @@
 //if the passed reference is null.
  VARIABLE::VARIABLE ( std::vector<VARIABLE *> *variable_array )
 {{
+ this ->m_lp_conversion_cache = 0;
  std::vector<VARIABLE *> *v;
  if ( JSON_DEBUG_MODE )
       printf ( "new vector: %p\n", variable_array );
@@ -329,6 +336,7 @@
 //the passed map, or an empty map, if it is null.
  VARIABLE::VARIABLE ( std::map<std::string, VARIABLE *> *variable_map )
 {{
+ this ->m_lp_conversion_cache = 0;
  std::map<std::string, VARIABLE *> *m;
 
  if ( JSON_DEBUG_MODE )
@@ -346,26 +354,44 @@
  std::string VARIABLE::get_padding ( int64_t i64_spaces )
 {{
  std::string str;
- for ( int64_t i64_i = 0; i64_i < i64_spaces; i64_i ++ )
-       str .append ( " " );
+ VARIABLE::append_padding ( str, i64_spaces );
 
  return str;
 }}
 
+//This will append i64_spaces spaces to the passed string if i64_spaces is >= 0.
+ void VARIABLE::append_padding ( std::string &json_string, int64_t i64_spaces )
+{{
+ if ( i64_spaces > 0 )
+      json_string .append ( (size_t) i64_spaces, ' ' );
+}}
+
 /*
  This will convert the VARIABLE class into a JSON string, recursively,
  with K&R spacing.
 */
  std::string VARIABLE::to_json ( int64_t i64_depth )
 {{
- //std::string s;
+ std::string json_string;
+ this ->append_json ( json_string, i64_depth );
+
+ return json_string;
+}}
+
+/*
+ This does the work of VARIABLE::to_json, but it appends to the passed string
+ so that each nested array or object doesn't need its own temporary buffer.
+*/
+ void VARIABLE::append_json ( std::string &json_string, int64_t i64_depth )
+{{
  char sz_string [ 255 ] = { 0 };
 
  if ( this ->m_ul_type == VARIABLE_TYPE_OBJECT )
      {
       //foreach of the variables within this map.
       std::map<std::string, VARIABLE *> *lp_map = (std::map<std::string, VARIABLE *> *) this ->m_lpv_data;
-      std::string combined_string = "{\r\n" + get_padding ( i64_depth );
+      json_string .append ( "{\r\n" );
+      VARIABLE::append_padding ( json_string, i64_depth );
       for ( std::map<std::string, VARIABLE *>::iterator variable_iterator = lp_map ->begin (  );
             variable_iterator != lp_map ->end (  );
             variable_iterator ++
@@ -373,29 +399,26 @@
            {
             if ( variable_iterator != lp_map ->begin (  ) )
                 {
-                 combined_string .append ( ",\r\n" );
-                 combined_string .append ( get_padding ( i64_depth ) );
+                 json_string .append ( ",\r\n" );
+                 VARIABLE::append_padding ( json_string, i64_depth );
                 }
 
-            combined_string .append ( "\"" );
-            combined_string .append ( //The key string needs to be escaped, too!
-              VARIABLE::get_escaped_string ( variable_iterator ->first )
-            );
-            combined_string .append ( "\" : " ); //the quotations will be added, automatically, by to_json, if needed.
-            combined_string .append ( variable_iterator ->second ->to_json ( i64_depth+2 ) );
+            json_string .append ( "\"" );
+            VARIABLE::append_escaped_string ( json_string, variable_iterator ->first ); //The key string needs to be escaped, too!
+            json_string .append ( "\" : " ); //the quotations will be added, automatically, by to_json, if needed.
+            variable_iterator ->second ->append_json ( json_string, i64_depth+2 );
            }
 
-      combined_string .append ( "\r\n" );
-      combined_string .append ( get_padding ( i64_depth-2 ) );
-      combined_string .append ( "}" );
-
-      return combined_string;
+      json_string .append ( "\r\n" );
+      VARIABLE::append_padding ( json_string, i64_depth-2 );
+      json_string .append ( "}" );
      }
  else if ( this ->m_ul_type == VARIABLE_TYPE_ARRAY )
      {
       //foreach of the variables within this map.
       std::vector<VARIABLE *> *lp_vector = (std::vector<VARIABLE *> *) this ->m_lpv_data;
-      std::string combined_string = "[\r\n" + get_padding ( i64_depth );
+      json_string .append ( "[\r\n" );
+      VARIABLE::append_padding ( json_string, i64_depth );
       for ( std::vector<VARIABLE *>::iterator variable_iterator = lp_vector ->begin (  );
             variable_iterator != lp_vector ->end (  );
             variable_iterator ++
@@ -403,41 +426,218 @@
            {
             if ( variable_iterator != lp_vector ->begin (  ) )
                 {
-                 combined_string .append ( ",\r\n" );
-                 combined_string .append ( get_padding ( i64_depth ) );
+                 json_string .append ( ",\r\n" );
+                 VARIABLE::append_padding ( json_string, i64_depth );
                 }
 
             //Note: We don't always want the quotations around the value, since JSON only uses quotes around strings and keys.
-            combined_string .append ( (*variable_iterator) ->to_json ( i64_depth+2 ) );
+            (*variable_iterator) ->append_json ( json_string, i64_depth+2 );
            }
 
-      combined_string .append ( "\r\n" );
-      combined_string .append ( get_padding ( i64_depth-2 ) );
-      combined_string .append ( "]" );
-
-      return combined_string;
+      json_string .append ( "\r\n" );
+      VARIABLE::append_padding ( json_string, i64_depth-2 );
+      json_string .append ( "]" );
      }
  else if ( this ->m_ul_type == VARIABLE_TYPE_INT64 )
      {
       //%llu would be uint64_t, but we're dealing with a int64_t (signed).
       snprintf ( sz_string, 255, "%lld", *((int64_t *) this ->m_lpv_data) );
-      return std::string ( sz_string );
+      json_string .append ( sz_string );
      }
  else if ( this ->m_ul_type == VARIABLE_TYPE_DOUBLE )
      {
       snprintf ( sz_string, 255, "%f", *((double *) this ->m_lpv_data) );
-      return std::string ( sz_string );
+      json_string .append ( sz_string );
      }
  else if ( this ->m_ul_type == VARIABLE_TYPE_STRING )
      {
-      return std::string ( "\"" ) +
-             VARIABLE::get_escaped_string (
-               *((std::string *) this ->m_lpv_data)
-             ) +
-             std::string ( "\"" );
+      json_string .append ( "\"" );
+      VARIABLE::append_escaped_string ( json_string, *((std::string *) this ->m_lpv_data) );
+      json_string .append ( "\"" );
+     }
+ else json_string .append ( "unsupported type." );
+}}
+
+/*
+ This will do the same as VARIABLE::append_json, except that any array or object
+ with at least JSON_PARALLEL_MINIMUM_ELEMENTS elements will have its elements split
+ into chunks that are serialized by worker threads into their own buffers.
+
+ The output is a list of pieces that, when concatenated in order, are byte-for-byte
+ identical to what VARIABLE::to_json would have produced. Text that's produced on the
+ calling thread is always appended to piece_vector .back (  ).
+*/
+ void VARIABLE::append_json_pieces (
+   std::vector<std::string> &piece_vector,
+   int64_t i64_depth,
+   uint32_t ui32_thread_count
+ )
+{{
+ if ( piece_vector .empty (  ) )
+      piece_vector .push_back ( std::string (  ) );
+
+ //Primitives are never worth splitting.
+ if ( this ->m_ul_type != VARIABLE_TYPE_OBJECT && this ->m_ul_type != VARIABLE_TYPE_ARRAY )
+     {
+      this ->append_json ( piece_vector .back (  ), i64_depth );
+      return ;
+     }
+
+ //Gather the elements (and keys, for objects) so that they can be addressed by index.
+ std::vector<VARIABLE *> element_vector;
+ std::vector<const std::string *> key_vector;
+ if ( this ->m_ul_type == VARIABLE_TYPE_OBJECT )
+     {
+      std::map<std::string, VARIABLE *> *lp_map = (std::map<std::string, VARIABLE *> *) this ->m_lpv_data;
+      element_vector .reserve ( lp_map ->size (  ) );
+      key_vector .reserve ( lp_map ->size (  ) );
+      for ( std::map<std::string, VARIABLE *>::iterator variable_iterator = lp_map ->begin (  );
+            variable_iterator != lp_map ->end (  );
+            variable_iterator ++
+          )
+           {
+            key_vector .push_back ( &variable_iterator ->first );
+            element_vector .push_back ( variable_iterator ->second );
+           }
      }
+ else element_vector = *((std::vector<VARIABLE *> *) this ->m_lpv_data);
+
+ const char *sz_open = this ->m_ul_type == VARIABLE_TYPE_OBJECT ? "{\r\n" : "[\r\n";
+ const char *sz_close = this ->m_ul_type == VARIABLE_TYPE_OBJECT ? "}" : "]";
 
- return std::string ( "unsupported type." );
+ piece_vector .back (  ) .append ( sz_open );
+ VARIABLE::append_padding ( piece_vector .back (  ), i64_depth );
+
+ //This will serialize elements [ui64_start, ui64_end) into json_string, including the
+ //delimiters that precede every element after the first one of the whole container.
+ auto append_elements = [&] ( std::string &json_string, uint64_t ui64_start, uint64_t ui64_end ) {
+   for ( uint64_t ui64_i = ui64_start; ui64_i < ui64_end; ui64_i ++ ) {
+     if ( ui64_i )
+         {
+          json_string .append ( ",\r\n" );
+          VARIABLE::append_padding ( json_string, i64_depth );
+         }
+
+     if ( ! key_vector .empty (  ) )
+         {
+          json_string .append ( "\"" );
+          VARIABLE::append_escaped_string ( json_string, *key_vector [ ui64_i ] );
+          json_string .append ( "\" : " );
+         }
+
+     element_vector [ ui64_i ] ->append_json ( json_string, i64_depth+2 );
+   }
+ };
+
+ uint64_t ui64_element_count = element_vector .size (  );
+ if ( ui32_thread_count > 1 && ui64_element_count >= JSON_PARALLEL_MINIMUM_ELEMENTS )
+     {
+      uint64_t ui64_chunk_count = (uint64_t) ui32_thread_count * JSON_PARALLEL_CHUNKS_PER_THREAD;
+      if ( ui64_chunk_count > ui64_element_count )
+           ui64_chunk_count = ui64_element_count;
+
+      std::vector<std::string> chunk_vector ( ui64_chunk_count );
+      std::atomic<uint64_t> next_chunk ( 0 );
+
+      //Each worker keeps claiming the next unclaimed chunk until there are none left.
+      auto worker = [&] (  ) {
+        uint64_t ui64_chunk;
+        while ( (ui64_chunk = next_chunk .fetch_add ( 1 )) < ui64_chunk_count ) {
+          append_elements (
+            chunk_vector [ ui64_chunk ],
+            ui64_element_count * ui64_chunk / ui64_chunk_count,
+            ui64_element_count * (ui64_chunk + 1) / ui64_chunk_count
+          );
+        }
+      };
+
+      std::vector<std::thread> thread_vector;
+      for ( uint32_t ui32_i = 1; ui32_i < ui32_thread_count; ui32_i ++ )
+           thread_vector .push_back ( std::thread ( worker ) );
+      worker (  ); //The calling thread works, too.
+      for ( std::thread &t : thread_vector )
+           t .join (  );
+
+      for ( std::string &chunk : chunk_vector )
+           piece_vector .push_back ( std::move ( chunk ) );
+      piece_vector .push_back ( std::string (  ) );
+     }
+ //This container is too small to split, but one of its children might not be.
+ else {
+   for ( uint64_t ui64_i = 0; ui64_i < ui64_element_count; ui64_i ++ ) {
+     if ( ui64_i )
+         {
+          piece_vector .back (  ) .append ( ",\r\n" );
+          VARIABLE::append_padding ( piece_vector .back (  ), i64_depth );
+         }
+
+     if ( ! key_vector .empty (  ) )
+         {
+          piece_vector .back (  ) .append ( "\"" );
+          VARIABLE::append_escaped_string ( piece_vector .back (  ), *key_vector [ ui64_i ] );
+          piece_vector .back (  ) .append ( "\" : " );
+         }
+
+     element_vector [ ui64_i ] ->append_json_pieces ( piece_vector, i64_depth+2, ui32_thread_count );
+   }
+ }
+
+ piece_vector .back (  ) .append ( "\r\n" );
+ VARIABLE::append_padding ( piece_vector .back (  ), i64_depth-2 );
+ piece_vector .back (  ) .append ( sz_close );
+}}
+
+/*
+ This will produce the same string as VARIABLE::to_json (  ), but large arrays and
+ objects will be serialized on ui32_thread_count threads. Passing zero will use one
+ thread per hardware thread.
+*/
+ std::string VARIABLE::to_json_parallel ( uint32_t ui32_thread_count )
+{{
+ if ( ! ui32_thread_count )
+      ui32_thread_count = std::thread::hardware_concurrency (  );
+
+ std::vector<std::string> piece_vector;
+ this ->append_json_pieces ( piece_vector, 2, ui32_thread_count );
+
+ //If nothing was split, there's no need to copy anything.
+ if ( piece_vector .size (  ) == 1 )
+      return std::move ( piece_vector [ 0 ] );
+
+ size_t st_length = 0;
+ for ( const std::string &piece : piece_vector )
+      st_length += piece .size (  );
+
+ std::string json_string;
+ json_string .reserve ( st_length );
+ for ( const std::string &piece : piece_vector )
+      json_string .append ( piece );
+
+ return json_string;
+}}
+
+/*
+ This will write the same bytes as VARIABLE::to_json (  ) to the passed file, but the
+ chunks serialized by each thread are written one after another without ever being
+ concatenated into a single string.
+ Returns the number of bytes written.
+*/
+ uint64_t VARIABLE::write_json_parallel ( FILE *lp_file, uint32_t ui32_thread_count )
+{{
+ if ( ! lp_file )
+      return 0;
+
+ if ( ! ui32_thread_count )
+      ui32_thread_count = std::thread::hardware_concurrency (  );
+
+ std::vector<std::string> piece_vector;
+ this ->append_json_pieces ( piece_vector, 2, ui32_thread_count );
+
+ uint64_t ui64_bytes_written = 0;
+ for ( const std::string &piece : piece_vector )
+      ui64_bytes_written += fwrite ( piece .data (  ), 1, piece .size (  ), lp_file );
+
+ return ui64_bytes_written;
 }}
 
 /*
@@ -475,20 +675,28 @@
  if ( ! str )
       return escaped_string;
 
- const char *p = (const char *) str ->c_str (  ), *e;
+ VARIABLE::append_escaped_string ( escaped_string, *str );
+
+ return escaped_string;
+}}
+
+/*
+ This will append the passed string to json_string with all backslashes and quotes
+ prefixed with backslashes. This doesn't use any static buffers, so it's safe to call
+ from the worker threads of VARIABLE::to_json_parallel.
+*/
+ void VARIABLE::append_escaped_string ( std::string &json_string, const std::string &str )
+{{
+ const char *p = (const char *) str .c_str (  ), *e;
  uint64_t ui64_len = strlen ( p );
- static char sz_character [ 2 ] = { 0 };
 
  for ( e = p+ui64_len; p != e; p ++ ) {
    if ( *p == '\\' || *p == '\"' ) {
-     escaped_string .append ( "\\" );
+     json_string .push_back ( '\\' );
    }
 
-   *sz_character = *p;
-   escaped_string .append ( sz_character );
+   json_string .push_back ( *p );
  }
-
- return escaped_string;
 }}
 
 /*
@@ -836,7 +1044,7 @@
 //This will assign the current VARIABLE instance to the type and value of the passed integer.
  unsigned char VARIABLE::set ( int64_t x )
 {{
- if ( this ->m_ul_type == VARIABLE_TYPE_INVALID )
+ if ( this ->m_ul_type != VARIABLE_TYPE_INVALID )
       this ->clear (  );
 
  this ->m_lpv_data = (void *) new int64_t ( x );
@@ -848,7 +1056,7 @@
 //This will assign the current VARIABLE instance to the type and value of the passed decimal.
  unsigned char VARIABLE::set ( double x )
 {{
- if ( this ->m_ul_type == VARIABLE_TYPE_INVALID )
+ if ( this ->m_ul_type != VARIABLE_TYPE_INVALID )
       this ->clear (  );
 
  this ->m_lpv_data = (void *) new double ( x );
@@ -860,7 +1068,7 @@
 //This will assign the current VARIABLE instance to an array type and copy the vector, if it has any contents.
  unsigned char VARIABLE::set ( std::vector<VARIABLE *> *v )
 {{
- if ( this ->m_ul_type == VARIABLE_TYPE_INVALID )
+ if ( this ->m_ul_type != VARIABLE_TYPE_INVALID )
       this ->clear (  );
 
  if ( v )
@@ -932,10 +1140,29 @@
  return this ->set ( lp_variable );
 }}
 
- double VARIABLE::get_double ( void )
+ VARIABLE_CONVERSION_CACHE *VARIABLE::get_conversion_cache ( void )
+{{
+ if ( ! this ->m_lp_conversion_cache )
+     {
+      this ->m_lp_conversion_cache = new VARIABLE_CONVERSION_CACHE (  );
+      this ->m_lp_conversion_cache ->ui8_flags = 0;
+     }
+
+ return this ->m_lp_conversion_cache;
+}}
+
+//This must be called whenever the value changes so that stale conversions aren't returned.
+ void VARIABLE::clear_conversion_cache ( void )
 {{
- const char sz_string [ 2048 ] = { 0 };
+ if ( this ->m_lp_conversion_cache )
+     {
+      delete this ->m_lp_conversion_cache;
+      this ->m_lp_conversion_cache = 0;
+     }
+}}
 
+ double VARIABLE::get_double ( void )
+{{
  //Handle any conversions that we can.
  switch ( this ->m_ul_type ) {
 
@@ -946,12 +1173,22 @@
    return (double) *((int64_t *) this ->m_lpv_data);
 
    case VARIABLE_TYPE_STRING:
-     //If this can't be converted into an integer, return zero.
-     try {
-       return stod ( *((std::string *) this ->m_lpv_data) );
-     } catch ( ... ) {
-       return 0;
-     } //catch
+   {
+     VARIABLE_CONVERSION_CACHE *lp_cache = this ->get_conversion_cache (  );
+     if ( ! (lp_cache ->ui8_flags & VARIABLE_CACHED_DOUBLE) )
+         {
+          //If this can't be converted into a double, use zero.
+          try {
+            lp_cache ->dbl_double = stod ( *((std::string *) this ->m_lpv_data) );
+          } catch ( ... ) {
+            lp_cache ->dbl_double = 0;
+          } //catch
+
+          lp_cache ->ui8_flags |= VARIABLE_CACHED_DOUBLE;
+         }
+
+     return lp_cache ->dbl_double;
+   } //case string
  }
 
  return std::numeric_limits<double>::quiet_NaN (  );
@@ -959,8 +1196,6 @@
 
  int64_t VARIABLE::get_integer ( void )
 {{
- const char sz_string [ 2048 ] = { 0 };
-
  //Handle any conversions that we can.
  switch ( this ->m_ul_type ) {
 
@@ -972,12 +1207,20 @@
 
    case VARIABLE_TYPE_STRING:
    {
-     //If this can't be converted into an integer, return zero.
-     try {
-       return stoll ( *((std::string *) this ->m_lpv_data) );
-     } catch ( ... ) { //std::invalid_argument might be thrown.
-       return 0;
-     } //catch
+     VARIABLE_CONVERSION_CACHE *lp_cache = this ->get_conversion_cache (  );
+     if ( ! (lp_cache ->ui8_flags & VARIABLE_CACHED_INTEGER) )
+         {
+          //If this can't be converted into an integer, use zero.
+          try {
+            lp_cache ->i64_integer = stoll ( *((std::string *) this ->m_lpv_data) );
+          } catch ( ... ) { //std::invalid_argument might be thrown.
+            lp_cache ->i64_integer = 0;
+          } //catch
+
+          lp_cache ->ui8_flags |= VARIABLE_CACHED_INTEGER;
+         }
+
+     return lp_cache ->i64_integer;
    } //case string
  }
 
@@ -993,25 +1236,26 @@
 */
  std::string VARIABLE::get_string ( void )
 {{
- static char sz_string [ 2048 ] = { 0 };
+ char sz_string [ 2048 ] = { 0 };
 
  //Handle any conversions that we can.
  switch ( this ->m_ul_type ) {
 
    case VARIABLE_TYPE_DOUBLE:
-     {
-      std::string s;
-      snprintf ( sz_string, 2048, "%f", *((double *) this ->m_lpv_data) );
-      s = sz_string;
-      return s;
-     }
-
    case VARIABLE_TYPE_INT64:
      {
-      std::string s;
-      snprintf ( sz_string, 2048, "%lld", *((int64_t *) this ->m_lpv_data) );
-      s = sz_string;
-      return s;
+      VARIABLE_CONVERSION_CACHE *lp_cache = this ->get_conversion_cache (  );
+      if ( ! (lp_cache ->ui8_flags & VARIABLE_CACHED_STRING) )
+          {
+           if ( this ->m_ul_type == VARIABLE_TYPE_DOUBLE )
+                snprintf ( sz_string, 2048, "%f", *((double *) this ->m_lpv_data) );
+           else snprintf ( sz_string, 2048, "%lld", *((int64_t *) this ->m_lpv_data) );
+
+           lp_cache ->str_string = sz_string;
+           lp_cache ->ui8_flags |= VARIABLE_CACHED_STRING;
+          }
+
+      return lp_cache ->str_string;
      }
 
    case VARIABLE_TYPE_STRING:
@@ -1019,10 +1263,11 @@
       return *((std::string *) this ->m_lpv_data);
      }
 
+   //Counts aren't cached because they change with every add and size (  ) is already cheap.
    case VARIABLE_TYPE_ARRAY:
      {
       std::string s;
-      snprintf ( sz_string, 2048, "Array ( %d )", ((std::vector<VARIABLE *> *) this ->m_lpv_data) ->size (  ) );
+      snprintf ( sz_string, 2048, "Array ( %d )", (int) ((std::vector<VARIABLE *> *) this ->m_lpv_data) ->size (  ) );
       s = sz_string;
       return s;
      }
@@ -1030,7 +1275,7 @@
    case VARIABLE_TYPE_OBJECT:
      {
       std::string s;
-      snprintf ( sz_string, 2048, "Object ( %d )", ((std::map<std::string, VARIABLE *> *) this ->m_lpv_data) ->size (  ) );
+      snprintf ( sz_string, 2048, "Object ( %d )", (int) ((std::map<std::string, VARIABLE *> *) this ->m_lpv_data) ->size (  ) );
       s = sz_string;
 
       return s;
@@ -1045,6 +1290,43 @@
  return std::string ( "Unknown type." );
 }}
 
+/*
+ These return the stored value without any conversion, if the variable is already of the
+ requested type. Otherwise, false is returned and the output parameter isn't touched.
+
+ Usage:
+ int64_t i64_id;
+ if ( v [ "id" ] .try_get_int64 ( i64_id ) ) {
+   //..use i64_id.
+ }
+*/
+ bool VARIABLE::try_get_int64 ( int64_t &i64_value )
+{{
+ if ( this ->m_ul_type != VARIABLE_TYPE_INT64 )
+      return false;
+
+ i64_value = *((int64_t *) this ->m_lpv_data);
+ return true;
+}}
+
+ bool VARIABLE::try_get_double ( double &dbl_value )
+{{
+ if ( this ->m_ul_type != VARIABLE_TYPE_DOUBLE )
+      return false;
+
+ dbl_value = *((double *) this ->m_lpv_data);
+ return true;
+}}
+
+ bool VARIABLE::try_get_string ( const std::string *&lp_string )
+{{
+ if ( this ->m_ul_type != VARIABLE_TYPE_STRING )
+      return false;
+
+ lp_string = (const std::string *) this ->m_lpv_data;
+ return true;
+}}
+
 /*
  This will put the passed JSON into the minimal characters as a std::string object.
 */
@@ -1680,6 +1962,81 @@
  return true;
 }}
 
+/*
+ This will replace the contents of the passed variable with the value described by a
+ VARIABLE_LITERAL. Every node is allocated exactly once and attached directly, rather than
+ being built separately and then deep-copied into its parent like VARIABLE::add does.
+ Returns false (and leaves the variable empty) if the literal has an invalid type.
+*/
+ bool VARIABLE::from_literal ( VARIABLE &variable, const VARIABLE_LITERAL &literal )
+{{
+ variable .clear (  );
+
+ switch ( literal .ul_type ) {
+
+   case VARIABLE_TYPE_INT64:
+     variable .m_lpv_data = (void *) new int64_t ( literal .i64_integer );
+     break;
+
+   case VARIABLE_TYPE_DOUBLE:
+     variable .m_lpv_data = (void *) new double ( literal .dbl_double );
+     break;
+
+   case VARIABLE_TYPE_STRING:
+     variable .m_lpv_data = (void *) new std::string ( literal .sz_string ? literal .sz_string : "" );
+     break;
+
+   case VARIABLE_TYPE_ARRAY:
+     {
+      std::vector<VARIABLE *> *lp_vector = new std::vector<VARIABLE *> (  );
+      lp_vector ->reserve ( literal .ui64_child_count );
+      for ( uint64_t ui64_i = 0; ui64_i < literal .ui64_child_count; ui64_i ++ ) {
+        lp_vector ->push_back ( VARIABLE::new_from_literal ( literal .lp_children [ ui64_i ] ) );
+      }
+
+      variable .m_lpv_data = (void *) lp_vector;
+      break;
+     }
+
+   case VARIABLE_TYPE_OBJECT:
+     {
+      std::map<std::string, VARIABLE *> *lp_map = new std::map<std::string, VARIABLE *> (  );
+      for ( uint64_t ui64_i = 0; ui64_i < literal .ui64_child_count; ui64_i ++ ) {
+        const VARIABLE_LITERAL &member = literal .lp_children [ ui64_i ];
+        VARIABLE *&lp_member = (*lp_map) [ member .sz_key ? member .sz_key : "" ];
+
+        //If a key was repeated, the last one wins, like it would with a chain of add (  ) calls.
+        if ( lp_member )
+             delete lp_member;
+
+        lp_member = VARIABLE::new_from_literal ( member );
+      }
+
+      variable .m_lpv_data = (void *) lp_map;
+      break;
+     }
+
+   default:
+     return false;
+ }
+
+ variable .m_ul_type = literal .ul_type;
+
+ return true;
+}}
+
+/*
+ This is the same as VARIABLE::from_literal, except that the new VARIABLE is
+ dynamically allocated and must be freed with delete.
+*/
+ VARIABLE *VARIABLE::new_from_literal ( const VARIABLE_LITERAL &literal )
+{{
+ VARIABLE *lp_variable = new VARIABLE (  );
+ VARIABLE::from_literal ( *lp_variable, literal );
+
+ return lp_variable;
+}}
+
 /*
  int main ( int argc, char **argv )
 {{
@@ -13,6 +13,8 @@
  #include <vector>
  #include <map>
  #include <limits> //so that we can return NaN if someone requests a double value of an unconvertable type.
+ #include <thread> //for VARIABLE::to_json_parallel.
+ #include <atomic>
 
 #ifndef VARIABLE_TYPE_OBJECT
 #define VARIABLE_TYPE_OBJECT 1
@@ -27,11 +29,91 @@
 #define JSON_ENFORCE_SAFE_USAGE 1
 #endif
 
+//Arrays and objects with fewer elements than this will be serialized on the calling thread
+//by VARIABLE::to_json_parallel, since spinning up workers for them costs more than it saves.
+#ifndef JSON_PARALLEL_MINIMUM_ELEMENTS
+#define JSON_PARALLEL_MINIMUM_ELEMENTS 4096
+#endif
+//Each worker thread will be given this many chunks (on average) so that uneven elements balance out.
+#ifndef JSON_PARALLEL_CHUNKS_PER_THREAD
+#define JSON_PARALLEL_CHUNKS_PER_THREAD 4
+#endif
+
+/*
+ A VARIABLE_LITERAL is a read-only description of a JSON value that the compiler can lay out in
+ static storage, so that constant response skeletons don't need any allocations or add (  ) chains
+ to exist. VARIABLE::from_literal turns one into a VARIABLE with exactly one allocation per node.
+
+ Usage:
+ static constexpr VARIABLE_LITERAL status_members [ ] = {
+   JSON_LITERAL_INT64 ( "code", 200 ),
+   JSON_LITERAL_STRING ( "message", "OK" )
+ };
+ static constexpr VARIABLE_LITERAL response_members [ ] = {
+   JSON_LITERAL_OBJECT ( "status", status_members ),
+   JSON_LITERAL_EMPTY_ARRAY ( "results" )
+ };
+ static constexpr VARIABLE_LITERAL response = JSON_LITERAL_OBJECT ( 0, response_members );
+
+ VARIABLE v;
+ VARIABLE::from_literal ( v, response );
+ v [ "results" ] .add ( "per-request data" );
+
+ Keys are ignored for array elements and the top-level literal, so 0 can be passed for them.
+ Children must be declared before their parents because the parents point at them.
+*/
+ typedef struct VARIABLE_LITERAL {
+   uint32_t ul_type; //VARIABLE_TYPE_*
+   const char *sz_key; //The key of this value, if it's a member of an object.
+   int64_t i64_integer;
+   double dbl_double;
+   const char *sz_string;
+   const struct VARIABLE_LITERAL *lp_children; //The elements or members of an array or object.
+   uint64_t ui64_child_count;
+ } VARIABLE_LITERAL;
+
+#define JSON_LITERAL_INT64(K,X) { VARIABLE_TYPE_INT64, K, (int64_t) (X), 0.0, 0, 0, 0 }
+#define JSON_LITERAL_DOUBLE(K,X) { VARIABLE_TYPE_DOUBLE, K, 0, (double) (X), 0, 0, 0 }
+#define JSON_LITERAL_STRING(K,X) { VARIABLE_TYPE_STRING, K, 0, 0.0, X, 0, 0 }
+#define JSON_LITERAL_ARRAY(K,A) { VARIABLE_TYPE_ARRAY, K, 0, 0.0, 0, A, sizeof ( A ) / sizeof ( *(A) ) }
+#define JSON_LITERAL_OBJECT(K,A) { VARIABLE_TYPE_OBJECT, K, 0, 0.0, 0, A, sizeof ( A ) / sizeof ( *(A) ) }
+#define JSON_LITERAL_EMPTY_ARRAY(K) { VARIABLE_TYPE_ARRAY, K, 0, 0.0, 0, 0, 0 }
+#define JSON_LITERAL_EMPTY_OBJECT(K) { VARIABLE_TYPE_OBJECT, K, 0, 0.0, 0, 0, 0 }
+
+//Bits of VARIABLE_CONVERSION_CACHE::ui8_flags that say which conversions have been cached.
+#define VARIABLE_CACHED_INTEGER 1
+#define VARIABLE_CACHED_DOUBLE 2
+#define VARIABLE_CACHED_STRING 4
+
+//get_integer, get_double, and get_string keep the result of converting a value from
+//another type here the first time that they're called, so that repeated calls don't
+//re-parse or re-format it. This is only allocated once a conversion is needed.
+//Because the cache is written while reading, those accessors aren't safe for threads that
+//share a VARIABLE, even if none of them changes it; use try_get_int64, try_get_double, and
+//try_get_string there, since they only read.
+ typedef struct VARIABLE_CONVERSION_CACHE {
+   int64_t i64_integer;
+   double dbl_double;
+   std::string str_string;
+   uint8_t ui8_flags; //VARIABLE_CACHED_INTEGER | VARIABLE_CACHED_DOUBLE | VARIABLE_CACHED_STRING
+ } VARIABLE_CONVERSION_CACHE;
+
  class VARIABLE
 {
  private:
    void *m_lpv_data;
    uint32_t m_ul_type;
+   VARIABLE_CONVERSION_CACHE *m_lp_conversion_cache; //null until get_integer/get_double/get_string has to convert.
+
+   VARIABLE_CONVERSION_CACHE *get_conversion_cache ( void );
+   void clear_conversion_cache ( void );
+
+   //These append to an existing buffer so that nested arrays and objects don't each build
+   //and return their own temporary std::string.
+   static void append_padding ( std::string &json_string, int64_t i64_spaces );
+   static void append_escaped_string ( std::string &json_string, const std::string &str );
+   void append_json ( std::string &json_string, int64_t i64_depth );
+   void append_json_pieces ( std::vector<std::string> &piece_vector, int64_t i64_depth, uint32_t ui32_thread_count );
 
  public:
 
@@ -66,6 +148,10 @@
    static VARIABLE *parse ( const char *sz_json_string );
    static bool parse ( VARIABLE &variable, const char *sz_json_string );
 
+   //This will build a VARIABLE from a statically laid out JSON literal (see VARIABLE_LITERAL).
+   static bool from_literal ( VARIABLE &variable, const VARIABLE_LITERAL &literal );
+   static VARIABLE *new_from_literal ( const VARIABLE_LITERAL &literal );
+
    VARIABLE ( void ); //empty constructor defaults to VARIABLE_TYPE_INVALID with a null pointer in m_lpv_data.
    VARIABLE ( std::string str );
 
@@ -98,6 +184,11 @@
    std::string to_json ( void );
    std::string to_minimal_json ( void );
 
+   //These produce the same output as to_json (  ), but large arrays and objects are split into
+   //chunks that are serialized on ui32_thread_count threads (0 = one per hardware thread).
+   std::string to_json_parallel ( uint32_t ui32_thread_count );
+   uint64_t write_json_parallel ( FILE *lp_file, uint32_t ui32_thread_count );
+
    //This will make a deep copy of the variable such that objects and arrays of objects, arrays, and primitives will copy.
    VARIABLE *get_copy ( void );
 
@@ -135,9 +226,19 @@
    //These will get a double, integer, or string value from the current node, if possible.
    //If these are called on an array or object, the statistics (count) will be returned
    //instead.
+   //Conversions are cached on first use, so these are cheap to call repeatedly.
+   //Filling the cache writes to this variable, so concurrent readers need a lock or try_get_*.
    double get_double ( void );
    int64_t get_integer ( void );
    std::string get_string ( void );
+
+   //These never convert. They return false and leave the output untouched, if the variable
+   //isn't already of the requested type. The string pointer stays valid until this variable
+   //is changed or destroyed. They don't touch the conversion cache, so several threads may
+   //call them on the same variable as long as none of them changes it.
+   bool try_get_int64 ( int64_t &i64_value );
+   bool try_get_double ( double &dbl_value );
+   bool try_get_string ( const std::string *&lp_string );
 };
 
 #endif
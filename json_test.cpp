@@ -14,9 +14,35 @@
  JSON_ENFORCE_SAFE_USAGE, to 0. This is defined in json.h.
 
  To compile:
-   g++ json.cpp json_test.cpp -o json
+   g++ json.cpp json_test.cpp -o json -pthread
 */
  #include "json.h"
+ #include <chrono>
+ #include <new>
+
+ //Every allocation made with new is counted so that tests can report how many they needed.
+ static std::atomic<uint64_t> g_ui64_allocation_count ( 0 );
+
+ void *operator new ( size_t st_size )
+{{
+ g_ui64_allocation_count .fetch_add ( 1, std::memory_order_relaxed );
+
+ void *lpv_memory = malloc ( st_size ? st_size : 1 );
+ if ( ! lpv_memory )
+      throw std::bad_alloc (  );
+
+ return lpv_memory;
+}}
+
+ void operator delete ( void *lpv_memory ) noexcept
+{{
+ free ( lpv_memory );
+}}
+
+ void operator delete ( void *lpv_memory, size_t ) noexcept
+{{
+ free ( lpv_memory );
+}}
 
  void json_minimize_test ( void )
 {{
@@ -395,6 +421,199 @@
 
  }
 
+ /*
+  This will ensure that the parallel serializer produces exactly the same bytes as
+  the sequential one and show how long each of them took.
+ */
+ void test9 ( void ) {
+   printf ( "Beginning test #9.\n" );
+
+   //A large top-level array, and a small object holding another large array so that
+   //the nested path gets split, too.
+   VARIABLE v;
+   for ( int64_t i64_i = 0; i64_i < 200000; i64_i ++ ) {
+     v .add ( NEW_OBJECT );
+     v [ i64_i ] [ "id" ] = i64_i;
+     v [ i64_i ] [ "ratio" ] = i64_i / 7.0;
+     v [ i64_i ] [ "name" ] = "item \"" + std::to_string ( i64_i ) + "\"";
+   }
+
+   VARIABLE nested;
+   nested [ "name" ] = "nested";
+   for ( int64_t i64_i = 0; i64_i < 50000; i64_i ++ ) {
+     nested [ "values" ] .add ( i64_i );
+   }
+
+   auto start = std::chrono::steady_clock::now (  );
+   std::string sequential_string = v .to_json (  );
+   auto middle = std::chrono::steady_clock::now (  );
+   std::string parallel_string = v .to_json_parallel ( 4 );
+   auto end = std::chrono::steady_clock::now (  );
+
+   printf (
+     "to_json: %.3f ms; to_json_parallel ( 4 ): %.3f ms; %s.\n",
+     std::chrono::duration<double, std::milli> ( middle - start ) .count (  ),
+     std::chrono::duration<double, std::milli> ( end - middle ) .count (  ),
+     sequential_string == parallel_string ? "identical" : "DIFFERENT"
+   );
+
+   printf (
+     "nested: %s.\n",
+     nested .to_json (  ) == nested .to_json_parallel ( 4 ) ? "identical" : "DIFFERENT"
+   );
+
+   //Write the chunks to a temporary file and make sure they come back the same, too.
+   FILE *lp_file = tmpfile (  );
+   if ( lp_file ) {
+     uint64_t ui64_bytes_written = v .write_json_parallel ( lp_file, 4 );
+     std::string file_string ( ui64_bytes_written, '\0' );
+     rewind ( lp_file );
+     size_t st_bytes_read = fread ( &file_string [ 0 ], 1, file_string .size (  ), lp_file );
+     fclose ( lp_file );
+
+     printf (
+       "write_json_parallel: %llu bytes; %s.\n",
+       (unsigned long long) ui64_bytes_written,
+       st_bytes_read == sequential_string .size (  ) && file_string == sequential_string ? "identical" : "DIFFERENT"
+     );
+   }
+ }
+
+ /*
+  This is a micro-benchmark of each of the conversion paths: the first (uncached)
+  conversion, the cached conversions, and the typed accessors that never convert.
+ */
+ void test10 ( void ) {
+   printf ( "Beginning test #10.\n" );
+
+   const int64_t i64_iterations = 1000000;
+   VARIABLE integer_string ( std::string ( "123456789" ) );
+   VARIABLE decimal_string ( std::string ( "3.14159" ) );
+   VARIABLE integer ( (int64_t) 42 );
+   VARIABLE decimal ( 2.5 );
+
+   //Anything that's summed here is printed so that the loops can't be optimized away.
+   int64_t i64_sum = 0;
+   double dbl_sum = 0;
+   size_t st_length = 0;
+
+   auto time_loop = [&] ( const char *sz_name, auto loop_body ) {
+     auto start = std::chrono::steady_clock::now (  );
+     for ( int64_t i64_i = 0; i64_i < i64_iterations; i64_i ++ )
+          loop_body (  );
+     auto end = std::chrono::steady_clock::now (  );
+
+     printf (
+       "%-40s %8.2f ns/call\n",
+       sz_name,
+       std::chrono::duration<double, std::nano> ( end - start ) .count (  ) / i64_iterations
+     );
+   };
+
+   //The first call to each of these converts and caches; every call after that is a load.
+   time_loop ( "string .get_integer (  ) (cached)", [&] (  ) { i64_sum += integer_string .get_integer (  ); } );
+   time_loop ( "string .get_double (  ) (cached)", [&] (  ) { dbl_sum += decimal_string .get_double (  ); } );
+   time_loop ( "int64 .get_string (  ) (cached)", [&] (  ) { st_length += integer .get_string (  ) .size (  ); } );
+   time_loop ( "double .get_string (  ) (cached)", [&] (  ) { st_length += decimal .get_string (  ) .size (  ); } );
+
+   //Changing the value must drop the cached conversion, so this converts on every call.
+   time_loop ( "string .set (  ) + .get_integer (  )", [&] (  ) {
+     integer_string .set ( std::string ( "987654321" ) );
+     i64_sum += integer_string .get_integer (  );
+   } );
+
+   time_loop ( "int64 .get_integer (  )", [&] (  ) { i64_sum += integer .get_integer (  ); } );
+   time_loop ( "int64 .try_get_int64 (  )", [&] (  ) {
+     int64_t i64_value;
+     if ( integer .try_get_int64 ( i64_value ) )
+          i64_sum += i64_value;
+   } );
+   time_loop ( "double .try_get_double (  )", [&] (  ) {
+     double dbl_value;
+     if ( decimal .try_get_double ( dbl_value ) )
+          dbl_sum += dbl_value;
+   } );
+   time_loop ( "string .try_get_string (  )", [&] (  ) {
+     const std::string *lp_string;
+     if ( integer_string .try_get_string ( lp_string ) )
+          st_length += lp_string ->size (  );
+   } );
+
+   int64_t i64_value = -1;
+   printf (
+     "Checks: %s; %s; sums: %lld, %f, %zu.\n",
+     integer_string .get_integer (  ) == 987654321 ? "set (  ) invalidated the cache" : "STALE CACHE",
+     ! decimal .try_get_int64 ( i64_value ) && i64_value == -1 ? "try_get_int64 didn't convert a double" : "CONVERTED",
+     (long long) i64_sum,
+     dbl_sum,
+     st_length
+   );
+ }
+
+ /*
+  This builds the same response skeleton with a chain of add (  ) calls and from a
+  VARIABLE_LITERAL that the compiler laid out, then compares the output and the number
+  of allocations that each of them needed.
+ */
+ static constexpr VARIABLE_LITERAL g_status_members [ ] = {
+   JSON_LITERAL_INT64 ( "code", 200 ),
+   JSON_LITERAL_STRING ( "message", "OK" ),
+   JSON_LITERAL_DOUBLE ( "version", 1.5 )
+ };
+ static constexpr VARIABLE_LITERAL g_tags [ ] = {
+   JSON_LITERAL_STRING ( 0, "cached" ),
+   JSON_LITERAL_STRING ( 0, "public" )
+ };
+ static constexpr VARIABLE_LITERAL g_response_members [ ] = {
+   JSON_LITERAL_OBJECT ( "status", g_status_members ),
+   JSON_LITERAL_ARRAY ( "tags", g_tags ),
+   JSON_LITERAL_EMPTY_ARRAY ( "results" ),
+   JSON_LITERAL_STRING ( "request_id", "" )
+ };
+ static constexpr VARIABLE_LITERAL g_response = JSON_LITERAL_OBJECT ( 0, g_response_members );
+ static_assert ( g_response .ui64_child_count == 4, "The response literal should be laid out at compile time." );
+
+ void test11 ( void ) {
+   printf ( "Beginning test #11.\n" );
+
+   uint64_t ui64_start = g_ui64_allocation_count;
+
+   VARIABLE status ( NEW_OBJECT );
+   status .add ( "code", (int64_t) 200 );
+   status .add ( "message", std::string ( "OK" ) );
+   status .add ( "version", 1.5 );
+   VARIABLE tags ( NEW_ARRAY );
+   tags .add ( std::string ( "cached" ) );
+   tags .add ( std::string ( "public" ) );
+   VARIABLE chained ( NEW_OBJECT );
+   chained .add ( "status", &status );
+   chained .add ( "tags", &tags );
+   chained .add ( "results", NEW_ARRAY );
+   chained .add ( "request_id", std::string ( "" ) );
+
+   uint64_t ui64_chained = g_ui64_allocation_count - ui64_start;
+   ui64_start = g_ui64_allocation_count;
+
+   VARIABLE templated;
+   VARIABLE::from_literal ( templated, g_response );
+
+   uint64_t ui64_templated = g_ui64_allocation_count - ui64_start;
+
+   //Fill in the per-request parts of the skeleton.
+   templated [ "request_id" ] = "abc-123";
+   templated [ "results" ] .add ( (int64_t) 7 );
+   chained [ "request_id" ] = "abc-123";
+   chained [ "results" ] .add ( (int64_t) 7 );
+
+   printf (
+     "add (  ) chain: %llu allocations; from_literal: %llu allocations; output %s.\n",
+     (unsigned long long) ui64_chained,
+     (unsigned long long) ui64_templated,
+     chained .to_json (  ) == templated .to_json (  ) ? "identical" : "DIFFERENT"
+   );
+   printf ( "%s\n", templated .to_json (  ) .c_str (  ) );
+ }
+
  int main ( int argc, char **argv )
 {{
  json_minimize_test (  );
@@ -408,6 +627,9 @@
  test6 (  );
  test7 (  );
  test8 (  );
+ test9 (  );
+ test10 (  );
+ test11 (  );
 
  return 0;
 }}
@@ -2,114 +2,277 @@
  Created on 2022-04-08 by Jacob Bethany
  Purpose: To create a generic map in C that is quick,
  rather than based upon some kind of linear lookup.
- This implementation will group similar keys (using
- the first two bytes thereof, or the first byte and
- zero, if only one byte is present in the key string).
+ This implementation originally grouped similar keys (using
+ the first two bytes thereof) into 65535 tranches, but keys
+ that share a prefix ("user:", "sess:") all landed in the same
+ tranche and lookups became linear. Now, every byte of the key
+ is hashed and the nodes live in an open-addressed table that
+ grows with its contents. Nothing is allocated until the first
+ node is added, so empty maps cost only the MAP structure
+ itself. Each node (its header, user-data, and key) is a single
+ block carved out of the map's own slab pages, so a lookup
+ touches one block per node and free_map only has to free the
+ pages.
  To allow for iterating by insertion order, a vector
  can be exploited within the main structure of the
  pseudo object.
+
+ To compile (with the example usage in map_test.c):
+   gcc map.c map_test.c -o map
 */
- //Type, Map, Index
- //Example usage: MAP_DATA_AT ( SOME_STRUCTURE, some_map, 0 ) .some_structure_member
- #define MAP_DATA_AT(T,M,I) ( *((T*) M .lpary_doubly_linked_list [ I ] ->lpv_data) )
- #define MAP_KEY_AT(M,I) ( M .lpary_doubly_linked_list [ I ] ->lpsz_key )
-
- //Usage: SET_MAP_NODE ( map, "some_key", x );
- //Usage: SET_MAP_NODE_NO_ALLOC ( map, "some_key", lp_dynamically_allocated_structure_that_can_be_freed_implicitly );
- #define SET_MAP_NODE(M,K,V) set_map_node__internal ( &M, K, (void *) &V, 0 )
- #define SET_MAP_NODE_NO_ALLOC(M,K,V) set_map_node__internal ( M, K, V, 1 )
-
- #include "stdio.h"
- #include "stdlib.h"
- #include "stdint.h"
- #include "inttypes.h"
-#ifndef _WIN32
- #include "string.h"
-#else
- #include "windows.h"
- #include "conio.h"
-#endif
+ #include "map.h"
+
+ //map_trace_printf ( L, ... ) writes to stdout only when L <= MAP_TRACE_LEVEL (see map.h).
+ //When MAP_TRACE_LEVEL is 0, every call disappears at compile time, arguments and all.
+ #if ( MAP_TRACE_LEVEL )
+   #define map_trace_printf(L,...) do { if ( (L) <= MAP_TRACE_LEVEL ) fprintf ( stdout, __VA_ARGS__ ); } while ( 0 )
+ #else
+   #define map_trace_printf(L,...)
+ #endif
+
+ //map_statistics_add ( M, F, N ) adds N to (M) ->statistics .F when MAP_COLLECT_STATISTICS is set.
+ #if ( MAP_COLLECT_STATISTICS )
+   #define map_statistics_add(M,F,N) ( (M) ->statistics .F += (N) )
+ #else
+   #define map_statistics_add(M,F,N)
+ #endif
+
+ //Binary keys aren't zero-terminated, so they can't be traced with "%s".
+ #define MAP_TRACE_KEY(M,K) ( (M) ->ui32_key_size ? "(binary key)" : (K) )
+
+ //This asks the processor to start loading the cache line at P, without waiting for it.
+ #if defined ( __GNUC__ ) || defined ( __clang__ )
+   #define map_prefetch(P) __builtin_prefetch ( (P), 0, 3 )
+ #elif defined ( _MSC_VER ) && ( defined ( _M_X64 ) || defined ( _M_IX86 ) )
+   #include "xmmintrin.h"
+   #define map_prefetch(P) _mm_prefetch ( (const char *) (P), _MM_HINT_T0 )
+ #else
+   #define map_prefetch(P)
+ #endif
+
+ //Rotate a 64-bit integer left by the specified number of bits.
+ #define MAP_ROTATE_LEFT(X,N) ( ((X) << (N)) | ((X) >> (64 - (N))) )
+
+ //This mixes all of the bits of a 64-bit integer together (the MurmurHash3 finalizer).
+ static uint64_t mix_map_hash ( uint64_t ui64_hash )
+{{
+ ui64_hash ^= ui64_hash >> 33;
+ ui64_hash *= 0xff51afd7ed558ccdULL;
+ ui64_hash ^= ui64_hash >> 33;
+ ui64_hash *= 0xc4ceb9fe1a85ec53ULL;
+ ui64_hash ^= ui64_hash >> 33;
+
+ return ui64_hash;
+}}
+
+/*
+ This will hash every byte of the key, eight bytes at a time, so that keys which only
+ differ near their ends ("user:1000", "user:1001") are spread across the whole table.
+*/
+ static uint64_t hash_map_key_bytes ( const char *lpsz_key, size_t st_length )
+{{
+ uint64_t ui64_hash = 0x9e3779b97f4a7c15ULL ^ (st_length * 0xc2b2ae3d27d4eb4fULL);
+ uint64_t ui64_word;
+ const char *p = lpsz_key, *e = lpsz_key + st_length;
+
+ for ( ; e - p >= 8; p += 8 ) {
+   memcpy ( &ui64_word, p, 8 );
+   ui64_word *= 0x87c37b91114253d5ULL;
+   ui64_word = MAP_ROTATE_LEFT ( ui64_word, 31 );
+   ui64_word *= 0x4cf5ad432745937fULL;
+
+   ui64_hash ^= ui64_word;
+   ui64_hash = MAP_ROTATE_LEFT ( ui64_hash, 27 ) * 5 + 0x52dce729;
+ }
+
+ //Mix in the remaining zero to seven bytes.
+ if ( p != e ) {
+   ui64_word = 0;
+   memcpy ( &ui64_word, p, e - p );
+   ui64_word *= 0x87c37b91114253d5ULL;
+   ui64_word = MAP_ROTATE_LEFT ( ui64_word, 31 );
+   ui64_word *= 0x4cf5ad432745937fULL;
+   ui64_hash ^= ui64_word;
+ }
+
+ return mix_map_hash ( ui64_hash );
+}}
+
+ uint64_t get_map_key_hash ( const char *lpsz_key )
+{{
+ return hash_map_key_bytes ( lpsz_key, strlen ( lpsz_key ) );
+}}
+
+/*
+ This is get_map_key_hash for a key of ui32_key_size bytes (see initialize_binary_key_map).
+ An eight-byte key (an integer) is just mixed. Every step of mix_map_hash can be undone,
+ so no two integers have the same hash, and find_map_slot doesn't need to compare them.
+*/
+ uint64_t get_map_binary_key_hash ( const void *lpv_key, uint32_t ui32_key_size )
+{{
+ if ( ui32_key_size == sizeof ( uint64_t ) ) {
+   uint64_t ui64_key;
+   memcpy ( &ui64_key, lpv_key, sizeof ( uint64_t ) );
+   return mix_map_hash ( ui64_key );
+ }
+
+ return hash_map_key_bytes ( (const char *) lpv_key, ui32_key_size );
+}}
+
+ //This will hash a key the way that the map stores its keys.
+ static uint64_t hash_map_key ( MAP *lpm_map, const char *lpsz_key )
+{{
+ if ( lpm_map ->ui32_key_size ) {
+   return get_map_binary_key_hash ( lpsz_key, lpm_map ->ui32_key_size );
+ }
+
+ return get_map_key_hash ( lpsz_key );
+}}
+
+ //The user-data is stored right after the node's header, so that it's aligned like a malloc'd block would be.
+ #define MAP_NODE_HEADER_SIZE ( (sizeof ( DOUBLY_LINKED_LIST ) + MAP_NODE_ALIGNMENT - 1) & ~(size_t) (MAP_NODE_ALIGNMENT - 1) )
+ #define MAP_NODE_INLINE_DATA(N) ( (void *) ((char *) (N) + MAP_NODE_HEADER_SIZE) )
+ //The first bytes of each slab page link to the page before it; nodes start after them.
+ #define MAP_SLAB_PAGE_HEADER_SIZE ( (sizeof ( char * ) + MAP_NODE_ALIGNMENT - 1) & ~(size_t) (MAP_NODE_ALIGNMENT - 1) )
+
+/*
+ This will return a block of ui32_node_size bytes (a multiple of MAP_NODE_ALIGNMENT) for a node.
+ Small nodes are reused from the free list for their size, if one has been freed, or are carved
+ off of the end of the current slab page. Large nodes are allocated on their own.
+*/
+ static DOUBLY_LINKED_LIST *allocate_map_node ( MAP *lpm_map, uint32_t ui32_node_size )
+{{
+ if ( ui32_node_size > MAP_SLAB_LARGEST_NODE ) {
+   DOUBLY_LINKED_LIST *node = (DOUBLY_LINKED_LIST *) malloc ( ui32_node_size );
+   if ( node ) {
+     lpm_map ->st_node_memory += ui32_node_size;
+   }
+
+   return node;
+ }
+
+ uint32_t ui32_size_class = ui32_node_size / MAP_NODE_ALIGNMENT;
+ DOUBLY_LINKED_LIST *node = lpm_map ->lpary_free_nodes [ ui32_size_class ];
+ if ( node ) {
+   lpm_map ->lpary_free_nodes [ ui32_size_class ] = node ->lp_next;
+   return node;
+ }
+
+ //If the node won't fit in what's left of the current page, start a new one.
+ //Each page is twice the size of the one before it (up to MAP_SLAB_PAGE_SIZE),
+ //so that small maps stay small.
+ if ( ! lpm_map ->lp_slab_page || lpm_map ->ui32_slab_page_used + ui32_node_size > lpm_map ->ui32_slab_page_size ) {
+   uint32_t ui32_new_page_size = ! lpm_map ->lp_slab_page ? MAP_SLAB_FIRST_PAGE_SIZE :
+                                 lpm_map ->ui32_slab_page_size < MAP_SLAB_PAGE_SIZE ? lpm_map ->ui32_slab_page_size << 1 :
+                                 MAP_SLAB_PAGE_SIZE;
+   char *lp_new_page = (char *) malloc ( ui32_new_page_size );
+   if ( ! lp_new_page ) {
+     return 0;
+   }
+
+   map_trace_printf (
+     1,
+     "allocate_map_node: Allocating a new slab page of %" PRIu32 " bytes @ %p.\n",
+     ui32_new_page_size,
+     lp_new_page
+   );
+
+   //Keep whatever is left at the end of the old page for nodes of that size.
+   uint32_t ui32_remaining = lpm_map ->ui32_slab_page_size - lpm_map ->ui32_slab_page_used;
+   //(Every node is larger than its header, so anything smaller could never be used.)
+   if ( lpm_map ->lp_slab_page && ui32_remaining > MAP_NODE_HEADER_SIZE ) {
+     node = (DOUBLY_LINKED_LIST *) (lpm_map ->lp_slab_page + lpm_map ->ui32_slab_page_used);
+     node ->lp_next = lpm_map ->lpary_free_nodes [ ui32_remaining / MAP_NODE_ALIGNMENT ];
+     lpm_map ->lpary_free_nodes [ ui32_remaining / MAP_NODE_ALIGNMENT ] = node;
+   }
+
+   *(char **) lp_new_page = lpm_map ->lp_slab_page;
+   lpm_map ->lp_slab_page = lp_new_page;
+   lpm_map ->ui32_slab_page_size = ui32_new_page_size;
+   lpm_map ->ui32_slab_page_used = MAP_SLAB_PAGE_HEADER_SIZE;
+   lpm_map ->st_node_memory += ui32_new_page_size;
+ }
+
+ node = (DOUBLY_LINKED_LIST *) (lpm_map ->lp_slab_page + lpm_map ->ui32_slab_page_used);
+ lpm_map ->ui32_slab_page_used += ui32_node_size;
+
+ return node;
+}}
+
+ //This will give a node's block back to the map, so that the next node of the same size can reuse it.
+ static void release_map_node ( MAP *lpm_map, DOUBLY_LINKED_LIST *node )
+{{
+ if ( node ->ui32_node_size > MAP_SLAB_LARGEST_NODE ) {
+   lpm_map ->st_node_memory -= node ->ui32_node_size;
+   free ( node );
+   return ;
+ }
+
+ uint32_t ui32_size_class = node ->ui32_node_size / MAP_NODE_ALIGNMENT;
+ node ->lp_next = lpm_map ->lpary_free_nodes [ ui32_size_class ];
+ lpm_map ->lpary_free_nodes [ ui32_size_class ] = node;
+}}
 
- typedef struct DOUBLY_LINKED_LIST {
-   char *lpsz_key;
-   void *lpv_data;
-
-   struct DOUBLY_LINKED_LIST *lp_next;
-   struct DOUBLY_LINKED_LIST *lp_prev;
- } DOUBLY_LINKED_LIST;
-
- typedef struct TRANCHE {
-   DOUBLY_LINKED_LIST *lp_first_node; //first in sorted order (based upon user-defined sorting function).
-   DOUBLY_LINKED_LIST *lp_last_node;  //last in sorted order (based upon user-defined sorting function).
-   uint32_t ui32_count; //How many nodes are currently in the list?
- } TRANCHE;
-
- typedef struct MAP {
-   //This will be an array of references to the actual nodes within the tranches, in case we want to iterate through the list in the order in which the nodes were inserted.
-   DOUBLY_LINKED_LIST **lpary_doubly_linked_list; //DOUBLY_LINKED_LIST*[]. The index is the node starting from lp_first_node and following lp_next until N nodes have been accessed.
-   TRANCHE tranches [ 0xFFFF /*65535 or (2^16)-1*/ ]; //[(1<<16)-1] different tranches.
-   int8_t (*lpfn_sort_comparator_function)(void *lpv_node1, void *lpv_node2); //-1 = node1 should be left; 0 either is fine; 1 = node1 should be on the right.
-   uint8_t (*lpfn_free)(void *lpv_node1); //user-defined free function, in case the data stored in the tranch[n]->lpv_data memory block has dynamicly allocated memory, as well.
-   void *(*lpfn_initialize)(void); //user-defined function to return an initialized block of memory of the same arbitrary structure type being used in this map.
-   uint32_t ui32_count; //Count of all nodes in all tranches.
-   uint32_t ui32_data_size; //Store the size of the data in a user-defined block of a DOUBLY_LINKED_LIST struct, here.
-
- } MAP;
-
- //This will allocate memory large enough to hold a new DOUBLY_LINKED_LIST
- //structure node, and fill it with the passed data. The prev and next members
- //can be set to be zero, if needed. They exist only so as to make latent
- //insertion function creation easier.
+/*
+ This will allocate a single block large enough to hold a new DOUBLY_LINKED_LIST
+ structure node, the map's user-data, and the key, and fill it with the passed data.
+ If b_assign_data_instead_of_allocating_and_copying is set, no room is made for the
+ user-data and the node just references the block that was passed.
+ The prev and next members can be set to be zero, if needed. They exist only so
+ as to make latent insertion function creation easier.
+*/
  DOUBLY_LINKED_LIST *new_doubly_linked_list_node (
+   MAP *lpm_map,
    const char *lpsz_key,
+   uint64_t ui64_hash,
    void *lpv_data,
-   uint32_t ui32_data_size,
    DOUBLY_LINKED_LIST *lp_prev,
    DOUBLY_LINKED_LIST *lp_next,
    uint8_t b_assign_data_instead_of_allocating_and_copying //don't allocate a new block, just reference the one specified.
  )
 {{
- DOUBLY_LINKED_LIST *node = (DOUBLY_LINKED_LIST *) calloc ( sizeof (DOUBLY_LINKED_LIST), 1 );
- if ( ! node ) {
+ size_t st_key_size = lpm_map ->ui32_key_size ? lpm_map ->ui32_key_size : strlen ( lpsz_key ) + 1;
+ size_t st_data_size = b_assign_data_instead_of_allocating_and_copying ? 0 : lpm_map ->ui32_data_size;
+ size_t st_node_size = (MAP_NODE_HEADER_SIZE + st_data_size + st_key_size + MAP_NODE_ALIGNMENT - 1) &
+                       ~(size_t) (MAP_NODE_ALIGNMENT - 1);
+
+ //If the node's size can't be recorded, fail.
+ if ( st_node_size > UINT32_MAX ) {
    return 0;
  }
 
- //If we couldn't allocate memory for the key to store within the structure.
-#ifdef _WIN32
- if ( ! (node ->lpsz_key = _strdup ( lpsz_key )) ) {
-#else
- if ( ! (node ->lpsz_key = strdup ( lpsz_key )) ) {
-#endif
-   //Free the memory that we successfully allocated for the structure itself, earlier.
-   free ( node );
+ DOUBLY_LINKED_LIST *node = allocate_map_node ( lpm_map, (uint32_t) st_node_size );
+ if ( ! node ) {
    return 0;
  }
 
+ node ->ui32_node_size = (uint32_t) st_node_size;
+ node ->ui32_index = 0;
+
+ //The key goes after the user-data (if there is any), so that the user-data stays aligned.
+ node ->lpsz_key = (char *) MAP_NODE_INLINE_DATA ( node ) + st_data_size;
+ memcpy ( node ->lpsz_key, lpsz_key, st_key_size );
+
  if ( b_assign_data_instead_of_allocating_and_copying ) {
    node ->lpv_data = lpv_data;
  }
  else {
-   //If we couldn't allocate enough space to hold the contents of this new
-   //user data within the structure, free what we've allocated so far and fail.
-   if ( ! (node ->lpv_data = calloc(ui32_data_size, 1) ) ) {
-     free ( node ->lpsz_key );
-     free ( node );
-     return 0;
-   }
-
+   node ->lpv_data = MAP_NODE_INLINE_DATA ( node );
    memcpy (
      node ->lpv_data,
      lpv_data,
-     ui32_data_size
+     st_data_size
    );
  }
 
+ node ->ui64_hash = ui64_hash;
  node ->lp_next = lp_next;
  node ->lp_prev = lp_prev;
 
  return node;
 }}
 
+ //This won't allocate anything; the table is allocated when the first node is added.
  uint8_t initialize_map (
    MAP *lpm_map,
    uint32_t ui32_data_size,
@@ -136,103 +299,387 @@
  return 1;
 }}
 
- //This will return 0, if no node with the specified key exists, yet.
- //I'm tempted to make a get_map_node version that inserts a new node,
- //if nothing is found. This would invoke some user-defined initialization
- //function that returns a new structure. (MAP would require a new member,
- //void (*lpfn_init)(void);)
- void *find_map_node__internal (
+/*
+ This is initialize_map for a map that's about to have ui32_capacity keys added to it.
+ The table and the reference array are allocated up front with room for that many nodes,
+ so that a bulk load never has to grow them. (A capacity of 0 allocates nothing.)
+ Returns 0, if that memory couldn't be allocated.
+*/
+ uint8_t initialize_map_with_capacity (
+   MAP *lpm_map,
+   uint32_t ui32_capacity,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ )
+{{
+ if ( ! initialize_map ( lpm_map, ui32_data_size, lpfn_initialize, lpfn_sort_comparator_function, lpfn_free ) ) {
+   return 0;
+ }
+
+ return reserve_map ( lpm_map, ui32_capacity );
+}}
+
+/*
+ This is initialize_map for a map whose keys are all ui32_key_size bytes long (IDs, hashes,
+ packed structures), instead of strings. Each key is copied into its node, like a string
+ key is, but without looking for a terminating zero, so the keys can contain any bytes.
+ Use the *_map_binary_node* functions with it (or the *_map_integer_node* functions,
+ if ui32_key_size is 8); the string functions will read ui32_key_size bytes from their key.
+ Binary keys have no order, so the ordered index and snapshots aren't available for them.
+*/
+ uint8_t initialize_binary_key_map (
+   MAP *lpm_map,
+   uint32_t ui32_key_size,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ )
+{{
+ if ( ! ui32_key_size ) {
+   return 0;
+ }
+ if ( ! initialize_map ( lpm_map, ui32_data_size, lpfn_initialize, lpfn_sort_comparator_function, lpfn_free ) ) {
+   return 0;
+ }
+
+ lpm_map ->ui32_key_size = ui32_key_size;
+
+ return 1;
+}}
+
+ //This is initialize_binary_key_map for keys that are 64-bit integers.
+ uint8_t initialize_integer_key_map (
+   MAP *lpm_map,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ )
+{{
+ return initialize_binary_key_map (
+   lpm_map,
+   sizeof ( uint64_t ),
+   ui32_data_size,
+   lpfn_initialize,
+   lpfn_sort_comparator_function,
+   lpfn_free
+ );
+}}
+
+/*
+ This will compare two binary keys of ui32_key_size bytes and return 0, if they're the same.
+ Sixteen-byte keys (UUIDs and the like) are compared as two words, without calling memcmp.
+*/
+ static int compare_map_binary_keys ( const char *lpsz_key1, const char *lpsz_key2, uint32_t ui32_key_size )
+{{
+ if ( ui32_key_size == 2 * sizeof ( uint64_t ) ) {
+   uint64_t ui64_words1 [ 2 ], ui64_words2 [ 2 ];
+   memcpy ( ui64_words1, lpsz_key1, sizeof ( ui64_words1 ) );
+   memcpy ( ui64_words2, lpsz_key2, sizeof ( ui64_words2 ) );
+   return ((ui64_words1 [ 0 ] ^ ui64_words2 [ 0 ]) | (ui64_words1 [ 1 ] ^ ui64_words2 [ 1 ])) != 0;
+ }
+
+ return memcmp ( lpsz_key1, lpsz_key2, ui32_key_size );
+}}
+
+/*
+ This will return the index of the slot that holds the key, if it exists.
+ Otherwise, it will return the index of the empty slot at which the probe
+ sequence ended, which is where the key should be inserted.
+*/
+ static uint32_t find_map_slot (
    MAP *lpm_map,
    const char *lpsz_key,
-   uint8_t b_return_node_data_instead_of_node
+   uint64_t ui64_hash
  )
 {{
- fprintf (
-   stdout,
-   "find_map_node__internal: Checking to see whether the referenced map is valid.\n"
+ uint32_t ui32_mask = lpm_map ->ui32_slot_count - 1;
+ uint32_t ui32_slot = (uint32_t) ui64_hash & ui32_mask;
+
+ map_trace_printf (
+   2,
+   "find_map_slot: Looking for \"%s\" starting at slot #%" PRIu32 "\n",
+   MAP_TRACE_KEY ( lpm_map, lpsz_key ),
+   ui32_slot
  );
 
- //If the reference to the map is invalid.
- if ( ! lpm_map ) {
+ map_statistics_add ( lpm_map, ui64_lookups, 1 );
+#if ( MAP_COLLECT_STATISTICS )
+ uint32_t ui32_probe_length = 0;
+#endif
+
+ //There's always at least one empty slot, since the table grows before it's full.
+ while ( lpm_map ->lpary_slots [ ui32_slot ] .lp_node ) {
+#if ( MAP_COLLECT_STATISTICS )
+   ui32_probe_length ++;
+#endif
+
+   //Only compare the keys, if the full hashes match.
+   if ( lpm_map ->lpary_slots [ ui32_slot ] .ui64_hash == ui64_hash ) {
+     //Integer keys have unique hashes (see get_map_binary_key_hash), so they already match.
+     if ( lpm_map ->ui32_key_size == sizeof ( uint64_t ) ) {
+       break;
+     }
+
+     map_statistics_add ( lpm_map, ui64_key_comparisons, 1 );
+     map_trace_printf (
+       2,
+       "find_map_slot: \"%s\" ?= \"%s\"\n",
+       MAP_TRACE_KEY ( lpm_map, lpm_map ->lpary_slots [ ui32_slot ] .lp_node ->lpsz_key ),
+       MAP_TRACE_KEY ( lpm_map, lpsz_key )
+     );
+
+     if ( lpm_map ->ui32_key_size ) {
+       if ( ! compare_map_binary_keys ( lpm_map ->lpary_slots [ ui32_slot ] .lp_node ->lpsz_key, lpsz_key, lpm_map ->ui32_key_size ) ) {
+         break;
+       }
+     }
+     else if ( ! strcmp ( lpm_map ->lpary_slots [ ui32_slot ] .lp_node ->lpsz_key, lpsz_key ) ) {
+       break;
+     }
+   }
+
+   ui32_slot = (ui32_slot + 1) & ui32_mask;
+ }
+
+#if ( MAP_COLLECT_STATISTICS )
+ lpm_map ->statistics .ui64_probes += ui32_probe_length;
+ if ( lpm_map ->statistics .ui32_longest_probe < ui32_probe_length ) {
+   lpm_map ->statistics .ui32_longest_probe = ui32_probe_length;
+ }
+#endif
+
+ return ui32_slot;
+}}
+
+/*
+ This will resize the hash table to ui32_new_slot_count slots (a power of two that's
+ large enough to hold every node) and put every node back into it.
+ The hashes are stored in the slots, so none of the keys need to be read.
+*/
+ static uint8_t resize_map_slots ( MAP *lpm_map, uint32_t ui32_new_slot_count )
+{{
+ uint32_t ui32_mask = ui32_new_slot_count - 1;
+
+ //If the table can't get any larger, fail.
+ if ( ! ui32_new_slot_count ) {
    return 0;
  }
- fprintf (
-   stdout,
-   "find_map_node__internal: Checking to see whether the referenced key is valid.\n"
- );
 
- //If the key string is an invalid reference.
- if ( ! lpsz_key ) {
+ MAP_SLOT *lpary_new_slots = (MAP_SLOT *) calloc ( ui32_new_slot_count, sizeof ( MAP_SLOT ) );
+ if ( ! lpary_new_slots ) {
    return 0;
  }
- fprintf (
-   stdout,
-   "find_map_node__internal: Checking to see whether the referenced key is empty.\n"
+
+ map_trace_printf (
+   1,
+   "resize_map_slots: Growing the table from %" PRIu32 " to %" PRIu32 " slots.\n",
+   lpm_map ->ui32_slot_count,
+   ui32_new_slot_count
  );
 
- //If the key string doesn't have at least one character.
- if ( ! *lpsz_key ) {
-   return 0;
+ for ( uint32_t ui32_i = 0; ui32_i < lpm_map ->ui32_slot_count; ui32_i ++ ) {
+   if ( ! lpm_map ->lpary_slots [ ui32_i ] .lp_node ) {
+     continue;
+   }
+
+   uint32_t ui32_slot = (uint32_t) lpm_map ->lpary_slots [ ui32_i ] .ui64_hash & ui32_mask;
+   while ( lpary_new_slots [ ui32_slot ] .lp_node ) {
+     ui32_slot = (ui32_slot + 1) & ui32_mask;
+   }
+
+   lpary_new_slots [ ui32_slot ] = lpm_map ->lpary_slots [ ui32_i ];
  }
- fprintf (
-   stdout,
-   "find_map_node__internal: Resolving the tranche index.\n"
+
+ free ( lpm_map ->lpary_slots );
+ lpm_map ->lpary_slots = lpary_new_slots;
+ lpm_map ->ui32_slot_count = ui32_new_slot_count;
+ map_statistics_add ( lpm_map, ui64_table_growths, 1 );
+
+ return 1;
+}}
+
+ //This will allocate the hash table, if it hasn't been, yet, or double its size.
+ static uint8_t grow_map_slots ( MAP *lpm_map )
+{{
+ return resize_map_slots (
+   lpm_map,
+   lpm_map ->ui32_slot_count ? lpm_map ->ui32_slot_count << 1 : MAP_INITIAL_SLOT_COUNT
  );
+}}
 
+ //This will make room for at least ui32_capacity references in the insertion-order reference array.
+ //(realloc acts like malloc, if there's no reference array allocated, yet.)
+ static uint8_t reserve_map_index ( MAP *lpm_map, uint32_t ui32_capacity )
+{{
+ if ( ui32_capacity <= lpm_map ->ui32_index_capacity ) {
+   return 1;
+ }
 
- //Get the tranche index.
- unsigned short us_tranche_identifier = *((unsigned short *) lpsz_key);
-/*
- memcpy ( //us_tranche_idenifier = *((unsigned short *) lpsz_key);
-   &us_tranche_identifier,
-   lpsz_key,
-   2
+ map_trace_printf (
+   1,
+   "reserve_map_index: Expanding the reference array to hold %" PRIu32 " references.\n",
+   ui32_capacity
  );
-*/
 
- fprintf (
-   stdout,
-   "Looking for \"%s\" in tranche #%" PRIu32 "\n",
-   lpsz_key,
-   us_tranche_identifier
+ void *lpv_new_node_reference_array = realloc (
+   (void *) lpm_map ->lpary_doubly_linked_list,
+   (size_t) ui32_capacity * sizeof ( DOUBLY_LINKED_LIST *)
  );
+ if ( ! lpv_new_node_reference_array ) {
+   return 0;
+ }
 
- //We'll start at the beginning of the tranche list and move forward.
- //Some basic hashing algorithm or tree structure of alphabetically sorted
- //keys within the tranche's linked list could speed things up a bit more,
- //but we'll search linearly, from the first node, for now.
- DOUBLY_LINKED_LIST *lp_doubly_linked_list_node = lpm_map ->tranches [ us_tranche_identifier ] .lp_first_node;
- while ( lp_doubly_linked_list_node ) {
-
-   fprintf (
-     stdout,
-     "find_map_node__internal: \"%s\" ?= \"%s\"\n",
-     lp_doubly_linked_list_node ->lpsz_key,
-     lpsz_key
-   );
+ lpm_map ->lpary_doubly_linked_list = (DOUBLY_LINKED_LIST **) lpv_new_node_reference_array;
 
-   //If the key of this node matches what we're looking for.
-   if ( ! strcmp ( lp_doubly_linked_list_node ->lpsz_key, lpsz_key ) ) {
-     if ( b_return_node_data_instead_of_node ) {
-       return lp_doubly_linked_list_node ->lpv_data;
-     }
+ //A CLOCK cache keeps a referenced flag for each reference.
+ if ( lpm_map ->ui8_cache_policy == MAP_CACHE_CLOCK ) {
+   uint8_t *lpary_referenced = (uint8_t *) realloc ( lpm_map ->lpary_cache_referenced, ui32_capacity );
+   if ( ! lpary_referenced ) {
+     return 0;
+   }
+   lpm_map ->lpary_cache_referenced = lpary_referenced;
+ }
+
+ lpm_map ->ui32_index_capacity = ui32_capacity;
+ map_statistics_add ( lpm_map, ui64_index_reallocations, 1 );
+
+ return 1;
+}}
 
-     return lp_doubly_linked_list_node;
+/*
+ This will make room for ui32_capacity nodes in total, so that adding nodes until the map
+ holds that many won't have to grow the table or the reference array.
+ Returns 0, if the memory couldn't be allocated (the map is left as it was).
+*/
+ uint8_t reserve_map ( MAP *lpm_map, uint32_t ui32_capacity )
+{{
+ if ( ! lpm_map ) {
+   return 0;
+ }
+
+ //Find the smallest table that can hold ui32_capacity nodes without exceeding the maximum load.
+ uint64_t ui64_slot_count = MAP_INITIAL_SLOT_COUNT;
+ while ( (uint64_t) ui32_capacity * MAP_MAXIMUM_LOAD_DENOMINATOR > ui64_slot_count * MAP_MAXIMUM_LOAD_NUMERATOR ) {
+   ui64_slot_count <<= 1;
+ }
+ if ( ui64_slot_count > 0x80000000ULL ) {
+   return 0;
+ }
+
+ if ( ui32_capacity && ui64_slot_count > lpm_map ->ui32_slot_count ) {
+   if ( ! resize_map_slots ( lpm_map, (uint32_t) ui64_slot_count ) ) {
+     return 0;
    }
-   else {
-     fprintf ( stdout, "find_map_node__internal: They were NOT EQUAL.\n" );
+ }
+
+ //The tombstones in the reference array take up room, too.
+ return reserve_map_index ( lpm_map, lpm_map ->ui32_index_length - lpm_map ->ui32_count + ui32_capacity );
+}}
+
+/*
+ This will empty the specified slot and shift any nodes that follow it in the same
+ probe run back towards their home slots, so that no tombstones are needed and
+ lookups never have to step over deleted entries.
+*/
+ static void remove_map_slot ( MAP *lpm_map, uint32_t ui32_slot )
+{{
+ uint32_t ui32_mask = lpm_map ->ui32_slot_count - 1;
+ uint32_t ui32_next = ui32_slot;
+
+ for ( ;; ) {
+   ui32_next = (ui32_next + 1) & ui32_mask;
+   if ( ! lpm_map ->lpary_slots [ ui32_next ] .lp_node ) {
+     break;
    }
 
-   lp_doubly_linked_list_node = lp_doubly_linked_list_node ->lp_next;
-   fprintf (
-     stdout,
-     "find_map_node__internal: We've followed the next reference to %p.\n",
-     lp_doubly_linked_list_node
-   );
+   //If the hole is between this node's home slot and its current slot (cyclically),
+   //then moving the node into the hole keeps it reachable.
+   uint32_t ui32_home = (uint32_t) lpm_map ->lpary_slots [ ui32_next ] .ui64_hash & ui32_mask;
+   if ( ((ui32_next - ui32_home) & ui32_mask) >= ((ui32_next - ui32_slot) & ui32_mask) ) {
+     lpm_map ->lpary_slots [ ui32_slot ] = lpm_map ->lpary_slots [ ui32_next ];
+     ui32_slot = ui32_next;
+   }
  }
 
+ lpm_map ->lpary_slots [ ui32_slot ] .lp_node = 0;
+ lpm_map ->lpary_slots [ ui32_slot ] .ui64_hash = 0;
+}}
+
+ static void touch_map_cache_node ( MAP *lpm_map, DOUBLY_LINKED_LIST *node );
+
+/*
+ This is the part of a lookup that comes after the key has been hashed: it finds the node
+ (or returns 0) and, if the map is a cache, counts the hit or miss and marks the node as used.
+ The table must have been allocated.
+*/
+ static DOUBLY_LINKED_LIST *find_map_hashed_node ( MAP *lpm_map, const char *lpsz_key, uint64_t ui64_hash )
+{{
+ DOUBLY_LINKED_LIST *node = lpm_map ->lpary_slots [ find_map_slot ( lpm_map, lpsz_key, ui64_hash ) ] .lp_node;
+
+ if ( lpm_map ->ui32_cache_capacity ) {
+   if ( ! node ) {
+     lpm_map ->cache_statistics .ui64_misses ++;
+     return 0;
+   }
+   lpm_map ->cache_statistics .ui64_hits ++;
+   touch_map_cache_node ( lpm_map, node );
+ }
+
+ return node;
+}}
+
+ //This will return 0, if no node with the specified key exists, yet.
+ void *find_map_node__internal (
+   MAP *lpm_map,
+   const char *lpsz_key,
+   uint8_t b_return_node_data_instead_of_node
+ )
+{{
+ //If the reference to the map is invalid.
+ if ( ! lpm_map ) {
+   return 0;
+ }
+
+ //If the key string is an invalid reference.
+ if ( ! lpsz_key ) {
+   return 0;
+ }
+
+ //If the key string doesn't have at least one character.
+ if ( ! lpm_map ->ui32_key_size && ! *lpsz_key ) {
+   return 0;
+ }
+
+ //If nothing has been added to the map, yet, there's nothing to find.
+ if ( ! lpm_map ->lpary_slots ) {
+   if ( lpm_map ->ui32_cache_capacity ) {
+     lpm_map ->cache_statistics .ui64_misses ++;
+   }
+   return 0;
+ }
+
+ map_trace_printf (
+   2,
+   "find_map_node__internal: Hashing the key, \"%s\".\n",
+   MAP_TRACE_KEY ( lpm_map, lpsz_key )
+ );
+
+ DOUBLY_LINKED_LIST *lp_doubly_linked_list_node = find_map_hashed_node ( lpm_map, lpsz_key, hash_map_key ( lpm_map, lpsz_key ) );
+
  //We couldn't find the node.
- return 0;
+ if ( ! lp_doubly_linked_list_node ) {
+   return 0;
+ }
+
+ if ( b_return_node_data_instead_of_node ) {
+   return lp_doubly_linked_list_node ->lpv_data;
+ }
+
+ return lp_doubly_linked_list_node;
 }}
 
  void *find_map_node (
@@ -243,7 +690,7 @@
  return find_map_node__internal (
    lpm_map,
    lpsz_key,
-   0 //0 = node ->lpv_data; 1 = node
+   0 //0 = node; 1 = node ->lpv_data
  );
 }}
 
@@ -255,8 +702,596 @@
  return find_map_node__internal (
    lpm_map,
    lpsz_key,
-   1 //0 = node ->lpv_data; 1 = node
+   1 //0 = node; 1 = node ->lpv_data
+ );
+}}
+
+/*
+ This will look up ui32_count keys at once and write each one's user-data (or 0, if the key
+ doesn't exist) to the same position in lpary_data. It returns how many of them were found.
+ It's the same as calling find_map_node_data on each key, but faster for large maps: the keys
+ are looked up MAP_BATCH_LOOKUP_GROUP_SIZE at a time, and for each group, all of the keys
+ are hashed and their slots prefetched, then the nodes in those slots are prefetched,
+ and only then are the keys compared. That way, the cache misses for a whole group
+ overlap instead of each lookup waiting for its own slot and then its own node.
+ For maps with binary keys (see initialize_binary_key_map), each entry of lpary_keys points to a key.
+*/
+ uint32_t find_map_nodes_data ( MAP *lpm_map, const char **lpary_keys, uint32_t ui32_count, void **lpary_data )
+{{
+ if ( ! lpm_map || ! lpary_keys || ! lpary_data ) {
+   return 0;
+ }
+
+ uint64_t ui64_hashes [ MAP_BATCH_LOOKUP_GROUP_SIZE ];
+ uint32_t ui32_mask = lpm_map ->ui32_slot_count - 1;
+ uint32_t ui32_found = 0;
+
+ for ( uint32_t ui32_group = 0; ui32_group < ui32_count; ui32_group += MAP_BATCH_LOOKUP_GROUP_SIZE ) {
+   uint32_t ui32_group_size = ui32_count - ui32_group < MAP_BATCH_LOOKUP_GROUP_SIZE ? ui32_count - ui32_group : MAP_BATCH_LOOKUP_GROUP_SIZE;
+   const char **lpary_group_keys = lpary_keys + ui32_group;
+
+   //Invalid keys (and every key, before anything has been added) are simply not found.
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_group_size; ui32_i ++ ) {
+     const char *lpsz_key = lpary_group_keys [ ui32_i ];
+     if ( ! lpm_map ->lpary_slots || ! lpsz_key || (! lpm_map ->ui32_key_size && ! *lpsz_key) ) {
+       ui64_hashes [ ui32_i ] = 0;
+       lpary_data [ ui32_group + ui32_i ] = 0;
+       continue;
+     }
+
+     ui64_hashes [ ui32_i ] = hash_map_key ( lpm_map, lpsz_key );
+     map_prefetch ( &lpm_map ->lpary_slots [ ui64_hashes [ ui32_i ] & ui32_mask ] );
+   }
+
+   //The slots should be arriving by now. Start loading the nodes that they point to
+   //(if the hash matches, that's very likely the node we want). Even integer keys,
+   //which are never compared, need their node for its lpv_data.
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_group_size; ui32_i ++ ) {
+     if ( lpary_group_keys [ ui32_i ] && lpm_map ->lpary_slots ) {
+       MAP_SLOT *lp_slot = &lpm_map ->lpary_slots [ ui64_hashes [ ui32_i ] & ui32_mask ];
+       if ( lp_slot ->ui64_hash == ui64_hashes [ ui32_i ] ) {
+         map_prefetch ( lp_slot ->lp_node );
+         //The key comes after the user-data, which can push it into the next cache line.
+         if ( lpm_map ->ui32_key_size != sizeof ( uint64_t ) ) {
+           map_prefetch ( (char *) lp_slot ->lp_node + MAP_NODE_HEADER_SIZE + lpm_map ->ui32_data_size );
+         }
+       }
+     }
+   }
+
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_group_size; ui32_i ++ ) {
+     const char *lpsz_key = lpary_group_keys [ ui32_i ];
+     if ( ! lpm_map ->lpary_slots || ! lpsz_key || (! lpm_map ->ui32_key_size && ! *lpsz_key) ) {
+       if ( lpm_map ->ui32_cache_capacity ) {
+         lpm_map ->cache_statistics .ui64_misses ++;
+       }
+       continue;
+     }
+
+     DOUBLY_LINKED_LIST *node = find_map_hashed_node ( lpm_map, lpsz_key, ui64_hashes [ ui32_i ] );
+     lpary_data [ ui32_group + ui32_i ] = node ? node ->lpv_data : 0;
+     ui32_found += node != 0;
+   }
+ }
+
+ return ui32_found;
+}}
+
+//This is find_map_nodes_data for maps with 64-bit integer keys (see initialize_integer_key_map).
+ uint32_t find_map_integer_nodes_data ( MAP *lpm_map, const uint64_t *lpary_keys, uint32_t ui32_count, void **lpary_data )
+{{
+ if ( ! lpm_map || ! lpary_keys || ! lpary_data ) {
+   return 0;
+ }
+
+ const char *lpary_key_references [ MAP_BATCH_LOOKUP_GROUP_SIZE ];
+ uint32_t ui32_found = 0;
+ for ( uint32_t ui32_group = 0; ui32_group < ui32_count; ui32_group += MAP_BATCH_LOOKUP_GROUP_SIZE ) {
+   uint32_t ui32_group_size = ui32_count - ui32_group < MAP_BATCH_LOOKUP_GROUP_SIZE ? ui32_count - ui32_group : MAP_BATCH_LOOKUP_GROUP_SIZE;
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_group_size; ui32_i ++ ) {
+     lpary_key_references [ ui32_i ] = (const char *) &lpary_keys [ ui32_group + ui32_i ];
+   }
+
+   ui32_found += find_map_nodes_data ( lpm_map, lpary_key_references, ui32_group_size, lpary_data + ui32_group );
+ }
+
+ return ui32_found;
+}}
+
+/*
+ The ordered index is a skip list of the map's nodes, sorted by key (with strcmp).
+ Each node gets a tower of 1 to MAP_ORDERED_INDEX_MAXIMUM_LEVEL forward links;
+ each level is about a quarter as full as the one below it, so finding a key,
+ adding it, or removing it takes O(log n) steps on average.
+*/
+ struct MAP_ORDERED_TOWER {
+   DOUBLY_LINKED_LIST *lp_node; //0 for the head of the list.
+   struct MAP_ORDERED_TOWER *lpary_next [  ]; //One forward link per level of this tower.
+ };
+
+ struct MAP_ORDERED_INDEX {
+   struct MAP_ORDERED_TOWER *lp_head; //Has MAP_ORDERED_INDEX_MAXIMUM_LEVEL levels and no node.
+   uint32_t ui32_levels; //How many levels are in use (at least 1).
+   uint64_t ui64_random_state; //Chooses the height of each new tower.
+ };
+
+ static struct MAP_ORDERED_TOWER *new_map_ordered_tower ( DOUBLY_LINKED_LIST *lp_node, uint32_t ui32_levels )
+{{
+ struct MAP_ORDERED_TOWER *lp_tower = (struct MAP_ORDERED_TOWER *) calloc (
+   1,
+   sizeof ( struct MAP_ORDERED_TOWER ) + ui32_levels * sizeof ( struct MAP_ORDERED_TOWER * )
+ );
+ if ( lp_tower ) {
+   lp_tower ->lp_node = lp_node;
+ }
+
+ return lp_tower;
+}}
+
+/*
+ This will fill lpary_update [ L ] with the last tower on each level L whose key is
+ less than lpsz_key, and return the tower after the one on the lowest level (the first
+ whose key is greater than or equal to lpsz_key), or 0, if there isn't one.
+ lpary_update can be 0, if the caller doesn't need it.
+*/
+ static struct MAP_ORDERED_TOWER *find_map_ordered_tower (
+   struct MAP_ORDERED_INDEX *lp_index,
+   const char *lpsz_key,
+   struct MAP_ORDERED_TOWER **lpary_update
+ )
+{{
+ struct MAP_ORDERED_TOWER *lp_tower = lp_index ->lp_head;
+
+ for ( uint32_t ui32_level = lp_index ->ui32_levels; ui32_level --; ) {
+   while ( lp_tower ->lpary_next [ ui32_level ] &&
+           strcmp ( lp_tower ->lpary_next [ ui32_level ] ->lp_node ->lpsz_key, lpsz_key ) < 0
+         ) {
+     lp_tower = lp_tower ->lpary_next [ ui32_level ];
+   }
+
+   if ( lpary_update ) {
+     lpary_update [ ui32_level ] = lp_tower;
+   }
+ }
+
+ return lp_tower ->lpary_next [ 0 ];
+}}
+
+ //This will link a node that was just added to the map into the ordered index. Returns 0, if memory couldn't be allocated.
+ static uint8_t insert_map_ordered_node ( struct MAP_ORDERED_INDEX *lp_index, DOUBLY_LINKED_LIST *lp_node )
+{{
+ struct MAP_ORDERED_TOWER *lpary_update [ MAP_ORDERED_INDEX_MAXIMUM_LEVEL ];
+ find_map_ordered_tower ( lp_index, lp_node ->lpsz_key, lpary_update );
+
+ //Each additional level is kept with a probability of one in four.
+ uint64_t x = lp_index ->ui64_random_state;
+ x ^= x << 13;
+ x ^= x >> 7;
+ x ^= x << 17;
+ lp_index ->ui64_random_state = x;
+
+ uint32_t ui32_levels = 1;
+ while ( ui32_levels < MAP_ORDERED_INDEX_MAXIMUM_LEVEL && ! (x & 3) ) {
+   ui32_levels ++;
+   x >>= 2;
+ }
+
+ struct MAP_ORDERED_TOWER *lp_tower = new_map_ordered_tower ( lp_node, ui32_levels );
+ if ( ! lp_tower ) {
+   return 0;
+ }
+
+ //Any levels that weren't in use, yet, start from the head.
+ for ( ; lp_index ->ui32_levels < ui32_levels; lp_index ->ui32_levels ++ ) {
+   lpary_update [ lp_index ->ui32_levels ] = lp_index ->lp_head;
+ }
+
+ for ( uint32_t ui32_level = 0; ui32_level < ui32_levels; ui32_level ++ ) {
+   lp_tower ->lpary_next [ ui32_level ] = lpary_update [ ui32_level ] ->lpary_next [ ui32_level ];
+   lpary_update [ ui32_level ] ->lpary_next [ ui32_level ] = lp_tower;
+ }
+
+ return 1;
+}}
+
+ //This will unlink the node with the specified key from the ordered index and free its tower.
+ static void remove_map_ordered_node ( struct MAP_ORDERED_INDEX *lp_index, const char *lpsz_key )
+{{
+ struct MAP_ORDERED_TOWER *lpary_update [ MAP_ORDERED_INDEX_MAXIMUM_LEVEL ];
+ struct MAP_ORDERED_TOWER *lp_tower = find_map_ordered_tower ( lp_index, lpsz_key, lpary_update );
+ if ( ! lp_tower || strcmp ( lp_tower ->lp_node ->lpsz_key, lpsz_key ) ) {
+   return ;
+ }
+
+ //The tower is linked in on every level, from the bottom, until its height is reached.
+ for ( uint32_t ui32_level = 0; ui32_level < lp_index ->ui32_levels; ui32_level ++ ) {
+   if ( lpary_update [ ui32_level ] ->lpary_next [ ui32_level ] != lp_tower ) {
+     break;
+   }
+   lpary_update [ ui32_level ] ->lpary_next [ ui32_level ] = lp_tower ->lpary_next [ ui32_level ];
+ }
+
+ while ( lp_index ->ui32_levels > 1 && ! lp_index ->lp_head ->lpary_next [ lp_index ->ui32_levels - 1 ] ) {
+   lp_index ->ui32_levels --;
+ }
+
+ free ( lp_tower );
+}}
+
+ static void free_map_ordered_index ( struct MAP_ORDERED_INDEX *lp_index )
+{{
+ struct MAP_ORDERED_TOWER *lp_tower = lp_index ->lp_head;
+ while ( lp_tower ) {
+   struct MAP_ORDERED_TOWER *lp_next = lp_tower ->lpary_next [ 0 ];
+   free ( lp_tower );
+   lp_tower = lp_next;
+ }
+
+ free ( lp_index );
+}}
+
+/*
+ This will start keeping the map's keys in sorted order (and sort the keys that are
+ already in it), so that find_map_lower_bound, begin_map_range, and begin_map_prefix
+ can be used. From then on, set_map_node__internal and free_map_node keep it up to date.
+ Returns 0, if memory couldn't be allocated or the keys aren't strings; 1, if the index exists.
+*/
+ uint8_t enable_map_ordered_index ( MAP *lpm_map )
+{{
+ if ( ! lpm_map || lpm_map ->ui32_key_size ) {
+   return 0;
+ }
+ if ( lpm_map ->lp_ordered_index ) {
+   return 1;
+ }
+
+ struct MAP_ORDERED_INDEX *lp_index = (struct MAP_ORDERED_INDEX *) calloc ( 1, sizeof ( struct MAP_ORDERED_INDEX ) );
+ if ( ! lp_index ) {
+   return 0;
+ }
+ lp_index ->ui32_levels = 1;
+ lp_index ->ui64_random_state = 0x9e3779b97f4a7c15ULL;
+ if ( ! (lp_index ->lp_head = new_map_ordered_tower ( 0, MAP_ORDERED_INDEX_MAXIMUM_LEVEL )) ) {
+   free ( lp_index );
+   return 0;
+ }
+
+ for ( DOUBLY_LINKED_LIST *node = lpm_map ->lp_first_node; node; node = node ->lp_next ) {
+   if ( ! insert_map_ordered_node ( lp_index, node ) ) {
+     free_map_ordered_index ( lp_index );
+     return 0;
+   }
+ }
+
+ map_trace_printf (
+   1,
+   "enable_map_ordered_index: Sorted %" PRIu32 " keys.\n",
+   lpm_map ->ui32_count
  );
+
+ lpm_map ->lp_ordered_index = lp_index;
+
+ return 1;
+}}
+
+ //This will stop keeping the map's keys in sorted order and free the ordered index.
+ void disable_map_ordered_index ( MAP *lpm_map )
+{{
+ if ( ! lpm_map || ! lpm_map ->lp_ordered_index ) {
+   return ;
+ }
+
+ free_map_ordered_index ( lpm_map ->lp_ordered_index );
+ lpm_map ->lp_ordered_index = 0;
+}}
+
+/*
+ This will return the node with the smallest key that's greater than or equal to lpsz_key,
+ or 0, if there isn't one or the map has no ordered index (see enable_map_ordered_index).
+*/
+ DOUBLY_LINKED_LIST *find_map_lower_bound ( MAP *lpm_map, const char *lpsz_key )
+{{
+ if ( ! lpm_map || ! lpm_map ->lp_ordered_index || ! lpsz_key ) {
+   return 0;
+ }
+
+ struct MAP_ORDERED_TOWER *lp_tower = find_map_ordered_tower ( lpm_map ->lp_ordered_index, lpsz_key, 0 );
+
+ return lp_tower ? lp_tower ->lp_node : 0;
+}}
+
+/*
+ This will point the iterator at the first key that's greater than or equal to lpsz_first
+ (or the smallest key, if it's 0); next_map_ordered_node will then return every key in
+ order until it reaches one that's greater than or equal to lpsz_last (or the end of the
+ map, if it's 0). So, begin_map_range ( &map, &iterator, 0, 0 ) iterates over every key.
+ The map must not be changed while the iterator is in use, and lpsz_last must stay valid.
+ Returns 0, if the map has no ordered index.
+*/
+ uint8_t begin_map_range (
+   MAP *lpm_map,
+   MAP_ORDERED_ITERATOR *lp_iterator,
+   const char *lpsz_first,
+   const char *lpsz_last
+ )
+{{
+ if ( ! lpm_map || ! lp_iterator ) {
+   return 0;
+ }
+
+ memset ( lp_iterator, 0, sizeof ( MAP_ORDERED_ITERATOR ) );
+ if ( ! lpm_map ->lp_ordered_index ) {
+   return 0;
+ }
+
+ lp_iterator ->lp_tower = lpsz_first ?
+                          find_map_ordered_tower ( lpm_map ->lp_ordered_index, lpsz_first, 0 ) :
+                          lpm_map ->lp_ordered_index ->lp_head ->lpary_next [ 0 ];
+ lp_iterator ->lpsz_last = lpsz_last;
+
+ return 1;
+}}
+
+/*
+ This will point the iterator at the first key that starts with lpsz_prefix;
+ next_map_ordered_node will then return every key that starts with it, in order.
+ (e.g. begin_map_prefix ( &map, &iterator, "order:2024-" ))
+ The map must not be changed while the iterator is in use, and lpsz_prefix must stay valid.
+ Returns 0, if the map has no ordered index.
+*/
+ uint8_t begin_map_prefix ( MAP *lpm_map, MAP_ORDERED_ITERATOR *lp_iterator, const char *lpsz_prefix )
+{{
+ if ( ! lpsz_prefix || ! begin_map_range ( lpm_map, lp_iterator, lpsz_prefix, 0 ) ) {
+   return 0;
+ }
+
+ lp_iterator ->lpsz_prefix = lpsz_prefix;
+ lp_iterator ->st_prefix_length = strlen ( lpsz_prefix );
+
+ return 1;
+}}
+
+//This will return the iterator's next node in key order, or 0, once the end of its range has been reached.
+ DOUBLY_LINKED_LIST *next_map_ordered_node ( MAP_ORDERED_ITERATOR *lp_iterator )
+{{
+ if ( ! lp_iterator || ! lp_iterator ->lp_tower ) {
+   return 0;
+ }
+
+ DOUBLY_LINKED_LIST *lp_node = lp_iterator ->lp_tower ->lp_node;
+ if ( (lp_iterator ->lpsz_last && strcmp ( lp_node ->lpsz_key, lp_iterator ->lpsz_last ) >= 0) ||
+      (lp_iterator ->lpsz_prefix && strncmp ( lp_node ->lpsz_key, lp_iterator ->lpsz_prefix, lp_iterator ->st_prefix_length ))
+    ) {
+   lp_iterator ->lp_tower = 0;
+   return 0;
+ }
+
+ lp_iterator ->lp_tower = lp_iterator ->lp_tower ->lpary_next [ 0 ];
+
+ return lp_node;
+}}
+
+//The map owns each node's user-data block (whether it copied it or was handed it),
+//so this calls the user-defined free function on it and then frees the block itself,
+//if it isn't stored inside of the node.
+ static void free_doubly_linked_list_node_data ( MAP *lpm_map, DOUBLY_LINKED_LIST *lp_doubly_linked_list_node )
+{{
+ lpm_map ->lpfn_free ( lp_doubly_linked_list_node ->lpv_data );
+
+ if ( lp_doubly_linked_list_node ->lpv_data != MAP_NODE_INLINE_DATA ( lp_doubly_linked_list_node ) ) {
+   free ( lp_doubly_linked_list_node ->lpv_data );
+ }
+}}
+
+/*
+ This will remove the node (which is in the specified slot) from the table, the ordered
+ index, the insertion-order list, and the reference array, and then free it.
+*/
+ static void remove_map_node ( MAP *lpm_map, uint32_t ui32_slot, DOUBLY_LINKED_LIST *node )
+{{
+ remove_map_slot ( lpm_map, ui32_slot );
+ if ( lpm_map ->lp_ordered_index ) {
+   remove_map_ordered_node ( lpm_map ->lp_ordered_index, node ->lpsz_key );
+ }
+
+ //Keep the nodes around the node we're deleting, if they exist.
+ if ( node ->lp_prev ) {
+   node ->lp_prev ->lp_next = node ->lp_next;
+ }
+ //This was the first node of the list.
+ else {
+   lpm_map ->lp_first_node = node ->lp_next;
+ }
+
+ if ( node ->lp_next ) {
+   node ->lp_next ->lp_prev = node ->lp_prev;
+ }
+ //Otherwise, this is the last node in the list.
+ else {
+   lpm_map ->lp_last_node = node ->lp_prev;
+ }
+
+ //The node knows where it's referenced, so we just leave a tombstone there rather than
+ //searching for it and moving every reference after it down by one.
+ lpm_map ->lpary_doubly_linked_list [ node ->ui32_index ] = (DOUBLY_LINKED_LIST *) 0;
+ lpm_map ->ui32_count --; //Update the count for the entire map.
+
+ //Once half of the references are tombstones, squeeze them out. Every compaction is paid
+ //for by the deletions that made it necessary, so deleting is still O(1) on average.
+ if ( (lpm_map ->ui32_index_length - lpm_map ->ui32_count) << 1 >= lpm_map ->ui32_index_length ) {
+   compact_map_index ( lpm_map );
+ }
+
+ map_trace_printf (
+   2,
+   "Calling the user-defined free function and freeing the DOUBLY_LINKED_LIST node.\n"
+ );
+ free_doubly_linked_list_node_data ( lpm_map, node );
+ release_map_node ( lpm_map, node );
+}}
+
+/*
+ This will mark the node as just used. With MAP_CACHE_LRU, it's moved to the end of the
+ insertion-order list (and reference array), so lp_first_node is always the least recently
+ used; with MAP_CACHE_CLOCK, its referenced flag is set, which is a single store.
+*/
+ static void touch_map_cache_node ( MAP *lpm_map, DOUBLY_LINKED_LIST *node )
+{{
+ if ( lpm_map ->ui8_cache_policy == MAP_CACHE_CLOCK ) {
+   lpm_map ->lpary_cache_referenced [ node ->ui32_index ] = 1;
+   return ;
+ }
+
+ //It's already the most recently used.
+ if ( node == lpm_map ->lp_last_node ) {
+   return ;
+ }
+
+ //Unlink the node (it isn't the last, so it has a next node) and link it in at the end.
+ if ( node ->lp_prev ) {
+   node ->lp_prev ->lp_next = node ->lp_next;
+ }
+ else {
+   lpm_map ->lp_first_node = node ->lp_next;
+ }
+ node ->lp_next ->lp_prev = node ->lp_prev;
+
+ node ->lp_prev = lpm_map ->lp_last_node;
+ node ->lp_next = 0;
+ lpm_map ->lp_last_node ->lp_next = node;
+ lpm_map ->lp_last_node = node;
+
+ //Move its reference to the end of the array the same way: a tombstone where it was and a new
+ //reference at the end. If the array can't grow, compacting it puts the node at the end, too.
+ lpm_map ->lpary_doubly_linked_list [ node ->ui32_index ] = (DOUBLY_LINKED_LIST *) 0;
+ if ( lpm_map ->ui32_index_length == lpm_map ->ui32_index_capacity &&
+      ! reserve_map_index ( lpm_map, lpm_map ->ui32_index_capacity << 1 )
+    ) {
+   compact_map_index ( lpm_map );
+   return ;
+ }
+
+ node ->ui32_index = lpm_map ->ui32_index_length;
+ lpm_map ->lpary_doubly_linked_list [ lpm_map ->ui32_index_length ++ ] = node;
+
+ if ( (lpm_map ->ui32_index_length - lpm_map ->ui32_count) << 1 >= lpm_map ->ui32_index_length ) {
+   compact_map_index ( lpm_map );
+ }
+}}
+
+/*
+ This will remove one node from a full cache, calling the user-defined free function on it.
+ MAP_CACHE_LRU evicts the least recently used node. MAP_CACHE_CLOCK sweeps the reference
+ array from where it left off, clearing referenced flags, and evicts the first node that
+ hasn't been used since the last sweep passed it.
+*/
+ static void evict_map_cache_node ( MAP *lpm_map )
+{{
+ DOUBLY_LINKED_LIST *lp_victim = lpm_map ->lp_first_node;
+ if ( ! lp_victim ) {
+   return ;
+ }
+
+ if ( lpm_map ->ui8_cache_policy == MAP_CACHE_CLOCK ) {
+   //Every flag that's passed is cleared, so this finds a node within two sweeps.
+   for ( ;; ) {
+     if ( lpm_map ->ui32_cache_hand >= lpm_map ->ui32_index_length ) {
+       lpm_map ->ui32_cache_hand = 0;
+     }
+
+     uint32_t ui32_hand = lpm_map ->ui32_cache_hand ++;
+     lp_victim = lpm_map ->lpary_doubly_linked_list [ ui32_hand ];
+     if ( ! lp_victim ) {
+       continue;
+     }
+     if ( ! lpm_map ->lpary_cache_referenced [ ui32_hand ] ) {
+       break;
+     }
+     lpm_map ->lpary_cache_referenced [ ui32_hand ] = 0;
+   }
+ }
+
+ map_trace_printf (
+   2,
+   "evict_map_cache_node: Evicting \"%s\".\n",
+   MAP_TRACE_KEY ( lpm_map, lp_victim ->lpsz_key )
+ );
+
+ //Find the victim's slot by following its probe sequence until we reach it.
+ uint32_t ui32_mask = lpm_map ->ui32_slot_count - 1;
+ uint32_t ui32_slot = (uint32_t) lp_victim ->ui64_hash & ui32_mask;
+ while ( lpm_map ->lpary_slots [ ui32_slot ] .lp_node != lp_victim ) {
+   ui32_slot = (ui32_slot + 1) & ui32_mask;
+ }
+
+ remove_map_node ( lpm_map, ui32_slot, lp_victim );
+ lpm_map ->cache_statistics .ui64_evictions ++;
+}}
+
+/*
+ This will turn the map into a cache that holds at most ui32_capacity keys: adding a key
+ to a full cache evicts another first (see evict_map_cache_node). ui8_policy is either
+ MAP_CACHE_LRU or MAP_CACHE_CLOCK. Every lookup counts as a use of the key it finds, and
+ the hits, misses, and evictions are counted (see get_map_cache_statistics).
+ With MAP_CACHE_LRU, MAP_DATA_AT and MAP_KEY_AT go from least to most recently used.
+ If the map holds more keys than ui32_capacity, the extra keys are evicted right away.
+ A capacity of 0 turns the cache back into a normal map.
+ Returns 0, if the policy isn't valid or memory couldn't be allocated.
+*/
+ uint8_t enable_map_cache ( MAP *lpm_map, uint32_t ui32_capacity, uint8_t ui8_policy )
+{{
+ if ( ! lpm_map ) {
+   return 0;
+ }
+
+ if ( ! ui32_capacity ) {
+   free ( lpm_map ->lpary_cache_referenced );
+   lpm_map ->lpary_cache_referenced = 0;
+   lpm_map ->ui32_cache_capacity = 0;
+   lpm_map ->ui8_cache_policy = 0;
+   lpm_map ->ui32_cache_hand = 0;
+   return 1;
+ }
+
+ if ( ui8_policy != MAP_CACHE_LRU && ui8_policy != MAP_CACHE_CLOCK ) {
+   return 0;
+ }
+
+ //CLOCK keeps a referenced flag for every position in the reference array.
+ if ( ui8_policy == MAP_CACHE_CLOCK ) {
+   uint8_t *lpary_referenced = (uint8_t *) realloc ( lpm_map ->lpary_cache_referenced, lpm_map ->ui32_index_capacity + 1 );
+   if ( ! lpary_referenced ) {
+     return 0;
+   }
+   memset ( lpary_referenced, 0, lpm_map ->ui32_index_capacity + 1 );
+   lpm_map ->lpary_cache_referenced = lpary_referenced;
+ }
+ else {
+   free ( lpm_map ->lpary_cache_referenced );
+   lpm_map ->lpary_cache_referenced = 0;
+ }
+
+ lpm_map ->ui32_cache_capacity = ui32_capacity;
+ lpm_map ->ui8_cache_policy = ui8_policy;
+ lpm_map ->ui32_cache_hand = 0;
+
+ while ( lpm_map ->ui32_count > ui32_capacity ) {
+   evict_map_cache_node ( lpm_map );
+ }
+
+ return 1;
+}}
+
+//This will copy the cache's hit, miss, and eviction counters into the passed structure.
+ uint8_t get_map_cache_statistics ( MAP *lpm_map, MAP_CACHE_STATISTICS *lp_statistics )
+{{
+ if ( ! lpm_map || ! lp_statistics ) {
+   return 0;
+ }
+
+ *lp_statistics = lpm_map ->cache_statistics;
+
+ return 1;
 }}
 
 /*
@@ -265,19 +1300,7 @@
  one (DOUBLY_LINKED_LIST*).
  2.) The new reference would need to be placed at the first reference
  of that list of refernces. (lpm_map ->lpary_doubly_linked_list)
-
- Note: The usage of the user-defined functions could allow for
- sorted nodes within the tranches and allow for quicker lookup.
- I'd use a hash of the value to insert/find vs the hashes of the
- first and last nodes in the automatically sorted tranche and
- start from whichever end is closest.
- I could further subdivde this by assuming that some ratio from
- the middle is correct (assuming equal distribution of key values
- which is undoubtedly incorrect in real-world cases) and have another
- array of references specific to each tranche. That is a bit overkill,
- however. An unordered linked list of nodes within each of the tranches
- is fine, since one can iterate from 0 ->n with the main reference array
- without issue.
+ 3.) The new node would need to be linked in before lp_first_node.
 */
  uint8_t set_map_node__internal (
    MAP *lpm_map,
@@ -295,7 +1318,7 @@
    return 0;
  }
  //If an empty string was passed for the key, fail.
- if ( ! *lpsz_key ) {
+ if ( ! lpm_map ->ui32_key_size && ! *lpsz_key ) {
    return 0;
  }
  //If we have no way of sorting the list, just fail.
@@ -306,32 +1329,54 @@
  if ( ! lpm_map ->lpfn_free ) {
    return 0;
  }
+ uint64_t ui64_hash = hash_map_key ( lpm_map, lpsz_key );
+
+ //The table isn't allocated until the first node is added to the map.
+ if ( ! lpm_map ->lpary_slots && ! grow_map_slots ( lpm_map ) ) {
+   return 0;
+ }
+
+ uint32_t ui32_slot = find_map_slot ( lpm_map, lpsz_key, ui64_hash );
 
  //If the key already exists, just update it.
- void *lpv_preexisting_doubly_linked_list_node_data;
- if ( lpv_preexisting_doubly_linked_list_node_data = find_map_node_data ( lpm_map, lpsz_key ) ) {
+ DOUBLY_LINKED_LIST *lp_preexisting_doubly_linked_list_node = lpm_map ->lpary_slots [ ui32_slot ] .lp_node;
+ if ( lp_preexisting_doubly_linked_list_node ) {
+   if ( lpm_map ->ui32_cache_capacity ) {
+     touch_map_cache_node ( lpm_map, lp_preexisting_doubly_linked_list_node );
+   }
 
-   fprintf (
-     stdout,
+   map_trace_printf (
+     2,
      "set_map_node__internal: Freeing the user-defined data with the user-supplied callback function.\n"
    );
 
    //Call the user-defined free function on the user-data stored within the pre-existing
    //structure in the node that we've found.
-   lpm_map ->lpfn_free ( lpv_preexisting_doubly_linked_list_node_data );
+   lpm_map ->lpfn_free ( lp_preexisting_doubly_linked_list_node ->lpv_data );
+
+   //If we've been handed a block to keep, it replaces the old block entirely.
+   //(The old block is only freed if it isn't stored inside of the node itself.)
+   if ( b_assign_data_instead_of_allocating_and_copying ) {
+     if ( lp_preexisting_doubly_linked_list_node ->lpv_data != MAP_NODE_INLINE_DATA ( lp_preexisting_doubly_linked_list_node ) ) {
+       free ( lp_preexisting_doubly_linked_list_node ->lpv_data );
+     }
+     lp_preexisting_doubly_linked_list_node ->lpv_data = lpv_data;
 
-   fprintf (
-     stdout,
+     return 1;
+   }
+
+   map_trace_printf (
+     2,
      "set_map_node__internal: Overwriting %" PRIu32 " bytes of user-data with the newly supplied" \
      " user-data @ %p for this key @ %p.\n",
      lpm_map ->ui32_data_size,
      lpv_data,
-     lpv_preexisting_doubly_linked_list_node_data
+     lp_preexisting_doubly_linked_list_node ->lpv_data
    );
 
    //We can safely assume that the user-data is of the same size and copy it in.
    memcpy (
-     lpv_preexisting_doubly_linked_list_node_data,
+     lp_preexisting_doubly_linked_list_node ->lpv_data,
      lpv_data,
      lpm_map ->ui32_data_size
    );
@@ -340,37 +1385,36 @@
    return 1;
  }
 
- fprintf (
-   stdout,
-   "set_map_node__internal: Getting the tranche identifier.\n"
- );
+ //If the map is a full cache, make room first. Evicting can move other nodes into
+ //the slot that we found, so we have to look for it again.
+ if ( lpm_map ->ui32_cache_capacity && lpm_map ->ui32_count >= lpm_map ->ui32_cache_capacity ) {
+   evict_map_cache_node ( lpm_map );
+   ui32_slot = find_map_slot ( lpm_map, lpsz_key, ui64_hash );
+ }
 
- //Store the first two characters of the key in a variable
- //to use as a tranche identifier. If the key contains only
- //a single character, that's fine because there will be a
- //terminating byte equal to zero at the end.
- unsigned short us_tranche_identifier = 0;
- memcpy ( &us_tranche_identifier, lpsz_key, 2 );
+ //If adding this node would make the table too full, grow it first and find the
+ //empty slot for this key in the new table.
+ if ( (uint64_t) (lpm_map ->ui32_count + 1) * MAP_MAXIMUM_LOAD_DENOMINATOR >
+      (uint64_t) lpm_map ->ui32_slot_count * MAP_MAXIMUM_LOAD_NUMERATOR
+    ) {
+   if ( ! grow_map_slots ( lpm_map ) ) {
+     return 0;
+   }
 
-/*
- DOUBLY_LINKED_LIST *lp_search_doubly_linked_list_node = lpm_map ->tranches [ us_tranche_identifier ] .lp_first_node;
- while ( lp_search_doubly_linked_list_node ->lp_next ) {
-   lp_search_doubly_linked_list_node = lp_search_doubly_linked_list_node ->lp_next;
+   ui32_slot = find_map_slot ( lpm_map, lpsz_key, ui64_hash );
  }
-*/
 
- DOUBLY_LINKED_LIST *lp_search_doubly_linked_list_node = lpm_map ->tranches [ us_tranche_identifier ] .lp_last_node;
-
- fprintf (
-   stdout,
-   "set_map_node__internal: Creating a new doubly-linked-list node in tranche #%" PRIu32 ".\n",
-   us_tranche_identifier
+ map_trace_printf (
+   2,
+   "set_map_node__internal: Creating a new doubly-linked-list node in slot #%" PRIu32 ".\n",
+   ui32_slot
  );
  DOUBLY_LINKED_LIST *lp_new_doubly_linked_list_node = new_doubly_linked_list_node (
+   lpm_map,
    lpsz_key,
+   ui64_hash,
    lpv_data,
-   lpm_map ->ui32_data_size,
-   lp_search_doubly_linked_list_node, //This is the previous node.
+   lpm_map ->lp_last_node, //This is the previous node.
    0, //This is the last node in the list, so there's nothing after.
    b_assign_data_instead_of_allocating_and_copying
  );
@@ -380,108 +1424,57 @@
    return 0;
  }
 
- fprintf (
-   stdout,
-   "set_map_node__internal: Attaching the new node to the end of the list.\n"
- );
-
- //If there is at least one node in the list, already.
- if ( lp_search_doubly_linked_list_node ) {
-   fprintf (
-     stdout,
-     "set_map_node__internal: Attatching this to the end of an existing tranche.\n"
-   );
-
-   lp_search_doubly_linked_list_node ->lp_next = lp_new_doubly_linked_list_node;
-
-   //Update the list-end pointer to be this newly added node.
-   lpm_map ->tranches [ us_tranche_identifier ] .lp_last_node = lp_new_doubly_linked_list_node;
- }
- //Otherwise, this is the only node in the list,
- //so it's both the first and last node that we need to reference in the tranche.
- else {
-   fprintf (
-     stdout,
-     "set_map_node__internal: Assigning this new node as the first and last node of a previously empty tranche.\n"
-   );
-   lpm_map ->tranches [ us_tranche_identifier ] .lp_first_node = lp_new_doubly_linked_list_node;
-   lpm_map ->tranches [ us_tranche_identifier ] .lp_last_node = lp_new_doubly_linked_list_node;
+ //If the keys are being kept in order, add this one to the ordered index.
+ if ( lpm_map ->lp_ordered_index && ! insert_map_ordered_node ( lpm_map ->lp_ordered_index, lp_new_doubly_linked_list_node ) ) {
+   release_map_node ( lpm_map, lp_new_doubly_linked_list_node );
+   return 0;
  }
 
- //Update the count within the tranche.
- lpm_map ->tranches [ us_tranche_identifier ] .ui32_count ++;
+ //If the reference array is full, double its capacity. Growing geometrically means
+ //that bulk loads copy each reference a constant number of times on average.
+ if ( lpm_map ->ui32_index_length == lpm_map ->ui32_index_capacity ) {
+   uint32_t ui32_new_capacity = lpm_map ->ui32_index_capacity ?
+                                lpm_map ->ui32_index_capacity << 1 :
+                                MAP_INITIAL_INDEX_CAPACITY;
+
+   //If we couldn't create or extend the reference array to add the new
+   //node reference to it, fail.
+   if ( ! reserve_map_index ( lpm_map, ui32_new_capacity ) ) {
+     if ( lpm_map ->lp_ordered_index ) {
+       remove_map_ordered_node ( lpm_map ->lp_ordered_index, lpsz_key );
+     }
+     release_map_node ( lpm_map, lp_new_doubly_linked_list_node );
+     return 0;
+   }
+ }
 
- fprintf (
-   stdout,
-   "Creating or expanding the reference array buffer.\n"
+ map_trace_printf (
+   2,
+   "set_map_node__internal: Storing the new reference at the end of the reference array (zero-based offset #%" PRIu32 ").\n",
+   lpm_map ->ui32_index_length
  );
 
- void *lpv_new_node_reference_array;
-
- //If there's no reference array allocated, yet, make a new one.
- if ( ! lpm_map ->lpary_doubly_linked_list ) {
-   fprintf (
-     stdout,
-     "Creating a new reference array.\n"
-   );
-   lpv_new_node_reference_array = malloc (
-     (++ lpm_map ->ui32_count) * sizeof ( DOUBLY_LINKED_LIST **)
-   );
-
+ lp_new_doubly_linked_list_node ->ui32_index = lpm_map ->ui32_index_length;
+ if ( lpm_map ->lpary_cache_referenced ) {
+   lpm_map ->lpary_cache_referenced [ lpm_map ->ui32_index_length ] = 0;
  }
- //Otherwise, simply expand the existing one to hold the new node.
- else {
-
-   fprintf (
-     stdout,
-     "Expanding an existing reference array.\n"
-   );
-
-   //Update the overall map count and expand the node reference array.
-   lpv_new_node_reference_array = realloc (
-     (void *) lpm_map ->lpary_doubly_linked_list,
-     (++ lpm_map ->ui32_count) * sizeof ( DOUBLY_LINKED_LIST **)
-   );
+ lpm_map ->lpary_doubly_linked_list [
+   lpm_map ->ui32_index_length ++
+ ] = lp_new_doubly_linked_list_node;
+ lpm_map ->ui32_count ++;
 
-   fprintf (
-     stdout,
-     "The reference array has been expanded via realloc.\n"
-   );
+ //Claim the empty slot at which the probe ended.
+ lpm_map ->lpary_slots [ ui32_slot ] .ui64_hash = ui64_hash;
+ lpm_map ->lpary_slots [ ui32_slot ] .lp_node = lp_new_doubly_linked_list_node;
 
+ //Attach the new node to the end of the insertion-order list.
+ if ( lpm_map ->lp_last_node ) {
+   lpm_map ->lp_last_node ->lp_next = lp_new_doubly_linked_list_node;
  }
-
- //If we couldn't create or extend the reference array to add the new
- //node reference to it, fail.
- if ( ! lpv_new_node_reference_array ) {
-   return 0;
+ else {
+   lpm_map ->lp_first_node = lp_new_doubly_linked_list_node;
  }
-
-/*
- //Copy all of the existing node references to the new array that has one
- //more empty slot. (Not needed for realloc -- just malloc/free method.)
- memcpy (
-   lpv_new_node_reference_array,
-   lpm_map ->lpary_doubly_linked_list,
-   sizeof(DOUBLY_LINKED_LIST**) * (lpm_map ->ui32_count - 1)
- );
-*/
-
- fprintf (
-   stdout,
-   "set_map_node__internal: Storing the newly re/allocated node reference array address in the map.\n"
- );
-
- lpm_map ->lpary_doubly_linked_list = (DOUBLY_LINKED_LIST **) lpv_new_node_reference_array;
-
- fprintf (
-   stdout,
-   "set_map_node__internal: Storing the new reference at the end of the reference array (zero-based offset #%" PRIu32 ").\n",
-   lpm_map ->ui32_count - 1
- );
-
- lpm_map ->lpary_doubly_linked_list [
-   lpm_map ->ui32_count - 1
- ] = lp_new_doubly_linked_list_node;
+ lpm_map ->lp_last_node = lp_new_doubly_linked_list_node;
 
  return 1;
 }}
@@ -522,12 +1515,200 @@
    return 0;
  }
 
- return set_map_node__internal (
-   lpm_map,
-   lpsz_key,
-   lpv_data,
-   1 //don't allocate memory, just assign lpv_data to the same reference.
- ) ? lpv_data : 0;
+ if ( ! set_map_node__internal (
+        lpm_map,
+        lpsz_key,
+        lpv_data,
+        1 //don't allocate memory, just assign lpv_data to the same reference.
+      )
+    ) {
+   free ( lpv_data );
+   return 0;
+ }
+
+ return lpv_data;
+}}
+
+/*
+ This will remove the tombstones that free_map_node leaves in the insertion-order reference
+ array, so that lpary_doubly_linked_list [ 0 ] through [ ui32_count - 1 ] are all valid again.
+ The nodes are linked in insertion order, so the array is simply rebuilt from that list.
+*/
+ void compact_map_index ( MAP *lpm_map )
+{{
+ if ( ! lpm_map ) {
+   return ;
+ }
+
+ //If there are no tombstones, there's nothing to do.
+ if ( lpm_map ->ui32_index_length == lpm_map ->ui32_count ) {
+   return ;
+ }
+
+ map_trace_printf (
+   1,
+   "compact_map_index: Removing %" PRIu32 " tombstones from the reference array.\n",
+   lpm_map ->ui32_index_length - lpm_map ->ui32_count
+ );
+
+ //A CLOCK cache's flags and hand move along with the references. (Its nodes are never
+ //reordered, so each one moves to the same or an earlier position and nothing is overwritten early.)
+ uint32_t ui32_i = 0, ui32_hand = 0;
+ for ( DOUBLY_LINKED_LIST *node = lpm_map ->lp_first_node; node; node = node ->lp_next ) {
+   if ( node ->ui32_index < lpm_map ->ui32_cache_hand ) {
+     ui32_hand ++;
+   }
+   if ( lpm_map ->lpary_cache_referenced ) {
+     lpm_map ->lpary_cache_referenced [ ui32_i ] = lpm_map ->lpary_cache_referenced [ node ->ui32_index ];
+   }
+
+   node ->ui32_index = ui32_i;
+   lpm_map ->lpary_doubly_linked_list [ ui32_i ++ ] = node;
+ }
+
+ lpm_map ->ui32_index_length = ui32_i;
+ lpm_map ->ui32_cache_hand = ui32_hand;
+ map_statistics_add ( lpm_map, ui64_index_compactions, 1 );
+}}
+
+/*
+ This will copy the map's counters into the passed structure.
+ Returns 1, if the counters are being collected (MAP_COLLECT_STATISTICS is set);
+ returns 0 and zeroes the structure, if they were compiled out.
+*/
+ uint8_t get_map_statistics ( MAP *lpm_map, MAP_STATISTICS *lp_statistics )
+{{
+ if ( ! lpm_map || ! lp_statistics ) {
+   return 0;
+ }
+
+#if ( MAP_COLLECT_STATISTICS )
+ *lp_statistics = lpm_map ->statistics;
+ return 1;
+#else
+ memset ( lp_statistics, 0, sizeof ( MAP_STATISTICS ) );
+ return 0;
+#endif
+}}
+
+//This will set all of the map's counters back to zero.
+ void reset_map_statistics ( MAP *lpm_map )
+{{
+ if ( lpm_map ) {
+   memset ( &lpm_map ->statistics, 0, sizeof ( MAP_STATISTICS ) );
+ }
+}}
+
+/*
+ This will walk the whole hash table and describe how the nodes are spread over it:
+ how far each node is from its home slot, how long the runs of occupied slots are,
+ and how full each region of MAP_OCCUPANCY_REGION_SIZE slots is. Unlike get_map_statistics,
+ this doesn't depend on MAP_COLLECT_STATISTICS, so any live map can be inspected.
+ A lookup that finds a node steps through (its displacement + 1) occupied slots, so the
+ average successful probe is ui64_displacement / ui32_used_slots + 1, and the average
+ unsuccessful probe is ui64_miss_probes / ui32_slot_count.
+*/
+ uint8_t get_map_occupancy ( MAP *lpm_map, MAP_OCCUPANCY *lp_occupancy )
+{{
+ if ( ! lpm_map || ! lp_occupancy ) {
+   return 0;
+ }
+
+ memset ( lp_occupancy, 0, sizeof ( MAP_OCCUPANCY ) );
+ lp_occupancy ->ui32_slot_count = lpm_map ->ui32_slot_count;
+ if ( ! lpm_map ->lpary_slots ) {
+   return 1;
+ }
+
+ uint32_t ui32_mask = lpm_map ->ui32_slot_count - 1;
+ uint32_t ui32_region_used = 0;
+ for ( uint32_t ui32_slot = 0; ui32_slot < lpm_map ->ui32_slot_count; ui32_slot ++ ) {
+   if ( lpm_map ->lpary_slots [ ui32_slot ] .lp_node ) {
+     uint32_t ui32_displacement = (ui32_slot - (uint32_t) lpm_map ->lpary_slots [ ui32_slot ] .ui64_hash) & ui32_mask;
+     lp_occupancy ->ui32_used_slots ++;
+     lp_occupancy ->ui64_displacement += ui32_displacement;
+     if ( lp_occupancy ->ui32_longest_displacement < ui32_displacement ) {
+       lp_occupancy ->ui32_longest_displacement = ui32_displacement;
+     }
+     lp_occupancy ->ui32_displacements [ ui32_displacement < MAP_OCCUPANCY_HISTOGRAM_SIZE ? ui32_displacement : MAP_OCCUPANCY_HISTOGRAM_SIZE - 1 ] ++;
+     ui32_region_used ++;
+   }
+
+   if ( (ui32_slot + 1) % MAP_OCCUPANCY_REGION_SIZE == 0 || ui32_slot == ui32_mask ) {
+     lp_occupancy ->ui32_regions [ ui32_region_used ] ++;
+     ui32_region_used = 0;
+   }
+ }
+
+ //Runs can wrap around the end of the table, so start counting them just after an empty slot.
+ //(There's always at least one, since the table grows before it's full.)
+ uint32_t ui32_start = 0;
+ while ( lpm_map ->lpary_slots [ ui32_start ] .lp_node ) {
+   ui32_start ++;
+ }
+
+ uint32_t ui32_run = 0;
+ for ( uint32_t ui32_i = 1; ui32_i <= lpm_map ->ui32_slot_count; ui32_i ++ ) {
+   if ( lpm_map ->lpary_slots [ (ui32_start + ui32_i) & ui32_mask ] .lp_node ) {
+     ui32_run ++;
+     continue;
+   }
+   if ( ui32_run ) {
+     //Lookups that start in a run of l slots step through l, l - 1, ..., 1 of them.
+     lp_occupancy ->ui64_miss_probes += (uint64_t) ui32_run * (ui32_run + 1) / 2;
+     lp_occupancy ->ui32_runs [ ui32_run < MAP_OCCUPANCY_HISTOGRAM_SIZE ? ui32_run : MAP_OCCUPANCY_HISTOGRAM_SIZE - 1 ] ++;
+     if ( lp_occupancy ->ui32_longest_run < ui32_run ) {
+       lp_occupancy ->ui32_longest_run = ui32_run;
+     }
+     ui32_run = 0;
+   }
+ }
+
+ return 1;
+}}
+
+/*
+ This will return the node at the specified zero-based position in insertion order,
+ or 0, if it's out of bounds. This is what MAP_DATA_AT and MAP_KEY_AT use, so any
+ tombstones are removed before the array is indexed.
+*/
+ DOUBLY_LINKED_LIST *get_map_node_at ( MAP *lpm_map, uint32_t ui32_index )
+{{
+ if ( ! lpm_map || ui32_index >= lpm_map ->ui32_count ) {
+   return 0;
+ }
+
+ if ( lpm_map ->ui32_index_length != lpm_map ->ui32_count ) {
+   compact_map_index ( lpm_map );
+ }
+
+ return lpm_map ->lpary_doubly_linked_list [ ui32_index ];
+}}
+
+/*
+ This will return how many bytes the map has allocated for itself: its slab pages,
+ any nodes too large for them, the hash table, and the insertion-order reference array.
+ Blocks handed to the map with SET_MAP_NODE_NO_ALLOC (or get_map_node) aren't counted.
+*/
+ size_t get_map_memory_usage ( MAP *lpm_map )
+{{
+ if ( ! lpm_map ) {
+   return 0;
+ }
+
+ return lpm_map ->st_node_memory +
+        (size_t) lpm_map ->ui32_slot_count * sizeof ( MAP_SLOT ) +
+        (size_t) lpm_map ->ui32_index_capacity * sizeof ( DOUBLY_LINKED_LIST * );
+}}
+
+ //This will free every slab page (and every node that was carved from them) at once.
+ static void free_map_slab_pages ( MAP *lpm_map )
+{{
+ while ( lpm_map ->lp_slab_page ) {
+   char *lp_previous_page = *(char **) lpm_map ->lp_slab_page;
+   free ( lpm_map ->lp_slab_page );
+   lpm_map ->lp_slab_page = lp_previous_page;
+ }
 }}
 
  uint8_t free_map ( MAP *lpm_map )
@@ -538,23 +1719,36 @@
  }
 
  //If there is no memory allocated for a list of references, then the list is empty.
+ disable_map_ordered_index ( lpm_map );
+ free ( lpm_map ->lpary_cache_referenced );
+
  if ( ! lpm_map ->lpary_doubly_linked_list ) {
+   free_map_slab_pages ( lpm_map );
+   free ( lpm_map ->lpary_slots );
    memset ( lpm_map, 0, sizeof ( MAP ) );
    return 0;
  }
 
- DOUBLY_LINKED_LIST *to_free = 0, *next = *lpm_map ->lpary_doubly_linked_list;
+ //Every node is linked together in insertion order, so we can call the user-defined free
+ //function for each of them by following lp_next. Only the nodes too large for the slab
+ //pages have to be freed one at a time.
+ DOUBLY_LINKED_LIST *to_free = 0, *next = lpm_map ->lp_first_node;
  while ( next ) {
    to_free = next;
    next = next ->lp_next;
 
-   //Call the user-defined free function for any dynamically allocated contents.
-   lpm_map ->lpfn_free ( to_free );
-
-   //Free the DOUBLY_LINKED_LIST node itself.
-   free ( to_free );
+   free_doubly_linked_list_node_data ( lpm_map, to_free );
+   if ( to_free ->ui32_node_size > MAP_SLAB_LARGEST_NODE ) {
+     free ( to_free );
+   }
  }
 
+ //Every other node goes away with the page that it was carved from.
+ free_map_slab_pages ( lpm_map );
+
+ free ( lpm_map ->lpary_doubly_linked_list );
+ free ( lpm_map ->lpary_slots );
+
  //Just in case we want to use this map variable again, we'll clear it.
  memset ( lpm_map, 0, sizeof ( MAP ) );
 
@@ -577,7 +1771,7 @@
    return 0;
  }
  //Fail if the key string is less than one character in length.
- if ( ! *lpsz_key ) {
+ if ( ! lpm_map ->ui32_key_size && ! *lpsz_key ) {
    return 0;
  }
 
@@ -586,270 +1780,90 @@
    return 0;
  }
 
- //This will return the doubly-linked-list node rather than the ->lpv_data within it.
- DOUBLY_LINKED_LIST *lp_doubly_linked_list_node = (DOUBLY_LINKED_LIST *) find_map_node ( lpm_map, lpsz_key );
- if ( ! lp_doubly_linked_list_node ) {
+ //If nothing has been added to the map, yet, there's nothing to remove.
+ if ( ! lpm_map ->lpary_slots ) {
    return 0;
  }
 
- fprintf (
-   stdout,
-   "Found the node, \"%s\" @ %p.\n",
-   lpsz_key,
-   lp_doubly_linked_list_node
- );
-
- //Get the tranche to which this key belongs.
- unsigned short us_tranche_identifier = *((unsigned short *) lpsz_key);
-
- //Decrement the count of nodes stored within this tranche.
- lpm_map ->tranches [ us_tranche_identifier ] .ui32_count --;
-
- //Keep the nodes around the node we're deleting, if they exist.
- if ( lp_doubly_linked_list_node ->lp_prev ) {
-   fprintf ( stdout, "Reassigning the previous node to point to the node after the one being freed.\n" );
-   lp_doubly_linked_list_node ->lp_prev ->lp_next = lp_doubly_linked_list_node ->lp_next;
- }
- //This was the first node of the list.
- //We need to find the tranche to which it belongs and update it to start on the next node.
- else {
-   fprintf ( stdout, "Reassigning the initial node to point to the node after the one being freed.\n" );
-
-   lpm_map ->tranches [ us_tranche_identifier ] .lp_first_node =
-     lp_doubly_linked_list_node ->lp_next;
- }
-
- if ( lp_doubly_linked_list_node ->lp_next ) {
-   fprintf ( stdout, "Reassigning the next node to point to the node before the one being freed.\n" );
-   lp_doubly_linked_list_node ->lp_next ->lp_prev = lp_doubly_linked_list_node ->lp_prev;
- }
- //Otherwise, this is the last node in the tranche and we need to update the tranche to
- //say that the last node is the node before this one, instead.
- else {
-   fprintf ( stdout, "Reassigning the final node to point to the node before the one being freed.\n" );
-   lpm_map ->tranches [ us_tranche_identifier ] .lp_last_node = lp_doubly_linked_list_node ->lp_prev;
+ uint32_t ui32_slot = find_map_slot ( lpm_map, lpsz_key, hash_map_key ( lpm_map, lpsz_key ) );
+ DOUBLY_LINKED_LIST *lp_doubly_linked_list_node = lpm_map ->lpary_slots [ ui32_slot ] .lp_node;
+ if ( ! lp_doubly_linked_list_node ) {
+   return 0;
  }
 
- fprintf (
-   stdout,
-   "Calling the user-defined free function.\n"
+ map_trace_printf (
+   2,
+   "Found the node, \"%s\" @ %p in slot #%" PRIu32 ".\n",
+   MAP_TRACE_KEY ( lpm_map, lpsz_key ),
+   lp_doubly_linked_list_node,
+   ui32_slot
  );
- lpm_map ->lpfn_free ( lp_doubly_linked_list_node ->lpv_data );
-
- fprintf (
-   stdout,
-   "Calling free on the DOUBLY_LINKED_LIST node.\n"
- );
- free ( lp_doubly_linked_list_node );
-
- //Find the reference to this DOUBLY_LINKED_LIST node in the reference array of the main map structure.
- for ( uint32_t ui32_i = 0 ; ui32_i < lpm_map ->ui32_count; ui32_i ++ ) {
 
-   fprintf (
-     stdout,
-     "%p ?= %p\n",
-     lp_doubly_linked_list_node,
-     lpm_map ->lpary_doubly_linked_list [ ui32_i ]
-   );
-
-   //If this a reference to the node that we've just deleted, remove it.
-   if ( lp_doubly_linked_list_node == lpm_map ->lpary_doubly_linked_list [ ui32_i ] ) {
-
-     //Move all of the items after this in the array of references down towards one to fill
-     //in the deleted node's slot.
-     memmove (
-       &lpm_map ->lpary_doubly_linked_list [ ui32_i ],
-       &lpm_map ->lpary_doubly_linked_list [ ui32_i + 1 ],
-       (lpm_map ->ui32_count - ui32_i)*sizeof(DOUBLY_LINKED_LIST**)
-     );
-
-     //Reference null at the end of the list for when free_map is called, at some point.
-     lpm_map ->lpary_doubly_linked_list [ lpm_map ->ui32_count - 1 ] = (DOUBLY_LINKED_LIST *) 0;
-     lpm_map ->ui32_count --; //Update the count for the entire map.
-
-     break;
-   }
- }
+ remove_map_node ( lpm_map, ui32_slot, lp_doubly_linked_list_node );
 
  return 1;
 }}
 
-
-///user-defined callbacks.
- uint8_t free_map_user_data ( void *lpv_data )
+/*
+ These are the lookup, insertion, and removal functions for maps with binary keys (see
+ initialize_binary_key_map). They pass the key along as-is: the map knows its key size.
+*/
+ void *find_map_binary_node ( MAP *lpm_map, const void *lpv_key )
 {{
- return 1; //always return successfully, since there's nothing to free.
+ return find_map_node__internal ( lpm_map, (const char *) lpv_key, 0 );
 }}
 
- int8_t compare_map_user_data ( void *lpv_data1, void *lpv_data2 )
+ void *find_map_binary_node_data ( MAP *lpm_map, const void *lpv_key )
 {{
- return 0; //All things can be considered equal, for now.
+ return find_map_node__internal ( lpm_map, (const char *) lpv_key, 1 );
 }}
 
- void *initialize_user_data ( void )
+ uint8_t set_map_binary_node__internal (
+   MAP *lpm_map,
+   const void *lpv_key,
+   void *lpv_data,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ )
 {{
- return calloc ( sizeof(int8_t), 1 );
+ return set_map_node__internal ( lpm_map, (const char *) lpv_key, lpv_data, b_assign_data_instead_of_allocating_and_copying );
 }}
 
- int main ( int argc, char **argv )
+ uint8_t free_map_binary_node ( MAP *lpm_map, const void *lpv_key )
 {{
- MAP map;
- fprintf (
-   stdout,
-   "main: Initializing the map.\n"
- );
-
- initialize_map (
-   &map, //The map that we're working with.
-   sizeof ( int8_t ), //This is the type of data with which we're working.
-   initialize_user_data, //What to return when get_map_node is called and the node doesn't exist.
-   compare_map_user_data, //reserved and unused.
-   free_map_user_data //called implicitly when free_map is invoked.
- );
-
- fprintf (
-   stdout,
-   "main: Preparing some user data.\n"
- );
-
- int8_t i8_x = 7;
-
- fprintf (
-   stdout,
-   "main: Adding the user data to the map.\n"
- );
-
- SET_MAP_NODE (
-   map,
-   "some_key",
-   i8_x
- );
-
- fprintf (
-   stdout,
-   "main: Adding another key to the map.\n"
- );
-
- i8_x = 29;
- SET_MAP_NODE (
-   map,
-   "jack",
-   i8_x
- );
-
- fprintf (
-   stdout,
-   "main: Looking for a key that won't exist, yet.\n"
- );
-
- int8_t *lpi8_x = (int8_t *) find_map_node_data (
-   &map,
-   "jacob"
- );
-
- fprintf (
-   stdout,
-   "main: We've made it out of find_map_node.\n"
- );
-
- if ( lpi8_x ) {
-   fprintf (
-     stdout,
-     "main: &map [ \"some_key\" ] = %p; its value is: %" PRIi8 "\n",
-     lpi8_x,
-     *lpi8_x
-   );
- }
- else {
-   fprintf (
-     stderr,
-     "main: Error: We were unable to find the node.\n"
-   );
- }
-
- fprintf (
-   stdout,
-   "main: Adding a third key to the map.\n"
- );
-
-
- //Should should be in the same tranche as "jack"
- SET_MAP_NODE (
-   map,
-   "jacob",
-   i8_x
- );
-
-
- //TODO: Find and display this node, again.
-
-
- fprintf (
-   stdout,
-   "main: Updating the third key.\n"
- );
-
- //Update the value to be 32.
- i8_x = 32;
- set_map_node__internal ( //using it directly for an example...
-   &map,
-   "jacob",
-   (void *) &i8_x,
-   0 //We DO want to allocate a buffer and copy the data from &i8_x into it.
- );
-
- fprintf (
-   stdout,
-   "Trying to access a key that doesn't exist with get_map_node to create a default one.\n"
- );
- int8_t *lpi8_default_node = (int8_t *) get_map_node (
-   &map,
-   "doesn't exist"
- );
- fprintf (
-   stdout,
-   "\"doesn't exist\" => %" PRIi8 " @ %p\n",
-   lpi8_default_node ? *lpi8_default_node : 0,
-   lpi8_default_node
- );
-
-
- fprintf (
-   stdout,
-   "Attempting to free a key from the map.\n"
- );
- //Freeing nodes in any position is working fine.
- free_map_node (
-   &map,
-   "jack" //"doesn't exist" //"jacob" //"jack" //"some_key"
- );
+ return free_map_node ( lpm_map, (const char *) lpv_key );
+}}
 
- fprintf (
-   stdout,
-   "main: Showing the user data.\n"
- );
+//The same for maps with 64-bit integer keys (see initialize_integer_key_map).
+ void *find_map_integer_node ( MAP *lpm_map, uint64_t ui64_key )
+{{
+ return find_map_node__internal ( lpm_map, (const char *) &ui64_key, 0 );
+}}
 
- for ( uint32_t ui32_i = 0; ui32_i < map .ui32_count; ui32_i ++ ) {
-   fprintf (
-     stdout,
-     "main: \"%s\" => \"%" PRIi8 "\"\n",
-//     *((int8_t*) map .lpary_doubly_linked_list [ ui32_i ] ->lpv_data)
-     MAP_KEY_AT ( map, ui32_i ),
-     MAP_DATA_AT ( int8_t, map, ui32_i )
-   );
- }
+ void *find_map_integer_node_data ( MAP *lpm_map, uint64_t ui64_key )
+{{
+ return find_map_node__internal ( lpm_map, (const char *) &ui64_key, 1 );
+}}
 
- fprintf (
-   stdout,
-   "main: Freeing the map.\n"
- );
+ uint8_t set_map_integer_node__internal (
+   MAP *lpm_map,
+   uint64_t ui64_key,
+   void *lpv_data,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ )
+{{
+ return set_map_node__internal ( lpm_map, (const char *) &ui64_key, lpv_data, b_assign_data_instead_of_allocating_and_copying );
+}}
 
- free_map ( &map );
+ uint8_t free_map_integer_node ( MAP *lpm_map, uint64_t ui64_key )
+{{
+ return free_map_node ( lpm_map, (const char *) &ui64_key );
+}}
 
- fprintf (
-   stdout,
-   "main: Terminating.\n"
- );
+//The key is stored right after the user-data, so it might not be aligned for a uint64_t.
+ uint64_t get_map_node_integer_key ( DOUBLY_LINKED_LIST *lp_node )
+{{
+ uint64_t ui64_key;
+ memcpy ( &ui64_key, lp_node ->lpsz_key, sizeof ( uint64_t ) );
 
- return 0;
+ return ui64_key;
 }}
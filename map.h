@@ -0,0 +1,300 @@
+/*
+ Created on 2022-04-08 by Jacob Bethany
+ Purpose: To create a generic map in C that is quick,
+ rather than based upon some kind of linear lookup.
+ Every key is hashed in full and its node is stored in an
+ open-addressed table (linear probing) that doubles in size
+ whenever it becomes more than three quarters full.
+ To allow for iterating by insertion order, a vector
+ can be exploited within the main structure of the
+ pseudo object. An optional skip list keeps the keys
+ sorted, too, for range and prefix scans, and a map
+ can be made into a bounded LRU or CLOCK cache
+ (see enable_map_cache and map_cache_benchmark.c).
+ Keys are strings, unless the map is initialized for
+ 64-bit integer or fixed-width binary keys instead.
+
+ See map.c for the implementation, map_test.c for example usage,
+ map_benchmark.c for performance measurements, and map_harness.cpp
+ for a comparison with std::unordered_map and occupancy histograms.
+*/
+#ifndef MAP_HEADER_DEFINED
+#define MAP_HEADER_DEFINED 1
+ #include "stdio.h"
+ #include "stdlib.h"
+ #include "stdint.h"
+ #include "inttypes.h"
+#ifndef _WIN32
+ #include "string.h"
+#else
+ #include "windows.h"
+ #include "conio.h"
+#endif
+
+ //Type, Map, Index
+ //Example usage: MAP_DATA_AT ( SOME_STRUCTURE, some_map, 0 ) .some_structure_member
+ //These go through get_map_node_at so that any gaps left by free_map_node are
+ //compacted away before I is used as an index.
+ #define MAP_DATA_AT(T,M,I) ( *((T*) get_map_node_at ( &M, I ) ->lpv_data) )
+ #define MAP_KEY_AT(M,I) ( get_map_node_at ( &M, I ) ->lpsz_key )
+
+ //Usage: SET_MAP_NODE ( map, "some_key", x );
+ //Usage: SET_MAP_NODE_NO_ALLOC ( map, "some_key", lp_dynamically_allocated_structure_that_can_be_freed_implicitly );
+ #define SET_MAP_NODE(M,K,V) set_map_node__internal ( &M, K, (void *) &V, 0 )
+ #define SET_MAP_NODE_NO_ALLOC(M,K,V) set_map_node__internal ( M, K, V, 1 )
+ //The same for maps with binary or integer keys (see initialize_binary_key_map).
+ #define SET_MAP_BINARY_NODE(M,K,V) set_map_binary_node__internal ( &M, K, (void *) &V, 0 )
+ #define SET_MAP_INTEGER_NODE(M,K,V) set_map_integer_node__internal ( &M, K, (void *) &V, 0 )
+ #define MAP_INTEGER_KEY_AT(M,I) ( get_map_node_integer_key ( get_map_node_at ( &M, I ) ) )
+
+ //Tracing is compiled out entirely unless this is raised (e.g. gcc -DMAP_TRACE_LEVEL=2 ...).
+ //1 = table growth, reallocation, and compaction; 2 = every lookup and key comparison, too.
+#ifndef MAP_TRACE_LEVEL
+ #define MAP_TRACE_LEVEL 0
+#endif
+ //If set to 1, each map counts its lookups, comparisons, probes, and reallocations (see get_map_statistics).
+#ifndef MAP_COLLECT_STATISTICS
+ #define MAP_COLLECT_STATISTICS 0
+#endif
+
+ //The hash table starts with this many slots (it must be a power of two) when the first node is added.
+ #define MAP_INITIAL_SLOT_COUNT 16
+ //The hash table doubles once ui32_count / ui32_slot_count would exceed this ratio.
+ #define MAP_MAXIMUM_LOAD_NUMERATOR 3
+ #define MAP_MAXIMUM_LOAD_DENOMINATOR 4
+ //The insertion-order reference array starts with room for this many nodes and doubles when it fills.
+ #define MAP_INITIAL_INDEX_CAPACITY 16
+
+ //Each node is one block: the DOUBLY_LINKED_LIST header, then the user-data, then the key's bytes.
+ //The blocks are rounded up to this many bytes and carved out of pages of MAP_SLAB_PAGE_SIZE bytes.
+ #define MAP_NODE_ALIGNMENT 16
+ //The first page is MAP_SLAB_FIRST_PAGE_SIZE bytes and each one after that is twice as large as the last.
+ #define MAP_SLAB_FIRST_PAGE_SIZE 1024
+ #define MAP_SLAB_PAGE_SIZE 65536
+ //Nodes that are larger than this (long keys or large user-data) get a block of their own from malloc.
+ #define MAP_SLAB_LARGEST_NODE 512
+ #define MAP_SLAB_SIZE_CLASSES ( MAP_SLAB_LARGEST_NODE / MAP_NODE_ALIGNMENT + 1 )
+
+ //The ordered index (see enable_map_ordered_index) is a skip list with at most this many levels,
+ //which keeps lookups logarithmic up to about 4^MAP_ORDERED_INDEX_MAXIMUM_LEVEL keys.
+ #define MAP_ORDERED_INDEX_MAXIMUM_LEVEL 16
+
+ //How many keys find_map_nodes_data hashes and prefetches before comparing any of them.
+ //There should be enough to keep the processor's outstanding cache misses busy, but not so many that
+ //the first prefetched lines are evicted before they're used.
+#ifndef MAP_BATCH_LOOKUP_GROUP_SIZE
+ #define MAP_BATCH_LOOKUP_GROUP_SIZE 16
+#endif
+
+ //Eviction policies for enable_map_cache.
+ #define MAP_CACHE_LRU 1 //Evict the least recently used key.
+ #define MAP_CACHE_CLOCK 2 //Evict a key that hasn't been used since the clock hand last passed it (cheaper hits).
+
+ typedef struct DOUBLY_LINKED_LIST {
+   char *lpsz_key; //Not zero-terminated, if the map has binary keys (see MAP ->ui32_key_size).
+   void *lpv_data;
+   uint64_t ui64_hash; //The full hash of lpsz_key, so that growing the table never has to rehash the keys.
+   uint32_t ui32_index; //Where this node is referenced in MAP ->lpary_doubly_linked_list.
+   uint32_t ui32_node_size; //How many bytes were allocated for this node (header, user-data, and key).
+
+   //These link every node of the map together in insertion order.
+   struct DOUBLY_LINKED_LIST *lp_next;
+   struct DOUBLY_LINKED_LIST *lp_prev;
+ } DOUBLY_LINKED_LIST;
+
+ //These are defined in map.c.
+ struct MAP_ORDERED_INDEX;
+ struct MAP_ORDERED_TOWER;
+
+ //Usage:
+ //  MAP_ORDERED_ITERATOR iterator;
+ //  begin_map_prefix ( &map, &iterator, "order:2024-" );
+ //  for ( DOUBLY_LINKED_LIST *node; (node = next_map_ordered_node ( &iterator )); ) { ... }
+ typedef struct MAP_ORDERED_ITERATOR {
+   struct MAP_ORDERED_TOWER *lp_tower; //Where the next node is; 0 = the range has ended.
+   const char *lpsz_last; //Stop at the first key that's greater than or equal to this one (0 = don't).
+   const char *lpsz_prefix; //Stop at the first key that doesn't start with this (0 = don't).
+   size_t st_prefix_length;
+ } MAP_ORDERED_ITERATOR;
+
+ typedef struct MAP_SLOT {
+   uint64_t ui64_hash; //A copy of lp_node ->ui64_hash, so that probing doesn't have to touch the node.
+   DOUBLY_LINKED_LIST *lp_node; //0 = this slot is empty.
+ } MAP_SLOT;
+
+ //Counters that are only updated when map.c is built with MAP_COLLECT_STATISTICS set.
+ typedef struct MAP_STATISTICS {
+   uint64_t ui64_lookups; //How many times a key was looked up (by find, set, or free).
+   uint64_t ui64_key_comparisons; //How many strcmp calls those lookups needed (only made on full hash matches).
+   uint64_t ui64_probes; //How many occupied slots those lookups stepped through.
+   uint32_t ui32_longest_probe; //The most occupied slots that a single lookup stepped through.
+   uint64_t ui64_table_growths; //How many times the hash table doubled.
+   uint64_t ui64_index_reallocations; //How many times the insertion-order reference array was reallocated.
+   uint64_t ui64_index_compactions; //How many times tombstones were removed from the reference array.
+ } MAP_STATISTICS;
+
+ //The last bucket of each MAP_OCCUPANCY histogram also counts everything larger.
+ #define MAP_OCCUPANCY_HISTOGRAM_SIZE 32
+ //How many consecutive slots make up one region of MAP_OCCUPANCY ->ui32_regions.
+ #define MAP_OCCUPANCY_REGION_SIZE 16
+
+ //A snapshot of how the nodes are spread over the hash table (see get_map_occupancy).
+ typedef struct MAP_OCCUPANCY {
+   uint32_t ui32_slot_count;
+   uint32_t ui32_used_slots;
+   uint64_t ui64_displacement; //The sum of how far every node is from its home slot (the slot its hash maps to).
+   uint32_t ui32_longest_displacement;
+   uint64_t ui64_miss_probes; //The sum, over every slot, of how many occupied slots a lookup that started there would step through before finding an empty one.
+   uint32_t ui32_longest_run; //The most consecutive occupied slots.
+   uint32_t ui32_displacements [ MAP_OCCUPANCY_HISTOGRAM_SIZE ]; //[d] = how many nodes are d slots past their home slot.
+   uint32_t ui32_runs [ MAP_OCCUPANCY_HISTOGRAM_SIZE ]; //[l] = how many runs of exactly l consecutive occupied slots there are ([0] is unused).
+   uint32_t ui32_regions [ MAP_OCCUPANCY_REGION_SIZE + 1 ]; //[n] = how many regions of MAP_OCCUPANCY_REGION_SIZE slots have n occupied slots.
+ } MAP_OCCUPANCY;
+
+ //Counted for every map that's a cache (see enable_map_cache).
+ typedef struct MAP_CACHE_STATISTICS {
+   uint64_t ui64_hits; //Lookups that found their key.
+   uint64_t ui64_misses; //Lookups that didn't.
+   uint64_t ui64_evictions; //Keys removed to make room for others.
+ } MAP_CACHE_STATISTICS;
+
+ typedef struct MAP {
+   //This will be an array of references to the actual nodes within the table, in case we want to iterate through the list in the order in which the nodes were inserted.
+   //free_map_node leaves a null reference (a tombstone) behind instead of moving everything after it down;
+   //the array is compacted once tombstones make up half of it, or when it's indexed with MAP_DATA_AT/MAP_KEY_AT.
+   DOUBLY_LINKED_LIST **lpary_doubly_linked_list; //DOUBLY_LINKED_LIST*[]. The index is the node starting from lp_first_node and following lp_next until N nodes have been accessed.
+   uint32_t ui32_index_length; //How many references (including tombstones) are in lpary_doubly_linked_list.
+   uint32_t ui32_index_capacity; //How many references lpary_doubly_linked_list has room for.
+   MAP_SLOT *lpary_slots; //MAP_SLOT[ui32_slot_count]; the open-addressed hash table. 0 until the first node is added.
+   uint32_t ui32_slot_count; //Always a power of two, so that (hash & (ui32_slot_count - 1)) is the home slot.
+   DOUBLY_LINKED_LIST *lp_first_node; //first in insertion order.
+   DOUBLY_LINKED_LIST *lp_last_node;  //last in insertion order.
+   int8_t (*lpfn_sort_comparator_function)(void *lpv_node1, void *lpv_node2); //-1 = node1 should be left; 0 either is fine; 1 = node1 should be on the right.
+   uint8_t (*lpfn_free)(void *lpv_node1); //user-defined free function, in case the data stored in the node ->lpv_data memory block has dynamicly allocated memory, as well.
+   void *(*lpfn_initialize)(void); //user-defined function to return an initialized block of memory of the same arbitrary structure type being used in this map.
+   uint32_t ui32_count; //Count of all nodes in the map.
+   uint32_t ui32_data_size; //Store the size of the data in a user-defined block of a DOUBLY_LINKED_LIST struct, here.
+   uint32_t ui32_key_size; //0 = the keys are zero-terminated strings; otherwise, every key is this many bytes (see initialize_binary_key_map).
+   char *lp_slab_page; //The page that nodes are currently being carved from. Its first pointer links to the page before it.
+   uint32_t ui32_slab_page_size; //How many bytes lp_slab_page holds.
+   uint32_t ui32_slab_page_used; //How many bytes of lp_slab_page have been carved off, so far.
+   DOUBLY_LINKED_LIST *lpary_free_nodes [ MAP_SLAB_SIZE_CLASSES ]; //Freed slab nodes, by size in MAP_NODE_ALIGNMENT units, linked through lp_next.
+   size_t st_node_memory; //How many bytes of slab pages and large nodes this map has allocated.
+   MAP_STATISTICS statistics; //Always present so that the layout doesn't depend on MAP_COLLECT_STATISTICS.
+   struct MAP_ORDERED_INDEX *lp_ordered_index; //The keys in sorted order (by strcmp); 0 unless enable_map_ordered_index has been called.
+   uint32_t ui32_cache_capacity; //0 = this isn't a cache; otherwise, the most keys the map will hold before evicting (see enable_map_cache).
+   uint8_t ui8_cache_policy; //MAP_CACHE_LRU or MAP_CACHE_CLOCK.
+   uint8_t *lpary_cache_referenced; //MAP_CACHE_CLOCK only: uint8_t[ui32_index_capacity]; 1 = the node at the same position in lpary_doubly_linked_list has been used since the hand passed it.
+   uint32_t ui32_cache_hand; //MAP_CACHE_CLOCK only: the position in lpary_doubly_linked_list where the next search for a node to evict starts.
+   MAP_CACHE_STATISTICS cache_statistics;
+
+ } MAP;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ uint64_t get_map_key_hash ( const char *lpsz_key );
+ uint64_t get_map_binary_key_hash ( const void *lpv_key, uint32_t ui32_key_size );
+
+ DOUBLY_LINKED_LIST *new_doubly_linked_list_node (
+   MAP *lpm_map,
+   const char *lpsz_key,
+   uint64_t ui64_hash,
+   void *lpv_data,
+   DOUBLY_LINKED_LIST *lp_prev,
+   DOUBLY_LINKED_LIST *lp_next,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ );
+
+ uint8_t initialize_map (
+   MAP *lpm_map,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ );
+ uint8_t initialize_map_with_capacity (
+   MAP *lpm_map,
+   uint32_t ui32_capacity,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ );
+ uint8_t initialize_binary_key_map (
+   MAP *lpm_map,
+   uint32_t ui32_key_size,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ );
+ uint8_t initialize_integer_key_map (
+   MAP *lpm_map,
+   uint32_t ui32_data_size,
+   void*(*lpfn_initialize)(void),
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ );
+ uint8_t reserve_map ( MAP *lpm_map, uint32_t ui32_capacity );
+
+ void *find_map_node__internal ( MAP *lpm_map, const char *lpsz_key, uint8_t b_return_node_data_instead_of_node );
+ void *find_map_node ( MAP *lpm_map, const char *lpsz_key );
+ void *find_map_node_data ( MAP *lpm_map, const char *lpsz_key );
+ uint32_t find_map_nodes_data ( MAP *lpm_map, const char **lpary_keys, uint32_t ui32_count, void **lpary_data );
+ uint32_t find_map_integer_nodes_data ( MAP *lpm_map, const uint64_t *lpary_keys, uint32_t ui32_count, void **lpary_data );
+ uint8_t set_map_node__internal (
+   MAP *lpm_map,
+   const char *lpsz_key,
+   void *lpv_data,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ );
+ void *get_map_node ( MAP *lpm_map, const char *lpsz_key );
+ void compact_map_index ( MAP *lpm_map );
+ DOUBLY_LINKED_LIST *get_map_node_at ( MAP *lpm_map, uint32_t ui32_index );
+ uint8_t get_map_statistics ( MAP *lpm_map, MAP_STATISTICS *lp_statistics );
+ void reset_map_statistics ( MAP *lpm_map );
+ uint8_t get_map_occupancy ( MAP *lpm_map, MAP_OCCUPANCY *lp_occupancy );
+ size_t get_map_memory_usage ( MAP *lpm_map );
+ uint8_t enable_map_ordered_index ( MAP *lpm_map );
+ void disable_map_ordered_index ( MAP *lpm_map );
+ DOUBLY_LINKED_LIST *find_map_lower_bound ( MAP *lpm_map, const char *lpsz_key );
+ uint8_t begin_map_range (
+   MAP *lpm_map,
+   MAP_ORDERED_ITERATOR *lp_iterator,
+   const char *lpsz_first,
+   const char *lpsz_last
+ );
+ uint8_t begin_map_prefix ( MAP *lpm_map, MAP_ORDERED_ITERATOR *lp_iterator, const char *lpsz_prefix );
+ DOUBLY_LINKED_LIST *next_map_ordered_node ( MAP_ORDERED_ITERATOR *lp_iterator );
+ uint8_t enable_map_cache ( MAP *lpm_map, uint32_t ui32_capacity, uint8_t ui8_policy );
+ uint8_t get_map_cache_statistics ( MAP *lpm_map, MAP_CACHE_STATISTICS *lp_statistics );
+ uint8_t free_map ( MAP *lpm_map );
+ uint8_t free_map_node ( MAP *lpm_map, const char *lpsz_key );
+
+ void *find_map_binary_node ( MAP *lpm_map, const void *lpv_key );
+ void *find_map_binary_node_data ( MAP *lpm_map, const void *lpv_key );
+ uint8_t set_map_binary_node__internal (
+   MAP *lpm_map,
+   const void *lpv_key,
+   void *lpv_data,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ );
+ uint8_t free_map_binary_node ( MAP *lpm_map, const void *lpv_key );
+ void *find_map_integer_node ( MAP *lpm_map, uint64_t ui64_key );
+ void *find_map_integer_node_data ( MAP *lpm_map, uint64_t ui64_key );
+ uint8_t set_map_integer_node__internal (
+   MAP *lpm_map,
+   uint64_t ui64_key,
+   void *lpv_data,
+   uint8_t b_assign_data_instead_of_allocating_and_copying
+ );
+ uint8_t free_map_integer_node ( MAP *lpm_map, uint64_t ui64_key );
+ uint64_t get_map_node_integer_key ( DOUBLY_LINKED_LIST *lp_node );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
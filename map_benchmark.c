@@ -0,0 +1,534 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure how quickly the map works, and how much memory it uses per key, as it grows.
+ The workloads are:
+  - Inserting, finding, replacing, and freeing keys that share a long prefix ("user:session:0000000001").
+  - The same with random keys.
+  - A map that keeps its keys sorted: inserts, lower bounds, in-order walks, and prefix scans.
+  - Lookups with integer and 16-byte binary keys instead of strings.
+  - Batched lookups (find_map_nodes_data) against one lookup at a time.
+  - The memory taken up by many small maps.
+
+ Usage: map_benchmark [largest key count (default: 1000000)]
+ The key count starts at 1000 and is multiplied by ten until it exceeds the
+ largest key count, so "map_benchmark 10000000" runs 1e3 through 1e7.
+
+ To compile:
+   gcc -O2 map.c map_benchmark.c -o map_benchmark
+ To also see how many probes and key comparisons the lookups needed:
+   gcc -O2 -DMAP_COLLECT_STATISTICS=1 map.c map_benchmark.c -o map_benchmark
+*/
+ #include "map.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_KEY_LENGTH 32
+ //How many keys each find_map_nodes_data call looks up (a typical request handler needs 50 to 500).
+ #define BENCHMARK_BATCH_SIZE 100
+
+/*
+ This will fill a buffer with ui32_count keys of BENCHMARK_KEY_LENGTH bytes each.
+ If b_prefixed is set, every key shares the same long prefix and only differs in
+ its trailing digits; otherwise, each key is a random string of hexadecimal digits.
+ The key that would come after the last one (index ui32_count) is also generated so
+ that it can be used for lookups that should miss.
+*/
+ static char *generate_benchmark_keys ( uint32_t ui32_count, uint8_t b_prefixed, uint64_t ui64_seed )
+{{
+ char *lpsz_keys = (char *) malloc ( (size_t) (ui32_count + 1) * BENCHMARK_KEY_LENGTH );
+ if ( ! lpsz_keys ) {
+   return 0;
+ }
+
+ uint64_t ui64_state = ui64_seed;
+ for ( uint32_t ui32_i = 0; ui32_i <= ui32_count; ui32_i ++ ) {
+   char *lpsz_key = lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH;
+   if ( b_prefixed ) {
+     snprintf ( lpsz_key, BENCHMARK_KEY_LENGTH, "user:session:%010" PRIu32, ui32_i );
+   }
+   else {
+     snprintf (
+       lpsz_key,
+       BENCHMARK_KEY_LENGTH,
+       "%016" PRIx64 "%08" PRIx32,
+       get_benchmark_random ( &ui64_state ),
+       ui32_i //keeps the keys unique.
+     );
+   }
+ }
+
+ return lpsz_keys;
+}}
+
+///user-defined callbacks.
+ static uint8_t free_benchmark_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1; //There's nothing inside of a uint32_t to free.
+}}
+
+ static int8_t compare_benchmark_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0;
+}}
+
+/*
+ This will time each of these phases on ui32_count keys, and then show the throughput of
+ each in millions of operations per second, along with how many bytes the map allocated per key:
+  1.) insert: add every key to a new map.
+  2.) presized insert: add them again to a map created with room for all of them.
+  3.) hit: look up every key.
+  4.) miss: look up as many keys that don't exist.
+  5.) churn: replace every key by deleting it and inserting another.
+  6.) free: free the whole map.
+*/
+ static void run_map_benchmark ( uint32_t ui32_count, uint8_t b_prefixed )
+{{
+ char *lpsz_keys = generate_benchmark_keys ( ui32_count, b_prefixed, 0x2545f4914f6cdd1dULL );
+ char *lpsz_missing_keys = generate_benchmark_keys ( ui32_count, b_prefixed, 0x9e3779b97f4a7c15ULL );
+ if ( ! lpsz_keys || ! lpsz_missing_keys ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_count );
+   free ( lpsz_keys );
+   free ( lpsz_missing_keys );
+   return ;
+ }
+
+ //Prefixed keys differ from each other by index, so the misses need a different prefix.
+ if ( b_prefixed ) {
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+     lpsz_missing_keys [ (size_t) ui32_i * BENCHMARK_KEY_LENGTH ] = 'U';
+   }
+ }
+
+ MAP map;
+ initialize_map ( &map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   SET_MAP_NODE ( map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+ }
+ double dbl_insert = get_benchmark_seconds (  ) - dbl_start;
+
+ //The same load into a map that was told how many keys to expect, so it never grows.
+ MAP presized_map;
+ initialize_map_with_capacity ( &presized_map, ui32_count, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   SET_MAP_NODE ( presized_map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+ }
+ double dbl_presized_insert = get_benchmark_seconds (  ) - dbl_start;
+ free_map ( &presized_map );
+
+ uint32_t ui32_found = 0;
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   uint32_t *lpui32_data = (uint32_t *) find_map_node_data ( &map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH );
+   if ( lpui32_data && *lpui32_data == ui32_i ) {
+     ui32_found ++;
+   }
+ }
+ double dbl_hit = get_benchmark_seconds (  ) - dbl_start;
+
+ uint32_t ui32_missed = 0;
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   if ( ! find_map_node_data ( &map, lpsz_missing_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH ) ) {
+     ui32_missed ++;
+   }
+ }
+ double dbl_miss = get_benchmark_seconds (  ) - dbl_start;
+
+ //Churn: replace every key with a new one, one deletion and one insertion at a time.
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   free_map_node ( &map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH );
+   SET_MAP_NODE ( map, lpsz_missing_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+ }
+ double dbl_churn = get_benchmark_seconds (  ) - dbl_start;
+
+ //After churning, the insertion order should be exactly the order of the replacement keys.
+ uint8_t b_ordered = map .ui32_count == ui32_count;
+ for ( uint32_t ui32_i = 0; b_ordered && ui32_i < ui32_count; ui32_i ++ ) {
+   b_ordered = MAP_DATA_AT ( uint32_t, map, ui32_i ) == ui32_i;
+ }
+
+ double dbl_bytes_per_key = (double) get_map_memory_usage ( &map ) / ui32_count;
+ MAP_STATISTICS statistics;
+ uint8_t b_statistics = get_map_statistics ( &map, &statistics );
+
+ dbl_start = get_benchmark_seconds (  );
+ free_map ( &map );
+ double dbl_free = get_benchmark_seconds (  ) - dbl_start;
+
+ fprintf (
+   stdout,
+   "%-8s %10" PRIu32 " keys: insert %8.3f Mops/s; presized insert %8.3f Mops/s; hit %8.3f Mops/s; miss %8.3f Mops/s; churn %8.3f Mops/s; "
+   "free %8.3f Mops/s; %6.1f bytes/key%s\n",
+   b_prefixed ? "prefixed" : "random",
+   ui32_count,
+   ui32_count / dbl_insert / 1e6,
+   ui32_count / dbl_presized_insert / 1e6,
+   ui32_count / dbl_hit / 1e6,
+   ui32_count / dbl_miss / 1e6,
+   ui32_count / dbl_churn / 1e6,
+   ui32_count / dbl_free / 1e6,
+   dbl_bytes_per_key,
+   ui32_found == ui32_count && ui32_missed == ui32_count && b_ordered ? "" : " (INCORRECT RESULTS)"
+ );
+
+ if ( b_statistics ) {
+   fprintf (
+     stdout,
+     "         %" PRIu64 " lookups: %.3f probes and %.3f key comparisons per lookup; longest probe: %" PRIu32 "; "
+     "%" PRIu64 " table growths; %" PRIu64 " index reallocations; %" PRIu64 " index compactions\n",
+     statistics .ui64_lookups,
+     (double) statistics .ui64_probes / statistics .ui64_lookups,
+     (double) statistics .ui64_key_comparisons / statistics .ui64_lookups,
+     statistics .ui32_longest_probe,
+     statistics .ui64_table_growths,
+     statistics .ui64_index_reallocations,
+     statistics .ui64_index_compactions
+   );
+ }
+
+ free ( lpsz_keys );
+ free ( lpsz_missing_keys );
+}}
+
+/*
+ This will insert ui32_count keys into a map that keeps them sorted, and then show how
+ quickly it inserts them, finds lower bounds, walks every key in order, and scans a
+ prefix that matches about one key in four thousand.
+*/
+ static void run_ordered_map_benchmark ( uint32_t ui32_count )
+{{
+ char *lpsz_keys = generate_benchmark_keys ( ui32_count, 0, 0x2545f4914f6cdd1dULL );
+ if ( ! lpsz_keys ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_count );
+   return ;
+ }
+
+ MAP map;
+ initialize_map ( &map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ enable_map_ordered_index ( &map );
+
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   SET_MAP_NODE ( map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+ }
+ double dbl_insert = get_benchmark_seconds (  ) - dbl_start;
+
+ uint32_t ui32_found = 0;
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   ui32_found += find_map_lower_bound ( &map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH ) != 0;
+ }
+ double dbl_lower_bound = get_benchmark_seconds (  ) - dbl_start;
+
+ //Every key should come out in strictly increasing order.
+ MAP_ORDERED_ITERATOR iterator;
+ uint32_t ui32_sorted = 0;
+ const char *lpsz_previous_key = "";
+ dbl_start = get_benchmark_seconds (  );
+ begin_map_range ( &map, &iterator, 0, 0 );
+ for ( DOUBLY_LINKED_LIST *node; (node = next_map_ordered_node ( &iterator )); lpsz_previous_key = node ->lpsz_key ) {
+   ui32_sorted += strcmp ( lpsz_previous_key, node ->lpsz_key ) < 0;
+ }
+ double dbl_iterate = get_benchmark_seconds (  ) - dbl_start;
+
+ //The keys are random hexadecimal digits, so a three digit prefix matches about 1 in 4096 of them.
+ uint32_t ui32_matched = 0;
+ dbl_start = get_benchmark_seconds (  );
+ begin_map_prefix ( &map, &iterator, "abc" );
+ while ( next_map_ordered_node ( &iterator ) ) {
+   ui32_matched ++;
+ }
+ double dbl_prefix = get_benchmark_seconds (  ) - dbl_start;
+
+ fprintf (
+   stdout,
+   "ordered  %10" PRIu32 " keys: insert %8.3f Mops/s; lower bound %8.3f Mops/s; in-order walk %8.3f Mkeys/s; "
+   "prefix scan %" PRIu32 " keys in %.3f ms%s\n",
+   ui32_count,
+   ui32_count / dbl_insert / 1e6,
+   ui32_count / dbl_lower_bound / 1e6,
+   ui32_count / dbl_iterate / 1e6,
+   ui32_matched,
+   dbl_prefix * 1e3,
+   ui32_found == ui32_count && ui32_sorted == ui32_count ? "" : " (INCORRECT RESULTS)"
+ );
+
+ free_map ( &map );
+ free ( lpsz_keys );
+}}
+
+/*
+ This will look up ui32_count 64-bit IDs three ways: printed into strings (the conversion is
+ counted, since it has to happen for every lookup), as integer keys, and as 16-byte binary keys
+ (the ID and its complement, like a UUID), and show the throughput of each and the memory per key.
+*/
+ static void run_key_type_benchmark ( uint32_t ui32_count )
+{{
+ uint64_t *lpary_ids = (uint64_t *) malloc ( (size_t) ui32_count * sizeof ( uint64_t ) );
+ if ( ! lpary_ids ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_count );
+   return ;
+ }
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   lpary_ids [ ui32_i ] = get_benchmark_random ( &ui64_state );
+ }
+
+ MAP string_map, integer_map, binary_map;
+ initialize_map ( &string_map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ initialize_integer_key_map ( &integer_map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ initialize_binary_key_map ( &binary_map, 2 * sizeof ( uint64_t ), sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+
+ char sz_key [ 24 ];
+ uint64_t ui64_binary_key [ 2 ];
+ double dbl_insert [ 3 ], dbl_hit [ 3 ], dbl_miss [ 3 ];
+ uint32_t ui32_found = 0, ui32_missed = 0;
+
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   snprintf ( sz_key, sizeof ( sz_key ), "%" PRIu64, lpary_ids [ ui32_i ] );
+   SET_MAP_NODE ( string_map, sz_key, ui32_i );
+ }
+ dbl_insert [ 0 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   SET_MAP_INTEGER_NODE ( integer_map, lpary_ids [ ui32_i ], ui32_i );
+ }
+ dbl_insert [ 1 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   ui64_binary_key [ 0 ] = lpary_ids [ ui32_i ];
+   ui64_binary_key [ 1 ] = ~lpary_ids [ ui32_i ];
+   SET_MAP_BINARY_NODE ( binary_map, ui64_binary_key, ui32_i );
+ }
+ dbl_insert [ 2 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   snprintf ( sz_key, sizeof ( sz_key ), "%" PRIu64, lpary_ids [ ui32_i ] );
+   uint32_t *lpui32_data = (uint32_t *) find_map_node_data ( &string_map, sz_key );
+   ui32_found += lpui32_data && *lpui32_data == ui32_i;
+ }
+ dbl_hit [ 0 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   uint32_t *lpui32_data = (uint32_t *) find_map_integer_node_data ( &integer_map, lpary_ids [ ui32_i ] );
+   ui32_found += lpui32_data && *lpui32_data == ui32_i;
+ }
+ dbl_hit [ 1 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   ui64_binary_key [ 0 ] = lpary_ids [ ui32_i ];
+   ui64_binary_key [ 1 ] = ~lpary_ids [ ui32_i ];
+   uint32_t *lpui32_data = (uint32_t *) find_map_binary_node_data ( &binary_map, ui64_binary_key );
+   ui32_found += lpui32_data && *lpui32_data == ui32_i;
+ }
+ dbl_hit [ 2 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ //The IDs are random, so flipping the lowest bit of one almost certainly gives an ID that isn't in the map.
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   snprintf ( sz_key, sizeof ( sz_key ), "%" PRIu64, lpary_ids [ ui32_i ] ^ 1 );
+   ui32_missed += ! find_map_node_data ( &string_map, sz_key );
+ }
+ dbl_miss [ 0 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   ui32_missed += ! find_map_integer_node_data ( &integer_map, lpary_ids [ ui32_i ] ^ 1 );
+ }
+ dbl_miss [ 1 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   ui64_binary_key [ 0 ] = lpary_ids [ ui32_i ] ^ 1;
+   ui64_binary_key [ 1 ] = ~lpary_ids [ ui32_i ];
+   ui32_missed += ! find_map_binary_node_data ( &binary_map, ui64_binary_key );
+ }
+ dbl_miss [ 2 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ MAP *lpary_maps [ 3 ] = { &string_map, &integer_map, &binary_map };
+ const char *lpsz_names [ 3 ] = { "string", "integer", "16-byte" };
+ for ( uint32_t ui32_i = 0; ui32_i < 3; ui32_i ++ ) {
+   fprintf (
+     stdout,
+     "%-8s %10" PRIu32 " IDs:  insert %8.3f Mops/s; hit %8.3f Mops/s; miss %8.3f Mops/s; %6.1f bytes/key%s\n",
+     lpsz_names [ ui32_i ],
+     ui32_count,
+     ui32_count / dbl_insert [ ui32_i ] / 1e6,
+     ui32_count / dbl_hit [ ui32_i ] / 1e6,
+     ui32_count / dbl_miss [ ui32_i ] / 1e6,
+     (double) get_map_memory_usage ( lpary_maps [ ui32_i ] ) / ui32_count,
+     ui32_found == 3 * ui32_count && ui32_missed == 3 * ui32_count ? "" : " (INCORRECT RESULTS)"
+   );
+   free_map ( lpary_maps [ ui32_i ] );
+ }
+
+ free ( lpary_ids );
+}}
+
+/*
+ This will look up every key of a map in a random order, first one key at a time and then in batches
+ of BENCHMARK_BATCH_SIZE keys (see find_map_nodes_data), and show the throughput of both, for random
+ string keys and for integer keys. Once the map is larger than the last-level cache, almost every
+ lookup misses the cache twice (on the slot and on the node), which is what batching overlaps.
+*/
+ static void run_batch_lookup_benchmark ( uint32_t ui32_count )
+{{
+ char *lpsz_keys = generate_benchmark_keys ( ui32_count, 0, 0x2545f4914f6cdd1dULL );
+ const char **lpary_keys = (const char **) malloc ( (size_t) ui32_count * sizeof ( char * ) );
+ uint64_t *lpary_ids = (uint64_t *) malloc ( (size_t) ui32_count * sizeof ( uint64_t ) );
+ uint32_t *lpary_order = (uint32_t *) malloc ( (size_t) ui32_count * sizeof ( uint32_t ) );
+ if ( ! lpsz_keys || ! lpary_keys || ! lpary_ids || ! lpary_order ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_count );
+   free ( lpsz_keys );
+   free ( lpary_keys );
+   free ( lpary_ids );
+   free ( lpary_order );
+   return ;
+ }
+
+ MAP string_map, integer_map;
+ initialize_map ( &string_map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ initialize_integer_key_map ( &integer_map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   SET_MAP_NODE ( string_map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+   SET_MAP_INTEGER_NODE ( integer_map, (uint64_t) ui32_i * 0x9e3779b97f4a7c15ULL, ui32_i );
+ }
+
+ //Shuffle the lookups, so that they don't visit the nodes in the order that they were allocated.
+ uint64_t ui64_state = 0x9e3779b97f4a7c15ULL;
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   lpary_order [ ui32_i ] = ui32_i;
+ }
+ for ( uint32_t ui32_i = ui32_count - 1; ui32_i > 0; ui32_i -- ) {
+   uint32_t ui32_j = (uint32_t) (get_benchmark_random ( &ui64_state ) % (ui32_i + 1));
+   uint32_t ui32_swap = lpary_order [ ui32_i ];
+   lpary_order [ ui32_i ] = lpary_order [ ui32_j ];
+   lpary_order [ ui32_j ] = ui32_swap;
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   lpary_keys [ ui32_i ] = lpsz_keys + (size_t) lpary_order [ ui32_i ] * BENCHMARK_KEY_LENGTH;
+   lpary_ids [ ui32_i ] = (uint64_t) lpary_order [ ui32_i ] * 0x9e3779b97f4a7c15ULL;
+ }
+
+ void *lpary_data [ BENCHMARK_BATCH_SIZE ];
+ uint32_t ui32_correct = 0;
+ double dbl_seconds [ 4 ];
+
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   uint32_t *lpui32_data = (uint32_t *) find_map_node_data ( &string_map, lpary_keys [ ui32_i ] );
+   ui32_correct += lpui32_data && *lpui32_data == lpary_order [ ui32_i ];
+ }
+ dbl_seconds [ 0 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i += BENCHMARK_BATCH_SIZE ) {
+   uint32_t ui32_batch = ui32_count - ui32_i < BENCHMARK_BATCH_SIZE ? ui32_count - ui32_i : BENCHMARK_BATCH_SIZE;
+   find_map_nodes_data ( &string_map, lpary_keys + ui32_i, ui32_batch, lpary_data );
+   for ( uint32_t ui32_j = 0; ui32_j < ui32_batch; ui32_j ++ ) {
+     ui32_correct += lpary_data [ ui32_j ] && *(uint32_t *) lpary_data [ ui32_j ] == lpary_order [ ui32_i + ui32_j ];
+   }
+ }
+ dbl_seconds [ 1 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   uint32_t *lpui32_data = (uint32_t *) find_map_integer_node_data ( &integer_map, lpary_ids [ ui32_i ] );
+   ui32_correct += lpui32_data && *lpui32_data == lpary_order [ ui32_i ];
+ }
+ dbl_seconds [ 2 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i += BENCHMARK_BATCH_SIZE ) {
+   uint32_t ui32_batch = ui32_count - ui32_i < BENCHMARK_BATCH_SIZE ? ui32_count - ui32_i : BENCHMARK_BATCH_SIZE;
+   find_map_integer_nodes_data ( &integer_map, lpary_ids + ui32_i, ui32_batch, lpary_data );
+   for ( uint32_t ui32_j = 0; ui32_j < ui32_batch; ui32_j ++ ) {
+     ui32_correct += lpary_data [ ui32_j ] && *(uint32_t *) lpary_data [ ui32_j ] == lpary_order [ ui32_i + ui32_j ];
+   }
+ }
+ dbl_seconds [ 3 ] = get_benchmark_seconds (  ) - dbl_start;
+
+ fprintf (
+   stdout,
+   "batch    %10" PRIu32 " keys: string loop %8.3f Mops/s, batch %8.3f Mops/s (%.2fx); "
+   "integer loop %8.3f Mops/s, batch %8.3f Mops/s (%.2fx)%s\n",
+   ui32_count,
+   ui32_count / dbl_seconds [ 0 ] / 1e6,
+   ui32_count / dbl_seconds [ 1 ] / 1e6,
+   dbl_seconds [ 0 ] / dbl_seconds [ 1 ],
+   ui32_count / dbl_seconds [ 2 ] / 1e6,
+   ui32_count / dbl_seconds [ 3 ] / 1e6,
+   dbl_seconds [ 2 ] / dbl_seconds [ 3 ],
+   ui32_correct == 4 * ui32_count ? "" : " (INCORRECT RESULTS)"
+ );
+
+ free_map ( &string_map );
+ free_map ( &integer_map );
+ free ( lpsz_keys );
+ free ( lpary_keys );
+ free ( lpary_ids );
+ free ( lpary_order );
+}}
+
+/*
+ This will show how much memory many small maps take up, counting the MAP structure
+ itself, since that's what dominates when a program keeps thousands of them around.
+*/
+ static void run_small_map_benchmark ( void )
+{{
+ char *lpsz_keys = generate_benchmark_keys ( 64, 1, 0 );
+ if ( ! lpsz_keys ) {
+   return ;
+ }
+
+ for ( uint32_t ui32_keys = 0; ui32_keys <= 64; ui32_keys = ui32_keys ? ui32_keys << 2 : 1 ) {
+   MAP map;
+   initialize_map ( &map, sizeof ( uint32_t ), 0, compare_benchmark_data, free_benchmark_data );
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_keys; ui32_i ++ ) {
+     SET_MAP_NODE ( map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui32_i );
+   }
+
+   fprintf (
+     stdout,
+     "small map %2" PRIu32 " keys: %6zu bytes (%zu of which is the MAP structure)\n",
+     ui32_keys,
+     sizeof ( MAP ) + get_map_memory_usage ( &map ),
+     sizeof ( MAP )
+   );
+   free_map ( &map );
+ }
+
+ free ( lpsz_keys );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ uint32_t ui32_largest_count = 1000000;
+ if ( argc > 1 ) {
+   ui32_largest_count = (uint32_t) strtoul ( argv [ 1 ], 0, 10 );
+ }
+
+ for ( uint32_t ui32_count = 1000; ui32_count && ui32_count <= ui32_largest_count; ui32_count *= 10 ) {
+   run_map_benchmark ( ui32_count, 1 );
+   run_map_benchmark ( ui32_count, 0 );
+   run_ordered_map_benchmark ( ui32_count );
+   run_key_type_benchmark ( ui32_count );
+   run_batch_lookup_benchmark ( ui32_count );
+ }
+
+ run_small_map_benchmark (  );
+
+ return 0;
+}}
@@ -0,0 +1,207 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure how quickly a map in cache mode (see enable_map_cache) serves a
+ cache-aside workload, and how many of its lookups hit, with LRU and with CLOCK eviction.
+
+ The requests follow a Zipfian distribution (a few keys are requested very often and
+ most keys rarely), which is what most caches see. Each request looks its key up and,
+ on a miss, puts the key in the cache, which evicts another key once the cache is full.
+
+ Usage: map_cache_benchmark [key count (default: 1000000)] [request count (default: 10000000)] [Zipf exponent (default: 0.99)]
+ Caches holding 1% and 10% of the keys are measured.
+
+ To compile:
+   gcc -O2 map.c map_cache_benchmark.c -lm -o map_cache_benchmark
+*/
+ #include "map.h"
+ #include "math.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_KEY_LENGTH 32
+
+/*
+ This will fill an array with ui32_request_count key numbers (0 through ui32_key_count - 1),
+ where key number k is requested with a probability proportional to 1 / (k + 1)^dbl_exponent.
+ The requests are generated before the timing starts, by a binary search of the
+ cumulative distribution, so the benchmark only measures the cache.
+ The key numbers are shuffled, so that the popular keys aren't also the first keys generated.
+*/
+ static uint32_t *generate_zipfian_requests (
+   uint32_t ui32_key_count,
+   uint32_t ui32_request_count,
+   double dbl_exponent,
+   uint64_t ui64_seed
+ )
+{{
+ double *lpary_cumulative = (double *) malloc ( (size_t) ui32_key_count * sizeof ( double ) );
+ uint32_t *lpary_permutation = (uint32_t *) malloc ( (size_t) ui32_key_count * sizeof ( uint32_t ) );
+ uint32_t *lpary_requests = (uint32_t *) malloc ( (size_t) ui32_request_count * sizeof ( uint32_t ) );
+ if ( ! lpary_cumulative || ! lpary_permutation || ! lpary_requests ) {
+   free ( lpary_cumulative );
+   free ( lpary_permutation );
+   free ( lpary_requests );
+   return 0;
+ }
+
+ double dbl_total = 0;
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_key_count; ui32_i ++ ) {
+   dbl_total += 1.0 / pow ( (double) ui32_i + 1, dbl_exponent );
+   lpary_cumulative [ ui32_i ] = dbl_total;
+ }
+
+ uint64_t ui64_state = ui64_seed;
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_key_count; ui32_i ++ ) {
+   lpary_permutation [ ui32_i ] = ui32_i;
+ }
+ for ( uint32_t ui32_i = ui32_key_count - 1; ui32_i > 0; ui32_i -- ) {
+   uint32_t ui32_j = (uint32_t) (get_benchmark_random ( &ui64_state ) % (ui32_i + 1));
+   uint32_t ui32_swap = lpary_permutation [ ui32_i ];
+   lpary_permutation [ ui32_i ] = lpary_permutation [ ui32_j ];
+   lpary_permutation [ ui32_j ] = ui32_swap;
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_request_count; ui32_i ++ ) {
+   double dbl_target = (double) (get_benchmark_random ( &ui64_state ) >> 11) / 9007199254740992.0 * dbl_total;
+
+   uint32_t ui32_low = 0, ui32_high = ui32_key_count - 1;
+   while ( ui32_low < ui32_high ) {
+     uint32_t ui32_middle = ui32_low + ((ui32_high - ui32_low) >> 1);
+     if ( lpary_cumulative [ ui32_middle ] < dbl_target ) {
+       ui32_low = ui32_middle + 1;
+     }
+     else {
+       ui32_high = ui32_middle;
+     }
+   }
+
+   lpary_requests [ ui32_i ] = lpary_permutation [ ui32_low ];
+ }
+
+ free ( lpary_cumulative );
+ free ( lpary_permutation );
+
+ return lpary_requests;
+}}
+
+///user-defined callbacks.
+ static uint8_t free_benchmark_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1; //There's nothing inside of a uint64_t to free.
+}}
+
+ static int8_t compare_benchmark_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0;
+}}
+
+/*
+ This will run every request against a cache of ui32_capacity keys and print its throughput
+ and hit ratio. The results are checked as it goes: every hit must return the data that was
+ put with its key, the cache must never hold more than ui32_capacity keys, and every miss
+ after the cache filled up must have evicted exactly one key.
+*/
+ static void run_map_cache_benchmark (
+   const char *lpsz_keys,
+   const uint32_t *lpary_requests,
+   uint32_t ui32_request_count,
+   uint32_t ui32_capacity,
+   uint8_t ui8_policy
+ )
+{{
+ MAP map;
+ initialize_map_with_capacity ( &map, ui32_capacity, sizeof ( uint64_t ), 0, compare_benchmark_data, free_benchmark_data );
+ if ( ! enable_map_cache ( &map, ui32_capacity, ui8_policy ) ) {
+   fprintf ( stderr, "Error: We couldn't turn the map into a cache.\n" );
+   free_map ( &map );
+   return ;
+ }
+
+ uint8_t b_correct = 1;
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_request_count; ui32_i ++ ) {
+   uint32_t ui32_key = lpary_requests [ ui32_i ];
+   const char *lpsz_key = lpsz_keys + (size_t) ui32_key * BENCHMARK_KEY_LENGTH;
+
+   uint64_t *lpui64_data = (uint64_t *) find_map_node_data ( &map, lpsz_key );
+   if ( lpui64_data ) {
+     b_correct = b_correct && *lpui64_data == ui32_key;
+   }
+   else {
+     uint64_t ui64_data = ui32_key;
+     SET_MAP_NODE ( map, lpsz_key, ui64_data );
+   }
+ }
+ double dbl_elapsed = get_benchmark_seconds (  ) - dbl_start;
+
+ MAP_CACHE_STATISTICS statistics;
+ get_map_cache_statistics ( &map, &statistics );
+ b_correct = b_correct &&
+   map .ui32_count <= ui32_capacity &&
+   statistics .ui64_hits + statistics .ui64_misses == ui32_request_count &&
+   statistics .ui64_evictions == statistics .ui64_misses - map .ui32_count;
+
+ fprintf (
+   stdout,
+   "%-5s capacity %8" PRIu32 ": %7.2f Mops/s; hit ratio %5.1f%%; %" PRIu64 " evictions%s\n",
+   ui8_policy == MAP_CACHE_LRU ? "LRU" : "CLOCK",
+   ui32_capacity,
+   ui32_request_count / dbl_elapsed / 1e6,
+   100.0 * statistics .ui64_hits / ui32_request_count,
+   statistics .ui64_evictions,
+   b_correct ? "" : " (INCORRECT RESULTS)"
+ );
+
+ free_map ( &map );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ uint32_t ui32_key_count = 1000000;
+ uint32_t ui32_request_count = 10000000;
+ double dbl_exponent = 0.99;
+ if ( argc > 1 ) {
+   ui32_key_count = (uint32_t) strtoul ( argv [ 1 ], 0, 10 );
+ }
+ if ( argc > 2 ) {
+   ui32_request_count = (uint32_t) strtoul ( argv [ 2 ], 0, 10 );
+ }
+ if ( argc > 3 ) {
+   dbl_exponent = strtod ( argv [ 3 ], 0 );
+ }
+ if ( ui32_key_count < 100 || ! ui32_request_count ) {
+   fprintf ( stderr, "Error: There must be at least 100 keys and one request.\n" );
+   return 1;
+ }
+
+ char *lpsz_keys = (char *) malloc ( (size_t) ui32_key_count * BENCHMARK_KEY_LENGTH );
+ uint32_t *lpary_requests = generate_zipfian_requests ( ui32_key_count, ui32_request_count, dbl_exponent, 0x2545f4914f6cdd1dULL );
+ if ( ! lpsz_keys || ! lpary_requests ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for the keys and requests.\n" );
+   free ( lpsz_keys );
+   free ( lpary_requests );
+   return 1;
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_key_count; ui32_i ++ ) {
+   snprintf ( lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, BENCHMARK_KEY_LENGTH, "user:session:%010" PRIu32, ui32_i );
+ }
+
+ fprintf (
+   stdout,
+   "%" PRIu32 " keys, %" PRIu32 " requests, Zipf exponent %.2f\n",
+   ui32_key_count,
+   ui32_request_count,
+   dbl_exponent
+ );
+ run_map_cache_benchmark ( lpsz_keys, lpary_requests, ui32_request_count, ui32_key_count / 100, MAP_CACHE_LRU );
+ run_map_cache_benchmark ( lpsz_keys, lpary_requests, ui32_request_count, ui32_key_count / 100, MAP_CACHE_CLOCK );
+ run_map_cache_benchmark ( lpsz_keys, lpary_requests, ui32_request_count, ui32_key_count / 10, MAP_CACHE_LRU );
+ run_map_cache_benchmark ( lpsz_keys, lpary_requests, ui32_request_count, ui32_key_count / 10, MAP_CACHE_CLOCK );
+
+ free ( lpsz_keys );
+ free ( lpary_requests );
+
+ return 0;
+}}
@@ -0,0 +1,597 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To judge the map against std::unordered_map on the same keys, and to show
+ how its keys are spread over its hash table.
+
+ For each key count, both containers run the same workloads: insert every key, look every
+ key up (hits), look up keys that aren't there (misses), update every key, iterate over every
+ key, and delete every key. Each workload is run twice on identical containers: once as a
+ plain loop, for operations per second, and once with every operation timed on its own, for
+ latency percentiles. (The timer's own overhead is printed, and is included in the latencies.)
+ Memory per key is what each container allocated while the keys were inserted: MAP reports
+ its own (get_map_memory_usage); std::unordered_map's is counted by replacing operator new.
+ After the inserts, the occupancy of the live MAP (see get_map_occupancy) and the bucket sizes
+ of the std::unordered_map are dumped as histograms.
+
+ Usage: map_harness [prefixed|random|integer] [key count ...]
+ prefixed keys share a long prefix ("user:session:0000000001"), random keys are random
+ hexadecimal strings, and integer keys are random 64-bit IDs (an integer-keyed MAP and a
+ std::unordered_map<uint64_t, uint32_t>). The default is "map_harness prefixed 100000 1000000".
+
+ To compile:
+   gcc -O2 -c map.c -o map.o
+   g++ -O2 map.o map_harness.cpp -o map_harness
+*/
+ #include "map.h"
+ #include <chrono>
+ #include <new>
+ #include <string>
+ #include <vector>
+ #include <unordered_map>
+ #include <algorithm>
+
+ #define HARNESS_KEY_LENGTH 32
+ #define HARNESS_KEYS_PREFIXED 0
+ #define HARNESS_KEYS_RANDOM 1
+ #define HARNESS_KEYS_INTEGER 2
+ //How wide the longest bar of a histogram is.
+ #define HARNESS_HISTOGRAM_WIDTH 50
+
+ //Every block allocated with new is preceded by its size, so that the bytes in use can be counted.
+ static size_t g_st_allocated_bytes = 0;
+
+ void *operator new ( size_t st_size )
+{{
+ size_t *lpst_block = (size_t *) malloc ( st_size + MAP_NODE_ALIGNMENT );
+ if ( ! lpst_block )
+      throw std::bad_alloc (  );
+
+ *lpst_block = st_size;
+ g_st_allocated_bytes += st_size;
+
+ return (char *) lpst_block + MAP_NODE_ALIGNMENT;
+}}
+
+ void operator delete ( void *lpv_memory ) noexcept
+{{
+ if ( ! lpv_memory ) {
+   return ;
+ }
+
+ size_t *lpst_block = (size_t *) ((uintptr_t) lpv_memory - MAP_NODE_ALIGNMENT);
+ g_st_allocated_bytes -= *lpst_block;
+ free ( lpst_block );
+}}
+
+ void operator delete ( void *lpv_memory, size_t ) noexcept
+{{
+ operator delete ( lpv_memory );
+}}
+
+ //A small xorshift generator, so that every run uses the same keys.
+ static uint64_t get_harness_random ( uint64_t *lpui64_state )
+{{
+ uint64_t x = *lpui64_state;
+ x ^= x << 13;
+ x ^= x >> 7;
+ x ^= x << 17;
+
+ return *lpui64_state = x;
+}}
+
+/*
+ The keys that every container is tested with. Each key exists as a C string (for MAP),
+ as a std::string (for std::unordered_map, so that its lookups don't have to build one),
+ and, for integer keys, as a uint64_t. The missing keys are never inserted.
+*/
+ struct HARNESS_KEYS {
+   uint8_t ui8_type; //HARNESS_KEYS_*
+   uint32_t ui32_count;
+   std::vector<char> keys; //ui32_count keys of HARNESS_KEY_LENGTH bytes each.
+   std::vector<char> missing_keys;
+   std::vector<std::string> key_strings;
+   std::vector<std::string> missing_key_strings;
+   std::vector<uint64_t> ids;
+   std::vector<uint64_t> missing_ids;
+ };
+
+ static void generate_harness_keys ( HARNESS_KEYS *lp_keys, uint8_t ui8_type, uint32_t ui32_count )
+{{
+ lp_keys ->ui8_type = ui8_type;
+ lp_keys ->ui32_count = ui32_count;
+ lp_keys ->keys .assign ( (size_t) ui32_count * HARNESS_KEY_LENGTH, 0 );
+ lp_keys ->missing_keys .assign ( (size_t) ui32_count * HARNESS_KEY_LENGTH, 0 );
+ lp_keys ->key_strings .clear (  );
+ lp_keys ->missing_key_strings .clear (  );
+ lp_keys ->ids .clear (  );
+ lp_keys ->missing_ids .clear (  );
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   char *lpsz_key = &lp_keys ->keys [ (size_t) ui32_i * HARNESS_KEY_LENGTH ];
+   char *lpsz_missing_key = &lp_keys ->missing_keys [ (size_t) ui32_i * HARNESS_KEY_LENGTH ];
+
+   if ( ui8_type == HARNESS_KEYS_INTEGER ) {
+     //Random IDs are distinct with overwhelming probability; the hit and miss counts would show it if they weren't.
+     lp_keys ->ids .push_back ( get_harness_random ( &ui64_state ) );
+     lp_keys ->missing_ids .push_back ( get_harness_random ( &ui64_state ) );
+     continue;
+   }
+
+   if ( ui8_type == HARNESS_KEYS_PREFIXED ) {
+     snprintf ( lpsz_key, HARNESS_KEY_LENGTH, "user:session:%010" PRIu32, ui32_i );
+     snprintf ( lpsz_missing_key, HARNESS_KEY_LENGTH, "User:session:%010" PRIu32, ui32_i );
+   }
+   else {
+     //The trailing index keeps the keys unique; the missing keys have a different length.
+     snprintf ( lpsz_key, HARNESS_KEY_LENGTH, "%016" PRIx64 "%08" PRIx32, get_harness_random ( &ui64_state ), ui32_i );
+     snprintf ( lpsz_missing_key, HARNESS_KEY_LENGTH, "%016" PRIx64 "%07" PRIx32, get_harness_random ( &ui64_state ), ui32_i );
+   }
+   lp_keys ->key_strings .push_back ( std::string ( lpsz_key ) );
+   lp_keys ->missing_key_strings .push_back ( std::string ( lpsz_missing_key ) );
+ }
+}}
+
+/*
+ Each container is wrapped in a class with the same methods, so that run_harness can
+ run the same workloads on any of them. Key number i is the i'th key of the HARNESS_KEYS.
+*/
+
+///user-defined callbacks.
+ static uint8_t free_harness_data ( void * )
+{{
+ return 1; //There's nothing inside of a uint32_t to free.
+}}
+
+ static int8_t compare_harness_data ( void *, void * )
+{{
+ return 0;
+}}
+
+ class MAP_HARNESS_TARGET {
+ public:
+   MAP m_map;
+   const HARNESS_KEYS *m_lp_keys;
+
+   MAP_HARNESS_TARGET ( const HARNESS_KEYS *lp_keys )
+  {{
+   this ->m_lp_keys = lp_keys;
+   if ( lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        initialize_integer_key_map ( &this ->m_map, sizeof ( uint32_t ), 0, compare_harness_data, free_harness_data );
+   else
+        initialize_map ( &this ->m_map, sizeof ( uint32_t ), 0, compare_harness_data, free_harness_data );
+  }}
+
+   ~MAP_HARNESS_TARGET (  )
+  {{
+   free_map ( &this ->m_map );
+  }}
+
+   const char *name ( void )
+  {{
+   return "MAP";
+  }}
+
+   //Inserting an existing key updates it, just as it does with operator[].
+   void set ( uint32_t ui32_i, uint32_t ui32_value )
+  {{
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        SET_MAP_INTEGER_NODE ( this ->m_map, this ->m_lp_keys ->ids [ ui32_i ], ui32_value );
+   else
+        SET_MAP_NODE ( this ->m_map, &this ->m_lp_keys ->keys [ (size_t) ui32_i * HARNESS_KEY_LENGTH ], ui32_value );
+  }}
+
+   //Returns 1 if the key was found with the expected value; b_missing looks up the i'th missing key, instead.
+   uint8_t find ( uint32_t ui32_i, uint8_t b_missing, uint32_t ui32_value )
+  {{
+   uint32_t *lpui32_data;
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        lpui32_data = (uint32_t *) find_map_integer_node_data (
+          &this ->m_map,
+          b_missing ? this ->m_lp_keys ->missing_ids [ ui32_i ] : this ->m_lp_keys ->ids [ ui32_i ]
+        );
+   else
+        lpui32_data = (uint32_t *) find_map_node_data (
+          &this ->m_map,
+          &(b_missing ? this ->m_lp_keys ->missing_keys : this ->m_lp_keys ->keys) [ (size_t) ui32_i * HARNESS_KEY_LENGTH ]
+        );
+
+   return lpui32_data && *lpui32_data == ui32_value;
+  }}
+
+   uint8_t erase ( uint32_t ui32_i )
+  {{
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        return free_map_integer_node ( &this ->m_map, this ->m_lp_keys ->ids [ ui32_i ] );
+
+   return free_map_node ( &this ->m_map, &this ->m_lp_keys ->keys [ (size_t) ui32_i * HARNESS_KEY_LENGTH ] );
+  }}
+
+   //This walks every key in insertion order and returns the sum of their values.
+   uint64_t iterate ( void )
+  {{
+   uint64_t ui64_sum = 0;
+   for ( uint32_t ui32_i = 0; ui32_i < this ->m_map .ui32_count; ui32_i ++ )
+        ui64_sum += MAP_DATA_AT ( uint32_t, this ->m_map, ui32_i );
+
+   return ui64_sum;
+  }}
+
+   uint32_t size ( void )
+  {{
+   return this ->m_map .ui32_count;
+  }}
+
+   //The map allocates with malloc, so it counts its own memory instead of using what operator new counted.
+   size_t memory_usage ( size_t )
+  {{
+   return get_map_memory_usage ( &this ->m_map );
+  }}
+
+   void dump_occupancy ( void );
+ };
+
+ class UNORDERED_MAP_HARNESS_TARGET {
+ public:
+   std::unordered_map<std::string, uint32_t> m_strings;
+   std::unordered_map<uint64_t, uint32_t> m_integers;
+   const HARNESS_KEYS *m_lp_keys;
+
+   UNORDERED_MAP_HARNESS_TARGET ( const HARNESS_KEYS *lp_keys )
+  {{
+   this ->m_lp_keys = lp_keys;
+  }}
+
+   const char *name ( void )
+  {{
+   return "std::unordered_map";
+  }}
+
+   void set ( uint32_t ui32_i, uint32_t ui32_value )
+  {{
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        this ->m_integers [ this ->m_lp_keys ->ids [ ui32_i ] ] = ui32_value;
+   else
+        this ->m_strings [ this ->m_lp_keys ->key_strings [ ui32_i ] ] = ui32_value;
+  }}
+
+   uint8_t find ( uint32_t ui32_i, uint8_t b_missing, uint32_t ui32_value )
+  {{
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER ) {
+        std::unordered_map<uint64_t, uint32_t>::iterator it = this ->m_integers .find (
+          b_missing ? this ->m_lp_keys ->missing_ids [ ui32_i ] : this ->m_lp_keys ->ids [ ui32_i ]
+        );
+        return it != this ->m_integers .end (  ) && it ->second == ui32_value;
+   }
+
+   std::unordered_map<std::string, uint32_t>::iterator it = this ->m_strings .find (
+     b_missing ? this ->m_lp_keys ->missing_key_strings [ ui32_i ] : this ->m_lp_keys ->key_strings [ ui32_i ]
+   );
+   return it != this ->m_strings .end (  ) && it ->second == ui32_value;
+  }}
+
+   uint8_t erase ( uint32_t ui32_i )
+  {{
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER )
+        return this ->m_integers .erase ( this ->m_lp_keys ->ids [ ui32_i ] ) == 1;
+
+   return this ->m_strings .erase ( this ->m_lp_keys ->key_strings [ ui32_i ] ) == 1;
+  }}
+
+   uint64_t iterate ( void )
+  {{
+   uint64_t ui64_sum = 0;
+   if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER ) {
+        for ( std::unordered_map<uint64_t, uint32_t>::iterator it = this ->m_integers .begin (  ); it != this ->m_integers .end (  ); ++ it )
+             ui64_sum += it ->second;
+   }
+   else {
+        for ( std::unordered_map<std::string, uint32_t>::iterator it = this ->m_strings .begin (  ); it != this ->m_strings .end (  ); ++ it )
+             ui64_sum += it ->second;
+   }
+
+   return ui64_sum;
+  }}
+
+   uint32_t size ( void )
+  {{
+   return (uint32_t) (this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER ? this ->m_integers .size (  ) : this ->m_strings .size (  ));
+  }}
+
+   //st_new_bytes is how much was allocated with new while the keys were being inserted.
+   size_t memory_usage ( size_t st_new_bytes )
+  {{
+   return st_new_bytes;
+  }}
+
+   void dump_occupancy ( void );
+ };
+
+/*
+ This will print one line of a histogram: the label, the count, and a bar that's
+ HARNESS_HISTOGRAM_WIDTH characters long for the largest count (ui64_largest).
+*/
+ static void print_harness_histogram_line ( const char *lpsz_label, uint64_t ui64_count, uint64_t ui64_largest )
+{{
+ char sz_bar [ HARNESS_HISTOGRAM_WIDTH + 1 ];
+ uint32_t ui32_width = ui64_largest ? (uint32_t) ((ui64_count * HARNESS_HISTOGRAM_WIDTH + ui64_largest - 1) / ui64_largest) : 0;
+ memset ( sz_bar, '#', ui32_width );
+ sz_bar [ ui32_width ] = 0;
+
+ fprintf ( stdout, "    %8s %10" PRIu64 " %s\n", lpsz_label, ui64_count, sz_bar );
+}}
+
+//This will print every non-zero bucket of a histogram; the last bucket counts everything at least that large.
+ static void print_harness_histogram ( const char *lpsz_title, const uint32_t *lpui32_buckets, uint32_t ui32_buckets, uint32_t ui32_first )
+{{
+ uint64_t ui64_largest = 0;
+ for ( uint32_t ui32_i = ui32_first; ui32_i < ui32_buckets; ui32_i ++ ) {
+   ui64_largest = std::max ( ui64_largest, (uint64_t) lpui32_buckets [ ui32_i ] );
+ }
+
+ fprintf ( stdout, "  %s\n", lpsz_title );
+ for ( uint32_t ui32_i = ui32_first; ui32_i < ui32_buckets; ui32_i ++ ) {
+   if ( ! lpui32_buckets [ ui32_i ] ) {
+     continue;
+   }
+
+   char sz_label [ 16 ];
+   snprintf ( sz_label, sizeof ( sz_label ), ui32_i == ui32_buckets - 1 ? "%" PRIu32 "+" : "%" PRIu32, ui32_i );
+   print_harness_histogram_line ( sz_label, lpui32_buckets [ ui32_i ], ui64_largest );
+ }
+}}
+
+ void MAP_HARNESS_TARGET::dump_occupancy ( void )
+{{
+ MAP_OCCUPANCY occupancy;
+ if ( ! get_map_occupancy ( &this ->m_map, &occupancy ) || ! occupancy .ui32_used_slots ) {
+   return ;
+ }
+
+ fprintf (
+   stdout,
+   "  MAP occupancy: %" PRIu32 " of %" PRIu32 " slots used (%.1f%%); average probe: hit %.3f, miss %.3f slots; "
+   "longest displacement %" PRIu32 "; longest run %" PRIu32 "\n",
+   occupancy .ui32_used_slots,
+   occupancy .ui32_slot_count,
+   100.0 * occupancy .ui32_used_slots / occupancy .ui32_slot_count,
+   (double) occupancy .ui64_displacement / occupancy .ui32_used_slots + 1,
+   (double) occupancy .ui64_miss_probes / occupancy .ui32_slot_count,
+   occupancy .ui32_longest_displacement,
+   occupancy .ui32_longest_run
+ );
+ print_harness_histogram ( "displacement from the home slot (nodes):", occupancy .ui32_displacements, MAP_OCCUPANCY_HISTOGRAM_SIZE, 0 );
+ print_harness_histogram ( "runs of occupied slots (by length):", occupancy .ui32_runs, MAP_OCCUPANCY_HISTOGRAM_SIZE, 1 );
+ char sz_title [ 64 ];
+ snprintf ( sz_title, sizeof ( sz_title ), "used slots per region of %d slots (regions):", MAP_OCCUPANCY_REGION_SIZE );
+ print_harness_histogram ( sz_title, occupancy .ui32_regions, MAP_OCCUPANCY_REGION_SIZE + 1, 0 );
+}}
+
+ void UNORDERED_MAP_HARNESS_TARGET::dump_occupancy ( void )
+{{
+ uint32_t ui32_sizes [ MAP_OCCUPANCY_HISTOGRAM_SIZE ] = { 0 };
+ size_t st_buckets, st_size;
+ if ( this ->m_lp_keys ->ui8_type == HARNESS_KEYS_INTEGER ) {
+   st_buckets = this ->m_integers .bucket_count (  );
+   st_size = this ->m_integers .size (  );
+   for ( size_t st_i = 0; st_i < st_buckets; st_i ++ )
+        ui32_sizes [ std::min ( this ->m_integers .bucket_size ( st_i ), (size_t) MAP_OCCUPANCY_HISTOGRAM_SIZE - 1 ) ] ++;
+ }
+ else {
+   st_buckets = this ->m_strings .bucket_count (  );
+   st_size = this ->m_strings .size (  );
+   for ( size_t st_i = 0; st_i < st_buckets; st_i ++ )
+        ui32_sizes [ std::min ( this ->m_strings .bucket_size ( st_i ), (size_t) MAP_OCCUPANCY_HISTOGRAM_SIZE - 1 ) ] ++;
+ }
+
+ fprintf ( stdout, "  std::unordered_map occupancy: %zu keys in %zu buckets (load factor %.3f)\n", st_size, st_buckets, (double) st_size / st_buckets );
+ print_harness_histogram ( "keys per bucket (buckets):", ui32_sizes, MAP_OCCUPANCY_HISTOGRAM_SIZE, 0 );
+}}
+
+ typedef std::chrono::steady_clock HARNESS_CLOCK;
+
+ static double get_harness_seconds ( HARNESS_CLOCK::time_point start )
+{{
+ return std::chrono::duration<double> ( HARNESS_CLOCK::now (  ) - start ) .count (  );
+}}
+
+ static uint32_t get_harness_nanoseconds ( HARNESS_CLOCK::time_point start, HARNESS_CLOCK::time_point end )
+{{
+ return (uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds> ( end - start ) .count (  );
+}}
+
+/*
+ This will print one workload's results: its throughput and, if lp_latencies isn't 0,
+ its 50th, 90th, 99th, and 99.9th percentile and longest latencies. b_correct is
+ whether every operation did what it should have.
+*/
+ static void print_harness_result (
+   const char *lpsz_target,
+   const char *lpsz_workload,
+   uint32_t ui32_count,
+   double dbl_seconds,
+   std::vector<uint32_t> *lp_latencies,
+   uint8_t b_correct
+ )
+{{
+ fprintf ( stdout, "  %-18s %-7s %9.3f Mops/s", lpsz_target, lpsz_workload, ui32_count / dbl_seconds / 1e6 );
+
+ if ( lp_latencies && ! lp_latencies ->empty (  ) ) {
+   std::sort ( lp_latencies ->begin (  ), lp_latencies ->end (  ) );
+   size_t st_last = lp_latencies ->size (  ) - 1;
+   fprintf (
+     stdout,
+     "; latency p50 %6" PRIu32 " ns, p90 %6" PRIu32 " ns, p99 %6" PRIu32 " ns, p99.9 %7" PRIu32 " ns, max %8" PRIu32 " ns",
+     (*lp_latencies) [ st_last * 50 / 100 ],
+     (*lp_latencies) [ st_last * 90 / 100 ],
+     (*lp_latencies) [ st_last * 99 / 100 ],
+     (*lp_latencies) [ st_last * 999 / 1000 ],
+     (*lp_latencies) [ st_last ]
+   );
+ }
+
+ fprintf ( stdout, "%s\n", b_correct ? "" : " (INCORRECT RESULTS)" );
+}}
+
+/*
+ This will run every workload on two identical TARGET containers: the first, untimed per
+ operation, for throughput; the second, with every operation timed, for latencies.
+*/
+ template <class TARGET> static void run_harness ( const HARNESS_KEYS *lp_keys )
+{{
+ TARGET throughput_target ( lp_keys ), latency_target ( lp_keys );
+ uint32_t ui32_count = lp_keys ->ui32_count;
+ std::vector<uint32_t> latencies ( ui32_count );
+ uint32_t ui32_correct;
+ HARNESS_CLOCK::time_point start, end;
+
+ //insert
+ size_t st_allocated_bytes = g_st_allocated_bytes;
+ start = HARNESS_CLOCK::now (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ )
+      throughput_target .set ( ui32_i, ui32_i );
+ double dbl_seconds = get_harness_seconds ( start );
+ size_t st_memory = throughput_target .memory_usage ( g_st_allocated_bytes - st_allocated_bytes );
+
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   start = HARNESS_CLOCK::now (  );
+   latency_target .set ( ui32_i, ui32_i );
+   end = HARNESS_CLOCK::now (  );
+   latencies [ ui32_i ] = get_harness_nanoseconds ( start, end );
+ }
+ print_harness_result ( throughput_target .name (  ), "insert", ui32_count, dbl_seconds, &latencies, throughput_target .size (  ) == ui32_count );
+
+ //hit and miss
+ for ( uint8_t b_missing = 0; b_missing < 2; b_missing ++ ) {
+   ui32_correct = 0;
+   start = HARNESS_CLOCK::now (  );
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ )
+        ui32_correct += throughput_target .find ( ui32_i, b_missing, ui32_i );
+   dbl_seconds = get_harness_seconds ( start );
+
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+     start = HARNESS_CLOCK::now (  );
+     ui32_correct += latency_target .find ( ui32_i, b_missing, ui32_i );
+     end = HARNESS_CLOCK::now (  );
+     latencies [ ui32_i ] = get_harness_nanoseconds ( start, end );
+   }
+   print_harness_result (
+     throughput_target .name (  ),
+     b_missing ? "miss" : "hit",
+     ui32_count,
+     dbl_seconds,
+     &latencies,
+     ui32_correct == (b_missing ? 0 : 2 * ui32_count)
+   );
+ }
+
+ //update
+ start = HARNESS_CLOCK::now (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ )
+      throughput_target .set ( ui32_i, ui32_i + 1 );
+ dbl_seconds = get_harness_seconds ( start );
+
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   start = HARNESS_CLOCK::now (  );
+   latency_target .set ( ui32_i, ui32_i + 1 );
+   end = HARNESS_CLOCK::now (  );
+   latencies [ ui32_i ] = get_harness_nanoseconds ( start, end );
+ }
+ ui32_correct = throughput_target .size (  ) == ui32_count && throughput_target .find ( ui32_count - 1, 0, ui32_count );
+ print_harness_result ( throughput_target .name (  ), "update", ui32_count, dbl_seconds, &latencies, ui32_correct );
+
+ //iterate (there's no per-key latency to measure; the whole walk is one operation)
+ start = HARNESS_CLOCK::now (  );
+ uint64_t ui64_sum = throughput_target .iterate (  );
+ dbl_seconds = get_harness_seconds ( start );
+ print_harness_result (
+   throughput_target .name (  ),
+   "iterate",
+   ui32_count,
+   dbl_seconds,
+   0,
+   ui64_sum == (uint64_t) ui32_count * (ui32_count + 1) / 2
+ );
+
+ fprintf ( stdout, "  %-18s memory  %9.1f bytes/key\n", throughput_target .name (  ), (double) st_memory / ui32_count );
+ throughput_target .dump_occupancy (  );
+
+ //delete
+ ui32_correct = 0;
+ start = HARNESS_CLOCK::now (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ )
+      ui32_correct += throughput_target .erase ( ui32_i );
+ dbl_seconds = get_harness_seconds ( start );
+
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   start = HARNESS_CLOCK::now (  );
+   ui32_correct += latency_target .erase ( ui32_i );
+   end = HARNESS_CLOCK::now (  );
+   latencies [ ui32_i ] = get_harness_nanoseconds ( start, end );
+ }
+ print_harness_result (
+   throughput_target .name (  ),
+   "delete",
+   ui32_count,
+   dbl_seconds,
+   &latencies,
+   ui32_correct == 2 * ui32_count && ! throughput_target .size (  ) && ! latency_target .size (  )
+ );
+}}
+
+//This will return the median time between two back-to-back clock readings, which every latency includes.
+ static uint32_t get_harness_timer_overhead ( void )
+{{
+ std::vector<uint32_t> samples ( 10001 );
+ for ( size_t st_i = 0; st_i < samples .size (  ); st_i ++ ) {
+   HARNESS_CLOCK::time_point start = HARNESS_CLOCK::now (  );
+   samples [ st_i ] = get_harness_nanoseconds ( start, HARNESS_CLOCK::now (  ) );
+ }
+ std::nth_element ( samples .begin (  ), samples .begin (  ) + samples .size (  ) / 2, samples .end (  ) );
+
+ return samples [ samples .size (  ) / 2 ];
+}}
+
+ int main ( int argc, char **argv )
+{{
+ uint8_t ui8_type = HARNESS_KEYS_PREFIXED;
+ const char *lpsz_type = "prefixed";
+ if ( argc > 1 ) {
+   lpsz_type = argv [ 1 ];
+   if ( ! strcmp ( lpsz_type, "prefixed" ) )
+        ui8_type = HARNESS_KEYS_PREFIXED;
+   else if ( ! strcmp ( lpsz_type, "random" ) )
+        ui8_type = HARNESS_KEYS_RANDOM;
+   else if ( ! strcmp ( lpsz_type, "integer" ) )
+        ui8_type = HARNESS_KEYS_INTEGER;
+   else {
+        fprintf ( stderr, "Usage: %s [prefixed|random|integer] [key count ...]\n", argv [ 0 ] );
+        return 1;
+   }
+ }
+
+ std::vector<uint32_t> counts;
+ for ( int i = 2; i < argc; i ++ ) {
+   counts .push_back ( (uint32_t) strtoul ( argv [ i ], 0, 10 ) );
+ }
+ if ( counts .empty (  ) ) {
+   counts .push_back ( 100000 );
+   counts .push_back ( 1000000 );
+ }
+
+ fprintf ( stdout, "Timer overhead (included in every latency): %" PRIu32 " ns\n", get_harness_timer_overhead (  ) );
+
+ HARNESS_KEYS keys;
+ for ( size_t st_i = 0; st_i < counts .size (  ); st_i ++ ) {
+   if ( ! counts [ st_i ] ) {
+     continue;
+   }
+
+   generate_harness_keys ( &keys, ui8_type, counts [ st_i ] );
+   fprintf ( stdout, "%" PRIu32 " %s keys:\n", counts [ st_i ], lpsz_type );
+   run_harness<MAP_HARNESS_TARGET> ( &keys );
+   run_harness<UNORDERED_MAP_HARNESS_TARGET> ( &keys );
+ }
+
+ return 0;
+}}
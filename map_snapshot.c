@@ -0,0 +1,381 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the map snapshot files described in map_snapshot.h.
+
+ To compile (with the benchmark):
+   gcc -O2 map.c mapped_file.c map_snapshot.c map_snapshot_benchmark.c -o map_snapshot_benchmark
+*/
+ #include "map_snapshot.h"
+
+ //Round X up to the next multiple of MAP_SNAPSHOT_ALIGNMENT.
+ #define MAP_SNAPSHOT_ALIGN(X) ( ((X) + MAP_SNAPSHOT_ALIGNMENT - 1) & ~(uint64_t) (MAP_SNAPSHOT_ALIGNMENT - 1) )
+
+ //This will write ui64_count zeroes to the file. Returns 0, if they couldn't be written.
+ static uint8_t write_map_snapshot_padding ( FILE *lp_file, uint64_t ui64_count )
+{{
+ static const char sz_zeroes [ MAP_SNAPSHOT_ALIGNMENT ] = { 0 };
+
+ return ! ui64_count || fwrite ( sz_zeroes, (size_t) ui64_count, 1, lp_file ) == 1;
+}}
+
+/*
+ This will write the map to a temporary file and then rename it over lpsz_path (see
+ create_mapped_file), so processes that have the old snapshot open keep reading it, and the
+ old snapshot is only replaced once the new one is complete.
+ Returns 0 (leaving any old file alone), if the file couldn't be written, memory couldn't be
+ allocated, or the map has binary keys.
+*/
+ uint8_t save_map_snapshot ( MAP *lpm_map, const char *lpsz_path )
+{{
+ if ( ! lpm_map || ! lpsz_path ) {
+   return 0;
+ }
+ //The file stores string keys (see MAP_SNAPSHOT_ENTRY).
+ if ( lpm_map ->ui32_key_size ) {
+   return 0;
+ }
+
+ MAP_SNAPSHOT_HEADER header;
+ memset ( &header, 0, sizeof ( MAP_SNAPSHOT_HEADER ) );
+ set_mapped_file_signature ( &header .signature, MAP_SNAPSHOT_MAGIC, MAP_SNAPSHOT_VERSION );
+ header .ui32_count = lpm_map ->ui32_count;
+ header .ui32_data_size = lpm_map ->ui32_data_size;
+
+ //The table is sized like the map's own, so that it's never more than three quarters full.
+ uint64_t ui64_slot_count = MAP_INITIAL_SLOT_COUNT;
+ while ( (uint64_t) header .ui32_count * MAP_MAXIMUM_LOAD_DENOMINATOR > ui64_slot_count * MAP_MAXIMUM_LOAD_NUMERATOR ) {
+   ui64_slot_count <<= 1;
+ }
+ if ( ui64_slot_count > 0x80000000ULL ) {
+   return 0;
+ }
+ header .ui32_slot_count = (uint32_t) ui64_slot_count;
+
+ uint64_t *lpary_order = (uint64_t *) malloc ( ((size_t) header .ui32_count + 1) * sizeof ( uint64_t ) );
+ MAP_SNAPSHOT_SLOT *lpary_slots = (MAP_SNAPSHOT_SLOT *) calloc ( (size_t) ui64_slot_count, sizeof ( MAP_SNAPSHOT_SLOT ) );
+ MAPPED_FILE_WRITER writer;
+ FILE *lp_file = create_mapped_file ( &writer, lpsz_path );
+ uint8_t b_success = lpary_order && lpary_slots && lp_file;
+
+ //Leave room for the header (zeroed out, so it has no magic number yet), which is
+ //filled in once everything else has been written.
+ uint64_t ui64_offset = MAP_SNAPSHOT_ALIGN ( sizeof ( MAP_SNAPSHOT_HEADER ) );
+ for ( uint64_t ui64_i = 0; b_success && ui64_i < ui64_offset; ui64_i += MAP_SNAPSHOT_ALIGNMENT ) {
+   b_success = write_map_snapshot_padding ( lp_file, MAP_SNAPSHOT_ALIGNMENT );
+ }
+ header .ui64_entries_offset = ui64_offset;
+
+ uint32_t ui32_mask = header .ui32_slot_count - 1;
+ uint32_t ui32_i = 0;
+ for ( DOUBLY_LINKED_LIST *node = lpm_map ->lp_first_node; b_success && node; node = node ->lp_next ) {
+   MAP_SNAPSHOT_ENTRY entry;
+   memset ( &entry, 0, sizeof ( MAP_SNAPSHOT_ENTRY ) );
+   entry .ui32_key_length = (uint32_t) strlen ( node ->lpsz_key );
+
+   uint64_t ui64_entry_size = sizeof ( MAP_SNAPSHOT_ENTRY ) + header .ui32_data_size + entry .ui32_key_length + 1;
+   b_success = fwrite ( &entry, sizeof ( MAP_SNAPSHOT_ENTRY ), 1, lp_file ) == 1 &&
+               ( ! header .ui32_data_size || fwrite ( node ->lpv_data, header .ui32_data_size, 1, lp_file ) == 1 ) &&
+               fwrite ( node ->lpsz_key, entry .ui32_key_length + 1, 1, lp_file ) == 1 &&
+               write_map_snapshot_padding ( lp_file, MAP_SNAPSHOT_ALIGN ( ui64_entry_size ) - ui64_entry_size );
+
+   lpary_order [ ui32_i ++ ] = ui64_offset;
+
+   //The node already knows its hash, so the keys don't need to be hashed again.
+   uint32_t ui32_slot = (uint32_t) node ->ui64_hash & ui32_mask;
+   while ( lpary_slots [ ui32_slot ] .ui64_entry_offset ) {
+     ui32_slot = (ui32_slot + 1) & ui32_mask;
+   }
+   lpary_slots [ ui32_slot ] .ui64_hash = node ->ui64_hash;
+   lpary_slots [ ui32_slot ] .ui64_entry_offset = ui64_offset;
+
+   ui64_offset += MAP_SNAPSHOT_ALIGN ( ui64_entry_size );
+ }
+
+ header .ui64_order_offset = ui64_offset;
+ uint64_t ui64_order_size = (uint64_t) header .ui32_count * sizeof ( uint64_t );
+ b_success = b_success &&
+             ( ! ui64_order_size || fwrite ( lpary_order, (size_t) ui64_order_size, 1, lp_file ) == 1 ) &&
+             write_map_snapshot_padding ( lp_file, MAP_SNAPSHOT_ALIGN ( ui64_order_size ) - ui64_order_size );
+
+ header .ui64_slots_offset = ui64_offset + MAP_SNAPSHOT_ALIGN ( ui64_order_size );
+ header .ui64_file_size = header .ui64_slots_offset + ui64_slot_count * sizeof ( MAP_SNAPSHOT_SLOT );
+ b_success = b_success &&
+             fwrite ( lpary_slots, sizeof ( MAP_SNAPSHOT_SLOT ), (size_t) ui64_slot_count, lp_file ) == ui64_slot_count;
+
+ //Now that the file is complete, the header can say so.
+ b_success = b_success && ! fseek ( lp_file, 0, SEEK_SET ) &&
+             fwrite ( &header, sizeof ( MAP_SNAPSHOT_HEADER ), 1, lp_file ) == 1;
+
+ free ( lpary_order );
+ free ( lpary_slots );
+
+ //This replaces the old file (if any) only if everything was written.
+ b_success = finish_mapped_file ( &writer, b_success );
+ if ( ! b_success ) {
+   fprintf ( stderr, "save_map_snapshot: Error: We couldn't write \"%s\".\n", lpsz_path );
+ }
+
+ return b_success;
+}}
+
+///callbacks for the map of hidden keys, which only holds a placeholder byte for each.
+ static uint8_t free_map_snapshot_hidden_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1;
+}}
+
+ static int8_t compare_map_snapshot_hidden_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0;
+}}
+
+/*
+ This will map the file at lpsz_path into memory so that it can be searched right away.
+ The callbacks are used for the overlay map that holds changed keys (see initialize_map);
+ the user-data in the overlay is copied from the file or from set_map_snapshot_node.
+ Returns 0, if the file couldn't be opened or isn't a snapshot that this version can read.
+*/
+ uint8_t open_map_snapshot (
+   MAP_SNAPSHOT *lp_snapshot,
+   const char *lpsz_path,
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ )
+{{
+ if ( ! lp_snapshot || ! lpsz_path ) {
+   return 0;
+ }
+
+ memset ( lp_snapshot, 0, sizeof ( MAP_SNAPSHOT ) );
+ if ( ! open_mapped_file ( &lp_snapshot ->file, lpsz_path, sizeof ( MAP_SNAPSHOT_HEADER ) ) ) {
+   return 0;
+ }
+
+ //Make sure that everything the header points to is inside of the file before trusting it.
+ const MAP_SNAPSHOT_HEADER *lp_header = (const MAP_SNAPSHOT_HEADER *) lp_snapshot ->file .lp_base;
+ uint8_t b_valid = is_mapped_file_signature ( &lp_header ->signature, MAP_SNAPSHOT_MAGIC, MAP_SNAPSHOT_VERSION ) &&
+                   lp_header ->ui64_file_size == lp_snapshot ->file .st_size &&
+                   lp_header ->ui32_slot_count && ! (lp_header ->ui32_slot_count & (lp_header ->ui32_slot_count - 1)) &&
+                   lp_header ->ui32_count < lp_header ->ui32_slot_count &&
+                   ! (lp_header ->ui64_order_offset % MAP_SNAPSHOT_ALIGNMENT) &&
+                   ! (lp_header ->ui64_slots_offset % MAP_SNAPSHOT_ALIGNMENT) &&
+                   lp_header ->ui64_order_offset <= lp_snapshot ->file .st_size &&
+                   (lp_snapshot ->file .st_size - lp_header ->ui64_order_offset) / sizeof ( uint64_t ) >= lp_header ->ui32_count &&
+                   lp_header ->ui64_slots_offset <= lp_snapshot ->file .st_size &&
+                   (lp_snapshot ->file .st_size - lp_header ->ui64_slots_offset) / sizeof ( MAP_SNAPSHOT_SLOT ) >= lp_header ->ui32_slot_count;
+ if ( ! b_valid ) {
+   fprintf ( stderr, "open_map_snapshot: Error: \"%s\" isn't a snapshot that we can read.\n", lpsz_path );
+   close_mapped_file ( &lp_snapshot ->file );
+   return 0;
+ }
+
+ lp_snapshot ->lp_header = lp_header;
+ lp_snapshot ->lpary_order = (const uint64_t *) (lp_snapshot ->file .lp_base + lp_header ->ui64_order_offset);
+ lp_snapshot ->lpary_slots = (const MAP_SNAPSHOT_SLOT *) (lp_snapshot ->file .lp_base + lp_header ->ui64_slots_offset);
+
+ initialize_map ( &lp_snapshot ->overlay, lp_header ->ui32_data_size, 0, lpfn_sort_comparator_function, lpfn_free );
+ initialize_map ( &lp_snapshot ->hidden, 1, 0, compare_map_snapshot_hidden_data, free_map_snapshot_hidden_data );
+
+ return 1;
+}}
+
+/*
+ This will return the entry at the specified offset in the file, and set *lplpsz_key and
+ *lplpv_data to its key and user-data, or return 0, if the entry doesn't fit in the file.
+*/
+ static const MAP_SNAPSHOT_ENTRY *get_map_snapshot_entry (
+   MAP_SNAPSHOT *lp_snapshot,
+   uint64_t ui64_offset,
+   const char **lplpsz_key,
+   const void **lplpv_data
+ )
+{{
+ uint64_t ui64_data_size = lp_snapshot ->lp_header ->ui32_data_size;
+ if ( ui64_offset % MAP_SNAPSHOT_ALIGNMENT ||
+      ui64_offset > lp_snapshot ->file .st_size ||
+      lp_snapshot ->file .st_size - ui64_offset < sizeof ( MAP_SNAPSHOT_ENTRY ) + ui64_data_size
+    ) {
+   return 0;
+ }
+
+ const MAP_SNAPSHOT_ENTRY *lp_entry = (const MAP_SNAPSHOT_ENTRY *) (lp_snapshot ->file .lp_base + ui64_offset);
+ uint64_t ui64_key_offset = ui64_offset + sizeof ( MAP_SNAPSHOT_ENTRY ) + ui64_data_size;
+ if ( lp_entry ->ui32_key_length >= lp_snapshot ->file .st_size - ui64_key_offset ||
+      lp_snapshot ->file .lp_base [ ui64_key_offset + lp_entry ->ui32_key_length ]
+    ) {
+   return 0;
+ }
+
+ *lplpv_data = lp_entry + 1;
+ *lplpsz_key = lp_snapshot ->file .lp_base + ui64_key_offset;
+
+ return lp_entry;
+}}
+
+ //This will return the user-data for the key in the file (ignoring the overlay), or 0, if it isn't in the file.
+ static const void *find_map_snapshot_file_data ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key )
+{{
+ uint64_t ui64_hash = get_map_key_hash ( lpsz_key );
+ uint32_t ui32_mask = lp_snapshot ->lp_header ->ui32_slot_count - 1;
+ uint32_t ui32_slot = (uint32_t) ui64_hash & ui32_mask;
+
+ //There's always at least one empty slot, but a damaged file might not have one.
+ for ( uint32_t ui32_probes = 0; ui32_probes <= ui32_mask; ui32_probes ++ ) {
+   const MAP_SNAPSHOT_SLOT *lp_slot = &lp_snapshot ->lpary_slots [ ui32_slot ];
+   if ( ! lp_slot ->ui64_entry_offset ) {
+     return 0;
+   }
+
+   const char *lpsz_entry_key;
+   const void *lpv_data;
+   if ( lp_slot ->ui64_hash == ui64_hash &&
+        get_map_snapshot_entry ( lp_snapshot, lp_slot ->ui64_entry_offset, &lpsz_entry_key, &lpv_data ) &&
+        ! strcmp ( lpsz_entry_key, lpsz_key )
+      ) {
+     return lpv_data;
+   }
+
+   ui32_slot = (ui32_slot + 1) & ui32_mask;
+ }
+
+ return 0;
+}}
+
+/*
+ This will return the user-data for the key (read-only), or 0, if it doesn't exist.
+ Keys that have been changed since the file was opened come from the overlay; everything
+ else points straight into the mapped file.
+*/
+ const void *find_map_snapshot_node_data ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header || ! lpsz_key || ! *lpsz_key ) {
+   return 0;
+ }
+
+ const void *lpv_data = find_map_node_data ( &lp_snapshot ->overlay, lpsz_key );
+ if ( lpv_data ) {
+   return lpv_data;
+ }
+
+ //If the key has been freed, the file's copy doesn't count any more.
+ if ( lp_snapshot ->hidden .ui32_count && find_map_node_data ( &lp_snapshot ->hidden, lpsz_key ) ) {
+   return 0;
+ }
+
+ return find_map_snapshot_file_data ( lp_snapshot, lpsz_key );
+}}
+
+/*
+ This will return user-data for the key that can be written to, copying it out of the
+ file and into the overlay the first time, or 0, if the key doesn't exist.
+*/
+ void *get_map_snapshot_node_data_for_writing ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header || ! lpsz_key || ! *lpsz_key ) {
+   return 0;
+ }
+
+ void *lpv_data = find_map_node_data ( &lp_snapshot ->overlay, lpsz_key );
+ if ( lpv_data ) {
+   return lpv_data;
+ }
+
+ const void *lpv_file_data = find_map_snapshot_node_data ( lp_snapshot, lpsz_key );
+ if ( ! lpv_file_data ) {
+   return 0;
+ }
+
+ if ( ! set_map_node__internal ( &lp_snapshot ->overlay, lpsz_key, (void *) lpv_file_data, 0 ) ) {
+   return 0;
+ }
+
+ return find_map_node_data ( &lp_snapshot ->overlay, lpsz_key );
+}}
+
+//This will add the key (or replace its user-data) in the overlay. Returns 0, if memory couldn't be allocated.
+ uint8_t set_map_snapshot_node ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key, const void *lpv_data )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header || ! lpsz_key || ! *lpsz_key || ! lpv_data ) {
+   return 0;
+ }
+
+ if ( ! set_map_node__internal ( &lp_snapshot ->overlay, lpsz_key, (void *) lpv_data, 0 ) ) {
+   return 0;
+ }
+
+ //The key is in the overlay, now, so it doesn't need to be hidden.
+ if ( lp_snapshot ->hidden .ui32_count ) {
+   free_map_node ( &lp_snapshot ->hidden, lpsz_key );
+ }
+
+ return 1;
+}}
+
+//This will remove the key from the overlay and hide it in the file. Returns 0, if it didn't exist.
+ uint8_t free_map_snapshot_node ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header || ! lpsz_key || ! *lpsz_key ) {
+   return 0;
+ }
+
+ uint8_t b_freed = free_map_node ( &lp_snapshot ->overlay, lpsz_key );
+
+ if ( ! find_map_node_data ( &lp_snapshot ->hidden, lpsz_key ) && find_map_snapshot_file_data ( lp_snapshot, lpsz_key ) ) {
+   uint8_t ui8_placeholder = 1;
+   if ( ! SET_MAP_NODE ( lp_snapshot ->hidden, lpsz_key, ui8_placeholder ) ) {
+     return 0;
+   }
+   b_freed = 1;
+ }
+
+ return b_freed;
+}}
+
+/*
+ This will set *lplpsz_key and *lplpv_data to the key and (current) user-data of the file's
+ entry at the specified zero-based position in insertion order. Keys added since the file
+ was opened are in lp_snapshot ->overlay, after any that were copied there to be changed.
+ Returns 0, if the position is out of bounds, the entry is damaged, or its key was freed.
+*/
+ uint8_t get_map_snapshot_entry_at (
+   MAP_SNAPSHOT *lp_snapshot,
+   uint32_t ui32_index,
+   const char **lplpsz_key,
+   const void **lplpv_data
+ )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header || ! lplpsz_key || ! lplpv_data ) {
+   return 0;
+ }
+ if ( ui32_index >= lp_snapshot ->lp_header ->ui32_count ) {
+   return 0;
+ }
+
+ if ( ! get_map_snapshot_entry ( lp_snapshot, lp_snapshot ->lpary_order [ ui32_index ], lplpsz_key, lplpv_data ) ) {
+   return 0;
+ }
+
+ if ( lp_snapshot ->overlay .ui32_count || lp_snapshot ->hidden .ui32_count ) {
+   *lplpv_data = find_map_snapshot_node_data ( lp_snapshot, *lplpsz_key );
+ }
+
+ return *lplpv_data != 0;
+}}
+
+//This will free the overlay and unmap the file.
+ uint8_t close_map_snapshot ( MAP_SNAPSHOT *lp_snapshot )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->lp_header ) {
+   return 0;
+ }
+
+ free_map ( &lp_snapshot ->overlay );
+ free_map ( &lp_snapshot ->hidden );
+ close_mapped_file ( &lp_snapshot ->file );
+ memset ( lp_snapshot, 0, sizeof ( MAP_SNAPSHOT ) );
+
+ return 1;
+}}
@@ -0,0 +1,98 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To save a map to a file that can be opened again instantly, instead of
+ rebuilding the map from its source data every time a program starts.
+
+ save_map_snapshot writes every key, its ui32_data_size bytes of user-data, and the
+ insertion order to one flat file, along with a ready-made hash table. Everything in
+ the file refers to everything else by its offset from the start of the file, so
+ open_map_snapshot can just map the file into memory (read-only) and start answering
+ lookups without reading or copying anything else.
+
+ Changes are copied into the heap, instead: set_map_snapshot_node and
+ get_map_snapshot_node_data_for_writing put a copy of the key in an overlay map,
+ which is checked before the file, and free_map_snapshot_node hides a key from the
+ file. The file itself is never changed: saving to the same path again writes a new file
+ and renames it over the old one, so processes that have the old one open keep using it.
+
+ The user-data is saved byte for byte, so it shouldn't hold any pointers. The file
+ can only be opened on a machine with the same byte order.
+
+ File layout (every offset is from the start of the file and a multiple of 16):
+   MAP_SNAPSHOT_HEADER
+   entries: MAP_SNAPSHOT_ENTRY, then ui32_data_size bytes of user-data, then the key and its terminating zero
+   order: uint64_t[ui32_count], the offset of each entry in insertion order
+   slots: MAP_SNAPSHOT_SLOT[ui32_slot_count], an open-addressed table (linear probing) of get_map_key_hash values
+
+ See map_snapshot.c for the implementation and
+ map_snapshot_benchmark.c for startup measurements.
+*/
+#ifndef MAP_SNAPSHOT_HEADER_DEFINED
+#define MAP_SNAPSHOT_HEADER_DEFINED 1
+ #include "map.h"
+ #include "mapped_file.h"
+
+ #define MAP_SNAPSHOT_MAGIC "MAPSNAP"
+ #define MAP_SNAPSHOT_VERSION 1
+ #define MAP_SNAPSHOT_ALIGNMENT 16
+
+ typedef struct MAP_SNAPSHOT_HEADER {
+   MAPPED_FILE_SIGNATURE signature; //MAP_SNAPSHOT_MAGIC and MAP_SNAPSHOT_VERSION
+   uint32_t ui32_count; //How many entries there are.
+   uint32_t ui32_data_size; //How many bytes of user-data each entry has.
+   uint32_t ui32_slot_count; //Always a power of two.
+   uint32_t ui32_reserved;
+   uint64_t ui64_entries_offset;
+   uint64_t ui64_order_offset;
+   uint64_t ui64_slots_offset;
+   uint64_t ui64_file_size;
+ } MAP_SNAPSHOT_HEADER;
+
+ typedef struct MAP_SNAPSHOT_ENTRY {
+   uint32_t ui32_key_length; //Not counting the terminating zero.
+   uint32_t ui32_reserved [ 3 ]; //Pads the entry to MAP_SNAPSHOT_ALIGNMENT bytes, so that the user-data is aligned.
+ } MAP_SNAPSHOT_ENTRY;
+
+ typedef struct MAP_SNAPSHOT_SLOT {
+   uint64_t ui64_hash;
+   uint64_t ui64_entry_offset; //0 = this slot is empty.
+ } MAP_SNAPSHOT_SLOT;
+
+ typedef struct MAP_SNAPSHOT {
+   MAPPED_FILE file;
+   const MAP_SNAPSHOT_HEADER *lp_header;
+   const MAP_SNAPSHOT_SLOT *lpary_slots;
+   const uint64_t *lpary_order;
+   MAP overlay; //Keys that have been set (or copied to be written to) since the file was opened.
+   MAP hidden; //Keys in the file that have been freed since it was opened.
+ } MAP_SNAPSHOT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ uint8_t save_map_snapshot ( MAP *lpm_map, const char *lpsz_path );
+
+ uint8_t open_map_snapshot (
+   MAP_SNAPSHOT *lp_snapshot,
+   const char *lpsz_path,
+   int8_t (*lpfn_sort_comparator_function)(void*,void*),
+   uint8_t (*lpfn_free)(void*)
+ );
+ const void *find_map_snapshot_node_data ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key );
+ void *get_map_snapshot_node_data_for_writing ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key );
+ uint8_t set_map_snapshot_node ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key, const void *lpv_data );
+ uint8_t free_map_snapshot_node ( MAP_SNAPSHOT *lp_snapshot, const char *lpsz_key );
+ uint8_t get_map_snapshot_entry_at (
+   MAP_SNAPSHOT *lp_snapshot,
+   uint32_t ui32_index,
+   const char **lplpsz_key,
+   const void **lplpv_data
+ );
+ uint8_t close_map_snapshot ( MAP_SNAPSHOT *lp_snapshot );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To compare starting up by rebuilding a map from its source data against
+ starting up by opening a snapshot of it (see map_snapshot.h).
+
+ Usage: map_snapshot_benchmark [key count (default: 10000000)] [snapshot path (default: map_snapshot_benchmark.snapshot)]
+ The snapshot file is removed when the benchmark is done. It was just written, so
+ it's probably still in the operating system's cache; the first lookups after a
+ reboot will be slower while its pages are read from the disk.
+
+ To compile:
+   gcc -O2 map.c mapped_file.c map_snapshot.c map_snapshot_benchmark.c -o map_snapshot_benchmark
+*/
+ #include "map_snapshot.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_KEY_LENGTH 32
+
+///user-defined callbacks.
+ static uint8_t free_benchmark_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1; //There's nothing inside of a uint64_t to free.
+}}
+
+ static int8_t compare_benchmark_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0;
+}}
+
+ int main ( int argc, char **argv )
+{{
+ uint32_t ui32_count = 10000000;
+ const char *lpsz_path = "map_snapshot_benchmark.snapshot";
+ if ( argc > 1 ) {
+   ui32_count = (uint32_t) strtoul ( argv [ 1 ], 0, 10 );
+ }
+ if ( argc > 2 ) {
+   lpsz_path = argv [ 2 ];
+ }
+ if ( ui32_count < 1000 ) {
+   fprintf ( stderr, "Error: The key count must be at least 1000.\n" );
+   return 1;
+ }
+
+ char *lpsz_keys = (char *) malloc ( (size_t) ui32_count * BENCHMARK_KEY_LENGTH );
+ if ( ! lpsz_keys ) {
+   fprintf ( stderr, "Error: We couldn't allocate memory for %" PRIu32 " keys.\n", ui32_count );
+   return 1;
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   snprintf ( lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, BENCHMARK_KEY_LENGTH, "user:session:%010" PRIu32, ui32_i );
+ }
+
+ //Starting up the slow way: building the map one key at a time.
+ MAP map;
+ initialize_map ( &map, sizeof ( uint64_t ), 0, compare_benchmark_data, free_benchmark_data );
+ double dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   uint64_t ui64_data = (uint64_t) ui32_i * 3;
+   SET_MAP_NODE ( map, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH, ui64_data );
+ }
+ double dbl_rebuild = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ uint8_t b_saved = save_map_snapshot ( &map, lpsz_path );
+ double dbl_save = get_benchmark_seconds (  ) - dbl_start;
+ free_map ( &map );
+ if ( ! b_saved ) {
+   free ( lpsz_keys );
+   return 1;
+ }
+
+ //Starting up the fast way: mapping the snapshot and looking a key up right away.
+ MAP_SNAPSHOT snapshot;
+ dbl_start = get_benchmark_seconds (  );
+ if ( ! open_map_snapshot ( &snapshot, lpsz_path, compare_benchmark_data, free_benchmark_data ) ) {
+   fprintf ( stderr, "Error: We couldn't open \"%s\".\n", lpsz_path );
+   remove ( lpsz_path );
+   free ( lpsz_keys );
+   return 1;
+ }
+ double dbl_open = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ const uint64_t *lpui64_first = (const uint64_t *) find_map_snapshot_node_data ( &snapshot, lpsz_keys + (size_t) (ui32_count / 2) * BENCHMARK_KEY_LENGTH );
+ double dbl_first_lookup = get_benchmark_seconds (  ) - dbl_start;
+
+ uint32_t ui32_found = lpui64_first && *lpui64_first == (uint64_t) (ui32_count / 2) * 3;
+ dbl_start = get_benchmark_seconds (  );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   const uint64_t *lpui64_data = (const uint64_t *) find_map_snapshot_node_data ( &snapshot, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH );
+   ui32_found += lpui64_data && *lpui64_data == (uint64_t) ui32_i * 3;
+ }
+ double dbl_lookups = get_benchmark_seconds (  ) - dbl_start;
+
+ //Change the first thousand keys (copying them into the heap) and free the next thousand.
+ uint8_t b_correct = ui32_found == ui32_count + 1;
+ for ( uint32_t ui32_i = 0; ui32_i < 1000; ui32_i ++ ) {
+   uint64_t *lpui64_data = (uint64_t *) get_map_snapshot_node_data_for_writing ( &snapshot, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH );
+   if ( lpui64_data ) {
+     *lpui64_data = 7;
+   }
+   free_map_snapshot_node ( &snapshot, lpsz_keys + (size_t) (ui32_i + 1000) * BENCHMARK_KEY_LENGTH );
+ }
+ for ( uint32_t ui32_i = 0; ui32_i < 3000; ui32_i ++ ) {
+   const uint64_t *lpui64_data = (const uint64_t *) find_map_snapshot_node_data ( &snapshot, lpsz_keys + (size_t) ui32_i * BENCHMARK_KEY_LENGTH );
+   uint64_t ui64_expected = ui32_i < 1000 ? 7 : (uint64_t) ui32_i * 3;
+   b_correct = b_correct && ( ui32_i >= 1000 && ui32_i < 2000 ? ! lpui64_data : lpui64_data && *lpui64_data == ui64_expected );
+ }
+
+ fprintf (
+   stdout,
+   "%" PRIu32 " keys: rebuild %.3f s; save %.3f s (%.1f MB); open %.6f s; first lookup %.6f s; "
+   "lookups from the snapshot %.3f Mops/s%s\n",
+   ui32_count,
+   dbl_rebuild,
+   dbl_save,
+   snapshot .file .st_size / 1e6,
+   dbl_open,
+   dbl_first_lookup,
+   ui32_count / dbl_lookups / 1e6,
+   b_correct ? "" : " (INCORRECT RESULTS)"
+ );
+
+ close_map_snapshot ( &snapshot );
+ remove ( lpsz_path );
+ free ( lpsz_keys );
+
+ return 0;
+}}
@@ -0,0 +1,785 @@
+/*
+ Created on 2022-04-08 by Jacob Bethany
+ Purpose: To move the example usage of the map out of map.c, and to check the map against
+ a plain array of its keys and values (kept by the functions below), covering:
+   - setting, updating, freeing (which shifts later keys back into the freed slot), and re-adding keys;
+   - MAP_KEY_AT/MAP_DATA_AT still going in insertion order after frees have left tombstones in the index;
+   - the ordered index: whole-map, range, and prefix iteration, and find_map_lower_bound;
+   - LRU and CLOCK caches: which key each one evicts, and their hit, miss, and eviction counts;
+   - maps with integer and binary keys.
+ Every failed check is shown, and the program returns 1, if there were any.
+
+ To compile:
+   gcc map.c map_test.c -o map
+ To see what the map is doing internally, too:
+   gcc -DMAP_TRACE_LEVEL=2 map.c map_test.c -o map
+*/
+ #include "map.h"
+
+ //The randomized checks pick their keys from this many IDs.
+ #define MAP_TEST_KEY_COUNT 4096
+ //Long enough that most of a binary key is zeros (see get_map_test_binary_key).
+ #define MAP_TEST_BINARY_KEY_SIZE 12
+ //How many failed checks are shown before the rest are only counted.
+ #define MAP_TEST_SHOWN_FAILURES 20
+
+ //Which kind of key the map in a check uses.
+ #define MAP_TEST_STRING_KEYS 0
+ #define MAP_TEST_INTEGER_KEYS 1
+ #define MAP_TEST_BINARY_KEYS 2
+
+/*
+ What a map should hold: the IDs of its keys in insertion order (or from least to most
+ recently used, for an LRU cache) and each ID's value. For a CLOCK cache, this also
+ tracks each key's referenced flag and how many of the keys come before the clock hand.
+*/
+ typedef struct MAP_TEST_REFERENCE {
+   uint32_t ui32_count;
+   uint32_t ui32_hand;
+   uint32_t ui32_order [ MAP_TEST_KEY_COUNT ];
+   int32_t i32_values [ MAP_TEST_KEY_COUNT ];
+   uint8_t b_present [ MAP_TEST_KEY_COUNT ];
+   uint8_t b_referenced [ MAP_TEST_KEY_COUNT ];
+ } MAP_TEST_REFERENCE;
+
+ //The string key for each ID ("key:0" through "key:4095", so they sort differently than the IDs do).
+ static char sz_map_test_keys [ MAP_TEST_KEY_COUNT ] [ 16 ];
+ static uint32_t ui32_failed_checks = 0;
+ static uint64_t ui64_freed_data = 0;
+
+///user-defined callbacks.
+ uint8_t free_map_user_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ return 1; //always return successfully, since there's nothing to free.
+}}
+
+ int8_t compare_map_user_data ( void *lpv_data1, void *lpv_data2 )
+{{
+ (void) lpv_data1;
+ (void) lpv_data2;
+ return 0; //All things can be considered equal, for now.
+}}
+
+ void *initialize_user_data ( void )
+{{
+ return calloc ( sizeof(int8_t), 1 );
+}}
+
+ //The free function for the checks' maps; it counts the blocks, so that we can tell if one was freed twice or never.
+ static uint8_t count_freed_map_data ( void *lpv_data )
+{{
+ (void) lpv_data;
+ ui64_freed_data ++;
+ return 1;
+}}
+
+ //The example usage that used to be main.
+ static void show_map_example ( void )
+{{
+ MAP map;
+ fprintf (
+   stdout,
+   "show_map_example: Initializing the map.\n"
+ );
+
+ initialize_map (
+   &map, //The map that we're working with.
+   sizeof ( int8_t ), //This is the type of data with which we're working.
+   initialize_user_data, //What to return when get_map_node is called and the node doesn't exist.
+   compare_map_user_data, //reserved and unused.
+   free_map_user_data //called implicitly when free_map is invoked.
+ );
+
+ fprintf (
+   stdout,
+   "show_map_example: Preparing some user data.\n"
+ );
+
+ int8_t i8_x = 7;
+
+ fprintf (
+   stdout,
+   "show_map_example: Adding the user data to the map.\n"
+ );
+
+ SET_MAP_NODE (
+   map,
+   "some_key",
+   i8_x
+ );
+
+ fprintf (
+   stdout,
+   "show_map_example: Adding another key to the map.\n"
+ );
+
+ i8_x = 29;
+ SET_MAP_NODE (
+   map,
+   "jack",
+   i8_x
+ );
+
+ fprintf (
+   stdout,
+   "show_map_example: Looking for a key that won't exist, yet.\n"
+ );
+
+ int8_t *lpi8_x = (int8_t *) find_map_node_data (
+   &map,
+   "jacob"
+ );
+
+ fprintf (
+   stdout,
+   "show_map_example: We've made it out of find_map_node.\n"
+ );
+
+ if ( lpi8_x ) {
+   fprintf (
+     stdout,
+     "show_map_example: &map [ \"some_key\" ] = %p; its value is: %" PRIi8 "\n",
+     lpi8_x,
+     *lpi8_x
+   );
+ }
+ else {
+   fprintf (
+     stderr,
+     "show_map_example: Error: We were unable to find the node.\n"
+   );
+ }
+
+ fprintf (
+   stdout,
+   "show_map_example: Adding a third key to the map.\n"
+ );
+
+
+ //Should should be in the same tranche as "jack"
+ SET_MAP_NODE (
+   map,
+   "jacob",
+   i8_x
+ );
+
+
+ //TODO: Find and display this node, again.
+
+
+ fprintf (
+   stdout,
+   "show_map_example: Updating the third key.\n"
+ );
+
+ //Update the value to be 32.
+ i8_x = 32;
+ set_map_node__internal ( //using it directly for an example...
+   &map,
+   "jacob",
+   (void *) &i8_x,
+   0 //We DO want to allocate a buffer and copy the data from &i8_x into it.
+ );
+
+ fprintf (
+   stdout,
+   "Trying to access a key that doesn't exist with get_map_node to create a default one.\n"
+ );
+ int8_t *lpi8_default_node = (int8_t *) get_map_node (
+   &map,
+   "doesn't exist"
+ );
+ fprintf (
+   stdout,
+   "\"doesn't exist\" => %" PRIi8 " @ %p\n",
+   lpi8_default_node ? *lpi8_default_node : 0,
+   lpi8_default_node
+ );
+
+
+ fprintf (
+   stdout,
+   "Attempting to free a key from the map.\n"
+ );
+ //Freeing nodes in any position is working fine.
+ free_map_node (
+   &map,
+   "jack" //"doesn't exist" //"jacob" //"jack" //"some_key"
+ );
+
+ fprintf (
+   stdout,
+   "show_map_example: Showing the user data.\n"
+ );
+
+ for ( uint32_t ui32_i = 0; ui32_i < map .ui32_count; ui32_i ++ ) {
+   fprintf (
+     stdout,
+     "show_map_example: \"%s\" => \"%" PRIi8 "\"\n",
+//     *((int8_t*) map .lpary_doubly_linked_list [ ui32_i ] ->lpv_data)
+     MAP_KEY_AT ( map, ui32_i ),
+     MAP_DATA_AT ( int8_t, map, ui32_i )
+   );
+ }
+
+ fprintf (
+   stdout,
+   "show_map_example: Adding some order keys and showing them sorted by key.\n"
+ );
+
+ enable_map_ordered_index ( &map );
+ const char *lpsz_order_keys [  ] = { "order:2024-03", "order:2023-12", "order:2024-01", "order:2025-01" };
+ for ( uint32_t ui32_i = 0; ui32_i < sizeof ( lpsz_order_keys ) / sizeof ( lpsz_order_keys [ 0 ] ); ui32_i ++ ) {
+   i8_x = (int8_t) ui32_i;
+   SET_MAP_NODE ( map, lpsz_order_keys [ ui32_i ], i8_x );
+ }
+
+ MAP_ORDERED_ITERATOR iterator;
+ begin_map_range ( &map, &iterator, 0, 0 );
+ for ( DOUBLY_LINKED_LIST *node; (node = next_map_ordered_node ( &iterator )); ) {
+   fprintf (
+     stdout,
+     "show_map_example: \"%s\" => \"%" PRIi8 "\"\n",
+     node ->lpsz_key,
+     *(int8_t *) node ->lpv_data
+   );
+ }
+
+ fprintf (
+   stdout,
+   "show_map_example: Showing only the keys that start with \"order:2024-\".\n"
+ );
+
+ begin_map_prefix ( &map, &iterator, "order:2024-" );
+ for ( DOUBLY_LINKED_LIST *node; (node = next_map_ordered_node ( &iterator )); ) {
+   fprintf (
+     stdout,
+     "show_map_example: \"%s\"\n",
+     node ->lpsz_key
+   );
+ }
+
+ fprintf (
+   stdout,
+   "show_map_example: Freeing the map.\n"
+ );
+
+ free_map ( &map );
+}}
+
+ static uint64_t get_map_test_random ( uint64_t *lpui64_state )
+{{
+ uint64_t x = *lpui64_state;
+ x ^= x << 13;
+ x ^= x >> 7;
+ x ^= x << 17;
+
+ return *lpui64_state = x;
+}}
+
+ static void check_map ( uint8_t b_passed, const char *lpsz_check, uint32_t ui32_id )
+{{
+ if ( b_passed ) {
+   return ;
+ }
+
+ if ( ui32_failed_checks ++ < MAP_TEST_SHOWN_FAILURES ) {
+   fprintf (
+     stderr,
+     "check_map: Failed: %s (ID %" PRIu32 ").\n",
+     lpsz_check,
+     ui32_id
+   );
+ }
+}}
+
+ //Every ID gets its own integer key; ID 0 is key 0 and ID 1 is the largest key.
+ static uint64_t get_map_test_integer_key ( uint32_t ui32_id )
+{{
+ return ui32_id == 1 ? UINT64_MAX : (uint64_t) ui32_id * UINT64_C(0x9e3779b97f4a7c15);
+}}
+
+ //Every ID gets its own binary key, which is all zeros except for the ID's two bytes.
+ static void get_map_test_binary_key ( uint32_t ui32_id, uint8_t *lpui8_key )
+{{
+ memset ( lpui8_key, 0, MAP_TEST_BINARY_KEY_SIZE );
+ lpui8_key [ 3 ] = (uint8_t) ui32_id;
+ lpui8_key [ 9 ] = (uint8_t) (ui32_id >> 8);
+}}
+
+ static uint8_t set_map_test_node ( MAP *lpm_map, uint8_t ui8_key_kind, uint32_t ui32_id, int32_t i32_value )
+{{
+ uint8_t ui8_key [ MAP_TEST_BINARY_KEY_SIZE ];
+
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   return SET_MAP_INTEGER_NODE ( *lpm_map, get_map_test_integer_key ( ui32_id ), i32_value );
+ }
+ if ( ui8_key_kind == MAP_TEST_BINARY_KEYS ) {
+   get_map_test_binary_key ( ui32_id, ui8_key );
+   return SET_MAP_BINARY_NODE ( *lpm_map, ui8_key, i32_value );
+ }
+
+ return SET_MAP_NODE ( *lpm_map, sz_map_test_keys [ ui32_id ], i32_value );
+}}
+
+ static int32_t *find_map_test_node_data ( MAP *lpm_map, uint8_t ui8_key_kind, uint32_t ui32_id )
+{{
+ uint8_t ui8_key [ MAP_TEST_BINARY_KEY_SIZE ];
+
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   return (int32_t *) find_map_integer_node_data ( lpm_map, get_map_test_integer_key ( ui32_id ) );
+ }
+ if ( ui8_key_kind == MAP_TEST_BINARY_KEYS ) {
+   get_map_test_binary_key ( ui32_id, ui8_key );
+   return (int32_t *) find_map_binary_node_data ( lpm_map, ui8_key );
+ }
+
+ return (int32_t *) find_map_node_data ( lpm_map, sz_map_test_keys [ ui32_id ] );
+}}
+
+ static uint8_t free_map_test_node ( MAP *lpm_map, uint8_t ui8_key_kind, uint32_t ui32_id )
+{{
+ uint8_t ui8_key [ MAP_TEST_BINARY_KEY_SIZE ];
+
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   return free_map_integer_node ( lpm_map, get_map_test_integer_key ( ui32_id ) );
+ }
+ if ( ui8_key_kind == MAP_TEST_BINARY_KEYS ) {
+   get_map_test_binary_key ( ui32_id, ui8_key );
+   return free_map_binary_node ( lpm_map, ui8_key );
+ }
+
+ return free_map_node ( lpm_map, sz_map_test_keys [ ui32_id ] );
+}}
+
+ //Returns 1, if the node holds the key of the specified ID and the value that it should.
+ static uint8_t is_map_test_node ( const MAP_TEST_REFERENCE *lp_reference, uint8_t ui8_key_kind, DOUBLY_LINKED_LIST *node, uint32_t ui32_id )
+{{
+ uint8_t ui8_key [ MAP_TEST_BINARY_KEY_SIZE ];
+
+ if ( ! node || *(int32_t *) node ->lpv_data != lp_reference ->i32_values [ ui32_id ] ) {
+   return 0;
+ }
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   return get_map_node_integer_key ( node ) == get_map_test_integer_key ( ui32_id );
+ }
+ if ( ui8_key_kind == MAP_TEST_BINARY_KEYS ) {
+   get_map_test_binary_key ( ui32_id, ui8_key );
+   return memcmp ( node ->lpsz_key, ui8_key, MAP_TEST_BINARY_KEY_SIZE ) == 0;
+ }
+
+ return strcmp ( node ->lpsz_key, sz_map_test_keys [ ui32_id ] ) == 0;
+}}
+
+ //A new key goes at the end of the order, unreferenced.
+ static void add_map_reference_key ( MAP_TEST_REFERENCE *lp_reference, uint32_t ui32_id, int32_t i32_value )
+{{
+ lp_reference ->ui32_order [ lp_reference ->ui32_count ++ ] = ui32_id;
+ lp_reference ->i32_values [ ui32_id ] = i32_value;
+ lp_reference ->b_present [ ui32_id ] = 1;
+ lp_reference ->b_referenced [ ui32_id ] = 0;
+}}
+
+ static void remove_map_reference_key ( MAP_TEST_REFERENCE *lp_reference, uint32_t ui32_id )
+{{
+ uint32_t ui32_position = 0;
+ while ( lp_reference ->ui32_order [ ui32_position ] != ui32_id ) {
+   ui32_position ++;
+ }
+
+ memmove (
+   lp_reference ->ui32_order + ui32_position,
+   lp_reference ->ui32_order + ui32_position + 1,
+   (lp_reference ->ui32_count - ui32_position - 1) * sizeof ( uint32_t )
+ );
+ lp_reference ->ui32_count --;
+ lp_reference ->b_present [ ui32_id ] = 0;
+
+ //The hand stays on the key that came after the removed one.
+ if ( ui32_position < lp_reference ->ui32_hand ) {
+   lp_reference ->ui32_hand --;
+ }
+}}
+
+ //What a lookup does to a key in a cache.
+ static void touch_map_reference_key ( MAP_TEST_REFERENCE *lp_reference, uint32_t ui32_id, uint8_t ui8_policy )
+{{
+ if ( ui8_policy == MAP_CACHE_CLOCK ) {
+   lp_reference ->b_referenced [ ui32_id ] = 1;
+   return ;
+ }
+
+ int32_t i32_value = lp_reference ->i32_values [ ui32_id ];
+ remove_map_reference_key ( lp_reference, ui32_id );
+ add_map_reference_key ( lp_reference, ui32_id, i32_value );
+}}
+
+ //LRU evicts the least recently used key; CLOCK evicts the first unreferenced key from the hand on, clearing the flags that it passes.
+ static void evict_map_reference_key ( MAP_TEST_REFERENCE *lp_reference, uint8_t ui8_policy )
+{{
+ if ( ui8_policy == MAP_CACHE_LRU ) {
+   remove_map_reference_key ( lp_reference, lp_reference ->ui32_order [ 0 ] );
+   return ;
+ }
+
+ for ( ;; ) {
+   if ( lp_reference ->ui32_hand >= lp_reference ->ui32_count ) {
+     lp_reference ->ui32_hand = 0;
+   }
+
+   uint32_t ui32_id = lp_reference ->ui32_order [ lp_reference ->ui32_hand ];
+   if ( ! lp_reference ->b_referenced [ ui32_id ] ) {
+     remove_map_reference_key ( lp_reference, ui32_id );
+     return ;
+   }
+   lp_reference ->b_referenced [ ui32_id ] = 0;
+   lp_reference ->ui32_hand ++;
+ }
+}}
+
+/*
+ This will check that the map holds exactly the reference's keys and values, in the same
+ order, by following the insertion-order list. If b_thorough is set, this also goes through
+ the keys with get_map_node_at (which removes the index's tombstones first) and, unless the
+ map is a cache (where a lookup would count as a use), looks up every ID, one at a time and,
+ for integer keys, in a batch.
+*/
+ static void compare_map_with_reference ( MAP *lpm_map, const MAP_TEST_REFERENCE *lp_reference, uint8_t ui8_key_kind, uint8_t b_thorough )
+{{
+ check_map ( lpm_map ->ui32_count == lp_reference ->ui32_count, "The map holds as many keys as the reference", lpm_map ->ui32_count );
+
+ DOUBLY_LINKED_LIST *node = lpm_map ->lp_first_node;
+ for ( uint32_t ui32_i = 0; ui32_i < lp_reference ->ui32_count; ui32_i ++ ) {
+   uint32_t ui32_id = lp_reference ->ui32_order [ ui32_i ];
+   check_map ( is_map_test_node ( lp_reference, ui8_key_kind, node, ui32_id ), "The insertion-order list matches the reference", ui32_id );
+   if ( ! node ) {
+     return ;
+   }
+   node = node ->lp_next;
+ }
+ check_map ( node == 0, "The insertion-order list ends after the last key", 0 );
+
+ if ( ! b_thorough ) {
+   return ;
+ }
+
+ for ( uint32_t ui32_i = 0; ui32_i < lp_reference ->ui32_count; ui32_i ++ ) {
+   uint32_t ui32_id = lp_reference ->ui32_order [ ui32_i ];
+   check_map ( is_map_test_node ( lp_reference, ui8_key_kind, get_map_node_at ( lpm_map, ui32_i ), ui32_id ), "get_map_node_at matches the reference", ui32_id );
+ }
+ check_map ( lpm_map ->ui32_index_length == lpm_map ->ui32_count, "get_map_node_at removed the index's tombstones", lpm_map ->ui32_index_length );
+
+ if ( lpm_map ->ui32_cache_capacity ) {
+   return ;
+ }
+
+ for ( uint32_t ui32_id = 0; ui32_id < MAP_TEST_KEY_COUNT; ui32_id ++ ) {
+   int32_t *lpi32_value = find_map_test_node_data ( lpm_map, ui8_key_kind, ui32_id );
+   if ( lp_reference ->b_present [ ui32_id ] ) {
+     check_map ( lpi32_value && *lpi32_value == lp_reference ->i32_values [ ui32_id ], "Every key in the reference is found with its value", ui32_id );
+   }
+   else {
+     check_map ( lpi32_value == 0, "No key that's missing from the reference is found", ui32_id );
+   }
+ }
+
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   static uint64_t ui64_keys [ MAP_TEST_KEY_COUNT ];
+   static void *lpary_data [ MAP_TEST_KEY_COUNT ];
+   for ( uint32_t ui32_id = 0; ui32_id < MAP_TEST_KEY_COUNT; ui32_id ++ ) {
+     ui64_keys [ ui32_id ] = get_map_test_integer_key ( ui32_id );
+   }
+
+   uint32_t ui32_found = find_map_integer_nodes_data ( lpm_map, ui64_keys, MAP_TEST_KEY_COUNT, lpary_data );
+   check_map ( ui32_found == lp_reference ->ui32_count, "A batch lookup finds every key in the reference", ui32_found );
+   for ( uint32_t ui32_id = 0; ui32_id < MAP_TEST_KEY_COUNT; ui32_id ++ ) {
+     if ( lp_reference ->b_present [ ui32_id ] ) {
+       check_map ( lpary_data [ ui32_id ] && *(int32_t *) lpary_data [ ui32_id ] == lp_reference ->i32_values [ ui32_id ], "A batch lookup finds each key's value", ui32_id );
+     }
+     else {
+       check_map ( lpary_data [ ui32_id ] == 0, "A batch lookup doesn't find missing keys", ui32_id );
+     }
+   }
+ }
+}}
+
+/*
+ This will set, update, and free random keys, first mostly adding them (so the table grows),
+ then mostly freeing them (so that many keys are shifted back into freed slots and the index
+ fills with tombstones), and then mostly adding them again, checking the map against the
+ reference every 64 changes. At the end, every block of user-data must have been freed exactly once.
+*/
+ static void check_map_sets_and_frees ( uint8_t ui8_key_kind )
+{{
+ static MAP_TEST_REFERENCE reference;
+ const uint32_t ui32_phase_length = 40000;
+ const uint32_t ui32_set_percentages [  ] = { 70, 25, 70 };
+ uint64_t ui64_state = UINT64_C(0x2545f4914f6cdd1d) + ui8_key_kind;
+ uint64_t ui64_sets = 0;
+ MAP map;
+
+ memset ( &reference, 0, sizeof ( reference ) );
+ ui64_freed_data = 0;
+ if ( ui8_key_kind == MAP_TEST_INTEGER_KEYS ) {
+   initialize_integer_key_map ( &map, sizeof ( int32_t ), 0, compare_map_user_data, count_freed_map_data );
+ }
+ else if ( ui8_key_kind == MAP_TEST_BINARY_KEYS ) {
+   initialize_binary_key_map ( &map, MAP_TEST_BINARY_KEY_SIZE, sizeof ( int32_t ), 0, compare_map_user_data, count_freed_map_data );
+ }
+ else {
+   initialize_map ( &map, sizeof ( int32_t ), 0, compare_map_user_data, count_freed_map_data );
+ }
+
+ for ( uint32_t ui32_phase = 0; ui32_phase < 3; ui32_phase ++ ) {
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_phase_length; ui32_i ++ ) {
+     uint32_t ui32_id = (uint32_t) (get_map_test_random ( &ui64_state ) % MAP_TEST_KEY_COUNT);
+
+     if ( get_map_test_random ( &ui64_state ) % 100 < ui32_set_percentages [ ui32_phase ] ) {
+       int32_t i32_value = (int32_t) get_map_test_random ( &ui64_state );
+       check_map ( set_map_test_node ( &map, ui8_key_kind, ui32_id, i32_value ), "Setting a key succeeds", ui32_id );
+       ui64_sets ++;
+
+       //Updating a key leaves it where it was in the insertion order.
+       if ( reference .b_present [ ui32_id ] ) {
+         reference .i32_values [ ui32_id ] = i32_value;
+       }
+       else {
+         add_map_reference_key ( &reference, ui32_id, i32_value );
+       }
+     }
+     else {
+       uint8_t b_freed = free_map_test_node ( &map, ui8_key_kind, ui32_id );
+       check_map ( b_freed == reference .b_present [ ui32_id ], "Freeing a key succeeds only if it's in the map", ui32_id );
+       if ( reference .b_present [ ui32_id ] ) {
+         remove_map_reference_key ( &reference, ui32_id );
+       }
+     }
+
+     if ( ui32_i % 64 == 63 ) {
+       compare_map_with_reference ( &map, &reference, ui8_key_kind, ui32_i % 4096 == 4095 );
+     }
+   }
+ }
+
+ free_map ( &map );
+ check_map ( ui64_freed_data == ui64_sets, "Every block of user-data is freed exactly once", (uint32_t) ui64_freed_data );
+}}
+
+ static int compare_map_test_keys ( const void *lpv_id1, const void *lpv_id2 )
+{{
+ return strcmp ( sz_map_test_keys [ *(const uint32_t *) lpv_id1 ], sz_map_test_keys [ *(const uint32_t *) lpv_id2 ] );
+}}
+
+ //This will check that the iterator returns exactly the sorted keys from ui32_first up to (not including) ui32_last.
+ static void compare_map_iterator_with_reference ( MAP_ORDERED_ITERATOR *lp_iterator, const MAP_TEST_REFERENCE *lp_reference, const uint32_t *lpary_sorted, uint32_t ui32_first, uint32_t ui32_last, const char *lpsz_check )
+{{
+ for ( uint32_t ui32_i = ui32_first; ui32_i < ui32_last; ui32_i ++ ) {
+   DOUBLY_LINKED_LIST *node = next_map_ordered_node ( lp_iterator );
+   check_map ( is_map_test_node ( lp_reference, MAP_TEST_STRING_KEYS, node, lpary_sorted [ ui32_i ] ), lpsz_check, lpary_sorted [ ui32_i ] );
+   if ( ! node ) {
+     return ;
+   }
+ }
+ check_map ( next_map_ordered_node ( lp_iterator ) == 0, lpsz_check, ui32_last );
+}}
+
+ //Returns the position of the first sorted key that's greater than or equal to lpsz_key.
+ static uint32_t find_map_reference_lower_bound ( const uint32_t *lpary_sorted, uint32_t ui32_count, const char *lpsz_key )
+{{
+ uint32_t ui32_i = 0;
+ while ( ui32_i < ui32_count && strcmp ( sz_map_test_keys [ lpary_sorted [ ui32_i ] ], lpsz_key ) < 0 ) {
+   ui32_i ++;
+ }
+
+ return ui32_i;
+}}
+
+/*
+ This will turn on the ordered index once the map already has keys (so that it has to be built
+ from them), keep setting and freeing random keys, and every so often check whole-map, range,
+ and prefix iteration and find_map_lower_bound against a sorted copy of the reference's keys.
+*/
+ static void check_map_ordered_index ( void )
+{{
+ static MAP_TEST_REFERENCE reference;
+ static uint32_t ui32_sorted [ MAP_TEST_KEY_COUNT ];
+ uint64_t ui64_state = UINT64_C(0x9e3779b97f4a7c15);
+ MAP_ORDERED_ITERATOR iterator;
+ char sz_probe [ 16 ];
+ MAP map;
+
+ memset ( &reference, 0, sizeof ( reference ) );
+ initialize_map ( &map, sizeof ( int32_t ), 0, compare_map_user_data, count_freed_map_data );
+
+ for ( uint32_t ui32_i = 0; ui32_i < 30000; ui32_i ++ ) {
+   if ( ui32_i == 1000 ) {
+     check_map ( enable_map_ordered_index ( &map ), "The ordered index can be turned on", map .ui32_count );
+   }
+
+   uint32_t ui32_id = (uint32_t) (get_map_test_random ( &ui64_state ) % MAP_TEST_KEY_COUNT);
+   if ( get_map_test_random ( &ui64_state ) % 100 < 60 ) {
+     int32_t i32_value = (int32_t) get_map_test_random ( &ui64_state );
+     set_map_test_node ( &map, MAP_TEST_STRING_KEYS, ui32_id, i32_value );
+     if ( reference .b_present [ ui32_id ] ) {
+       reference .i32_values [ ui32_id ] = i32_value;
+     }
+     else {
+       add_map_reference_key ( &reference, ui32_id, i32_value );
+     }
+   }
+   else if ( reference .b_present [ ui32_id ] ) {
+     free_map_test_node ( &map, MAP_TEST_STRING_KEYS, ui32_id );
+     remove_map_reference_key ( &reference, ui32_id );
+   }
+
+   if ( ui32_i < 1000 || ui32_i % 1000 != 999 ) {
+     continue;
+   }
+
+   uint32_t ui32_count = reference .ui32_count;
+   memcpy ( ui32_sorted, reference .ui32_order, ui32_count * sizeof ( uint32_t ) );
+   qsort ( ui32_sorted, ui32_count, sizeof ( uint32_t ), compare_map_test_keys );
+
+   begin_map_range ( &map, &iterator, 0, 0 );
+   compare_map_iterator_with_reference ( &iterator, &reference, ui32_sorted, 0, ui32_count, "Iterating over the whole map goes in sorted order" );
+
+   for ( uint32_t ui32_j = 0; ui32_j < 20; ui32_j ++ ) {
+     //The probes are keys that may or may not be in the map, so they land both on and between keys.
+     const char *lpsz_first = sz_map_test_keys [ get_map_test_random ( &ui64_state ) % MAP_TEST_KEY_COUNT ];
+     const char *lpsz_last = sz_map_test_keys [ get_map_test_random ( &ui64_state ) % MAP_TEST_KEY_COUNT ];
+     uint32_t ui32_first = find_map_reference_lower_bound ( ui32_sorted, ui32_count, lpsz_first );
+     uint32_t ui32_last = find_map_reference_lower_bound ( ui32_sorted, ui32_count, lpsz_last );
+
+     DOUBLY_LINKED_LIST *node = find_map_lower_bound ( &map, lpsz_first );
+     if ( ui32_first < ui32_count ) {
+       check_map ( is_map_test_node ( &reference, MAP_TEST_STRING_KEYS, node, ui32_sorted [ ui32_first ] ), "find_map_lower_bound finds the first key that isn't less", ui32_sorted [ ui32_first ] );
+     }
+     else {
+       check_map ( node == 0, "find_map_lower_bound finds nothing past the last key", ui32_first );
+     }
+
+     begin_map_range ( &map, &iterator, lpsz_first, lpsz_last );
+     compare_map_iterator_with_reference ( &iterator, &reference, ui32_sorted, ui32_first, ui32_last > ui32_first ? ui32_last : ui32_first, "Iterating over a range returns the keys in it" );
+
+     begin_map_range ( &map, &iterator, lpsz_first, 0 );
+     compare_map_iterator_with_reference ( &iterator, &reference, ui32_sorted, ui32_first, ui32_count, "Iterating from a key returns the rest of the keys" );
+
+     //Prefixes from "key:" (every key) down to "key:" plus three digits.
+     uint32_t ui32_digits = (uint32_t) (get_map_test_random ( &ui64_state ) % 4);
+     snprintf ( sz_probe, sizeof ( sz_probe ), "key:%.*s", (int) ui32_digits, "0123456789" + get_map_test_random ( &ui64_state ) % 7 );
+     ui32_first = find_map_reference_lower_bound ( ui32_sorted, ui32_count, sz_probe );
+     ui32_last = ui32_first;
+     while ( ui32_last < ui32_count && strncmp ( sz_map_test_keys [ ui32_sorted [ ui32_last ] ], sz_probe, strlen ( sz_probe ) ) == 0 ) {
+       ui32_last ++;
+     }
+
+     begin_map_prefix ( &map, &iterator, sz_probe );
+     compare_map_iterator_with_reference ( &iterator, &reference, ui32_sorted, ui32_first, ui32_last, "Iterating over a prefix returns the keys that start with it" );
+   }
+
+   check_map ( find_map_lower_bound ( &map, "" ) == (ui32_count ? find_map_node ( &map, sz_map_test_keys [ ui32_sorted [ 0 ] ] ) : 0), "find_map_lower_bound ( \"\" ) finds the smallest key", 0 );
+   check_map ( find_map_lower_bound ( &map, "z" ) == 0, "find_map_lower_bound finds nothing after every key", 0 );
+ }
+
+ compare_map_with_reference ( &map, &reference, MAP_TEST_STRING_KEYS, 1 );
+ free_map ( &map );
+}}
+
+/*
+ This will look up, set, and free random keys in a cache that holds a quarter of them, doing
+ the same to the reference, and check that the cache evicts the same keys that the reference
+ does and counts the same hits, misses, and evictions.
+*/
+ static void check_map_cache ( uint8_t ui8_policy )
+{{
+ static MAP_TEST_REFERENCE reference;
+ const uint32_t ui32_capacity = 64;
+ uint64_t ui64_state = UINT64_C(0xd1b54a32d192ed03) + ui8_policy;
+ MAP_CACHE_STATISTICS expected, statistics;
+ MAP map;
+
+ memset ( &reference, 0, sizeof ( reference ) );
+ memset ( &expected, 0, sizeof ( expected ) );
+ initialize_map ( &map, sizeof ( int32_t ), 0, compare_map_user_data, count_freed_map_data );
+ check_map ( enable_map_cache ( &map, ui32_capacity, ui8_policy ), "The cache can be turned on", ui8_policy );
+
+ for ( uint32_t ui32_i = 0; ui32_i < 100000; ui32_i ++ ) {
+   uint32_t ui32_id = (uint32_t) (get_map_test_random ( &ui64_state ) % (ui32_capacity * 4));
+   uint32_t ui32_operation = (uint32_t) (get_map_test_random ( &ui64_state ) % 100);
+
+   if ( ui32_operation < 50 ) {
+     int32_t *lpi32_value = find_map_test_node_data ( &map, MAP_TEST_STRING_KEYS, ui32_id );
+     if ( reference .b_present [ ui32_id ] ) {
+       check_map ( lpi32_value && *lpi32_value == reference .i32_values [ ui32_id ], "A cached key is found with its value", ui32_id );
+       touch_map_reference_key ( &reference, ui32_id, ui8_policy );
+       expected .ui64_hits ++;
+     }
+     else {
+       check_map ( lpi32_value == 0, "An evicted or freed key isn't found", ui32_id );
+       expected .ui64_misses ++;
+     }
+   }
+   else if ( ui32_operation < 90 ) {
+     int32_t i32_value = (int32_t) get_map_test_random ( &ui64_state );
+     set_map_test_node ( &map, MAP_TEST_STRING_KEYS, ui32_id, i32_value );
+     if ( reference .b_present [ ui32_id ] ) {
+       touch_map_reference_key ( &reference, ui32_id, ui8_policy );
+       reference .i32_values [ ui32_id ] = i32_value;
+     }
+     else {
+       if ( reference .ui32_count >= ui32_capacity ) {
+         evict_map_reference_key ( &reference, ui8_policy );
+         expected .ui64_evictions ++;
+       }
+       add_map_reference_key ( &reference, ui32_id, i32_value );
+     }
+   }
+   else if ( reference .b_present [ ui32_id ] ) {
+     free_map_test_node ( &map, MAP_TEST_STRING_KEYS, ui32_id );
+     remove_map_reference_key ( &reference, ui32_id );
+   }
+
+   //Going through the keys by index removes the tombstones, which moves the CLOCK hand, so that's only done now and then.
+   compare_map_with_reference ( &map, &reference, MAP_TEST_STRING_KEYS, ui32_i % 97 == 96 );
+ }
+
+ get_map_cache_statistics ( &map, &statistics );
+ check_map ( statistics .ui64_hits == expected .ui64_hits, "The cache counts every hit", (uint32_t) statistics .ui64_hits );
+ check_map ( statistics .ui64_misses == expected .ui64_misses, "The cache counts every miss", (uint32_t) statistics .ui64_misses );
+ check_map ( statistics .ui64_evictions == expected .ui64_evictions, "The cache counts every eviction", (uint32_t) statistics .ui64_evictions );
+
+ free_map ( &map );
+}}
+
+ int main ( void )
+{{
+ show_map_example (  );
+
+ for ( uint32_t ui32_id = 0; ui32_id < MAP_TEST_KEY_COUNT; ui32_id ++ ) {
+   snprintf ( sz_map_test_keys [ ui32_id ], sizeof ( sz_map_test_keys [ ui32_id ] ), "key:%" PRIu32, ui32_id );
+ }
+
+ check_map_sets_and_frees ( MAP_TEST_STRING_KEYS );
+ check_map_sets_and_frees ( MAP_TEST_INTEGER_KEYS );
+ check_map_sets_and_frees ( MAP_TEST_BINARY_KEYS );
+ check_map_ordered_index (  );
+ check_map_cache ( MAP_CACHE_LRU );
+ check_map_cache ( MAP_CACHE_CLOCK );
+
+ if ( ui32_failed_checks ) {
+   fprintf (
+     stderr,
+     "main: %" PRIu32 " checks failed.\n",
+     ui32_failed_checks
+   );
+   return 1;
+ }
+
+ fprintf (
+   stdout,
+   "main: Every check passed.\n"
+ );
+
+ return 0;
+}}
@@ -0,0 +1,197 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the read-only file mappings described in mapped_file.h, and the
+ writing of the files that replace them.
+*/
+ #include "mapped_file.h"
+#ifdef _WIN32
+ #include "io.h"
+#else
+ #include "fcntl.h"
+ #include "unistd.h"
+ #include "sys/mman.h"
+ #include "sys/stat.h"
+#endif
+
+ //This will fill in a signature for the file format with the magic string (up to 7 characters) and version.
+ void set_mapped_file_signature ( MAPPED_FILE_SIGNATURE *lp_signature, const char *lpsz_magic, uint32_t ui32_version )
+{{
+ size_t st_length = strlen ( lpsz_magic );
+ memset ( lp_signature, 0, sizeof ( MAPPED_FILE_SIGNATURE ) );
+ memcpy ( lp_signature ->sz_magic, lpsz_magic, st_length < sizeof ( lp_signature ->sz_magic ) ? st_length : sizeof ( lp_signature ->sz_magic ) - 1 );
+ lp_signature ->ui32_version = ui32_version;
+ lp_signature ->ui32_byte_order = MAPPED_FILE_BYTE_ORDER;
+}}
+
+ //Whether the signature is the one that set_mapped_file_signature makes for the magic string and version, on this machine.
+ uint8_t is_mapped_file_signature ( const MAPPED_FILE_SIGNATURE *lp_signature, const char *lpsz_magic, uint32_t ui32_version )
+{{
+ MAPPED_FILE_SIGNATURE expected;
+ set_mapped_file_signature ( &expected, lpsz_magic, ui32_version );
+
+ return ! memcmp ( lp_signature, &expected, sizeof ( MAPPED_FILE_SIGNATURE ) );
+}}
+
+/*
+ This will map the whole file at lpsz_path into memory, read-only.
+ Returns 0, if it couldn't be opened or mapped, or is smaller than st_minimum_size bytes.
+*/
+ uint8_t open_mapped_file ( MAPPED_FILE *lp_file, const char *lpsz_path, size_t st_minimum_size )
+{{
+ if ( ! lp_file || ! lpsz_path ) {
+   return 0;
+ }
+
+ memset ( lp_file, 0, sizeof ( MAPPED_FILE ) );
+
+#ifdef _WIN32
+ LARGE_INTEGER li_size;
+ lp_file ->h_file = CreateFileA ( lpsz_path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+ if ( lp_file ->h_file == INVALID_HANDLE_VALUE || ! GetFileSizeEx ( lp_file ->h_file, &li_size ) ) {
+   close_mapped_file ( lp_file );
+   return 0;
+ }
+ lp_file ->st_size = (size_t) li_size .QuadPart;
+ if ( lp_file ->st_size < st_minimum_size || ! lp_file ->st_size ) {
+   close_mapped_file ( lp_file );
+   return 0;
+ }
+
+ lp_file ->h_mapping = CreateFileMappingA ( lp_file ->h_file, 0, PAGE_READONLY, 0, 0, 0 );
+ if ( lp_file ->h_mapping ) {
+   lp_file ->lp_base = (const char *) MapViewOfFile ( lp_file ->h_mapping, FILE_MAP_READ, 0, 0, 0 );
+ }
+#else
+ int i_file = open ( lpsz_path, O_RDONLY );
+ if ( i_file < 0 ) {
+   return 0;
+ }
+
+ struct stat file_status;
+ if ( fstat ( i_file, &file_status ) || (uint64_t) file_status .st_size < st_minimum_size || ! file_status .st_size ) {
+   close ( i_file );
+   return 0;
+ }
+ lp_file ->st_size = (size_t) file_status .st_size;
+
+ void *lpv_base = mmap ( 0, lp_file ->st_size, PROT_READ, MAP_SHARED, i_file, 0 );
+ close ( i_file ); //The mapping keeps the file open.
+ if ( lpv_base != MAP_FAILED ) {
+   lp_file ->lp_base = (const char *) lpv_base;
+ }
+#endif
+
+ if ( ! lp_file ->lp_base ) {
+   close_mapped_file ( lp_file );
+   return 0;
+ }
+
+ return 1;
+}}
+
+ //This will unmap the file (if it's mapped) and clear the structure.
+ void close_mapped_file ( MAPPED_FILE *lp_file )
+{{
+ if ( ! lp_file ) {
+   return ;
+ }
+
+#ifdef _WIN32
+ if ( lp_file ->lp_base ) {
+   UnmapViewOfFile ( lp_file ->lp_base );
+ }
+ if ( lp_file ->h_mapping ) {
+   CloseHandle ( lp_file ->h_mapping );
+ }
+ if ( lp_file ->h_file && lp_file ->h_file != INVALID_HANDLE_VALUE ) {
+   CloseHandle ( lp_file ->h_file );
+ }
+#else
+ if ( lp_file ->lp_base ) {
+   munmap ( (void *) lp_file ->lp_base, lp_file ->st_size );
+ }
+#endif
+
+ memset ( lp_file, 0, sizeof ( MAPPED_FILE ) );
+}}
+
+/*
+ This will create a temporary file next to lpsz_path (in the same directory, so that it can be
+ renamed over it) and return it, open for writing; lpsz_path must stay valid until
+ finish_mapped_file. The temporary file's name includes the process ID, and it's opened
+ exclusively, so two processes (or threads) saving the same path never write the same file.
+ Returns 0, if no temporary file could be created; finish_mapped_file must still be called.
+*/
+ FILE *create_mapped_file ( MAPPED_FILE_WRITER *lp_writer, const char *lpsz_path )
+{{
+ if ( ! lp_writer ) {
+   return 0;
+ }
+
+ memset ( lp_writer, 0, sizeof ( MAPPED_FILE_WRITER ) );
+ if ( ! lpsz_path ) {
+   return 0;
+ }
+
+ size_t st_length = strlen ( lpsz_path ) + 48;
+ lp_writer ->lpsz_path = lpsz_path;
+ lp_writer ->lpsz_temporary_path = (char *) malloc ( st_length );
+ if ( ! lp_writer ->lpsz_temporary_path ) {
+   return 0;
+ }
+
+#ifdef _WIN32
+ unsigned long ul_process = (unsigned long) GetCurrentProcessId (  );
+#else
+ unsigned long ul_process = (unsigned long) getpid (  );
+#endif
+ for ( uint32_t ui32_attempt = 0; ! lp_writer ->lp_file && ui32_attempt < 100; ui32_attempt ++ ) {
+   snprintf ( lp_writer ->lpsz_temporary_path, st_length, "%s.%lu.%" PRIu32 ".tmp", lpsz_path, ul_process, ui32_attempt );
+   //"x" fails if the file already exists.
+   lp_writer ->lp_file = fopen ( lp_writer ->lpsz_temporary_path, "wbx" );
+ }
+
+ if ( ! lp_writer ->lp_file ) {
+   free ( lp_writer ->lpsz_temporary_path );
+   lp_writer ->lpsz_temporary_path = 0;
+ }
+
+ return lp_writer ->lp_file;
+}}
+
+/*
+ This will close the file from create_mapped_file. If b_success is set (everything was written),
+ the file is flushed to the disk and then renamed over the target, which replaces it in one step;
+ otherwise, or if that fails, the temporary file is removed and the target is left as it was.
+ Returns 1, if the target was replaced.
+*/
+ uint8_t finish_mapped_file ( MAPPED_FILE_WRITER *lp_writer, uint8_t b_success )
+{{
+ if ( ! lp_writer || ! lp_writer ->lp_file ) {
+   return 0;
+ }
+
+ b_success = b_success && ! fflush ( lp_writer ->lp_file );
+#ifdef _WIN32
+ b_success = b_success && FlushFileBuffers ( (HANDLE) _get_osfhandle ( _fileno ( lp_writer ->lp_file ) ) );
+#else
+ b_success = b_success && ! fsync ( fileno ( lp_writer ->lp_file ) );
+#endif
+ if ( fclose ( lp_writer ->lp_file ) ) {
+   b_success = 0;
+ }
+
+#ifdef _WIN32
+ b_success = b_success && MoveFileExA ( lp_writer ->lpsz_temporary_path, lp_writer ->lpsz_path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH );
+#else
+ b_success = b_success && ! rename ( lp_writer ->lpsz_temporary_path, lp_writer ->lpsz_path );
+#endif
+ if ( ! b_success ) {
+   remove ( lp_writer ->lpsz_temporary_path );
+ }
+
+ free ( lp_writer ->lpsz_temporary_path );
+ memset ( lp_writer, 0, sizeof ( MAPPED_FILE_WRITER ) );
+
+ return b_success;
+}}
@@ -0,0 +1,86 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To map a whole file into memory, read-only, for the snapshot files
+ (map_snapshot.h and suffix_tree_snapshot.h), so that the code for each platform is in one place.
+
+ open_mapped_file maps the file with every page shared: every process that opens the same
+ file reads the same copy of it (the operating system's file cache), and pages are only
+ read from the disk as they're touched. close_mapped_file unmaps it.
+
+ Every snapshot file starts with a MAPPED_FILE_SIGNATURE, which says what kind of file it
+ is, which version of that format, and which byte order it was written with.
+
+ A snapshot is never rewritten in place, since truncating a file that another process has
+ mapped makes that process crash (SIGBUS) the next time it touches a page that's gone.
+ create_mapped_file opens a temporary file next to the target instead, and finish_mapped_file
+ flushes it to the disk and renames it over the target, so a process that has the old file
+ open keeps reading the old one, and a failed save leaves the old one alone. (On Windows, a
+ file can't be replaced while it's mapped, so the save fails until every reader closes it.)
+
+ Usage:
+ MAPPED_FILE_WRITER writer;
+ FILE *lp_file = create_mapped_file ( &writer, "data.snapshot" );
+ uint8_t b_success = lp_file && fwrite ( &signature, sizeof ( signature ), 1, lp_file ) == 1;
+ b_success = finish_mapped_file ( &writer, b_success );
+
+ MAPPED_FILE file;
+ if ( open_mapped_file ( &file, "data.snapshot", sizeof ( MAPPED_FILE_SIGNATURE ) ) ) {
+   uint8_t b_ours = is_mapped_file_signature ( (const MAPPED_FILE_SIGNATURE *) file .lp_base, "DATASNP", 1 );
+   close_mapped_file ( &file );
+ }
+
+ See mapped_file.c for the implementation.
+*/
+#ifndef MAPPED_FILE_HEADER_DEFINED
+#define MAPPED_FILE_HEADER_DEFINED 1
+ #include "stdio.h"
+ #include "stdlib.h"
+ #include "stdint.h"
+ #include "inttypes.h"
+#ifndef _WIN32
+ #include "string.h"
+#else
+ #include "windows.h"
+#endif
+
+ //Written as a uint32_t, so that a file from a machine with another byte order is recognized.
+ #define MAPPED_FILE_BYTE_ORDER 0x01020304
+
+ typedef struct MAPPED_FILE_SIGNATURE {
+   char sz_magic [ 8 ]; //Up to 7 characters, padded with zeroes.
+   uint32_t ui32_version;
+   uint32_t ui32_byte_order; //MAPPED_FILE_BYTE_ORDER
+ } MAPPED_FILE_SIGNATURE;
+
+ typedef struct MAPPED_FILE {
+   const char *lp_base; //Where the file is mapped.
+   size_t st_size;
+#ifdef _WIN32
+   HANDLE h_file;
+   HANDLE h_mapping;
+#endif
+ } MAPPED_FILE;
+
+ //A file that's written next to the one that it will replace (see create_mapped_file).
+ typedef struct MAPPED_FILE_WRITER {
+   FILE *lp_file;
+   const char *lpsz_path; //The file that's replaced by finish_mapped_file.
+   char *lpsz_temporary_path;
+ } MAPPED_FILE_WRITER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ void set_mapped_file_signature ( MAPPED_FILE_SIGNATURE *lp_signature, const char *lpsz_magic, uint32_t ui32_version );
+ uint8_t is_mapped_file_signature ( const MAPPED_FILE_SIGNATURE *lp_signature, const char *lpsz_magic, uint32_t ui32_version );
+ uint8_t open_mapped_file ( MAPPED_FILE *lp_file, const char *lpsz_path, size_t st_minimum_size );
+ void close_mapped_file ( MAPPED_FILE *lp_file );
+ FILE *create_mapped_file ( MAPPED_FILE_WRITER *lp_writer, const char *lpsz_path );
+ uint8_t finish_mapped_file ( MAPPED_FILE_WRITER *lp_writer, uint8_t b_success );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To pass substring queries to whichever index was built (see substring_index.h).
+*/
+ #include "substring_index.h"
+ #include <utility>
+
+/*
+ This will index st_length bytes of lp_data with the type of index in ui8_type,
+ freeing the other type's index, if it had one.
+ Returns 0, if the type isn't known or the text is too long for it (see TRIE_MAXIMUM_LENGTH
+ and SUFFIX_ARRAY_MAXIMUM_LENGTH).
+*/
+ uint8_t generate_substring_index ( SUBSTRING_INDEX &index, uint8_t ui8_type, const char *lp_data, size_t st_length )
+{{
+ //The old index (if any) is freed when these go out of scope.
+ TRIE trie;
+ SUFFIX_ARRAY suffix_array;
+ std::swap ( index .trie, trie );
+ std::swap ( index .suffix_array, suffix_array );
+ index .ui8_type = ui8_type;
+
+ switch ( ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return generate_trie ( index .trie, lp_data, st_length );
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return generate_suffix_array ( index .suffix_array, lp_data, st_length );
+ }
+
+ return 0;
+}}
+
+ //This will return 1 (true), if the pattern occurs in the text.
+ uint8_t has_indexed_substring ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length )
+{{
+ switch ( index .ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return find_trie_substring ( index .trie, lp_pattern, st_length ) != 0;
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return has_suffix_array_substring ( index .suffix_array, lp_pattern, st_length );
+ }
+
+ return 0;
+}}
+
+ //This will return the one-based index of the rightmost occurrence of the pattern, or 0, if it doesn't occur.
+ size_t find_indexed_substring ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length )
+{{
+ switch ( index .ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return find_trie_substring ( index .trie, lp_pattern, st_length );
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return find_suffix_array_substring ( index .suffix_array, lp_pattern, st_length );
+ }
+
+ return 0;
+}}
+
+ //This will return how many times the pattern occurs in the text (overlapping occurrences included).
+ size_t count_indexed_substrings ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length )
+{{
+ switch ( index .ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return count_trie_substrings ( index .trie, lp_pattern, st_length );
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return count_suffix_array_substrings ( index .suffix_array, lp_pattern, st_length );
+ }
+
+ return 0;
+}}
+
+/*
+ This will add the zero-based position of every occurrence of the pattern to vec_positions
+ (in no particular order) and return how many there were.
+*/
+ size_t find_indexed_substrings ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions )
+{{
+ switch ( index .ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return find_trie_substrings ( index .trie, lp_pattern, st_length, vec_positions );
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return find_suffix_array_substrings ( index .suffix_array, lp_pattern, st_length, vec_positions );
+ }
+
+ return 0;
+}}
+
+ //This will return how many bytes the index holds.
+ size_t get_substring_index_memory_usage ( const SUBSTRING_INDEX &index )
+{{
+ switch ( index .ui8_type ) {
+   case SUBSTRING_INDEX_SUFFIX_TREE:
+     return get_trie_memory_usage ( index .trie );
+
+   case SUBSTRING_INDEX_SUFFIX_ARRAY:
+     return get_suffix_array_memory_usage ( index .suffix_array );
+ }
+
+ return 0;
+}}
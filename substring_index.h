@@ -0,0 +1,38 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To search a text with either a suffix tree (suffix_tree.h) or a suffix array
+ (suffix_array.h) behind one interface, so that they can be swapped and compared.
+
+ The suffix tree answers each query in O(m) time, for a pattern of m bytes, but takes
+ 45 to 60 bytes per byte of text. The suffix array takes 9 bytes per byte of text, but
+ each query is a binary search, in O(m log n) time.
+
+ Usage:
+ SUBSTRING_INDEX index;
+ generate_substring_index ( index, SUBSTRING_INDEX_SUFFIX_ARRAY, lp_text, st_text_length );
+ size_t st_count = count_indexed_substrings ( index, "test", 4 );
+
+ See substring_index_benchmark.cpp for a comparison of the two.
+*/
+#ifndef SUBSTRING_INDEX_HEADER_DEFINED
+#define SUBSTRING_INDEX_HEADER_DEFINED 1
+ #include "suffix_tree.h"
+ #include "suffix_array.h"
+
+ #define SUBSTRING_INDEX_SUFFIX_TREE 1
+ #define SUBSTRING_INDEX_SUFFIX_ARRAY 2
+
+typedef struct SUBSTRING_INDEX {
+  uint8_t ui8_type; //SUBSTRING_INDEX_*
+  TRIE trie; //Only used by SUBSTRING_INDEX_SUFFIX_TREE.
+  SUFFIX_ARRAY suffix_array; //Only used by SUBSTRING_INDEX_SUFFIX_ARRAY.
+} SUBSTRING_INDEX;
+
+ uint8_t generate_substring_index ( SUBSTRING_INDEX &index, uint8_t ui8_type, const char *lp_data, size_t st_length );
+ uint8_t has_indexed_substring ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length );
+ size_t find_indexed_substring ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length );
+ size_t count_indexed_substrings ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length );
+ size_t find_indexed_substrings ( const SUBSTRING_INDEX &index, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions );
+ size_t get_substring_index_memory_usage ( const SUBSTRING_INDEX &index );
+
+#endif
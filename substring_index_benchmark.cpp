@@ -0,0 +1,172 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To compare the suffix tree and the suffix array (see substring_index.h): how long
+ each takes to build, how much memory it takes per byte of text, and how quickly it answers
+ each kind of query (existence, rightmost occurrence, count, and all occurrences).
+
+ The same DNA, English-like, and binary texts as in suffix_tree_benchmark.cpp are indexed.
+ Half of the queries are substrings of the text and half are random (and mostly miss). Every answer from the
+ suffix array is checked against the suffix tree's, and every occurrence against the text.
+
+ Usage: substring_index_benchmark [text size in MB]... (default: 1 10)
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_array.cpp substring_index.cpp substring_index_benchmark.cpp -o substring_index_benchmark
+*/
+ #include "substring_index.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_QUERY_COUNT 200000
+
+//What one index answered for every query, so that the two can be compared.
+typedef struct BENCHMARK_ANSWERS {
+  std::vector<uint8_t> vec_has;
+  std::vector<size_t> vec_find;
+  std::vector<size_t> vec_count;
+  size_t st_occurrences; //From find_indexed_substrings.
+  uint8_t b_correct; //Whether every occurrence matched the text.
+} BENCHMARK_ANSWERS;
+
+ static void run_substring_index_benchmark (
+   const char *lpsz_name,
+   uint8_t ui8_type,
+   const std::string &str_text,
+   const std::vector<std::string> &vec_queries,
+   BENCHMARK_ANSWERS &answers
+ )
+{{
+ SUBSTRING_INDEX index;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_substring_index ( index, ui8_type, str_text .data (  ), str_text .size (  ) );
+ double dbl_build = get_benchmark_seconds (  ) - dbl_start;
+
+ const size_t st_query_count = vec_queries .size (  );
+ answers .vec_has .resize ( st_query_count );
+ answers .vec_find .resize ( st_query_count );
+ answers .vec_count .resize ( st_query_count );
+ answers .st_occurrences = 0;
+ answers .b_correct = 1;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   answers .vec_has [ st_i ] = has_indexed_substring ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_has = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   answers .vec_find [ st_i ] = find_indexed_substring ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_find = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   answers .vec_count [ st_i ] = count_indexed_substrings ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_count = get_benchmark_seconds (  ) - dbl_start;
+
+ std::vector<uint32_t> vec_positions;
+ double dbl_all = 0;
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   vec_positions .clear (  );
+   dbl_start = get_benchmark_seconds (  );
+   size_t st_found = find_indexed_substrings ( index, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ), vec_positions );
+   dbl_all += get_benchmark_seconds (  ) - dbl_start;
+
+   answers .st_occurrences += st_found;
+   answers .b_correct = answers .b_correct && st_found == vec_positions .size (  ) && st_found == answers .vec_count [ st_i ];
+   for ( std::vector<uint32_t>::const_iterator it_position = vec_positions .cbegin (  ); it_position != vec_positions .cend (  ); it_position ++ ) {
+     answers .b_correct = answers .b_correct &&
+       ! memcmp ( str_text .data (  ) + *it_position, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+   }
+ }
+
+ fprintf (
+   stdout,
+   "  %-13s build %7.2f s; %5.1f bytes per input byte; has %6.3f, find %6.3f, count %6.3f, all %6.3f Mops/s\n",
+   lpsz_name,
+   dbl_build,
+   (double) get_substring_index_memory_usage ( index ) / str_text .size (  ),
+   st_query_count / dbl_has / 1e6,
+   st_query_count / dbl_find / 1e6,
+   st_query_count / dbl_count / 1e6,
+   st_query_count / dbl_all / 1e6
+ );
+}}
+
+ static void compare_substring_indexes ( const char *lpsz_name, const std::string &str_text, uint64_t *lpui64_state )
+{{
+ //The random patterns use every symbol of the text equally, so that the zeroes of the binary text don't make most of them match.
+ const size_t st_length = str_text .size (  );
+ std::string str_symbols;
+ uint8_t ary_seen [ 256 ] = { 0 };
+ for ( size_t st_i = 0; st_i < st_length; st_i ++ ) {
+   if ( ! ary_seen [ (uint8_t) str_text [ st_i ] ] ) {
+     ary_seen [ (uint8_t) str_text [ st_i ] ] = 1;
+     str_symbols += str_text [ st_i ];
+   }
+ }
+
+ //Short patterns, so that many of them occur more than once.
+ std::vector<std::string> vec_queries ( BENCHMARK_QUERY_COUNT );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   size_t st_query_length = 4 + get_benchmark_random ( lpui64_state ) % 13;
+   if ( st_i & 1 ) {
+     vec_queries [ st_i ] .resize ( st_query_length );
+     for ( size_t st_j = 0; st_j < st_query_length; st_j ++ ) {
+       vec_queries [ st_i ] [ st_j ] = str_symbols [ get_benchmark_random ( lpui64_state ) % str_symbols .size (  ) ];
+     }
+   }
+   else {
+     vec_queries [ st_i ] = str_text .substr ( get_benchmark_random ( lpui64_state ) % (st_length - st_query_length), st_query_length );
+   }
+ }
+
+ fprintf ( stdout, "%s, %.1f MB:\n", lpsz_name, st_length / 1e6 );
+ BENCHMARK_ANSWERS tree_answers, array_answers;
+ run_substring_index_benchmark ( "suffix tree", SUBSTRING_INDEX_SUFFIX_TREE, str_text, vec_queries, tree_answers );
+ run_substring_index_benchmark ( "suffix array", SUBSTRING_INDEX_SUFFIX_ARRAY, str_text, vec_queries, array_answers );
+
+ uint8_t b_same = tree_answers .vec_has == array_answers .vec_has &&
+   tree_answers .vec_find == array_answers .vec_find &&
+   tree_answers .vec_count == array_answers .vec_count &&
+   tree_answers .st_occurrences == array_answers .st_occurrences;
+ fprintf (
+   stdout,
+   "  %zu occurrences of %d patterns%s\n",
+   tree_answers .st_occurrences,
+   BENCHMARK_QUERY_COUNT,
+   b_same && tree_answers .b_correct && array_answers .b_correct ? "" : " (INCORRECT RESULTS)"
+ );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ std::vector<size_t> vec_sizes;
+ for ( int i = 1; i < argc; i ++ ) {
+   vec_sizes .push_back ( (size_t) (strtod ( argv [ i ], 0 ) * 1e6) );
+ }
+ if ( vec_sizes .empty (  ) ) {
+   vec_sizes .push_back ( 1000000 );
+   vec_sizes .push_back ( 10000000 );
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text;
+ for ( std::vector<size_t>::const_iterator it_size = vec_sizes .cbegin (  ); it_size != vec_sizes .cend (  ); it_size ++ ) {
+   //The node positions are 32-bit, and every text needs room for its terminator's leaf.
+   if ( *it_size < 64 || *it_size >= UINT32_MAX / 2 - 2 ) {
+     fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+     return 1;
+   }
+
+   generate_dna_text ( str_text, *it_size, &ui64_state );
+   compare_substring_indexes ( "DNA", str_text, &ui64_state );
+   generate_english_text ( str_text, *it_size, &ui64_state );
+   compare_substring_indexes ( "English", str_text, &ui64_state );
+   generate_binary_text ( str_text, *it_size, &ui64_state );
+   compare_substring_indexes ( "binary", str_text, &ui64_state );
+ }
+
+ return 0;
+}}
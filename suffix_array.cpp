@@ -0,0 +1,828 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To build and search suffix arrays (see suffix_array.h).
+
+ See:
+   Nong, Zhang, and Chan: "Two Efficient Algorithms for Linear Time Suffix Array Construction" (SA-IS)
+   Kasai, Lee, Arimura, Arikawa, and Park: "Linear-Time Longest-Common-Prefix Computation in Suffix Arrays and Its Applications"
+
+ To compile (with the comparison against the suffix tree):
+   g++ -O2 suffix_tree.cpp suffix_array.cpp substring_index.cpp substring_index_benchmark.cpp -o substring_index_benchmark
+*/
+ #include "suffix_array.h"
+ #include <algorithm>
+
+/*
+SA-IS, in short:
+
+Each suffix is S-type, if it's smaller than the suffix after it, or L-type, if it's larger.
+(Comparing the two only takes looking at their first characters, unless those are equal, in
+which case the suffix has the same type as the one after it.) An LMS (leftmost S) suffix is
+an S-type suffix right after an L-type one.
+
+If the LMS suffixes are already sorted, every other suffix can be sorted by "inducing":
+  1.) Put the LMS suffixes at the ends of their first characters' buckets, in order.
+  2.) Scan forward: for each suffix in the array, if the suffix before it (in the text) is
+      L-type, put it at the next free spot at the front of its bucket.
+  3.) Scan backward: for each suffix, if the suffix before it is S-type, put it at the next
+      free spot at the back of its bucket.
+To sort the LMS suffixes, they're induced once in text order, which sorts the LMS substrings
+(the characters from one LMS position to the next). Each LMS substring gets a name (its
+rank, where equal substrings share names), and if every name is unique, the LMS suffixes
+are sorted; otherwise, the string of names is sorted the same way, recursively. It's at most
+half as long, so the whole sort takes linear time.
+*/
+
+/*
+ This will induce the order of every suffix from the LMS suffixes in vec_lms (steps 1 to 3
+ above). vec_bucket_l and vec_bucket_s hold where each symbol's L-type and S-type
+ suffixes start in the array.
+*/
+ template <class SYMBOL> static void induce_suffix_array (
+   const SYMBOL *lp_text,
+   int32_t i32_length,
+   const std::vector<uint8_t> &vec_s_types,
+   const std::vector<int32_t> &vec_bucket_l,
+   const std::vector<int32_t> &vec_bucket_s,
+   const std::vector<int32_t> &vec_lms,
+   int32_t *lp_suffixes
+ )
+{{
+ for ( int32_t i = 0; i < i32_length; i ++ ) {
+   lp_suffixes [ i ] = -1;
+ }
+
+ std::vector<int32_t> vec_next ( vec_bucket_s );
+ for ( std::vector<int32_t>::const_iterator it_lms = vec_lms .cbegin (  ); it_lms != vec_lms .cend (  ); it_lms ++ ) {
+   lp_suffixes [ vec_next [ lp_text [ *it_lms ] ] ++ ] = *it_lms;
+ }
+
+ //The last suffix is L-type (nothing comes after it), and nothing would induce it.
+ vec_next = vec_bucket_l;
+ lp_suffixes [ vec_next [ lp_text [ i32_length - 1 ] ] ++ ] = i32_length - 1;
+ for ( int32_t i = 0; i < i32_length; i ++ ) {
+   int32_t i32_suffix = lp_suffixes [ i ];
+   if ( i32_suffix >= 1 && ! vec_s_types [ i32_suffix - 1 ] ) {
+     lp_suffixes [ vec_next [ lp_text [ i32_suffix - 1 ] ] ++ ] = i32_suffix - 1;
+   }
+ }
+
+ //The S-type suffixes of each bucket end where the next symbol's L-type suffixes start.
+ vec_next = vec_bucket_l;
+ for ( int32_t i = i32_length - 1; i >= 0; i -- ) {
+   int32_t i32_suffix = lp_suffixes [ i ];
+   if ( i32_suffix >= 1 && vec_s_types [ i32_suffix - 1 ] ) {
+     lp_suffixes [ -- vec_next [ lp_text [ i32_suffix - 1 ] + 1 ] ] = i32_suffix - 1;
+   }
+ }
+}}
+
+/*
+ This will sort the suffixes of i32_length symbols (each from 0 through i32_upper) into
+ lp_suffixes. A shorter suffix comes before every longer suffix that it's a prefix of.
+*/
+ template <class SYMBOL> static void sort_suffixes ( const SYMBOL *lp_text, int32_t i32_length, int32_t i32_upper, int32_t *lp_suffixes )
+{{
+ if ( i32_length <= 2 ) {
+   if ( i32_length == 2 ) {
+     lp_suffixes [ 0 ] = lp_text [ 0 ] < lp_text [ 1 ] ? 0 : 1;
+     lp_suffixes [ 1 ] = 1 - lp_suffixes [ 0 ];
+   }
+   else if ( i32_length == 1 ) {
+     lp_suffixes [ 0 ] = 0;
+   }
+   return ;
+ }
+
+ std::vector<uint8_t> vec_s_types ( i32_length, 0 );
+ for ( int32_t i = i32_length - 2; i >= 0; i -- ) {
+   vec_s_types [ i ] = lp_text [ i ] == lp_text [ i + 1 ] ? vec_s_types [ i + 1 ] : lp_text [ i ] < lp_text [ i + 1 ];
+ }
+
+ //Each symbol's bucket holds its L-type suffixes, then its S-type suffixes.
+ std::vector<int32_t> vec_bucket_l ( i32_upper + 2, 0 ), vec_bucket_s ( i32_upper + 2, 0 );
+ for ( int32_t i = 0; i < i32_length; i ++ ) {
+   if ( ! vec_s_types [ i ] ) {
+     vec_bucket_s [ lp_text [ i ] ] ++;
+   }
+   else {
+     vec_bucket_l [ lp_text [ i ] + 1 ] ++;
+   }
+ }
+ for ( int32_t i = 0; i <= i32_upper; i ++ ) {
+   vec_bucket_s [ i ] += vec_bucket_l [ i ];
+   vec_bucket_l [ i + 1 ] += vec_bucket_s [ i ];
+ }
+
+ std::vector<int32_t> vec_lms_names ( i32_length + 1, -1 ); //Each LMS suffix's position in vec_lms.
+ std::vector<int32_t> vec_lms;
+ for ( int32_t i = 1; i < i32_length; i ++ ) {
+   if ( ! vec_s_types [ i - 1 ] && vec_s_types [ i ] ) {
+     vec_lms_names [ i ] = (int32_t) vec_lms .size (  );
+     vec_lms .push_back ( i );
+   }
+ }
+
+ induce_suffix_array ( lp_text, i32_length, vec_s_types, vec_bucket_l, vec_bucket_s, vec_lms, lp_suffixes );
+ if ( vec_lms .empty (  ) ) {
+   return ;
+ }
+
+ //The LMS substrings are sorted now; name them.
+ int32_t i32_lms_count = (int32_t) vec_lms .size (  );
+ std::vector<int32_t> vec_sorted_lms;
+ vec_sorted_lms .reserve ( i32_lms_count );
+ for ( int32_t i = 0; i < i32_length; i ++ ) {
+   if ( vec_lms_names [ lp_suffixes [ i ] ] != -1 ) {
+     vec_sorted_lms .push_back ( lp_suffixes [ i ] );
+   }
+ }
+
+ std::vector<int32_t> vec_names ( i32_lms_count );
+ int32_t i32_name = 0;
+ vec_names [ vec_lms_names [ vec_sorted_lms [ 0 ] ] ] = 0;
+ for ( int32_t i = 1; i < i32_lms_count; i ++ ) {
+   int32_t i32_left = vec_sorted_lms [ i - 1 ], i32_right = vec_sorted_lms [ i ];
+   int32_t i32_left_end = vec_lms_names [ i32_left ] + 1 < i32_lms_count ? vec_lms [ vec_lms_names [ i32_left ] + 1 ] : i32_length;
+   int32_t i32_right_end = vec_lms_names [ i32_right ] + 1 < i32_lms_count ? vec_lms [ vec_lms_names [ i32_right ] + 1 ] : i32_length;
+   uint8_t b_same = i32_left_end - i32_left == i32_right_end - i32_right;
+   if ( b_same ) {
+     while ( i32_left < i32_left_end && lp_text [ i32_left ] == lp_text [ i32_right ] ) {
+       i32_left ++;
+       i32_right ++;
+     }
+     b_same = i32_left != i32_length && lp_text [ i32_left ] == lp_text [ i32_right ];
+   }
+   i32_name += ! b_same;
+   vec_names [ vec_lms_names [ vec_sorted_lms [ i ] ] ] = i32_name;
+ }
+
+ //Sort the LMS suffixes by sorting the string of their names.
+ std::vector<int32_t> (  ) .swap ( vec_lms_names );
+ std::vector<int32_t> vec_name_suffixes ( i32_lms_count );
+ sort_suffixes ( vec_names .data (  ), i32_lms_count, i32_name, vec_name_suffixes .data (  ) );
+ for ( int32_t i = 0; i < i32_lms_count; i ++ ) {
+   vec_sorted_lms [ i ] = vec_lms [ vec_name_suffixes [ i ] ];
+ }
+
+ induce_suffix_array ( lp_text, i32_length, vec_s_types, vec_bucket_l, vec_bucket_s, vec_sorted_lms, lp_suffixes );
+}}
+
+/*
+ This will return 1 (true), if no suffix runs past st_position: it's the end of the text, or
+ a document starts there (so the one before it ends). The document starts are a bitmap, so
+ that a comparison can check every byte it reads.
+*/
+ static inline uint8_t is_suffix_array_document_end ( const SUFFIX_ARRAY &suffix_array, size_t st_position )
+{{
+ return st_position >= suffix_array .str_text .size (  ) ||
+   (! suffix_array .vec_document_bits .empty (  ) && (suffix_array .vec_document_bits [ st_position >> 6 ] >> (st_position & 63)) & 1);
+}}
+
+ //This will return how many bytes the suffix at st_suffix shares with the pattern, given that it shares at least st_shared.
+ static inline size_t get_suffix_array_shared ( const SUFFIX_ARRAY &suffix_array, size_t st_suffix, const char *lp_pattern, size_t st_length, size_t st_shared )
+{{
+ const char *lp_text = suffix_array .str_text .data (  );
+ //Every suffix holds at least one byte of its own document.
+ if ( ! st_shared && st_length && lp_text [ st_suffix ] == lp_pattern [ 0 ] ) {
+   st_shared = 1;
+ }
+ while ( st_shared && st_shared < st_length && ! is_suffix_array_document_end ( suffix_array, st_suffix + st_shared ) &&
+         lp_text [ st_suffix + st_shared ] == lp_pattern [ st_shared ] ) {
+   st_shared ++;
+ }
+
+ return st_shared;
+}}
+
+/*
+ Kasai: the suffix after the next one in the text shares at least one fewer byte with its
+ neighbor, so the LCP array takes linear time. No common prefix runs past the end of
+ either suffix's document.
+*/
+ static void set_suffix_array_lcp ( SUFFIX_ARRAY &suffix_array )
+{{
+ const size_t st_length = suffix_array .str_text .size (  );
+ std::vector<uint32_t> vec_ranks ( st_length );
+ for ( uint32_t ui32_rank = 0; ui32_rank < (uint32_t) st_length; ui32_rank ++ ) {
+   vec_ranks [ suffix_array .vec_suffixes [ ui32_rank ] ] = ui32_rank;
+ }
+
+ const char *lp_text = suffix_array .str_text .data (  );
+ suffix_array .vec_lcp .assign ( st_length, 0 );
+ uint32_t ui32_shared = 0;
+ for ( uint32_t ui32_suffix = 0; ui32_suffix < (uint32_t) st_length; ui32_suffix ++ ) {
+   //What the last suffix shared doesn't carry over into the next document.
+   if ( ! vec_ranks [ ui32_suffix ] || is_suffix_array_document_end ( suffix_array, ui32_suffix ) ) {
+     ui32_shared = 0;
+     if ( ! vec_ranks [ ui32_suffix ] ) {
+       continue;
+     }
+   }
+
+   uint32_t ui32_previous = suffix_array .vec_suffixes [ vec_ranks [ ui32_suffix ] - 1 ];
+   if ( ! ui32_shared && lp_text [ ui32_suffix ] == lp_text [ ui32_previous ] ) {
+     ui32_shared = 1;
+   }
+   while ( ui32_shared &&
+           ! is_suffix_array_document_end ( suffix_array, ui32_suffix + ui32_shared ) &&
+           ! is_suffix_array_document_end ( suffix_array, ui32_previous + ui32_shared ) &&
+           lp_text [ ui32_suffix + ui32_shared ] == lp_text [ ui32_previous + ui32_shared ] ) {
+     ui32_shared ++;
+   }
+   suffix_array .vec_lcp [ vec_ranks [ ui32_suffix ] ] = ui32_shared;
+   ui32_shared -= ui32_shared > 0;
+ }
+}}
+
+/*
+ This will fill in vec_block_maximums (see suffix_array.h): the largest position in each
+ block of SUFFIX_ARRAY_BLOCK_SIZE suffixes, and then in each run of 2, 4, 8, ... blocks,
+ each from the two runs of half as many that it's made of.
+*/
+ static void set_suffix_array_block_maximums ( SUFFIX_ARRAY &suffix_array )
+{{
+ const size_t st_block_count = suffix_array .vec_suffixes .size (  ) / SUFFIX_ARRAY_BLOCK_SIZE;
+ size_t st_levels = 1;
+ while ( ((size_t) 1 << st_levels) <= st_block_count ) {
+   st_levels ++;
+ }
+ suffix_array .vec_block_maximums .assign ( st_block_count ? st_levels * st_block_count : 0, 0 );
+
+ uint32_t *lp_maximums = suffix_array .vec_block_maximums .data (  );
+ for ( size_t st_i = 0; st_i < st_block_count * SUFFIX_ARRAY_BLOCK_SIZE; st_i ++ ) {
+   uint32_t &ui32_maximum = lp_maximums [ st_i / SUFFIX_ARRAY_BLOCK_SIZE ];
+   if ( ui32_maximum < suffix_array .vec_suffixes [ st_i ] ) {
+     ui32_maximum = suffix_array .vec_suffixes [ st_i ];
+   }
+ }
+ for ( size_t st_level = 1; st_level < st_levels; st_level ++ ) {
+   const uint32_t *lp_half = lp_maximums + (st_level - 1) * st_block_count;
+   uint32_t *lp_level = lp_maximums + st_level * st_block_count;
+   size_t st_half = (size_t) 1 << (st_level - 1);
+   for ( size_t st_i = 0; st_i + 2 * st_half <= st_block_count; st_i ++ ) {
+     lp_level [ st_i ] = lp_half [ st_i ] > lp_half [ st_i + st_half ] ? lp_half [ st_i ] : lp_half [ st_i + st_half ];
+   }
+ }
+}}
+
+/*
+ This will build the suffix array (and LCP array) of st_length bytes of lp_data (which can
+ contain any bytes, including zeroes), replacing whatever the suffix array held before.
+ Returns 0 and leaves the suffix array empty, if the text is longer than SUFFIX_ARRAY_MAXIMUM_LENGTH bytes.
+*/
+ uint8_t generate_suffix_array ( SUFFIX_ARRAY &suffix_array, const char *lp_data, size_t st_length )
+{{
+ if ( st_length > SUFFIX_ARRAY_MAXIMUM_LENGTH ) {
+   suffix_array = SUFFIX_ARRAY (  );
+   return 0;
+ }
+
+ suffix_array .str_text .assign ( lp_data, st_length );
+ suffix_array .vec_document_starts .clear (  );
+ suffix_array .vec_document_bits .clear (  );
+ suffix_array .vec_suffixes .assign ( st_length, 0 );
+ sort_suffixes (
+   (const uint8_t *) suffix_array .str_text .data (  ),
+   (int32_t) st_length,
+   UINT8_MAX,
+   (int32_t *) suffix_array .vec_suffixes .data (  )
+ );
+
+ set_suffix_array_lcp ( suffix_array );
+ set_suffix_array_block_maximums ( suffix_array );
+
+ return 1;
+}}
+
+/*
+ This will build a generalized suffix array over several documents, which are stored one
+ after the other in lp_data; lpary_document_starts holds where each one starts (in order,
+ with the first at 0). Every document ends with its own terminator, so no match or common
+ prefix runs from one document into the next.
+
+ The terminators are symbols 0 through (document count - 1), and the bytes come after
+ them, so SA-IS sorts a string of 32-bit symbols rather than bytes here.
+ Returns 0 and leaves the suffix array empty, if the bytes and terminators together are
+ more than SUFFIX_ARRAY_MAXIMUM_LENGTH symbols.
+*/
+ uint8_t generate_document_suffix_array (
+   SUFFIX_ARRAY &suffix_array,
+   const char *lp_data,
+   size_t st_length,
+   const uint32_t *lpary_document_starts,
+   size_t st_document_count
+ )
+{{
+ if ( st_length > SUFFIX_ARRAY_MAXIMUM_LENGTH || st_document_count > SUFFIX_ARRAY_MAXIMUM_LENGTH - st_length ) {
+   suffix_array = SUFFIX_ARRAY (  );
+   return 0;
+ }
+
+ suffix_array .str_text .assign ( lp_data, st_length );
+ suffix_array .vec_document_starts .assign ( lpary_document_starts, lpary_document_starts + st_document_count );
+ suffix_array .vec_block_maximums .clear (  );
+ suffix_array .vec_document_bits .assign ( (st_length >> 6) + 1, 0 );
+ for ( size_t st_document = 0; st_document < st_document_count; st_document ++ ) {
+   suffix_array .vec_document_bits [ lpary_document_starts [ st_document ] >> 6 ] |= (uint64_t) 1 << (lpary_document_starts [ st_document ] & 63);
+ }
+
+ std::vector<int32_t> vec_symbols;
+ vec_symbols .reserve ( st_length + st_document_count );
+ for ( size_t st_document = 0; st_document < st_document_count; st_document ++ ) {
+   size_t st_end = st_document + 1 < st_document_count ? lpary_document_starts [ st_document + 1 ] : st_length;
+   for ( size_t st_i = lpary_document_starts [ st_document ]; st_i < st_end; st_i ++ ) {
+     vec_symbols .push_back ( (int32_t) st_document_count + (uint8_t) lp_data [ st_i ] );
+   }
+   vec_symbols .push_back ( (int32_t) st_document );
+ }
+
+ std::vector<int32_t> vec_suffixes ( vec_symbols .size (  ) );
+ sort_suffixes (
+   vec_symbols .data (  ),
+   (int32_t) vec_symbols .size (  ),
+   (int32_t) st_document_count + UINT8_MAX,
+   vec_suffixes .data (  )
+ );
+ std::vector<int32_t> (  ) .swap ( vec_symbols );
+
+ //The terminators' suffixes sort first; skip them, and take out the terminators before each of the others.
+ suffix_array .vec_suffixes .resize ( st_length );
+ for ( size_t st_i = st_document_count; st_i < vec_suffixes .size (  ); st_i ++ ) {
+   uint32_t ui32_suffix = (uint32_t) vec_suffixes [ st_i ];
+   //There's one terminator before each document; the document holding this suffix is the last one that starts at or before it.
+   size_t st_low = 0, st_high = st_document_count;
+   while ( st_high - st_low > 1 ) {
+     size_t st_middle = (st_low + st_high) >> 1;
+     if ( lpary_document_starts [ st_middle ] + st_middle <= ui32_suffix ) {
+       st_low = st_middle;
+     }
+     else {
+       st_high = st_middle;
+     }
+   }
+   suffix_array .vec_suffixes [ st_i - st_document_count ] = ui32_suffix - (uint32_t) st_low;
+ }
+
+ set_suffix_array_lcp ( suffix_array );
+ return 1;
+}}
+
+/*
+ This will return the first position in the suffix array whose suffix isn't smaller than the
+ pattern (b_past_matches == 0), or the first position past the suffixes that start with the
+ pattern (b_past_matches == 1).
+
+ Every suffix between the two ends of the search shares at least as many bytes with the
+ pattern as the ends both do, so those bytes are skipped.
+*/
+ static uint32_t search_suffix_array ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length, uint8_t b_past_matches )
+{{
+ const uint8_t *lp_text = (const uint8_t *) suffix_array .str_text .data (  );
+ const uint8_t *lp_symbols = (const uint8_t *) lp_pattern;
+ uint32_t ui32_low = 0, ui32_high = (uint32_t) suffix_array .vec_suffixes .size (  );
+ size_t st_low_shared = 0, st_high_shared = 0;
+
+ while ( ui32_low < ui32_high ) {
+   uint32_t ui32_middle = ui32_low + ((ui32_high - ui32_low) >> 1);
+   size_t st_suffix = suffix_array .vec_suffixes [ ui32_middle ];
+   size_t st_shared = get_suffix_array_shared (
+     suffix_array,
+     st_suffix,
+     lp_pattern,
+     st_length,
+     st_low_shared < st_high_shared ? st_low_shared : st_high_shared
+   );
+
+   //Is the suffix in the middle before the end that we're looking for? (A suffix that ends first is smaller.)
+   uint8_t b_before;
+   if ( st_shared == st_length ) {
+     b_before = b_past_matches;
+   }
+   else {
+     b_before = (st_shared && is_suffix_array_document_end ( suffix_array, st_suffix + st_shared )) ||
+       lp_text [ st_suffix + st_shared ] < lp_symbols [ st_shared ];
+   }
+
+   if ( b_before ) {
+     ui32_low = ui32_middle + 1;
+     st_low_shared = st_shared;
+   }
+   else {
+     ui32_high = ui32_middle;
+     st_high_shared = st_shared;
+   }
+ }
+
+ return ui32_low;
+}}
+
+/*
+ This will return how many suffixes start with the pattern, and set *lpui32_first to the
+ position in vec_suffixes of the first of them (they're all next to each other).
+*/
+ size_t find_suffix_array_range ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length, uint32_t *lpui32_first )
+{{
+ *lpui32_first = 0;
+ if ( ! lp_pattern || ! st_length ) {
+   return 0;
+ }
+
+ *lpui32_first = search_suffix_array ( suffix_array, lp_pattern, st_length, 0 );
+
+ return search_suffix_array ( suffix_array, lp_pattern, st_length, 1 ) - *lpui32_first;
+}}
+
+//This will return 1 (true), if the pattern occurs in the text; it only needs one search.
+ uint8_t has_suffix_array_substring ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length )
+{{
+ if ( ! lp_pattern || ! st_length ) {
+   return 0;
+ }
+
+ uint32_t ui32_first = search_suffix_array ( suffix_array, lp_pattern, st_length, 0 );
+ if ( ui32_first == suffix_array .vec_suffixes .size (  ) ) {
+   return 0;
+ }
+ uint32_t ui32_suffix = suffix_array .vec_suffixes [ ui32_first ];
+
+ return get_suffix_array_shared ( suffix_array, ui32_suffix, lp_pattern, st_length, 0 ) == st_length;
+}}
+
+/*
+ This will return the largest suffix position from ui32_first up to (not including) ui32_end
+ in the array, which must not be empty. The blocks that the range covers completely are
+ looked up in vec_block_maximums, if it's there, and the rest are looked at one at a time.
+*/
+ static uint32_t get_suffix_array_maximum_position ( const SUFFIX_ARRAY &suffix_array, uint32_t ui32_first, uint32_t ui32_end )
+{{
+ const uint32_t *lp_suffixes = suffix_array .vec_suffixes .data (  );
+ uint32_t ui32_first_block = (ui32_first + SUFFIX_ARRAY_BLOCK_SIZE - 1) / SUFFIX_ARRAY_BLOCK_SIZE;
+ uint32_t ui32_end_block = ui32_end / SUFFIX_ARRAY_BLOCK_SIZE;
+ uint32_t ui32_maximum = 0;
+ if ( suffix_array .vec_block_maximums .empty (  ) || ui32_first_block >= ui32_end_block ) {
+   for ( uint32_t ui32_i = ui32_first; ui32_i < ui32_end; ui32_i ++ ) {
+     ui32_maximum = lp_suffixes [ ui32_i ] > ui32_maximum ? lp_suffixes [ ui32_i ] : ui32_maximum;
+   }
+   return ui32_maximum;
+ }
+
+ for ( uint32_t ui32_i = ui32_first; ui32_i < ui32_first_block * SUFFIX_ARRAY_BLOCK_SIZE; ui32_i ++ ) {
+   ui32_maximum = lp_suffixes [ ui32_i ] > ui32_maximum ? lp_suffixes [ ui32_i ] : ui32_maximum;
+ }
+ for ( uint32_t ui32_i = ui32_end_block * SUFFIX_ARRAY_BLOCK_SIZE; ui32_i < ui32_end; ui32_i ++ ) {
+   ui32_maximum = lp_suffixes [ ui32_i ] > ui32_maximum ? lp_suffixes [ ui32_i ] : ui32_maximum;
+ }
+
+ //Two runs of 2^level blocks, one from each end, cover the blocks in between (overlapping, if they have to).
+ uint32_t ui32_level = 0;
+ while ( (2u << ui32_level) <= ui32_end_block - ui32_first_block ) {
+   ui32_level ++;
+ }
+ const uint32_t *lp_level = suffix_array .vec_block_maximums .data (  ) + (size_t) ui32_level * (suffix_array .vec_suffixes .size (  ) / SUFFIX_ARRAY_BLOCK_SIZE);
+ uint32_t ui32_left = lp_level [ ui32_first_block ], ui32_right = lp_level [ ui32_end_block - (1u << ui32_level) ];
+ ui32_maximum = ui32_left > ui32_maximum ? ui32_left : ui32_maximum;
+ ui32_maximum = ui32_right > ui32_maximum ? ui32_right : ui32_maximum;
+
+ return ui32_maximum;
+}}
+
+/*
+ Like find_trie_substring, this will return the one-based index of the rightmost occurrence,
+ or 0, if the pattern doesn't occur. The occurrences are in suffix order, so the rightmost is
+ the largest position in their range (see get_suffix_array_maximum_position).
+*/
+ size_t find_suffix_array_substring ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length )
+{{
+ uint32_t ui32_first;
+ size_t st_count = find_suffix_array_range ( suffix_array, lp_pattern, st_length, &ui32_first );
+ if ( ! st_count ) {
+   return 0;
+ }
+
+ return (size_t) get_suffix_array_maximum_position ( suffix_array, ui32_first, ui32_first + (uint32_t) st_count ) + 1;
+}}
+
+ //This will return how many times the pattern occurs in the text (overlapping occurrences included).
+ size_t count_suffix_array_substrings ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length )
+{{
+ uint32_t ui32_first;
+
+ return find_suffix_array_range ( suffix_array, lp_pattern, st_length, &ui32_first );
+}}
+
+/*
+ This will add the zero-based position of every occurrence of the pattern to vec_positions
+ (in suffix order, which is no particular order in the text) and return how many there were.
+*/
+ size_t find_suffix_array_substrings ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions )
+{{
+ uint32_t ui32_first;
+ size_t st_count = find_suffix_array_range ( suffix_array, lp_pattern, st_length, &ui32_first );
+ vec_positions .insert (
+   vec_positions .end (  ),
+   suffix_array .vec_suffixes .begin (  ) + ui32_first,
+   suffix_array .vec_suffixes .begin (  ) + ui32_first + st_count
+ );
+
+ return st_count;
+}}
+
+/*
+ This will return which document (counting from 0) holds the byte at ui32_position.
+ (It's always 0, if the suffix array was built without documents.)
+*/
+ uint32_t get_suffix_array_document ( const SUFFIX_ARRAY &suffix_array, uint32_t ui32_position )
+{{
+ if ( suffix_array .vec_document_starts .empty (  ) ) {
+   return 0;
+ }
+
+ return (uint32_t) (std::upper_bound (
+   suffix_array .vec_document_starts .cbegin (  ),
+   suffix_array .vec_document_starts .cend (  ),
+   ui32_position
+ ) - suffix_array .vec_document_starts .cbegin (  )) - 1;
+}}
+
+ //This will return how many different documents hold the pattern.
+ size_t count_suffix_array_documents ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length )
+{{
+ uint32_t ui32_first;
+ size_t st_count = find_suffix_array_range ( suffix_array, lp_pattern, st_length, &ui32_first );
+ if ( st_count < 2 ) {
+   return st_count;
+ }
+
+ std::vector<uint32_t> vec_documents ( st_count );
+ for ( size_t st_i = 0; st_i < st_count; st_i ++ ) {
+   vec_documents [ st_i ] = get_suffix_array_document ( suffix_array, suffix_array .vec_suffixes [ ui32_first + st_i ] );
+ }
+ std::sort ( vec_documents .begin (  ), vec_documents .end (  ) );
+
+ return std::unique ( vec_documents .begin (  ), vec_documents .end (  ) ) - vec_documents .begin (  );
+}}
+
+/*
+ This will find the longest prefix that the suffixes in a window of the sorted order share,
+ among the windows that hold suffixes of at least ui32_min_documents different documents,
+ set *lpui32_rank to the position (in the sorted order) of one of those suffixes, and return
+ its length. lpary_documents holds each suffix's document (from 0 to st_document_count - 1)
+ and lpary_lcp how many bytes it shares with the one before it, in sorted order.
+
+ The suffixes that share a prefix are next to each other, so this slides a window over the
+ sorted order: it grows the window until it holds ui32_min_documents documents, then
+ shrinks it from the front for as long as it still does. The prefix that every suffix in
+ the window shares is as long as the smallest LCP inside of it, which a deque of the LCPs
+ in increasing order keeps track of. That takes linear time.
+*/
+ static size_t find_longest_window_prefix (
+   const uint32_t *lpary_documents,
+   const uint32_t *lpary_lcp,
+   uint32_t ui32_count,
+   size_t st_document_count,
+   uint32_t ui32_min_documents,
+   uint32_t *lpui32_rank
+ )
+{{
+ std::vector<uint32_t> vec_in_window ( st_document_count, 0 ); //How many of each document's suffixes are in the window.
+ std::vector<uint32_t> vec_minimums ( ui32_count ); //A deque of positions (in the window) of increasing LCPs.
+ uint32_t ui32_minimum_front = 0, ui32_minimum_back = 0;
+ uint32_t ui32_documents = 0, ui32_front = 0;
+ size_t st_best = 0;
+ *lpui32_rank = 0;
+
+ for ( uint32_t ui32_back = 0; ui32_back < ui32_count; ui32_back ++ ) {
+   ui32_documents += ! vec_in_window [ lpary_documents [ ui32_back ] ] ++;
+   //The LCP at a position is between that suffix and the one before it, so the window's LCPs start after its front.
+   if ( ui32_back > ui32_front ) {
+     while ( ui32_minimum_back > ui32_minimum_front && lpary_lcp [ vec_minimums [ ui32_minimum_back - 1 ] ] >= lpary_lcp [ ui32_back ] ) {
+       ui32_minimum_back --;
+     }
+     vec_minimums [ ui32_minimum_back ++ ] = ui32_back;
+   }
+
+   while ( ui32_documents >= ui32_min_documents ) {
+     //Every suffix in the window shares this much.
+     if ( ui32_minimum_back > ui32_minimum_front && lpary_lcp [ vec_minimums [ ui32_minimum_front ] ] > st_best ) {
+       st_best = lpary_lcp [ vec_minimums [ ui32_minimum_front ] ];
+       *lpui32_rank = ui32_back;
+     }
+
+     //Can the front go and leave enough documents?
+     if ( vec_in_window [ lpary_documents [ ui32_front ] ] == 1 && ui32_documents == ui32_min_documents ) {
+       break;
+     }
+     ui32_documents -= ! -- vec_in_window [ lpary_documents [ ui32_front ] ];
+     ui32_front ++;
+     if ( ui32_minimum_back > ui32_minimum_front && vec_minimums [ ui32_minimum_front ] <= ui32_front ) {
+       ui32_minimum_front ++;
+     }
+   }
+ }
+
+ return st_best;
+}}
+
+/*
+ This will find the longest substring that occurs in at least ui32_min_documents different
+ documents, set *lpui32_position to the position of one of its occurrences, and return its
+ length (0, if there isn't one). See find_longest_window_prefix; this takes linear time
+ (after finding each suffix's document).
+*/
+ size_t find_suffix_array_longest_common_substring ( const SUFFIX_ARRAY &suffix_array, uint32_t ui32_min_documents, uint32_t *lpui32_position )
+{{
+ const uint32_t ui32_count = (uint32_t) suffix_array .vec_suffixes .size (  );
+ *lpui32_position = 0;
+ if ( ui32_min_documents < 2 || ui32_min_documents > suffix_array .vec_document_starts .size (  ) ) {
+   return 0;
+ }
+
+ std::vector<uint32_t> vec_documents ( ui32_count );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_count; ui32_i ++ ) {
+   vec_documents [ ui32_i ] = get_suffix_array_document ( suffix_array, suffix_array .vec_suffixes [ ui32_i ] );
+ }
+
+ uint32_t ui32_rank;
+ size_t st_best = find_longest_window_prefix (
+   vec_documents .data (  ),
+   suffix_array .vec_lcp .data (  ),
+   ui32_count,
+   suffix_array .vec_document_starts .size (  ),
+   ui32_min_documents,
+   &ui32_rank
+ );
+ if ( st_best ) {
+   *lpui32_position = suffix_array .vec_suffixes [ ui32_rank ];
+ }
+
+ return st_best;
+}}
+
+/*
+ This will compare the suffix at st_left in left with the one at st_right in right, in the
+ order that the sort puts them in (a suffix that ends first is the smaller one), and set
+ *lpst_shared to how many bytes they share. Returns -1, 1, or 0 (both end after the same bytes).
+*/
+ static int8_t compare_suffix_array_suffixes ( const SUFFIX_ARRAY &left, size_t st_left, const SUFFIX_ARRAY &right, size_t st_right, size_t *lpst_shared )
+{{
+ const uint8_t *lp_left = (const uint8_t *) left .str_text .data (  ) + st_left;
+ const uint8_t *lp_right = (const uint8_t *) right .str_text .data (  ) + st_right;
+ //Every suffix holds at least one byte of its own document.
+ size_t st_shared = 0;
+ while ( lp_left [ st_shared ] == lp_right [ st_shared ] ) {
+   st_shared ++;
+   uint8_t b_left_end = is_suffix_array_document_end ( left, st_left + st_shared );
+   uint8_t b_right_end = is_suffix_array_document_end ( right, st_right + st_shared );
+   if ( b_left_end || b_right_end ) {
+     *lpst_shared = st_shared;
+     return (int8_t) b_right_end - (int8_t) b_left_end;
+   }
+ }
+
+ *lpst_shared = st_shared;
+ return lp_left [ st_shared ] < lp_right [ st_shared ] ? -1 : 1;
+}}
+
+/*
+ This will move vec_order [ st_index ] later in vec_order, until it comes before every array
+ whose next suffix (at vec_next) is larger, or the same and in a later array.
+*/
+ static void insert_suffix_array_merge_order (
+   const std::vector<SUFFIX_ARRAY> &vec_arrays,
+   const std::vector<uint32_t> &vec_next,
+   std::vector<size_t> &vec_order,
+   size_t st_index
+ )
+{{
+ size_t st_array = vec_order [ st_index ], st_shared;
+ const SUFFIX_ARRAY &suffix_array = vec_arrays [ st_array ];
+ while ( st_index + 1 < vec_order .size (  ) ) {
+   size_t st_other = vec_order [ st_index + 1 ];
+   int8_t i8_order = compare_suffix_array_suffixes (
+     suffix_array, suffix_array .vec_suffixes [ vec_next [ st_array ] ],
+     vec_arrays [ st_other ], vec_arrays [ st_other ] .vec_suffixes [ vec_next [ st_other ] ],
+     &st_shared
+   );
+   if ( i8_order < 0 || (! i8_order && st_array < st_other) ) {
+     break;
+   }
+   vec_order [ st_index ] = st_other;
+   st_index ++;
+ }
+ vec_order [ st_index ] = st_array;
+}}
+
+/*
+ This will do what find_suffix_array_longest_common_substring does for documents that are
+ split between several generalized suffix arrays, numbered in order (the first array's
+ documents, then the second's, and so on), without building one array over all of them.
+ It sets *lpst_array to the array holding the occurrence and *lpui32_position to where it
+ is in that array's text.
+
+ Each array is already sorted, so their suffixes are merged (the smallest of the arrays' next
+ suffixes goes next). Two suffixes in a row from the same array are next to each other in it,
+ so they share the LCP that it already has; the rest are compared.
+*/
+ size_t find_suffix_arrays_longest_common_substring (
+   const std::vector<SUFFIX_ARRAY> &vec_arrays,
+   uint32_t ui32_min_documents,
+   size_t *lpst_array,
+   uint32_t *lpui32_position
+ )
+{{
+ *lpst_array = 0;
+ *lpui32_position = 0;
+ size_t st_count = 0, st_document_count = 0;
+ std::vector<size_t> vec_first_documents ( vec_arrays .size (  ) );
+ for ( size_t st_array = 0; st_array < vec_arrays .size (  ); st_array ++ ) {
+   vec_first_documents [ st_array ] = st_document_count;
+   st_document_count += vec_arrays [ st_array ] .vec_document_starts .size (  );
+   st_count += vec_arrays [ st_array ] .vec_suffixes .size (  );
+ }
+ if ( ui32_min_documents < 2 || ui32_min_documents > st_document_count || st_count > UINT32_MAX ) {
+   return 0;
+ }
+
+ //Each array's documents, by position, so that the merge doesn't search for them.
+ std::vector< std::vector<uint32_t> > vec_position_documents ( vec_arrays .size (  ) );
+ for ( size_t st_array = 0; st_array < vec_arrays .size (  ); st_array ++ ) {
+   const SUFFIX_ARRAY &suffix_array = vec_arrays [ st_array ];
+   std::vector<uint32_t> &vec_array_documents = vec_position_documents [ st_array ];
+   vec_array_documents .resize ( suffix_array .str_text .size (  ) );
+   for ( size_t st_document = 0; st_document < suffix_array .vec_document_starts .size (  ); st_document ++ ) {
+     size_t st_end = st_document + 1 < suffix_array .vec_document_starts .size (  ) ? suffix_array .vec_document_starts [ st_document + 1 ] : suffix_array .str_text .size (  );
+     std::fill ( vec_array_documents .begin (  ) + suffix_array .vec_document_starts [ st_document ], vec_array_documents .begin (  ) + st_end, (uint32_t) (vec_first_documents [ st_array ] + st_document) );
+   }
+ }
+
+ //The arrays that have suffixes left, in the order of their next suffixes (ties go to the earlier array, whose documents come first).
+ std::vector<uint32_t> vec_next ( vec_arrays .size (  ), 0 ); //The rank of each array's next suffix.
+ std::vector<size_t> vec_order;
+ for ( size_t st_array = 0; st_array < vec_arrays .size (  ); st_array ++ ) {
+   if ( ! vec_arrays [ st_array ] .vec_suffixes .empty (  ) ) {
+     vec_order .insert ( vec_order .begin (  ), st_array );
+     insert_suffix_array_merge_order ( vec_arrays, vec_next, vec_order, 0 );
+   }
+ }
+
+ std::vector<uint32_t> vec_documents ( st_count ), vec_lcp ( st_count ), vec_sources ( st_count );
+ size_t st_previous_array = 0, st_shared;
+ for ( size_t st_i = 0; st_i < st_count; st_i ++ ) {
+   size_t st_array = vec_order [ 0 ];
+   const SUFFIX_ARRAY &suffix_array = vec_arrays [ st_array ];
+   uint32_t ui32_position = suffix_array .vec_suffixes [ vec_next [ st_array ] ];
+   vec_documents [ st_i ] = vec_position_documents [ st_array ] [ ui32_position ];
+   vec_sources [ st_i ] = (uint32_t) st_array;
+   if ( st_i && st_array == st_previous_array ) {
+     vec_lcp [ st_i ] = suffix_array .vec_lcp [ vec_next [ st_array ] ];
+   }
+   else if ( st_i ) {
+     const SUFFIX_ARRAY &previous = vec_arrays [ st_previous_array ];
+     compare_suffix_array_suffixes ( previous, previous .vec_suffixes [ vec_next [ st_previous_array ] - 1 ], suffix_array, ui32_position, &st_shared );
+     vec_lcp [ st_i ] = (uint32_t) st_shared;
+   }
+   st_previous_array = st_array;
+
+   //Move the array back to where its next suffix goes; it's usually still first.
+   if ( ++ vec_next [ st_array ] == suffix_array .vec_suffixes .size (  ) ) {
+     vec_order .erase ( vec_order .begin (  ) );
+   }
+   else {
+     insert_suffix_array_merge_order ( vec_arrays, vec_next, vec_order, 0 );
+   }
+ }
+
+ uint32_t ui32_rank;
+ size_t st_best = find_longest_window_prefix (
+   vec_documents .data (  ),
+   vec_lcp .data (  ),
+   (uint32_t) st_count,
+   st_document_count,
+   ui32_min_documents,
+   &ui32_rank
+ );
+ if ( st_best ) {
+   //The merge doesn't keep positions, so find the suffix again: it's the one at its array's rank among that array's suffixes so far.
+   *lpst_array = vec_sources [ ui32_rank ];
+   uint32_t ui32_array_rank = 0;
+   for ( uint32_t ui32_i = 0; ui32_i < ui32_rank; ui32_i ++ ) {
+     ui32_array_rank += vec_sources [ ui32_i ] == vec_sources [ ui32_rank ];
+   }
+   *lpui32_position = vec_arrays [ *lpst_array ] .vec_suffixes [ ui32_array_rank ];
+ }
+
+ return st_best;
+}}
+
+//This will return how many bytes the suffix array holds (by capacity, since that's what's allocated).
+ size_t get_suffix_array_memory_usage ( const SUFFIX_ARRAY &suffix_array )
+{{
+ return sizeof ( SUFFIX_ARRAY ) +
+   suffix_array .str_text .capacity (  ) +
+   suffix_array .vec_suffixes .capacity (  ) * sizeof ( uint32_t ) +
+   suffix_array .vec_lcp .capacity (  ) * sizeof ( uint32_t ) +
+   suffix_array .vec_document_starts .capacity (  ) * sizeof ( uint32_t ) +
+   suffix_array .vec_document_bits .capacity (  ) * sizeof ( uint64_t ) +
+   suffix_array .vec_block_maximums .capacity (  ) * sizeof ( uint32_t );
+}}
@@ -0,0 +1,91 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: A suffix array index, as a memory-lean alternative to the suffix tree (suffix_tree.h).
+
+ generate_suffix_array sorts every suffix of a text in linear time with SA-IS (induced
+ sorting), and then finds the longest common prefix of each pair of neighboring suffixes
+ with Kasai's algorithm. The index is the text, the sorted suffix positions, and the LCP
+ array: 9 bytes per byte of text, where the suffix tree takes 45 to 60. The positions are
+ 32-bit, so a text (with its documents' terminators) can be at most SUFFIX_ARRAY_MAXIMUM_LENGTH
+ symbols (just under 2 GB) long; longer ones are refused.
+
+ A pattern's occurrences are the suffixes that start with it, which are next to each other
+ in the array, so each query is a binary search for that range (which also skips the
+ characters that both ends of the range are already known to share with the pattern).
+ Queries take O(m log n) time, for a pattern of m bytes and a text of n bytes, rather than
+ the tree's O(m).
+
+ find_suffix_array_substring wants the rightmost occurrence, which is the largest position in
+ that range. generate_suffix_array also keeps the largest position in each block of
+ SUFFIX_ARRAY_BLOCK_SIZE suffixes, in a sparse table (every run of 1, 2, 4, ... blocks), so
+ that takes two lookups plus a scan of the partial blocks at either end: about 1 more byte
+ per byte of text. Generalized suffix arrays don't have the table (the document index never
+ asks for the rightmost occurrence), so there it looks at every occurrence.
+
+ generate_document_suffix_array indexes many documents at once (a generalized suffix
+ array): each document ends with its own terminator, so no match or common prefix runs
+ from one document into the next. get_suffix_array_document turns a position into its
+ document, and find_suffix_array_longest_common_substring finds the longest substring
+ that a number of documents share (find_suffix_arrays_longest_common_substring does the
+ same for documents split between several arrays, by merging them as it goes).
+
+ See suffix_array.cpp for the implementation, substring_index.h for switching between
+ this and the suffix tree behind one interface, and document_index.h for a collection of
+ documents that grows.
+*/
+#ifndef SUFFIX_ARRAY_HEADER_DEFINED
+#define SUFFIX_ARRAY_HEADER_DEFINED 1
+#ifndef _WIN32
+ #include "string.h"
+#else
+ #include "windows.h"
+#endif
+ #include "stdio.h"
+ #include "stdlib.h"
+ #include "stdint.h"
+ #include "inttypes.h"
+ #include <string>
+ #include <vector>
+
+ #ifndef SUFFIX_ARRAY_BLOCK_SIZE
+   #define SUFFIX_ARRAY_BLOCK_SIZE 64
+ #endif
+
+ //The most symbols (bytes, plus one terminator per document in a generalized suffix array) that can be indexed,
+ //since SA-IS sorts them with 32-bit signed positions.
+ #define SUFFIX_ARRAY_MAXIMUM_LENGTH ( (size_t) INT32_MAX - 1 )
+
+typedef struct SUFFIX_ARRAY {
+  std::string str_text; //The indexed text.
+  std::vector<uint32_t> vec_suffixes; //The position of every suffix of the text, in sorted order.
+  std::vector<uint32_t> vec_lcp; //How many bytes each suffix shares with the one before it in vec_suffixes (the first is 0).
+  std::vector<uint32_t> vec_document_starts; //Where each document starts in str_text (empty, if the text is one document).
+  std::vector<uint64_t> vec_document_bits; //One bit per position in str_text (and one past it), set where a document starts.
+  std::vector<uint32_t> vec_block_maximums; //The largest suffix position in each run of 2^level blocks, from block I, at [ level * (block count) + I ] (empty, if the text has documents).
+} SUFFIX_ARRAY;
+
+ uint8_t generate_suffix_array ( SUFFIX_ARRAY &suffix_array, const char *lp_data, size_t st_length );
+ uint8_t generate_document_suffix_array (
+   SUFFIX_ARRAY &suffix_array,
+   const char *lp_data,
+   size_t st_length,
+   const uint32_t *lpary_document_starts,
+   size_t st_document_count
+ );
+ size_t find_suffix_array_range ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length, uint32_t *lpui32_first );
+ uint8_t has_suffix_array_substring ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length );
+ size_t find_suffix_array_substring ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length );
+ size_t count_suffix_array_substrings ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length );
+ size_t find_suffix_array_substrings ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions );
+ uint32_t get_suffix_array_document ( const SUFFIX_ARRAY &suffix_array, uint32_t ui32_position );
+ size_t count_suffix_array_documents ( const SUFFIX_ARRAY &suffix_array, const char *lp_pattern, size_t st_length );
+ size_t find_suffix_array_longest_common_substring ( const SUFFIX_ARRAY &suffix_array, uint32_t ui32_min_documents, uint32_t *lpui32_position );
+ size_t find_suffix_arrays_longest_common_substring (
+   const std::vector<SUFFIX_ARRAY> &vec_arrays,
+   uint32_t ui32_min_documents,
+   size_t *lpst_array,
+   uint32_t *lpui32_position
+ );
+ size_t get_suffix_array_memory_usage ( const SUFFIX_ARRAY &suffix_array );
+
+#endif
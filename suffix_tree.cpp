@@ -6,46 +6,29 @@
  [X] Generate suffix trie.
  [X] Matching substring with suffix trie.
  [X] MSVC and GCC compatibility.
- [ ] Use std::vector<TRIE>::insert on TRIE.vec_children to place each
- key at an alphabetical position.
- [ ] Store an extra std::vector<TRIE>* lpvec_first_char_map [ 256 ];
- This will map each possible starting character to the first of each
- list of nodes in the vector mentioned hereinabove for that character.
- It's important that the list be sorted as it is created so that this
- will work. It will speed inserts greatly, as the list grows in size.
+ [X] Build the tree in linear time (Ukkonen's algorithm), instead of
+ inserting each suffix from the root, which took quadratic time.
+ [X] Store the edges as offsets into one copy of the text, and the nodes
+ in one flat array, linked to their first child and next sibling.
+ [X] Keep each node's children in alphabetical order.
+ [X] Map each possible starting character to its child, so that a search
+ doesn't scan the children. (Each node gets a sorted array, a bitmap, or
+ a 256-slot table, depending on how many children it has.)
+ [X] Count and list every occurrence without walking the subtree.
+ [X] Build keyword tries (for many patterns at once) with the same nodes and child containers.
+ [X] Answer queries straight from a saved tree that's mapped into memory.
+ [X] Answer batches of queries on every core, interleaving the searches on each.
+ [X] Find approximate matches (Hamming or edit distance) by pruning a walk of the tree.
  [ ] Implement this trie suffix tree code into a map for its keys.
 
  See:
    https://www.youtube.com/watch?v=VA9m_l6LpwI
+   https://en.wikipedia.org/wiki/Ukkonen%27s_algorithm
 
- Note:
-  Matches will happen from right to left.
+ To compile (with the example usage in suffix_tree_test.cpp):
+   g++ -O2 suffix_tree.cpp suffix_tree_test.cpp -o suffix_tree
 */
-#ifndef _WIN32
- #include "string.h"
-#else
- #include "windows.h"
-#endif
- #include "stdio.h"
- #include "stdlib.h"
- #include "stdint.h"
- #include "inttypes.h"
- #include <string>
- #include <vector>
-
- //If set to 1 (true), debugging output will be added.
- #define DEBUG_MODE 0
- #if ( DEBUG_MODE )
-   #define debug_printf(...) fprintf ( stdout, __VA_ARGS__ )
- #else
-   #define debug_printf(...)
- #endif
-
-typedef struct TRIE {
-  std::string str_substring; //either empty or contains some chunk of letters.
-  uint32_t ui32_index; //The index of the first character of the substring represented by this node.
-  std::vector<TRIE> vec_children; //vector of zero or more children
-} TRIE;
+ #include "suffix_tree.h"
 
 /*
 It seems like one should keep branching recursively and always match only
@@ -101,122 +84,691 @@ GCTAB CTAB TA           A        B
 GCTAB      TA           A        B     CTA
           B  AGTAB     B AGTAB        B   GCTAB
 */
- uint8_t add_trie (
-   TRIE &trie,
-   const char *lpsz_substring,
-   uint32_t ui32_index
- )
+
+/*
+Ukkonen's algorithm (which replaced the process above):
+
+Every path from the root to a leaf spells one suffix, and every edge is
+labelled with the (offset, end) of its characters in the text, instead of
+a copy of them. The tree is built from left to right, one character
+(phase) at a time. During each phase, every suffix that isn't already in
+the tree is extended by the new character:
+
+1.) A suffix that ends at a leaf is extended for free, because a leaf's
+edge always runs to the end of the text seen so far (TRIE_LEAF_END).
+2.) A suffix that ends where the new character can't follow gets a new
+leaf (splitting the edge that it ends in, if it ends inside one).
+3.) As soon as a suffix is found that the new character already follows,
+every shorter suffix is already followed by it, too, so the phase ends.
+
+The active point (a node, the first character of the edge below it, and
+how far along that edge we are) is where the next suffix that needs
+extending ends, and suffix links take us from one suffix to the next
+(one character shorter) without walking down from the root. Each phase
+only does as much work as the number of leaves that it creates, so the
+whole tree takes linear time to build.
+*/
+
+ #if defined ( _MSC_VER )
+   #include "intrin.h"
+   #define trie_popcount(x) ((uint32_t) __popcnt64 ( x ))
+ #else
+   #define trie_popcount(x) ((uint32_t) __builtin_popcountll ( x ))
+ #endif
+
+ //The parts of the tree that are only needed while it's being built.
+typedef struct TRIE_BUILDER {
+  std::vector<uint32_t> vec_suffix_links; //For internal nodes: the node for the node's path without its first character.
+  //The first of the nodes below each node, or TRIE_NONE, or (with TRIE_BUILDER_TABLE) the
+  //node's table in vec_tables, once it has TRIE_DIRECT_CHILDREN_MIN children.
+  std::vector<uint32_t> vec_first_child;
+  std::vector<uint32_t> vec_next_sibling; //The next node below each node's parent, or TRIE_NONE.
+  std::vector<uint16_t> vec_child_counts;
+  std::vector<uint32_t> vec_tables; //TRIE_TERMINATOR + 1 children per table, by their first symbols.
+} TRIE_BUILDER;
+
+ #define TRIE_BUILDER_TABLE 0x80000000 //A flag in TRIE_BUILDER.vec_first_child.
+ #define IS_TRIE_BUILDER_TABLE(x) ((x) != TRIE_NONE && ((x) & TRIE_BUILDER_TABLE))
+
+ //This will return the symbol at the offset, which is TRIE_TERMINATOR just past the end of the text.
+ static inline uint32_t get_trie_symbol ( const TRIE &trie, uint32_t ui32_offset )
 {{
- if ( ! lpsz_substring ) {
-   return 0;
+ return ui32_offset < trie .str_text .size (  ) ? (uint8_t) trie .str_text [ ui32_offset ] : TRIE_TERMINATOR;
+}}
+
+ //While building: this will return the child of the node whose edge starts with the symbol, or TRIE_NONE.
+ static uint32_t find_building_trie_child ( const TRIE &trie, const TRIE_BUILDER &builder, uint32_t ui32_node, uint32_t ui32_symbol )
+{{
+ uint32_t ui32_child = builder .vec_first_child [ ui32_node ];
+ if ( IS_TRIE_BUILDER_TABLE ( ui32_child ) ) {
+   return builder .vec_tables [ (size_t) (ui32_child & ~TRIE_BUILDER_TABLE) * (TRIE_TERMINATOR + 1) + ui32_symbol ];
  }
- const char *lp_existing_branch_mismatch_point = 0;
- size_t st_existing_branch_mismatch_index = 0;
- TRIE *node = &trie;
- const char *lpsz_original_substring = lpsz_substring;
-
- bool b_done;
- //while we match as many characers as possible from lpsz_substring with
- //one of the children of the passed trie.
- do {
-
-   b_done = true;
-   debug_printf ( "Viewing nodes of substring: \"%s\"\n", node ->str_substring .c_str (  ) );
-   //Match as many characters as possible, then step into the child node.
-   for ( auto &t : node ->vec_children ) {
-     debug_printf ( "  Viewing node: \"%s\"\n", t .str_substring .c_str (  ) );
-
-     if ( *lpsz_substring == t .str_substring [ 0 ] ) {
-       lp_existing_branch_mismatch_point = t .str_substring .c_str (  ) + 1;
-       lpsz_substring ++;
-
-       while ( *lpsz_substring && *lp_existing_branch_mismatch_point == *lpsz_substring ) {
-         lp_existing_branch_mismatch_point ++, lpsz_substring ++;
-       }
+ while ( ui32_child != TRIE_NONE && get_trie_symbol ( trie, trie .vec_nodes [ ui32_child ] .ui32_start ) != ui32_symbol ) {
+   ui32_child = builder .vec_next_sibling [ ui32_child ];
+ }
+
+ return ui32_child;
+}}
+
+ //This will add a node whose edge is [ui32_start, ui32_end) and return its position.
+ static uint32_t new_trie_node ( TRIE &trie, TRIE_BUILDER &builder, uint32_t ui32_start, uint32_t ui32_end, uint32_t ui32_index )
+{{
+ TRIE_NODE node;
+ node .ui32_start = ui32_start;
+ node .ui32_end = ui32_end;
+ node .ui32_index = ui32_index;
+ node .ui32_children = 0;
+ node .ui16_child_count = 0;
+ node .ui8_child_type = TRIE_CHILDREN_NONE;
+ node .ui32_first_leaf = 0;
+ node .ui32_leaf_count = 0;
+ trie .vec_nodes .push_back ( node );
+ builder .vec_suffix_links .push_back ( TRIE_ROOT );
+ builder .vec_first_child .push_back ( TRIE_NONE );
+ builder .vec_next_sibling .push_back ( TRIE_NONE );
+ builder .vec_child_counts .push_back ( 0 );
+
+ return (uint32_t) trie .vec_nodes .size (  ) - 1;
+}}
+
+/*
+ This will make ui32_child the first child of ui32_parent, or put it in the parent's table.
+ A node whose list grows to TRIE_DIRECT_CHILDREN_MIN children gets a table instead, so that
+ building the tree of a text with every byte value doesn't scan long lists either.
+*/
+ static void add_trie_child ( const TRIE &trie, TRIE_BUILDER &builder, uint32_t ui32_parent, uint32_t ui32_child )
+{{
+ uint32_t ui32_first_child = builder .vec_first_child [ ui32_parent ];
+ if ( IS_TRIE_BUILDER_TABLE ( ui32_first_child ) ) {
+   size_t st_table = (size_t) (ui32_first_child & ~TRIE_BUILDER_TABLE) * (TRIE_TERMINATOR + 1);
+   builder .vec_tables [ st_table + get_trie_symbol ( trie, trie .vec_nodes [ ui32_child ] .ui32_start ) ] = ui32_child;
+   return ;
+ }
+
+ builder .vec_next_sibling [ ui32_child ] = ui32_first_child;
+ builder .vec_first_child [ ui32_parent ] = ui32_child;
+ if ( ++ builder .vec_child_counts [ ui32_parent ] >= TRIE_DIRECT_CHILDREN_MIN ) {
+   size_t st_table = builder .vec_tables .size (  );
+   builder .vec_tables .resize ( st_table + TRIE_TERMINATOR + 1, TRIE_NONE );
+   for ( uint32_t ui32_sibling = ui32_child; ui32_sibling != TRIE_NONE; ui32_sibling = builder .vec_next_sibling [ ui32_sibling ] ) {
+     builder .vec_tables [ st_table + get_trie_symbol ( trie, trie .vec_nodes [ ui32_sibling ] .ui32_start ) ] = ui32_sibling;
+   }
+   builder .vec_first_child [ ui32_parent ] = (uint32_t) (st_table / (TRIE_TERMINATOR + 1)) | TRIE_BUILDER_TABLE;
+ }
+}}
 
-       st_existing_branch_mismatch_index = lp_existing_branch_mismatch_point - t .str_substring .c_str (  );
+ //Once the tree is built, this will turn the builder's tables back into sibling lists.
+ static void unfold_trie_tables ( TRIE_BUILDER &builder )
+{{
+ for ( uint32_t ui32_node = 0; ui32_node < (uint32_t) builder .vec_first_child .size (  ); ui32_node ++ ) {
+   uint32_t ui32_first_child = builder .vec_first_child [ ui32_node ];
+   if ( ! IS_TRIE_BUILDER_TABLE ( ui32_first_child ) ) {
+     continue;
+   }
 
-       node = &t;
-       b_done = false;
-       break;
+   size_t st_table = (size_t) (ui32_first_child & ~TRIE_BUILDER_TABLE) * (TRIE_TERMINATOR + 1);
+   builder .vec_first_child [ ui32_node ] = TRIE_NONE;
+   for ( uint32_t ui32_symbol = 0; ui32_symbol <= TRIE_TERMINATOR; ui32_symbol ++ ) {
+     uint32_t ui32_child = builder .vec_tables [ st_table + ui32_symbol ];
+     if ( ui32_child != TRIE_NONE ) {
+       builder .vec_next_sibling [ ui32_child ] = builder .vec_first_child [ ui32_node ];
+       builder .vec_first_child [ ui32_node ] = ui32_child;
      }
    }
- } while ( ! b_done );
-
- //If we can't find a single node that matches the first character,
- //we won't have iterated past the initial reference.
-
- //Add the entire/remaining substring to the trie.
- TRIE new_node;
- new_node .ui32_index = ui32_index;
- new_node .str_substring = std::string ( lpsz_substring );
- node ->vec_children .push_back ( new_node );
-
- //If we need to bifurcate the substring that we found in the last node that we matched.
- if ( lp_existing_branch_mismatch_point &&
-      *lp_existing_branch_mismatch_point
-    ) {
-
-   new_node .str_substring = std::string ( lp_existing_branch_mismatch_point );
-   size_t st_characters_to_delete = node ->str_substring .size (  ) - st_existing_branch_mismatch_index;
-
-   debug_printf (
-     "Head node deletion index: %zu\n"
-     "Head node characters to delete: %zu\n",
-     st_existing_branch_mismatch_index,
-     st_characters_to_delete
-   );
+ }
+ std::vector<uint32_t> (  ) .swap ( builder .vec_tables );
+}}
+
+/*
+ Once the tree is built, this will give every internal node the index of the rightmost
+ suffix below it, so that find_trie_substring can return the rightmost match without
+ searching the subtree. The tree can be as deep as the text is long, so this uses its
+ own stack instead of recursing. (Children always come after their parents in vec_nodes,
+ except for the nodes created by splitting edges, so the order can't just be reversed.)
+*/
+ static void set_trie_indexes ( TRIE &trie, const TRIE_BUILDER &builder )
+{{
+ std::vector<std::pair<uint32_t, uint32_t> > vec_stack; //(node, its next child to visit)
+ vec_stack .push_back ( std::make_pair ( (uint32_t) TRIE_ROOT, builder .vec_first_child [ TRIE_ROOT ] ) );
+ trie .vec_nodes [ TRIE_ROOT ] .ui32_index = 0;
+
+ while ( ! vec_stack .empty (  ) ) {
+   uint32_t ui32_child = vec_stack .back (  ) .second;
+   if ( ui32_child != TRIE_NONE ) {
+     vec_stack .back (  ) .second = builder .vec_next_sibling [ ui32_child ];
+     if ( trie .vec_nodes [ ui32_child ] .ui32_end != TRIE_LEAF_END ) {
+       trie .vec_nodes [ ui32_child ] .ui32_index = 0;
+       vec_stack .push_back ( std::make_pair ( ui32_child, builder .vec_first_child [ ui32_child ] ) );
+     }
+     else if ( trie .vec_nodes [ vec_stack .back (  ) .first ] .ui32_index < trie .vec_nodes [ ui32_child ] .ui32_index ) {
+       trie .vec_nodes [ vec_stack .back (  ) .first ] .ui32_index = trie .vec_nodes [ ui32_child ] .ui32_index;
+     }
+     continue;
+   }
+
+   //Every child has its index by now, so pass this node's index up to its parent.
+   uint32_t ui32_node = vec_stack .back (  ) .first;
+   vec_stack .pop_back (  );
+   if ( ! vec_stack .empty (  ) && trie .vec_nodes [ vec_stack .back (  ) .first ] .ui32_index < trie .vec_nodes [ ui32_node ] .ui32_index ) {
+     trie .vec_nodes [ vec_stack .back (  ) .first ] .ui32_index = trie .vec_nodes [ ui32_node ] .ui32_index;
+   }
+ }
+}}
+
+/*
+ Once the tree is built, this will move every node's children out of the sibling lists
+ and into the container that suits how many there are (see suffix_tree.h).
+ The children are grouped by parent in vec_children, in symbol order, with the
+ terminator's child (if any) after the others.
+*/
+ static void set_trie_children ( TRIE &trie, const TRIE_BUILDER &builder )
+{{
+ uint32_t ary_slots [ TRIE_TERMINATOR + 1 ]; //The node's children by their first symbols.
+ for ( uint32_t ui32_symbol = 0; ui32_symbol <= TRIE_TERMINATOR; ui32_symbol ++ ) {
+   ary_slots [ ui32_symbol ] = TRIE_NONE;
+ }
 
-   if ( st_characters_to_delete && st_existing_branch_mismatch_index < node ->str_substring .size (  ) ) {
-     node ->str_substring .erase (
-       st_existing_branch_mismatch_index,
-       st_characters_to_delete
-     );
+ //Every node but the root is somebody's child.
+ trie .vec_children .clear (  );
+ trie .vec_children .reserve ( trie .vec_nodes .size (  ) - 1 );
+ trie .vec_child_symbols .clear (  );
+ trie .vec_child_symbols .reserve ( trie .vec_nodes .size (  ) - 1 );
+ trie .vec_child_bitmaps .clear (  );
+
+ for ( uint32_t ui32_node = 0; ui32_node < (uint32_t) trie .vec_nodes .size (  ); ui32_node ++ ) {
+   TRIE_NODE &node = trie .vec_nodes [ ui32_node ];
+   if ( builder .vec_first_child [ ui32_node ] == TRIE_NONE ) {
+     continue;
+   }
+
+   uint32_t ui32_count = 0;
+   for ( uint32_t ui32_child = builder .vec_first_child [ ui32_node ]; ui32_child != TRIE_NONE; ui32_child = builder .vec_next_sibling [ ui32_child ] ) {
+     uint32_t ui32_symbol = get_trie_symbol ( trie, trie .vec_nodes [ ui32_child ] .ui32_start );
+     ary_slots [ ui32_symbol ] = ui32_child;
+     ui32_count += ui32_symbol != TRIE_TERMINATOR;
+   }
+   node .ui16_child_count = (uint16_t) ui32_count;
+   uint32_t ui32_offset = (uint32_t) trie .vec_children .size (  );
+
+   if ( ui32_count >= TRIE_DIRECT_CHILDREN_MIN ) {
+     node .ui8_child_type = TRIE_CHILDREN_DIRECT;
+     node .ui32_children = ui32_offset;
+     trie .vec_children .insert ( trie .vec_children .end (  ), ary_slots, ary_slots + TRIE_TERMINATOR );
+     trie .vec_child_symbols .resize ( trie .vec_children .size (  ), 0 );
    }
    else {
-     fprintf (
-       stderr,
-       "Error: We can't remove some of the characters from the node from which we're splitting.\n"
-     );
+     if ( ui32_count > TRIE_SORTED_CHILDREN_MAX ) {
+       TRIE_CHILD_BITMAP bitmap;
+       memset ( &bitmap, 0, sizeof ( bitmap ) );
+       bitmap .ui32_children = ui32_offset;
+       node .ui8_child_type = TRIE_CHILDREN_BITMAP;
+       node .ui32_children = (uint32_t) trie .vec_child_bitmaps .size (  );
+       trie .vec_child_bitmaps .push_back ( bitmap );
+     }
+     else {
+       node .ui8_child_type = TRIE_CHILDREN_SORTED;
+       node .ui32_children = ui32_offset;
+     }
+
+     for ( uint32_t ui32_symbol = 0; ui32_symbol < TRIE_TERMINATOR; ui32_symbol ++ ) {
+       if ( ary_slots [ ui32_symbol ] != TRIE_NONE ) {
+         trie .vec_children .push_back ( ary_slots [ ui32_symbol ] );
+         trie .vec_child_symbols .push_back ( (uint8_t) ui32_symbol );
+         if ( node .ui8_child_type == TRIE_CHILDREN_BITMAP ) {
+           trie .vec_child_bitmaps .back (  ) .ui64_bits [ ui32_symbol >> 6 ] |= 1ULL << (ui32_symbol & 63);
+         }
+       }
+     }
+     if ( node .ui8_child_type == TRIE_CHILDREN_BITMAP ) {
+       TRIE_CHILD_BITMAP &bitmap = trie .vec_child_bitmaps .back (  );
+       for ( uint32_t ui32_word = 1; ui32_word < 4; ui32_word ++ ) {
+         bitmap .ui8_ranks [ ui32_word ] = (uint8_t) (bitmap .ui8_ranks [ ui32_word - 1 ] + trie_popcount ( bitmap .ui64_bits [ ui32_word - 1 ] ));
+       }
+     }
+   }
+
+   if ( ary_slots [ TRIE_TERMINATOR ] != TRIE_NONE ) {
+     node .ui8_child_type |= TRIE_CHILDREN_TERMINATOR;
+     trie .vec_children .push_back ( ary_slots [ TRIE_TERMINATOR ] );
+     trie .vec_child_symbols .push_back ( 0 );
+   }
+
+   for ( uint32_t ui32_child = builder .vec_first_child [ ui32_node ]; ui32_child != TRIE_NONE; ui32_child = builder .vec_next_sibling [ ui32_child ] ) {
+     ary_slots [ get_trie_symbol ( trie, trie .vec_nodes [ ui32_child ] .ui32_start ) ] = TRIE_NONE;
+   }
+ }
+
+ trie .vec_children .shrink_to_fit (  );
+ trie .vec_child_symbols .shrink_to_fit (  );
+ trie .vec_child_bitmaps .shrink_to_fit (  );
+}}
+
+ //This will point the view at the trie's arrays. (It's only good until the trie changes.)
+ void get_trie_view ( const TRIE &trie, TRIE_VIEW &view )
+{{
+ view .lp_text = trie .str_text .data (  );
+ view .st_text_length = trie .str_text .size (  );
+ view .lp_nodes = trie .vec_nodes .data (  );
+ view .st_node_count = trie .vec_nodes .size (  );
+ view .lp_children = trie .vec_children .data (  );
+ view .lp_child_symbols = trie .vec_child_symbols .data (  );
+ view .lp_child_bitmaps = trie .vec_child_bitmaps .data (  );
+ view .lp_leaves = trie .vec_leaves .data (  );
+}}
+
+ //This will return the child of the node whose edge starts with the byte, or TRIE_NONE.
+ uint32_t find_trie_child ( const TRIE_VIEW &view, uint32_t ui32_node, uint8_t ui8_symbol )
+{{
+ const TRIE_NODE &node = view .lp_nodes [ ui32_node ];
+ switch ( node .ui8_child_type & TRIE_CHILDREN_TYPE ) {
+   case TRIE_CHILDREN_SORTED: {
+     const uint8_t *lp_symbols = view .lp_child_symbols + node .ui32_children;
+     uint32_t ui32_low = 0, ui32_high = node .ui16_child_count;
+     while ( ui32_low < ui32_high ) {
+       uint32_t ui32_middle = (ui32_low + ui32_high) >> 1;
+       if ( lp_symbols [ ui32_middle ] < ui8_symbol ) {
+         ui32_low = ui32_middle + 1;
+       }
+       else {
+         ui32_high = ui32_middle;
+       }
+     }
+     if ( ui32_low < node .ui16_child_count && lp_symbols [ ui32_low ] == ui8_symbol ) {
+       return view .lp_children [ node .ui32_children + ui32_low ];
+     }
+     return TRIE_NONE;
+   }
+
+   case TRIE_CHILDREN_BITMAP: {
+     const TRIE_CHILD_BITMAP &bitmap = view .lp_child_bitmaps [ node .ui32_children ];
+     uint64_t ui64_word = bitmap .ui64_bits [ ui8_symbol >> 6 ];
+     uint64_t ui64_bit = 1ULL << (ui8_symbol & 63);
+     if ( ! (ui64_word & ui64_bit) ) {
+       return TRIE_NONE;
+     }
+     return view .lp_children [ bitmap .ui32_children + bitmap .ui8_ranks [ ui8_symbol >> 6 ] + trie_popcount ( ui64_word & (ui64_bit - 1) ) ];
+   }
+
+   case TRIE_CHILDREN_DIRECT:
+     return view .lp_children [ node .ui32_children + ui8_symbol ];
+ }
+
+ return TRIE_NONE;
+}}
+
+ uint32_t find_trie_child ( const TRIE &trie, uint32_t ui32_node, uint8_t ui8_symbol )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
+
+ return find_trie_child ( view, ui32_node, ui8_symbol );
+}}
+
+/*
+ Once the children are in their containers, this will list every leaf in vec_leaves in
+ depth-first order and give every node its range of leaves there.
+ Like set_trie_indexes, it uses its own stack, because the tree can be very deep.
+*/
+ static void set_trie_leaves ( TRIE &trie )
+{{
+ uint32_t ary_children [ TRIE_TERMINATOR + 1 ];
+ std::vector<std::pair<uint32_t, uint8_t> > vec_stack; //(node, whether its children have been visited)
+ trie .vec_leaves .clear (  );
+ trie .vec_leaves .reserve ( trie .str_text .size (  ) + 1 );
+ vec_stack .push_back ( std::make_pair ( (uint32_t) TRIE_ROOT, (uint8_t) 0 ) );
+
+ while ( ! vec_stack .empty (  ) ) {
+   uint32_t ui32_node = vec_stack .back (  ) .first;
+   TRIE_NODE &node = trie .vec_nodes [ ui32_node ];
+   if ( vec_stack .back (  ) .second ) {
+     node .ui32_leaf_count = (uint32_t) trie .vec_leaves .size (  ) - node .ui32_first_leaf;
+     vec_stack .pop_back (  );
+     continue;
+   }
+
+   node .ui32_first_leaf = (uint32_t) trie .vec_leaves .size (  );
+   if ( node .ui32_end == TRIE_LEAF_END ) {
+     node .ui32_leaf_count = 1;
+     trie .vec_leaves .push_back ( node .ui32_index - 1 );
+     vec_stack .pop_back (  );
+     continue;
+   }
+
+   //Come back to this node once its children are done; push them in reverse, so that the first is visited first.
+   vec_stack .back (  ) .second = 1;
+   uint32_t ui32_count = get_trie_children ( trie, ui32_node, ary_children );
+   while ( ui32_count ) {
+     vec_stack .push_back ( std::make_pair ( ary_children [ -- ui32_count ], (uint8_t) 0 ) );
+   }
+ }
+}}
+
+ //This will copy the node's children into lpary_children (in symbol order, with room for 257) and return how many there are.
+ uint32_t get_trie_children ( const TRIE_VIEW &view, uint32_t ui32_node, uint32_t *lpary_children )
+{{
+ const TRIE_NODE &node = view .lp_nodes [ ui32_node ];
+ uint32_t ui32_count = 0, ui32_offset = node .ui32_children;
+ switch ( node .ui8_child_type & TRIE_CHILDREN_TYPE ) {
+   case TRIE_CHILDREN_NONE:
+     return 0;
+
+   case TRIE_CHILDREN_DIRECT:
+     for ( uint32_t ui32_symbol = 0; ui32_symbol < TRIE_TERMINATOR; ui32_symbol ++ ) {
+       if ( view .lp_children [ ui32_offset + ui32_symbol ] != TRIE_NONE ) {
+         lpary_children [ ui32_count ++ ] = view .lp_children [ ui32_offset + ui32_symbol ];
+       }
+     }
+     ui32_offset += TRIE_TERMINATOR;
+     break;
+
+   case TRIE_CHILDREN_BITMAP:
+     ui32_offset = view .lp_child_bitmaps [ node .ui32_children ] .ui32_children;
+     //Fall through; the children are stored like sorted children.
+   default:
+     for ( ; ui32_count < node .ui16_child_count; ui32_count ++ ) {
+       lpary_children [ ui32_count ] = view .lp_children [ ui32_offset + ui32_count ];
+     }
+     ui32_offset += ui32_count;
+     break;
+ }
+
+ if ( node .ui8_child_type & TRIE_CHILDREN_TERMINATOR ) {
+   lpary_children [ ui32_count ++ ] = view .lp_children [ ui32_offset ];
+ }
+
+ return ui32_count;
+}}
+
+ uint32_t get_trie_children ( const TRIE &trie, uint32_t ui32_node, uint32_t *lpary_children )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
+
+ return get_trie_children ( view, ui32_node, lpary_children );
+}}
+
+/*
+ This will build the suffix tree of st_length bytes of lp_data (which can contain any bytes,
+ including zeroes), replacing whatever the trie held before.
+ Returns 0 and leaves the trie empty, if the text is longer than TRIE_MAXIMUM_LENGTH bytes.
+*/
+ uint8_t generate_trie ( TRIE &trie, const char *lp_data, size_t st_length )
+{{
+ if ( st_length > TRIE_MAXIMUM_LENGTH ) {
+   trie = TRIE (  );
+   return 0;
+ }
+
+ TRIE_BUILDER builder;
+ trie .str_text .assign ( lp_data, st_length );
+ trie .vec_nodes .clear (  );
+ //There are at most one leaf per suffix (plus the terminator) and one fewer internal nodes.
+ trie .vec_nodes .reserve ( 2 * st_length + 2 );
+ builder .vec_suffix_links .reserve ( 2 * st_length + 2 );
+ builder .vec_first_child .reserve ( 2 * st_length + 2 );
+ builder .vec_next_sibling .reserve ( 2 * st_length + 2 );
+ builder .vec_child_counts .reserve ( 2 * st_length + 2 );
+ new_trie_node ( trie, builder, 0, 0, 0 );
+
+ uint32_t ui32_active_node = TRIE_ROOT, ui32_active_edge = 0, ui32_active_length = 0;
+ uint32_t ui32_remainder = 0; //How many suffixes still need the current character added.
+
+ //The last phase adds the terminator, which turns every remaining suffix into a leaf.
+ for ( uint32_t ui32_phase = 0; ui32_phase <= (uint32_t) st_length; ui32_phase ++ ) {
+   uint32_t ui32_symbol = get_trie_symbol ( trie, ui32_phase );
+   uint32_t ui32_last_new_node = TRIE_NONE; //The last internal node made during this phase, which needs a suffix link.
+   ui32_remainder ++;
+
+   while ( ui32_remainder ) {
+     if ( ! ui32_active_length ) {
+       ui32_active_edge = ui32_phase;
+     }
+
+     uint32_t ui32_child = find_building_trie_child ( trie, builder, ui32_active_node, get_trie_symbol ( trie, ui32_active_edge ) );
+     if ( ui32_child == TRIE_NONE ) {
+       //Rule 2: nothing starts with this character here, so hang a new leaf off of the active node.
+       uint32_t ui32_leaf = new_trie_node ( trie, builder, ui32_phase, TRIE_LEAF_END, ui32_phase - ui32_remainder + 2 );
+       add_trie_child ( trie, builder, ui32_active_node, ui32_leaf );
+       if ( ui32_last_new_node != TRIE_NONE ) {
+         builder .vec_suffix_links [ ui32_last_new_node ] = ui32_active_node;
+         ui32_last_new_node = TRIE_NONE;
+       }
+     }
+     else {
+       //If the active point is past the end of this edge, walk down to the child first.
+       uint32_t ui32_child_end = trie .vec_nodes [ ui32_child ] .ui32_end == TRIE_LEAF_END ? ui32_phase + 1 : trie .vec_nodes [ ui32_child ] .ui32_end;
+       uint32_t ui32_edge_length = ui32_child_end - trie .vec_nodes [ ui32_child ] .ui32_start;
+       if ( ui32_active_length >= ui32_edge_length ) {
+         ui32_active_edge += ui32_edge_length;
+         ui32_active_length -= ui32_edge_length;
+         ui32_active_node = ui32_child;
+         continue;
+       }
+
+       //Rule 3: the character is already there, so this suffix (and every shorter one) is done.
+       if ( get_trie_symbol ( trie, trie .vec_nodes [ ui32_child ] .ui32_start + ui32_active_length ) == ui32_symbol ) {
+         if ( ui32_last_new_node != TRIE_NONE && ui32_active_node != TRIE_ROOT ) {
+           builder .vec_suffix_links [ ui32_last_new_node ] = ui32_active_node;
+           ui32_last_new_node = TRIE_NONE;
+         }
+         ui32_active_length ++;
+         break;
+       }
+
+       //Rule 2 inside an edge: split it where the characters differ and hang a new leaf off of the split.
+       //The split node takes the child's place among its siblings.
+       uint32_t ui32_child_start = trie .vec_nodes [ ui32_child ] .ui32_start;
+       uint32_t ui32_split = new_trie_node ( trie, builder, ui32_child_start, ui32_child_start + ui32_active_length, 0 );
+       if ( IS_TRIE_BUILDER_TABLE ( builder .vec_first_child [ ui32_active_node ] ) ) {
+         size_t st_table = (size_t) (builder .vec_first_child [ ui32_active_node ] & ~TRIE_BUILDER_TABLE) * (TRIE_TERMINATOR + 1);
+         builder .vec_tables [ st_table + get_trie_symbol ( trie, ui32_child_start ) ] = ui32_split;
+       }
+       else {
+         builder .vec_next_sibling [ ui32_split ] = builder .vec_next_sibling [ ui32_child ];
+         uint32_t *lpui32_link = &builder .vec_first_child [ ui32_active_node ];
+         while ( *lpui32_link != ui32_child ) {
+           lpui32_link = &builder .vec_next_sibling [ *lpui32_link ];
+         }
+         *lpui32_link = ui32_split;
+       }
+
+       uint32_t ui32_leaf = new_trie_node ( trie, builder, ui32_phase, TRIE_LEAF_END, ui32_phase - ui32_remainder + 2 );
+       trie .vec_nodes [ ui32_child ] .ui32_start += ui32_active_length;
+       builder .vec_next_sibling [ ui32_child ] = TRIE_NONE;
+       add_trie_child ( trie, builder, ui32_split, ui32_child );
+       add_trie_child ( trie, builder, ui32_split, ui32_leaf );
+
+       if ( ui32_last_new_node != TRIE_NONE ) {
+         builder .vec_suffix_links [ ui32_last_new_node ] = ui32_split;
+       }
+       ui32_last_new_node = ui32_split;
+     }
+
+     //Move the active point to the next shorter suffix.
+     ui32_remainder --;
+     if ( ui32_active_node == TRIE_ROOT && ui32_active_length ) {
+       ui32_active_length --;
+       ui32_active_edge = ui32_phase - ui32_remainder + 1;
+     }
+     else if ( ui32_active_node != TRIE_ROOT ) {
+       ui32_active_node = builder .vec_suffix_links [ ui32_active_node ];
+     }
    }
-   node ->vec_children .push_back ( new_node );
  }
 
+ //Give back the room that was reserved for the worst case (and the suffix links) before the tree is used.
+ std::vector<uint32_t> (  ) .swap ( builder .vec_suffix_links );
+ std::vector<uint16_t> (  ) .swap ( builder .vec_child_counts );
+ unfold_trie_tables ( builder );
+ trie .vec_nodes .shrink_to_fit (  );
+ set_trie_indexes ( trie, builder );
+ set_trie_children ( trie, builder );
+ set_trie_leaves ( trie );
+ debug_printf (
+   "generate_trie: %zu bytes, %zu nodes, %zu bitmaps.\n",
+   st_length,
+   trie .vec_nodes .size (  ),
+   trie .vec_child_bitmaps .size (  )
+ );
+
  return 1;
 }}
 
-//Show all of the contents of the trie in stdout for debugging purposes.
- void dump_tries ( const TRIE &trie, uint32_t ui32_depth )
+ uint8_t generate_trie ( TRIE &trie, const char *lpsz_string )
+{{
+ return generate_trie ( trie, lpsz_string, strlen ( lpsz_string ) );
+}}
+
+/*
+ This will build a keyword trie (not a suffix tree) of st_count keywords, replacing whatever
+ the trie held before: the path to each node spells a prefix of some keyword, one byte per
+ edge, so the node for each keyword is where its path ends. The keywords are stored one
+ after the other in str_text, and each edge refers to one byte there, so the nodes, their
+ child containers, and dump_tries work just like the suffix tree's.
+
+ In a keyword trie, ui32_index is the node's depth (the length of its path), and a node's
+ "leaves" in vec_leaves are the keywords (by their positions in lpary_keywords) that end
+ there. Empty keywords end at the root. The nodes are in breadth-first order.
+*/
+ void generate_keyword_trie ( TRIE &trie, const char **lpary_keywords, const size_t *lpary_lengths, size_t st_count )
 {{
- if ( ! trie .str_substring .empty (  ) ) {
-   if ( ui32_depth == 1 ) {
-     fprintf (
-       stdout,
-       "%*c(%s, %" PRIu32 ")",
-       ui32_depth<<1,
-       ' ',
-       trie .str_substring .c_str (  ),
-       trie .ui32_index
-     );
+ TRIE_BUILDER builder;
+ size_t st_total = 0;
+ for ( size_t st_keyword = 0; st_keyword < st_count; st_keyword ++ ) {
+   st_total += lpary_lengths [ st_keyword ];
+ }
+ trie .str_text .clear (  );
+ trie .str_text .reserve ( st_total );
+ trie .vec_nodes .clear (  );
+ new_trie_node ( trie, builder, 0, 0, 0 );
+
+ std::vector<uint32_t> vec_keyword_nodes ( st_count );
+ for ( size_t st_keyword = 0; st_keyword < st_count; st_keyword ++ ) {
+   uint32_t ui32_node = TRIE_ROOT;
+   uint32_t ui32_offset = (uint32_t) trie .str_text .size (  );
+   trie .str_text .append ( lpary_keywords [ st_keyword ], lpary_lengths [ st_keyword ] );
+   for ( uint32_t ui32_depth = 1; ui32_depth <= (uint32_t) lpary_lengths [ st_keyword ]; ui32_depth ++, ui32_offset ++ ) {
+     uint32_t ui32_child = find_building_trie_child ( trie, builder, ui32_node, (uint8_t) trie .str_text [ ui32_offset ] );
+     if ( ui32_child == TRIE_NONE ) {
+       ui32_child = new_trie_node ( trie, builder, ui32_offset, ui32_offset + 1, ui32_depth );
+       add_trie_child ( trie, builder, ui32_node, ui32_child );
+     }
+     ui32_node = ui32_child;
    }
-   else {
-     fprintf (
-       stdout,
-       " => {%" PRIu32 "}(\"%s\", %" PRIu32 ")",
-       ui32_depth,
-       trie .str_substring .c_str (  ),
-       trie .ui32_index
-     );
+   vec_keyword_nodes [ st_keyword ] = ui32_node;
+   trie .vec_nodes [ ui32_node ] .ui32_leaf_count ++;
+ }
+
+ std::vector<uint32_t> (  ) .swap ( builder .vec_suffix_links );
+ std::vector<uint16_t> (  ) .swap ( builder .vec_child_counts );
+ unfold_trie_tables ( builder );
+
+ //Number the nodes in breadth-first order, so that the shallow ones (which a scan visits most) are together, and every node comes after its parent.
+ std::vector<uint32_t> vec_order;
+ vec_order .reserve ( trie .vec_nodes .size (  ) );
+ vec_order .push_back ( TRIE_ROOT );
+ for ( size_t st_next = 0; st_next < vec_order .size (  ); st_next ++ ) {
+   for ( uint32_t ui32_child = builder .vec_first_child [ vec_order [ st_next ] ]; ui32_child != TRIE_NONE; ui32_child = builder .vec_next_sibling [ ui32_child ] ) {
+     vec_order .push_back ( ui32_child );
    }
  }
+ std::vector<uint32_t> vec_new_positions ( vec_order .size (  ) );
+ for ( uint32_t ui32_node = 0; ui32_node < (uint32_t) vec_order .size (  ); ui32_node ++ ) {
+   vec_new_positions [ vec_order [ ui32_node ] ] = ui32_node;
+ }
+ std::vector<TRIE_NODE> vec_nodes ( vec_order .size (  ) );
+ std::vector<uint32_t> vec_first_child ( vec_order .size (  ) ), vec_next_sibling ( vec_order .size (  ) );
+ for ( uint32_t ui32_node = 0; ui32_node < (uint32_t) vec_order .size (  ); ui32_node ++ ) {
+   uint32_t ui32_old = vec_order [ ui32_node ];
+   vec_nodes [ ui32_node ] = trie .vec_nodes [ ui32_old ];
+   vec_first_child [ ui32_node ] = builder .vec_first_child [ ui32_old ] == TRIE_NONE ? TRIE_NONE : vec_new_positions [ builder .vec_first_child [ ui32_old ] ];
+   vec_next_sibling [ ui32_node ] = builder .vec_next_sibling [ ui32_old ] == TRIE_NONE ? TRIE_NONE : vec_new_positions [ builder .vec_next_sibling [ ui32_old ] ];
+ }
+ trie .vec_nodes .swap ( vec_nodes );
+ builder .vec_first_child .swap ( vec_first_child );
+ builder .vec_next_sibling .swap ( vec_next_sibling );
+ for ( std::vector<uint32_t>::iterator it_node = vec_keyword_nodes .begin (  ); it_node != vec_keyword_nodes .end (  ); it_node ++ ) {
+   *it_node = vec_new_positions [ *it_node ];
+ }
+ set_trie_children ( trie, builder );
+
+ //Group the keywords by the node that they end at (a counting sort).
+ uint32_t ui32_first_leaf = 0;
+ for ( std::vector<TRIE_NODE>::iterator it_node = trie .vec_nodes .begin (  ); it_node != trie .vec_nodes .end (  ); it_node ++ ) {
+   it_node ->ui32_first_leaf = ui32_first_leaf;
+   ui32_first_leaf += it_node ->ui32_leaf_count;
+   it_node ->ui32_leaf_count = 0;
+ }
+ trie .vec_leaves .assign ( st_count, 0 );
+ for ( size_t st_keyword = 0; st_keyword < st_count; st_keyword ++ ) {
+   TRIE_NODE &node = trie .vec_nodes [ vec_keyword_nodes [ st_keyword ] ];
+   trie .vec_leaves [ node .ui32_first_leaf + node .ui32_leaf_count ++ ] = (uint32_t) st_keyword;
+ }
+}}
+
+//Show every edge of the trie (below ui32_node) in stdout for debugging purposes.
+ static void dump_trie_node ( const TRIE &trie, uint32_t ui32_node, uint32_t ui32_depth )
+{{
+ const TRIE_NODE &node = trie .vec_nodes [ ui32_node ];
+ if ( ui32_node != TRIE_ROOT ) {
+   uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) trie .str_text .size (  ) : node .ui32_end;
+   fprintf (
+     stdout,
+     "%*c(\"%.*s%s\", %" PRIu32 ")\n",
+     ui32_depth << 1,
+     ' ',
+     (int) (ui32_end - node .ui32_start),
+     trie .str_text .c_str (  ) + node .ui32_start,
+     node .ui32_end == TRIE_LEAF_END ? "$" : "",
+     node .ui32_index
+   );
+ }
+
+ uint32_t ary_children [ TRIE_TERMINATOR + 1 ];
+ uint32_t ui32_count = get_trie_children ( trie, ui32_node, ary_children );
+ for ( uint32_t ui32_child = 0; ui32_child < ui32_count; ui32_child ++ ) {
+   dump_trie_node ( trie, ary_children [ ui32_child ], ui32_depth + 1 );
+ }
+}}
+
+ void dump_tries ( const TRIE &trie )
+{{
+ if ( ! trie .vec_nodes .empty (  ) ) {
+   dump_trie_node ( trie, TRIE_ROOT, 0 );
+ }
+}}
 
- for ( const auto &t : trie .vec_children ) {
-   dump_tries ( t, ui32_depth + 1 );
+/*
+ This will return the node whose edge holds the end of the pattern (so every leaf below it
+ is an occurrence), or TRIE_NONE, if the pattern doesn't occur (or is empty).
+*/
+ static uint32_t find_trie_node ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length )
+{{
+ if ( ! lp_pattern || ! st_length || ! view .st_node_count ) {
+   return TRIE_NONE;
  }
 
- if ( ui32_depth == 1 ) {
-   fprintf ( stdout, "\n" );
+ uint32_t ui32_node = TRIE_ROOT;
+ size_t st_matched = 0;
+ while ( st_matched < st_length ) {
+   ui32_node = find_trie_child ( view, ui32_node, (uint8_t) lp_pattern [ st_matched ] );
+   if ( ui32_node == TRIE_NONE ) {
+     return TRIE_NONE;
+   }
+
+   //Match as much of this edge as the pattern covers. (Its first character already matched.)
+   const TRIE_NODE &node = view .lp_nodes [ ui32_node ];
+   uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) view .st_text_length : node .ui32_end;
+   size_t st_edge_length = ui32_end - node .ui32_start;
+   size_t st_compare = st_length - st_matched < st_edge_length ? st_length - st_matched : st_edge_length;
+   if ( memcmp ( view .lp_text + node .ui32_start + 1, lp_pattern + st_matched + 1, st_compare - 1 ) ) {
+     return TRIE_NONE;
+   }
+   st_matched += st_compare;
+   debug_printf ( "find_trie_node: matched %zu of %zu characters.\n", st_matched, st_length );
  }
+
+ return ui32_node;
 }}
 
 /*
@@ -232,146 +784,90 @@ GCTAB      TA           A        B     CTA
  So, "test test test" would match at the final "test" substring at the end.
       0123456789^123 = offset 10
 */
- size_t find_trie_substring (
-   const TRIE &trie,
-   const char *lpsz_search_substring
- )
+ size_t find_trie_substring ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length )
 {{
- const char *lpsz_substring = lpsz_search_substring, *lpsz_prev_substring;
- const TRIE *node = &trie;
- bool b_stepped_in; //if we've stepped into a child node, this will be true.
- do {
-   b_stepped_in = false; //Start false at the start of each child node vector iteration.
-
-   //Store the current reference position so that we can check whether or not we've
-   //matched any part of the substring during this loop iteration/recursion level.
-   lpsz_prev_substring = lpsz_substring;
-   for ( std::vector<TRIE>::const_iterator it_trie = node ->vec_children .cbegin (  );
-         it_trie != node ->vec_children .cend (  );
-         it_trie ++
-       ) {
-
-     const char *lpsz_trie_substring = it_trie ->str_substring .c_str (  );
-     while ( *lpsz_substring && *lpsz_trie_substring == *lpsz_substring ) {
-       debug_printf ( "'%hc' = '%hc'\n", *lpsz_trie_substring, *lpsz_substring );
-       lpsz_trie_substring ++, lpsz_substring ++;
-     }
-
-     if ( lpsz_substring != lpsz_prev_substring ) {
+ uint32_t ui32_node = find_trie_node ( view, lp_pattern, st_length );
 
-       debug_printf (
-         "partial match with \"%hs\"\n",
-         it_trie ->str_substring .c_str (  )
-       );
-
-       //If we've matched every character of the string, return the index of the match.
-       if ( ! *lpsz_substring ) {
-         return it_trie ->ui32_index;
-       }
-
-       debug_printf (
-         "there are more characters to match, so we're stepping in.\n"
-       );
-       debug_printf (
-         "prev: \"%hs\"; cur: \"%hs\"\n",
-         lpsz_substring,
-         lpsz_prev_substring
-       );
+ return ui32_node == TRIE_NONE ? 0 : view .lp_nodes [ ui32_node ] .ui32_index;
+}}
 
-       node = &(*it_trie);
-       b_stepped_in = true;
+ size_t find_trie_substring ( const TRIE &trie, const char *lp_pattern, size_t st_length )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
 
-       break;
+ return find_trie_substring ( view, lp_pattern, st_length );
+}}
 
-     } //if there has been a partial or full match with the curent node.
+ size_t find_trie_substring (
+   const TRIE &trie,
+   const char *lpsz_search_substring
+ )
+{{
+ if ( ! lpsz_search_substring ) {
+   return 0;
+ }
 
-   } //for each of the child nodes of the current node.
+ return find_trie_substring ( trie, lpsz_search_substring, strlen ( lpsz_search_substring ) );
+}}
 
- } while ( b_stepped_in ); //while we're continuing to work with new trie nodes.
+ //This will return how many times the pattern occurs in the text (overlapping occurrences included).
+ size_t count_trie_substrings ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length )
+{{
+ uint32_t ui32_node = find_trie_node ( view, lp_pattern, st_length );
 
- return 0; //the trie is one-based, so returning zero indicates that there was no match.
+ return ui32_node == TRIE_NONE ? 0 : view .lp_nodes [ ui32_node ] .ui32_leaf_count;
 }}
 
-/*
- Add 1 character, 2 characters, ...etc. from the right side of the string
- to the left side thereof until the start of the string is reached, inclusive.
-*/
- void generate_trie ( TRIE &trie, const char *lpsz_string )
+ size_t count_trie_substrings ( const TRIE &trie, const char *lp_pattern, size_t st_length )
 {{
- const char *p = lpsz_string;
- while ( *p ) p ++;
- p --;
- for ( ; p >= lpsz_string; p -- ) {
-   debug_printf (
-     "substring: \"%s\"\n",
-     p
-   );
-
-   add_trie (
-     trie,
-     p,
-     p - lpsz_string + 1
-   );
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
 
- } //for each of the substrings, in reverse order.
+ return count_trie_substrings ( view, lp_pattern, st_length );
 }}
 
 /*
- Takes two arguments from stdin during application execution:
- 1.) The string to match against (haystack).
- 2.) A substring to match with the trie that was generated from the first argument.
-
- Displays the offset of the match, the generated trie, and debugging information if DEBUG_MODE != 0.
+ This will add the zero-based position of every occurrence of the pattern to vec_positions
+ (in no particular order) and return how many there were.
 */
- int main ( int argc, char **argv )
+ size_t find_trie_substrings ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions )
 {{
- TRIE trie;
- std::vector<std::string> vec_substrings;
-
- //Prevent the user from invoking the application without any arguments.
- if ( argc < 3 ) {
-   fprintf (
-     stderr,
-     "Error: Two arguments expected:\n"
-     "1.) A string to break into a trie.\n"
-     "2.) A substring to match with the trie.\n"
-   );
+ uint32_t ui32_node = find_trie_node ( view, lp_pattern, st_length );
+ if ( ui32_node == TRIE_NONE ) {
    return 0;
  }
 
- fprintf (
-   stdout,
-   "Creating trie from string: \"%s\"\n\n",
-   argv [ 1 ]
+ const TRIE_NODE &node = view .lp_nodes [ ui32_node ];
+ vec_positions .insert (
+   vec_positions .end (  ),
+   view .lp_leaves + node .ui32_first_leaf,
+   view .lp_leaves + node .ui32_first_leaf + node .ui32_leaf_count
  );
 
- generate_trie ( trie, argv [ 1 ] );
- dump_tries ( trie, 0 );
+ return node .ui32_leaf_count;
+}}
 
- fprintf (
-   stdout,
-   "Attempting to match the trie with the substring, \"%hs\"\n",
-   argv [ 2 ]
- );
+ size_t find_trie_substrings ( const TRIE &trie, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
 
- size_t st_index = find_trie_substring (
-   trie,
-   argv [ 2 ]
- );
- if ( st_index ) {
-   fprintf (
-     stdout,
-     "Match found @ index: %zu.\n",
-     st_index - 1 //subtract one because its one-based in the trie.
-   );
- }
- else {
-   fprintf (
-     stderr,
-     "Error: The substring, \"%hs,\" couldn't be found.\n",
-     argv [ 2 ]
-   );
- }
+ return find_trie_substrings ( view, lp_pattern, st_length, vec_positions );
+}}
 
- return 0;
+/*
+ This will return how many bytes the tree holds: the text, the node array, and the
+ children's containers (by capacity, since that's what's allocated).
+ The allocator's own overhead isn't included.
+*/
+ size_t get_trie_memory_usage ( const TRIE &trie )
+{{
+ return sizeof ( TRIE ) +
+   trie .str_text .capacity (  ) +
+   trie .vec_nodes .capacity (  ) * sizeof ( TRIE_NODE ) +
+   trie .vec_children .capacity (  ) * sizeof ( uint32_t ) +
+   trie .vec_child_symbols .capacity (  ) +
+   trie .vec_child_bitmaps .capacity (  ) * sizeof ( TRIE_CHILD_BITMAP ) +
+   trie .vec_leaves .capacity (  ) * sizeof ( uint32_t );
 }}
@@ -0,0 +1,149 @@
+/*
+ Created on 2022-04-28 by Jacob Bethany
+ Purpose: To understand tries and suffix trees.
+
+ generate_trie builds the suffix tree of a text in linear time with Ukkonen's algorithm,
+ adding one character at a time and using suffix links to jump between the suffixes
+ that still need to be extended, instead of inserting every suffix from the root.
+ Each edge is stored as an offset range in one shared copy of the text, rather than
+ as its own string, and the nodes live in one flat array, so the whole tree takes a
+ handful of allocations. Suffix links and the sibling lists that are used while building
+ are kept in temporary arrays that are freed afterwards. The node numbers and offsets are
+ 32-bit, so the text can be at most TRIE_MAXIMUM_LENGTH bytes (just under 2 GB) long;
+ generate_trie refuses longer ones.
+
+ Once the tree is built, each node gets the container for its children that suits how
+ many it has, so that a search step never scans the children:
+  TRIE_CHILDREN_SORTED: up to TRIE_SORTED_CHILDREN_MAX children, with their first symbols
+  in a small sorted array (binary search).
+  TRIE_CHILDREN_BITMAP: a 256-bit bitmap of the first symbols, and the children in symbol
+  order, found by the rank of the symbol's bit (popcount).
+  TRIE_CHILDREN_DIRECT: at least TRIE_DIRECT_CHILDREN_MIN children (the busiest nodes, near
+  the root), in a 256-slot table that's indexed by the symbol.
+
+ Every leaf is one suffix, and vec_leaves lists them in the order of a depth-first walk,
+ so the leaves below any node are next to each other there. Each node keeps where its
+ leaves start and how many there are, so counting a pattern's occurrences takes O(m)
+ time, for a pattern of m bytes, and listing them takes O(m + occurrences).
+
+ generate_keyword_trie builds a plain trie of many keywords out of the same nodes and child
+ containers, which aho_corasick.h turns into a multi-pattern matcher.
+
+ The queries also take a TRIE_VIEW, which only points at the arrays, so that they can be
+ answered straight from a saved tree that's mapped into memory (suffix_tree_snapshot.h).
+ suffix_tree_batch.h answers large batches of them on every core, and suffix_tree_approximate.h
+ finds the places where a pattern occurs with a few errors.
+
+ See suffix_tree.cpp for the implementation, suffix_tree_test.cpp for example usage,
+ and suffix_tree_benchmark.cpp for construction measurements. suffix_array.h has a
+ leaner index with the same queries, and substring_index.h switches between the two.
+
+ Note:
+  Matches will happen from right to left.
+  (find_trie_substring returns the rightmost occurrence.)
+*/
+#ifndef SUFFIX_TREE_HEADER_DEFINED
+#define SUFFIX_TREE_HEADER_DEFINED 1
+#ifndef _WIN32
+ #include "string.h"
+#else
+ #include "windows.h"
+#endif
+ #include "stdio.h"
+ #include "stdlib.h"
+ #include "stdint.h"
+ #include "inttypes.h"
+ #include <string>
+ #include <vector>
+
+ //If set to 1 (true), debugging output will be added.
+ #define DEBUG_MODE 0
+ #if ( DEBUG_MODE )
+   #define debug_printf(...) fprintf ( stdout, __VA_ARGS__ )
+ #else
+   #define debug_printf(...)
+ #endif
+
+ #define TRIE_ROOT 0 //The root is always the first node.
+ #define TRIE_NONE UINT32_MAX //No node.
+ #define TRIE_LEAF_END UINT32_MAX //A leaf's edge runs to the end of the text (and grows with it during construction).
+ //The symbol after the last character of the text. It's unique, so every suffix ends at a leaf, and no pattern can match it.
+ #define TRIE_TERMINATOR 256
+ //The longest text that generate_trie accepts. A text of n bytes can need 2n + 2 nodes, and every node number has to stay below TRIE_NONE.
+ #define TRIE_MAXIMUM_LENGTH ( (size_t) (UINT32_MAX / 2 - 3) )
+
+ //How each node's children are stored (TRIE_NODE.ui8_child_type).
+ #define TRIE_CHILDREN_NONE 0 //A leaf.
+ #define TRIE_CHILDREN_SORTED 1
+ #define TRIE_CHILDREN_BITMAP 2
+ #define TRIE_CHILDREN_DIRECT 3
+ #define TRIE_CHILDREN_TYPE 0x7f
+ //A flag for the child type: one more child, whose edge is just the terminator, follows the others.
+ //(Patterns never match it, but it's a leaf, so it's an occurrence of its parent's path.)
+ #define TRIE_CHILDREN_TERMINATOR 0x80
+ #ifndef TRIE_SORTED_CHILDREN_MAX
+   #define TRIE_SORTED_CHILDREN_MAX 8
+ #endif
+ #ifndef TRIE_DIRECT_CHILDREN_MIN
+   #define TRIE_DIRECT_CHILDREN_MIN 48
+ #endif
+
+typedef struct TRIE_NODE {
+  uint32_t ui32_start; //The offset in the text of the first character of the edge leading into this node.
+  uint32_t ui32_end; //The offset just past the edge's last character, or TRIE_LEAF_END.
+  uint32_t ui32_index; //The one-based index of the rightmost suffix that passes through this node (in a keyword trie: its depth).
+  //For sorted and direct children: the offset of the first child in TRIE.vec_children.
+  //For bitmap children: the position of the bitmap in TRIE.vec_child_bitmaps.
+  uint32_t ui32_children;
+  uint16_t ui16_child_count; //Not counting the terminator's child.
+  uint8_t ui8_child_type; //TRIE_CHILDREN_*
+  uint32_t ui32_first_leaf; //The position in TRIE.vec_leaves of the first leaf below (or at) this node.
+  uint32_t ui32_leaf_count; //How many leaves are below (or at) this node (in a keyword trie: how many keywords end here).
+} TRIE_NODE;
+
+typedef struct TRIE_CHILD_BITMAP {
+  uint64_t ui64_bits [ 4 ]; //One bit per symbol that starts a child.
+  uint32_t ui32_children; //The offset of the first child in TRIE.vec_children.
+  uint8_t ui8_ranks [ 4 ]; //How many bits are set in the words before each word.
+} TRIE_CHILD_BITMAP;
+
+typedef struct TRIE {
+  std::string str_text; //The indexed text; every edge refers to it.
+  std::vector<TRIE_NODE> vec_nodes; //Every node of the tree; they refer to each other by their positions here.
+  std::vector<uint32_t> vec_children; //The children of every node, grouped by parent.
+  std::vector<uint8_t> vec_child_symbols; //The first symbol of each child in vec_children (used by sorted children).
+  std::vector<TRIE_CHILD_BITMAP> vec_child_bitmaps;
+  std::vector<uint32_t> vec_leaves; //The zero-based position of each leaf's suffix, in depth-first order (children in symbol order), or each keyword's ID.
+} TRIE;
+
+//The trie's arrays, wherever they are: in a TRIE (get_trie_view), or in a mapped file (suffix_tree_snapshot.h).
+typedef struct TRIE_VIEW {
+  const char *lp_text;
+  size_t st_text_length;
+  const TRIE_NODE *lp_nodes;
+  size_t st_node_count;
+  const uint32_t *lp_children;
+  const uint8_t *lp_child_symbols;
+  const TRIE_CHILD_BITMAP *lp_child_bitmaps;
+  const uint32_t *lp_leaves;
+} TRIE_VIEW;
+
+ uint8_t generate_trie ( TRIE &trie, const char *lpsz_string );
+ uint8_t generate_trie ( TRIE &trie, const char *lp_data, size_t st_length );
+ size_t find_trie_substring ( const TRIE &trie, const char *lpsz_search_substring );
+ size_t find_trie_substring ( const TRIE &trie, const char *lp_pattern, size_t st_length );
+ size_t count_trie_substrings ( const TRIE &trie, const char *lp_pattern, size_t st_length );
+ size_t find_trie_substrings ( const TRIE &trie, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions );
+ void get_trie_view ( const TRIE &trie, TRIE_VIEW &view );
+ size_t find_trie_substring ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length );
+ size_t count_trie_substrings ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length );
+ size_t find_trie_substrings ( const TRIE_VIEW &view, const char *lp_pattern, size_t st_length, std::vector<uint32_t> &vec_positions );
+ void generate_keyword_trie ( TRIE &trie, const char **lpary_keywords, const size_t *lpary_lengths, size_t st_count );
+ uint32_t find_trie_child ( const TRIE &trie, uint32_t ui32_node, uint8_t ui8_symbol );
+ uint32_t find_trie_child ( const TRIE_VIEW &view, uint32_t ui32_node, uint8_t ui8_symbol );
+ uint32_t get_trie_children ( const TRIE &trie, uint32_t ui32_node, uint32_t *lpary_children );
+ uint32_t get_trie_children ( const TRIE_VIEW &view, uint32_t ui32_node, uint32_t *lpary_children );
+ size_t get_trie_memory_usage ( const TRIE &trie );
+ void dump_tries ( const TRIE &trie );
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the approximate suffix tree search described in suffix_tree_approximate.h.
+
+ To compile (with the benchmark):
+   g++ -O2 suffix_tree.cpp suffix_tree_approximate.cpp suffix_tree_approximate_benchmark.cpp -o suffix_tree_approximate_benchmark
+*/
+ #include "suffix_tree_approximate.h"
+
+ //A node that the walk still has to visit.
+typedef struct TRIE_APPROXIMATE_STEP {
+  uint32_t ui32_node;
+  uint32_t ui32_depth; //How many characters of text lead up to the node's edge.
+  //Hamming: the substitutions so far. Edit distance: the fewest errors that a match of
+  //the whole pattern has had on the way here (or UINT32_MAX), and its length.
+  uint32_t ui32_errors;
+  uint32_t ui32_length;
+} TRIE_APPROXIMATE_STEP;
+
+ //This will list every suffix below (or at) the node as a match.
+ static void add_trie_approximate_matches (
+   const TRIE_VIEW &view,
+   uint32_t ui32_node,
+   uint32_t ui32_length,
+   uint32_t ui32_errors,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ const TRIE_NODE &node = view .lp_nodes [ ui32_node ];
+ TRIE_APPROXIMATE_MATCH match;
+ match .ui32_length = ui32_length;
+ match .ui32_errors = ui32_errors;
+ for ( uint32_t ui32_i = 0; ui32_i < node .ui32_leaf_count; ui32_i ++ ) {
+   match .ui32_position = view .lp_leaves [ node .ui32_first_leaf + ui32_i ];
+   vec_matches .push_back ( match );
+ }
+}}
+
+ //This will push the node's children onto the stack, with the walk's state after the node's edge.
+ static void push_trie_approximate_children (
+   const TRIE_VIEW &view,
+   const TRIE_APPROXIMATE_STEP &step,
+   uint32_t ui32_depth,
+   std::vector<TRIE_APPROXIMATE_STEP> &vec_stack
+ )
+{{
+ uint32_t ary_children [ TRIE_TERMINATOR + 1 ];
+ uint32_t ui32_count = get_trie_children ( view, step .ui32_node, ary_children );
+ TRIE_APPROXIMATE_STEP child = step;
+ child .ui32_depth = ui32_depth;
+ while ( ui32_count ) {
+   child .ui32_node = ary_children [ -- ui32_count ];
+   vec_stack .push_back ( child );
+ }
+}}
+
+ //Substitutions only: every match is as long as the pattern.
+ static void find_trie_hamming_substrings (
+   const TRIE_VIEW &view,
+   const uint8_t *lp_pattern,
+   uint32_t ui32_length,
+   uint32_t ui32_max_errors,
+   std::vector<TRIE_APPROXIMATE_STEP> &vec_stack,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ const uint8_t *lp_text = (const uint8_t *) view .lp_text;
+ TRIE_APPROXIMATE_STEP root;
+ root .ui32_node = TRIE_ROOT;
+ root .ui32_errors = 0;
+ root .ui32_length = ui32_length;
+ push_trie_approximate_children ( view, root, 0, vec_stack );
+
+ while ( ! vec_stack .empty (  ) ) {
+   TRIE_APPROXIMATE_STEP step = vec_stack .back (  );
+   vec_stack .pop_back (  );
+
+   //Compare the edge (which is empty for a terminator's leaf) until it, the pattern, or the errors allowed run out.
+   const TRIE_NODE &node = view .lp_nodes [ step .ui32_node ];
+   uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) view .st_text_length : node .ui32_end;
+   uint32_t ui32_depth = step .ui32_depth;
+   for ( uint32_t ui32_i = node .ui32_start; ui32_i < ui32_end && ui32_depth < ui32_length && step .ui32_errors <= ui32_max_errors; ui32_i ++ ) {
+     step .ui32_errors += lp_text [ ui32_i ] != lp_pattern [ ui32_depth ++ ];
+   }
+
+   if ( step .ui32_errors > ui32_max_errors ) {
+     continue;
+   }
+   if ( ui32_depth == ui32_length ) {
+     add_trie_approximate_matches ( view, step .ui32_node, ui32_length, step .ui32_errors, vec_matches );
+   }
+   else {
+     //(A leaf's suffix ended before the pattern did.)
+     push_trie_approximate_children ( view, step, ui32_depth, vec_stack );
+   }
+ }
+}}
+
+/*
+ Substitutions, insertions, and deletions. Row d of vec_rows is the column of the edit distance
+ table after d characters of the text on the current path: entry i is the distance between the
+ first i bytes of the pattern and those d characters. The rows above a node's edge are the same
+ for all of its children, so a child only overwrites the rows below its parent's.
+
+ Entry i of row d is at least |i - d|, so only the entries within k of the diagonal can be
+ within the limit; the rest are never computed, and hold k + 1 (every entry is capped there,
+ which doesn't change any entry that's within the limit).
+*/
+ static void find_trie_edit_substrings (
+   const TRIE_VIEW &view,
+   const uint8_t *lp_pattern,
+   uint32_t ui32_length,
+   uint32_t ui32_max_errors,
+   std::vector<TRIE_APPROXIMATE_STEP> &vec_stack,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ const uint8_t *lp_text = (const uint8_t *) view .lp_text;
+ const uint32_t ui32_row_size = ui32_length + 1;
+ const uint32_t ui32_over = ui32_max_errors + 1;
+ //A path can't go deeper than m + k characters: its last row would be all over the limit.
+ std::vector<uint32_t> vec_rows ( (size_t) (ui32_length + ui32_max_errors + 2) * ui32_row_size, ui32_over );
+ for ( uint32_t ui32_i = 0; ui32_i <= ui32_max_errors; ui32_i ++ ) {
+   vec_rows [ ui32_i ] = ui32_i;
+ }
+
+ TRIE_APPROXIMATE_STEP root;
+ root .ui32_node = TRIE_ROOT;
+ root .ui32_errors = UINT32_MAX;
+ root .ui32_length = 0;
+ push_trie_approximate_children ( view, root, 0, vec_stack );
+
+ while ( ! vec_stack .empty (  ) ) {
+   TRIE_APPROXIMATE_STEP step = vec_stack .back (  );
+   vec_stack .pop_back (  );
+
+   const TRIE_NODE &node = view .lp_nodes [ step .ui32_node ];
+   uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) view .st_text_length : node .ui32_end;
+   uint32_t ui32_depth = step .ui32_depth;
+   uint8_t b_hopeless = 0;
+   for ( uint32_t ui32_i = node .ui32_start; ui32_i < ui32_end && ! b_hopeless; ui32_i ++ ) {
+     const uint32_t *lp_previous = &vec_rows [ (size_t) ui32_depth * ui32_row_size ];
+     uint32_t *lp_row = &vec_rows [ (size_t) (ui32_depth + 1) * ui32_row_size ];
+     uint8_t ui8_symbol = lp_text [ ui32_i ];
+     ui32_depth ++;
+
+     //The band of entries within k of the diagonal. (It's empty once the path is more than m + k long.)
+     uint32_t ui32_first = ui32_depth > ui32_max_errors ? ui32_depth - ui32_max_errors : 1;
+     uint32_t ui32_last = ui32_depth + ui32_max_errors < ui32_length ? ui32_depth + ui32_max_errors : ui32_length;
+     uint32_t ui32_minimum = ui32_over;
+     if ( ui32_depth <= ui32_max_errors ) {
+       ui32_minimum = lp_row [ 0 ] = ui32_depth;
+     }
+     for ( uint32_t ui32_j = ui32_first; ui32_j <= ui32_last; ui32_j ++ ) {
+       uint32_t ui32_cost = lp_previous [ ui32_j - 1 ] + (lp_pattern [ ui32_j - 1 ] != ui8_symbol);
+       if ( lp_previous [ ui32_j ] + 1 < ui32_cost ) {
+         ui32_cost = lp_previous [ ui32_j ] + 1;
+       }
+       if ( lp_row [ ui32_j - 1 ] + 1 < ui32_cost ) {
+         ui32_cost = lp_row [ ui32_j - 1 ] + 1;
+       }
+       if ( ui32_cost > ui32_over ) {
+         ui32_cost = ui32_over;
+       }
+       lp_row [ ui32_j ] = ui32_cost;
+       if ( ui32_cost < ui32_minimum ) {
+         ui32_minimum = ui32_cost;
+       }
+     }
+
+     if ( lp_row [ ui32_length ] < step .ui32_errors && lp_row [ ui32_length ] <= ui32_max_errors ) {
+       step .ui32_errors = lp_row [ ui32_length ];
+       step .ui32_length = ui32_depth;
+     }
+     b_hopeless = ui32_minimum > ui32_max_errors;
+   }
+
+   //Every suffix below here has the best match that the path has had. (A leaf's edge
+   //can also end with its suffix, and a terminator's leaf has an empty edge.)
+   if ( b_hopeless || ! (node .ui8_child_type & TRIE_CHILDREN_TYPE) ) {
+     if ( step .ui32_errors <= ui32_max_errors ) {
+       add_trie_approximate_matches ( view, step .ui32_node, step .ui32_length, step .ui32_errors, vec_matches );
+     }
+   }
+   else {
+     push_trie_approximate_children ( view, step, ui32_depth, vec_stack );
+   }
+ }
+}}
+
+/*
+ This will add every position where the pattern occurs with at most ui32_max_errors errors
+ (TRIE_APPROXIMATE_HAMMING or TRIE_APPROXIMATE_EDIT) to vec_matches, and return how many it added.
+ Nothing matches an empty pattern, or a limit that's as long as the pattern.
+*/
+ size_t find_trie_approximate_substrings (
+   const TRIE_VIEW &view,
+   const char *lp_pattern,
+   size_t st_length,
+   uint32_t ui32_max_errors,
+   uint8_t ui8_error_type,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ if ( ! lp_pattern || ! st_length || ui32_max_errors >= st_length || st_length >= UINT32_MAX / 2 || ! view .st_node_count ) {
+   return 0;
+ }
+
+ size_t st_found = vec_matches .size (  );
+ std::vector<TRIE_APPROXIMATE_STEP> vec_stack;
+ if ( ui8_error_type == TRIE_APPROXIMATE_EDIT ) {
+   find_trie_edit_substrings ( view, (const uint8_t *) lp_pattern, (uint32_t) st_length, ui32_max_errors, vec_stack, vec_matches );
+ }
+ else {
+   find_trie_hamming_substrings ( view, (const uint8_t *) lp_pattern, (uint32_t) st_length, ui32_max_errors, vec_stack, vec_matches );
+ }
+
+ return vec_matches .size (  ) - st_found;
+}}
+
+ size_t find_trie_approximate_substrings (
+   const TRIE &trie,
+   const char *lp_pattern,
+   size_t st_length,
+   uint32_t ui32_max_errors,
+   uint8_t ui8_error_type,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
+
+ return find_trie_approximate_substrings ( view, lp_pattern, st_length, ui32_max_errors, ui8_error_type, vec_matches );
+}}
@@ -0,0 +1,71 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To find the places where a pattern occurs with a few errors (typos, misread
+ characters, sequencing errors), which find_trie_substring's exact matching misses.
+
+ find_trie_approximate_substrings lists every position in the text where the pattern starts
+ with at most ui32_max_errors errors, and how many errors each one has:
+  TRIE_APPROXIMATE_HAMMING: substitutions only; the text matches the pattern's length.
+  TRIE_APPROXIMATE_EDIT: substitutions, insertions, and deletions (Levenshtein distance).
+  Each position is listed once, with its smallest number of errors and the length of the
+  text that it matches with them (the shortest, if several lengths tie).
+
+ Rather than comparing the pattern against every position in the text, it walks the
+ suffix tree depth-first, comparing the pattern against each edge. The text that a walk
+ has passed is the same for every suffix below it, so each comparison covers all of
+ them at once. A branch is abandoned (and its suffixes rejected together) as soon as it
+ can't be matched within the limit:
+  Hamming: as soon as the substitutions so far exceed it.
+  Edit distance: the walk keeps the column of the edit distance table for the text so far
+  (one entry per prefix of the pattern), and adds a column for each character. Errors
+  never decrease as the text gets longer, so once every entry of a column exceeds the
+  limit, so will every later one. (This is also what stops every walk after at most
+  m + k characters, for a pattern of m bytes.)
+ The number of branches that survive grows roughly with (m * alphabet size)^k rather than
+ with the size of the text, so this is for small limits; at k = 0 it's an exact search.
+
+ Matches are listed in the order the tree was walked, not by position. The limit has to be
+ less than the pattern's length; otherwise every position would match.
+
+ Usage:
+ std::vector<TRIE_APPROXIMATE_MATCH> vec_matches;
+ find_trie_approximate_substrings ( trie, "GATTACA", 7, 1, TRIE_APPROXIMATE_EDIT, vec_matches );
+
+ See suffix_tree_approximate.cpp for the implementation, and
+ suffix_tree_approximate_benchmark.cpp for a comparison with scanning the text.
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_tree_approximate.cpp suffix_tree_approximate_benchmark.cpp -o suffix_tree_approximate_benchmark
+*/
+#ifndef SUFFIX_TREE_APPROXIMATE_HEADER_DEFINED
+#define SUFFIX_TREE_APPROXIMATE_HEADER_DEFINED 1
+ #include "suffix_tree.h"
+
+ //Which errors find_trie_approximate_substrings allows.
+ #define TRIE_APPROXIMATE_HAMMING 0
+ #define TRIE_APPROXIMATE_EDIT 1
+
+typedef struct TRIE_APPROXIMATE_MATCH {
+  uint32_t ui32_position; //The zero-based offset in the text where the match starts.
+  uint32_t ui32_length; //How many bytes of the text it covers.
+  uint32_t ui32_errors;
+} TRIE_APPROXIMATE_MATCH;
+
+ size_t find_trie_approximate_substrings (
+   const TRIE_VIEW &view,
+   const char *lp_pattern,
+   size_t st_length,
+   uint32_t ui32_max_errors,
+   uint8_t ui8_error_type,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ );
+ size_t find_trie_approximate_substrings (
+   const TRIE &trie,
+   const char *lp_pattern,
+   size_t st_length,
+   uint32_t ui32_max_errors,
+   uint8_t ui8_error_type,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ );
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To compare the approximate search in suffix_tree_approximate.h against scanning
+ the text for the same matches, for Hamming distance and edit distance at small limits.
+
+ The text is random DNA, and the patterns are like sequencing reads: substrings of the text
+ with a few random substitutions (and, for edit distance, insertions and deletions) added.
+ The scan tries every position in the text, and gives up on a position as soon as the
+ errors exceed the limit (for edit distance, as soon as a whole column of the table does),
+ so it's the same pruning that the tree does, but once per position instead of once per
+ branch. The first BENCHMARK_SCAN_QUERY_COUNT patterns are also scanned for, and their
+ matches compared.
+
+ Usage: suffix_tree_approximate_benchmark [text size in MB (default: 4)] [pattern length (default: 24)]
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_tree_approximate.cpp suffix_tree_approximate_benchmark.cpp -o suffix_tree_approximate_benchmark
+*/
+ #include "suffix_tree_approximate.h"
+ #include "benchmark.h"
+ #include <algorithm>
+
+ #define BENCHMARK_QUERY_COUNT 200
+ #define BENCHMARK_SCAN_QUERY_COUNT 10
+ #define BENCHMARK_MAXIMUM_ERRORS 3
+
+ //This will sort matches by position, so that the tree's and the scan's can be compared.
+ static bool compare_benchmark_matches ( const TRIE_APPROXIMATE_MATCH &match1, const TRIE_APPROXIMATE_MATCH &match2 )
+{{
+ return match1 .ui32_position < match2 .ui32_position;
+}}
+
+ //The scan for Hamming distance: every position, until its substitutions exceed the limit.
+ static void scan_hamming_substrings (
+   const std::string &str_text,
+   const std::string &str_pattern,
+   uint32_t ui32_max_errors,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ const size_t st_length = str_pattern .size (  );
+ for ( size_t st_position = 0; st_position + st_length <= str_text .size (  ); st_position ++ ) {
+   uint32_t ui32_errors = 0;
+   for ( size_t st_i = 0; st_i < st_length && ui32_errors <= ui32_max_errors; st_i ++ ) {
+     ui32_errors += str_text [ st_position + st_i ] != str_pattern [ st_i ];
+   }
+   if ( ui32_errors <= ui32_max_errors ) {
+     TRIE_APPROXIMATE_MATCH match = { (uint32_t) st_position, (uint32_t) st_length, ui32_errors };
+     vec_matches .push_back ( match );
+   }
+ }
+}}
+
+ //The scan for edit distance: a column of the table at a time from every position, until a whole
+ //column exceeds the limit. Like the tree, it only computes the entries within k of the diagonal.
+ static void scan_edit_substrings (
+   const std::string &str_text,
+   const std::string &str_pattern,
+   uint32_t ui32_max_errors,
+   std::vector<TRIE_APPROXIMATE_MATCH> &vec_matches
+ )
+{{
+ const uint32_t ui32_length = (uint32_t) str_pattern .size (  );
+ const uint32_t ui32_over = ui32_max_errors + 1;
+ std::vector<uint32_t> vec_rows ( (size_t) (ui32_length + ui32_max_errors + 2) * (ui32_length + 1), ui32_over );
+ for ( uint32_t ui32_i = 0; ui32_i <= ui32_max_errors; ui32_i ++ ) {
+   vec_rows [ ui32_i ] = ui32_i;
+ }
+
+ for ( size_t st_position = 0; st_position < str_text .size (  ); st_position ++ ) {
+   TRIE_APPROXIMATE_MATCH match = { (uint32_t) st_position, 0, UINT32_MAX };
+   uint32_t ui32_minimum = 0;
+   for ( uint32_t ui32_depth = 1; st_position + ui32_depth <= str_text .size (  ) && ui32_minimum <= ui32_max_errors; ui32_depth ++ ) {
+     const uint32_t *lp_previous = &vec_rows [ (size_t) (ui32_depth - 1) * (ui32_length + 1) ];
+     uint32_t *lp_row = &vec_rows [ (size_t) ui32_depth * (ui32_length + 1) ];
+     char c_symbol = str_text [ st_position + ui32_depth - 1 ];
+     uint32_t ui32_first = ui32_depth > ui32_max_errors ? ui32_depth - ui32_max_errors : 1;
+     uint32_t ui32_last = std::min ( ui32_depth + ui32_max_errors, ui32_length );
+     ui32_minimum = ui32_over;
+     if ( ui32_depth <= ui32_max_errors ) {
+       ui32_minimum = lp_row [ 0 ] = ui32_depth;
+     }
+     for ( uint32_t ui32_j = ui32_first; ui32_j <= ui32_last; ui32_j ++ ) {
+       uint32_t ui32_cost = lp_previous [ ui32_j - 1 ] + (str_pattern [ ui32_j - 1 ] != c_symbol);
+       ui32_cost = std::min ( ui32_cost, std::min ( lp_previous [ ui32_j ], lp_row [ ui32_j - 1 ] ) + 1 );
+       lp_row [ ui32_j ] = std::min ( ui32_cost, ui32_over );
+       ui32_minimum = std::min ( ui32_minimum, lp_row [ ui32_j ] );
+     }
+     if ( lp_row [ ui32_length ] < match .ui32_errors ) {
+       match .ui32_errors = lp_row [ ui32_length ];
+       match .ui32_length = ui32_depth;
+     }
+   }
+   if ( match .ui32_errors <= ui32_max_errors ) {
+     vec_matches .push_back ( match );
+   }
+ }
+}}
+
+ //This will copy a random substring of the text with ui32_errors random errors (substitutions only, unless b_edits is set).
+ static void generate_benchmark_read (
+   const std::string &str_text,
+   size_t st_length,
+   uint32_t ui32_errors,
+   uint8_t b_edits,
+   std::string &str_read,
+   uint64_t *lpui64_state
+ )
+{{
+ std::string str_base; //The base that a substitution or an insertion puts in.
+ str_read = str_text .substr ( get_benchmark_random ( lpui64_state ) % (str_text .size (  ) - st_length), st_length );
+ for ( uint32_t ui32_i = 0; ui32_i < ui32_errors; ui32_i ++ ) {
+   size_t st_position = get_benchmark_random ( lpui64_state ) % str_read .size (  );
+   uint32_t ui32_kind = b_edits ? (uint32_t) (get_benchmark_random ( lpui64_state ) % 3) : 0;
+   generate_dna_text ( str_base, 1, lpui64_state );
+   if ( ui32_kind == 1 ) {
+     str_read .insert ( st_position, str_base );
+   }
+   else if ( ui32_kind == 2 ) {
+     str_read .erase ( st_position, 1 );
+   }
+   else {
+     str_read [ st_position ] = str_base [ 0 ];
+   }
+ }
+ //Keep every pattern the same length, so that the limits mean the same thing for all of them.
+ str_read .resize ( st_length, 'A' );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ size_t st_length = 4000000;
+ size_t st_pattern_length = 24;
+ if ( argc > 1 ) {
+   st_length = (size_t) (strtod ( argv [ 1 ], 0 ) * 1e6);
+ }
+ if ( argc > 2 ) {
+   st_pattern_length = (size_t) strtoul ( argv [ 2 ], 0, 10 );
+ }
+ //The node positions are 32-bit, and the text needs room for its terminator's leaf.
+ if ( st_length < 64 || st_length >= UINT32_MAX / 2 - 2 ) {
+   fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+   return 1;
+ }
+ if ( st_pattern_length <= BENCHMARK_MAXIMUM_ERRORS || st_pattern_length >= st_length ) {
+   fprintf ( stderr, "Error: The patterns must be longer than %d bytes, and shorter than the text.\n", BENCHMARK_MAXIMUM_ERRORS );
+   return 1;
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text;
+ generate_dna_text ( str_text, st_length, &ui64_state );
+
+ TRIE trie;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_trie ( trie, str_text .data (  ), str_text .size (  ) );
+ fprintf (
+   stdout,
+   "%.1f MB of DNA (tree built in %.2f s), %zu-byte patterns, %d per limit (%d of them scanned for):\n",
+   st_length / 1e6,
+   get_benchmark_seconds (  ) - dbl_start,
+   st_pattern_length,
+   BENCHMARK_QUERY_COUNT,
+   BENCHMARK_SCAN_QUERY_COUNT
+ );
+
+ std::string str_read;
+ std::vector<TRIE_APPROXIMATE_MATCH> vec_matches, vec_scanned;
+ for ( uint8_t ui8_error_type = TRIE_APPROXIMATE_HAMMING; ui8_error_type <= TRIE_APPROXIMATE_EDIT; ui8_error_type ++ ) {
+   for ( uint32_t ui32_max_errors = ui8_error_type == TRIE_APPROXIMATE_EDIT; ui32_max_errors <= BENCHMARK_MAXIMUM_ERRORS; ui32_max_errors ++ ) {
+     double dbl_tree = 0, dbl_scan = 0;
+     size_t st_match_count = 0;
+     uint8_t b_correct = 1;
+     for ( size_t st_query = 0; st_query < BENCHMARK_QUERY_COUNT; st_query ++ ) {
+       generate_benchmark_read ( str_text, st_pattern_length, ui32_max_errors, ui8_error_type == TRIE_APPROXIMATE_EDIT, str_read, &ui64_state );
+
+       vec_matches .clear (  );
+       dbl_start = get_benchmark_seconds (  );
+       st_match_count += find_trie_approximate_substrings ( trie, str_read .data (  ), str_read .size (  ), ui32_max_errors, ui8_error_type, vec_matches );
+       dbl_tree += get_benchmark_seconds (  ) - dbl_start;
+
+       if ( st_query < BENCHMARK_SCAN_QUERY_COUNT ) {
+         vec_scanned .clear (  );
+         dbl_start = get_benchmark_seconds (  );
+         if ( ui8_error_type == TRIE_APPROXIMATE_EDIT ) {
+           scan_edit_substrings ( str_text, str_read, ui32_max_errors, vec_scanned );
+         }
+         else {
+           scan_hamming_substrings ( str_text, str_read, ui32_max_errors, vec_scanned );
+         }
+         dbl_scan += get_benchmark_seconds (  ) - dbl_start;
+
+         std::sort ( vec_matches .begin (  ), vec_matches .end (  ), compare_benchmark_matches );
+         b_correct = b_correct && vec_matches .size (  ) == vec_scanned .size (  );
+         for ( size_t st_i = 0; b_correct && st_i < vec_matches .size (  ); st_i ++ ) {
+           b_correct = vec_matches [ st_i ] .ui32_position == vec_scanned [ st_i ] .ui32_position &&
+             vec_matches [ st_i ] .ui32_length == vec_scanned [ st_i ] .ui32_length &&
+             vec_matches [ st_i ] .ui32_errors == vec_scanned [ st_i ] .ui32_errors;
+         }
+       }
+     }
+
+     double dbl_tree_query = dbl_tree / BENCHMARK_QUERY_COUNT, dbl_scan_query = dbl_scan / BENCHMARK_SCAN_QUERY_COUNT;
+     fprintf (
+       stdout,
+       "  %-8s k = %" PRIu32 ": tree %9.3f ms per pattern; scan %9.3f ms per pattern (%7.1fx); %.1f matches per pattern%s\n",
+       ui8_error_type == TRIE_APPROXIMATE_EDIT ? "edit" : "Hamming",
+       ui32_max_errors,
+       dbl_tree_query * 1e3,
+       dbl_scan_query * 1e3,
+       dbl_scan_query / dbl_tree_query,
+       (double) st_match_count / BENCHMARK_QUERY_COUNT,
+       b_correct ? "" : " (INCORRECT RESULTS)"
+     );
+     fflush ( stdout );
+   }
+ }
+
+ return 0;
+}}
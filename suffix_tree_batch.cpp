@@ -0,0 +1,278 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the batched suffix tree queries described in suffix_tree_batch.h.
+
+ To compile (with the benchmark):
+   g++ -O2 -pthread suffix_tree.cpp suffix_tree_batch.cpp suffix_tree_batch_benchmark.cpp -o suffix_tree_batch_benchmark
+*/
+ #include "suffix_tree_batch.h"
+ #include <atomic>
+ #include <thread>
+
+ //This asks the processor to start loading the cache line at P, without waiting for it.
+ #if defined ( __GNUC__ ) || defined ( __clang__ )
+   #define trie_prefetch(P) __builtin_prefetch ( (P), 0, 3 )
+ #elif defined ( _MSC_VER ) && ( defined ( _M_X64 ) || defined ( _M_IX86 ) )
+   #include "xmmintrin.h"
+   #define trie_prefetch(P) _mm_prefetch ( (const char *) (P), _MM_HINT_T0 )
+ #else
+   #define trie_prefetch(P)
+ #endif
+
+ //What a lane does on its next turn (TRIE_BATCH_LANE.ui8_step).
+ #define TRIE_BATCH_STEP_NODE 0 //Read the node (prefetched last turn), and prefetch its edge and its children.
+ #define TRIE_BATCH_STEP_EDGE 1 //Match the node's edge, find the next child, and prefetch it.
+
+ //One search in progress.
+typedef struct TRIE_BATCH_LANE {
+  size_t st_query; //The pattern's position in the batch.
+  size_t st_matched; //How many bytes of the pattern have been matched (not counting the current node's edge).
+  uint32_t ui32_node;
+  uint8_t ui8_step; //TRIE_BATCH_STEP_*
+} TRIE_BATCH_LANE;
+
+ //What every thread shares.
+typedef struct TRIE_BATCH_WORK {
+  const TRIE_VIEW *lp_view;
+  const char **lpary_patterns;
+  const size_t *lpary_lengths;
+  size_t st_count;
+  size_t *lpary_results;
+  uint8_t b_count; //1 = count_trie_substrings; 0 = find_trie_substring.
+  std::atomic<size_t> st_next_chunk;
+} TRIE_BATCH_WORK;
+
+/*
+ This will give the lane the next pattern in [*lpst_next, st_end) that needs a search,
+ answering the ones that don't (empty patterns, or any pattern, if the tree is empty) on the way.
+ Returns 0, if there are none left.
+*/
+ static uint8_t start_trie_batch_lane ( TRIE_BATCH_WORK &work, TRIE_BATCH_LANE &lane, size_t *lpst_next, size_t st_end )
+{{
+ while ( *lpst_next < st_end ) {
+   size_t st_query = (*lpst_next) ++;
+   if ( ! work .lpary_patterns [ st_query ] || ! work .lpary_lengths [ st_query ] || ! work .lp_view ->st_node_count ) {
+     work .lpary_results [ st_query ] = 0;
+     continue;
+   }
+
+   lane .st_query = st_query;
+   lane .st_matched = 0;
+   lane .ui32_node = TRIE_ROOT; //The root has no edge to match, so its first turn finds its child.
+   lane .ui8_step = TRIE_BATCH_STEP_EDGE;
+   return 1;
+ }
+
+ return 0;
+}}
+
+/*
+ This will answer the patterns in [st_first, st_end), TRIE_BATCH_LANES at a time.
+ Each lane's search is the same as find_trie_node's in suffix_tree.cpp, split at every
+ point where it would wait on memory.
+*/
+ static void search_trie_batch ( TRIE_BATCH_WORK &work, size_t st_first, size_t st_end )
+{{
+ const TRIE_VIEW &view = *work .lp_view;
+ TRIE_BATCH_LANE ary_lanes [ TRIE_BATCH_LANES ];
+ uint32_t ui32_active = 0;
+ size_t st_next = st_first;
+ while ( ui32_active < TRIE_BATCH_LANES && start_trie_batch_lane ( work, ary_lanes [ ui32_active ], &st_next, st_end ) ) {
+   ui32_active ++;
+ }
+
+ while ( ui32_active ) {
+   for ( uint32_t ui32_lane = 0; ui32_lane < ui32_active; ) {
+     TRIE_BATCH_LANE &lane = ary_lanes [ ui32_lane ];
+     const char *lp_pattern = work .lpary_patterns [ lane .st_query ];
+     size_t st_length = work .lpary_lengths [ lane .st_query ];
+     const TRIE_NODE &node = view .lp_nodes [ lane .ui32_node ];
+
+     if ( lane .ui8_step == TRIE_BATCH_STEP_NODE ) {
+       //The rest of the edge, and the container that the next child will be found in (if the pattern goes past the edge).
+       uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) view .st_text_length : node .ui32_end;
+       size_t st_next_symbol = lane .st_matched + (ui32_end - node .ui32_start);
+       trie_prefetch ( view .lp_text + node .ui32_start + 1 );
+       if ( st_next_symbol < st_length ) {
+         switch ( node .ui8_child_type & TRIE_CHILDREN_TYPE ) {
+           case TRIE_CHILDREN_SORTED:
+             trie_prefetch ( view .lp_child_symbols + node .ui32_children );
+             break;
+           case TRIE_CHILDREN_BITMAP:
+             trie_prefetch ( view .lp_child_bitmaps + node .ui32_children );
+             break;
+           case TRIE_CHILDREN_DIRECT:
+             trie_prefetch ( view .lp_children + node .ui32_children + (uint8_t) lp_pattern [ st_next_symbol ] );
+             break;
+         }
+       }
+       lane .ui8_step = TRIE_BATCH_STEP_EDGE;
+       ui32_lane ++;
+       continue;
+     }
+
+     //Match as much of this edge as the pattern covers. (Its first character already matched.)
+     uint32_t ui32_answer_node = TRIE_NONE;
+     uint8_t b_done = 0;
+     if ( lane .ui32_node != TRIE_ROOT ) {
+       uint32_t ui32_end = node .ui32_end == TRIE_LEAF_END ? (uint32_t) view .st_text_length : node .ui32_end;
+       size_t st_edge_length = ui32_end - node .ui32_start;
+       size_t st_compare = st_length - lane .st_matched < st_edge_length ? st_length - lane .st_matched : st_edge_length;
+       if ( memcmp ( view .lp_text + node .ui32_start + 1, lp_pattern + lane .st_matched + 1, st_compare - 1 ) ) {
+         b_done = 1;
+       }
+       else {
+         lane .st_matched += st_compare;
+         if ( lane .st_matched == st_length ) {
+           ui32_answer_node = lane .ui32_node;
+           b_done = 1;
+         }
+       }
+     }
+
+     if ( ! b_done ) {
+       lane .ui32_node = find_trie_child ( view, lane .ui32_node, (uint8_t) lp_pattern [ lane .st_matched ] );
+       if ( lane .ui32_node == TRIE_NONE ) {
+         b_done = 1;
+       }
+       else {
+         trie_prefetch ( view .lp_nodes + lane .ui32_node );
+         lane .ui8_step = TRIE_BATCH_STEP_NODE;
+       }
+     }
+
+     if ( ! b_done ) {
+       ui32_lane ++;
+       continue;
+     }
+
+     if ( ui32_answer_node == TRIE_NONE ) {
+       work .lpary_results [ lane .st_query ] = 0;
+     }
+     else {
+       const TRIE_NODE &answer = view .lp_nodes [ ui32_answer_node ];
+       work .lpary_results [ lane .st_query ] = work .b_count ? answer .ui32_leaf_count : answer .ui32_index;
+     }
+
+     //Start the next pattern in this lane, or, if there are none left, move the last lane here.
+     if ( ! start_trie_batch_lane ( work, lane, &st_next, st_end ) ) {
+       lane = ary_lanes [ -- ui32_active ];
+     }
+   }
+ }
+}}
+
+ //Each thread keeps claiming the next unclaimed chunk until there are none left.
+ static void run_trie_batch_thread ( TRIE_BATCH_WORK *lp_work )
+{{
+ size_t st_chunk;
+ while ( (st_chunk = lp_work ->st_next_chunk .fetch_add ( 1 )) * TRIE_BATCH_CHUNK_SIZE < lp_work ->st_count ) {
+   size_t st_first = st_chunk * TRIE_BATCH_CHUNK_SIZE;
+   size_t st_end = lp_work ->st_count - st_first < TRIE_BATCH_CHUNK_SIZE ? lp_work ->st_count : st_first + TRIE_BATCH_CHUNK_SIZE;
+   search_trie_batch ( *lp_work, st_first, st_end );
+ }
+}}
+
+/*
+ This will split the batch across ui32_thread_count threads (zero = one per hardware thread),
+ but never more than there are chunks, and it works on the calling thread, too.
+*/
+ static void run_trie_batch (
+   const TRIE_VIEW &view,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count,
+   uint8_t b_count
+ )
+{{
+ if ( ! lpary_patterns || ! lpary_lengths || ! lpary_results || ! st_count ) {
+   return ;
+ }
+
+ TRIE_BATCH_WORK work;
+ work .lp_view = &view;
+ work .lpary_patterns = lpary_patterns;
+ work .lpary_lengths = lpary_lengths;
+ work .st_count = st_count;
+ work .lpary_results = lpary_results;
+ work .b_count = b_count;
+ work .st_next_chunk = 0;
+
+ if ( ! ui32_thread_count ) {
+   ui32_thread_count = std::thread::hardware_concurrency (  );
+ }
+ size_t st_chunk_count = (st_count + TRIE_BATCH_CHUNK_SIZE - 1) / TRIE_BATCH_CHUNK_SIZE;
+ if ( ui32_thread_count > st_chunk_count ) {
+   ui32_thread_count = (uint32_t) st_chunk_count;
+ }
+
+ std::vector<std::thread> vec_threads;
+ for ( uint32_t ui32_i = 1; ui32_i < ui32_thread_count; ui32_i ++ ) {
+   vec_threads .push_back ( std::thread ( run_trie_batch_thread, &work ) );
+ }
+ run_trie_batch_thread ( &work ); //The calling thread works, too.
+ for ( std::vector<std::thread>::iterator it_thread = vec_threads .begin (  ); it_thread != vec_threads .end (  ); it_thread ++ ) {
+   it_thread ->join (  );
+ }
+}}
+
+/*
+ This will write find_trie_substring's answer for each pattern (the one-based index of its
+ rightmost occurrence, or 0) to the same position in lpary_results.
+*/
+ void find_trie_substring_batch (
+   const TRIE_VIEW &view,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ )
+{{
+ run_trie_batch ( view, lpary_patterns, lpary_lengths, st_count, lpary_results, ui32_thread_count, 0 );
+}}
+
+ void find_trie_substring_batch (
+   const TRIE &trie,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
+
+ run_trie_batch ( view, lpary_patterns, lpary_lengths, st_count, lpary_results, ui32_thread_count, 0 );
+}}
+
+ //This will write how many times each pattern occurs (count_trie_substrings) to the same position in lpary_results.
+ void count_trie_substring_batch (
+   const TRIE_VIEW &view,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ )
+{{
+ run_trie_batch ( view, lpary_patterns, lpary_lengths, st_count, lpary_results, ui32_thread_count, 1 );
+}}
+
+ void count_trie_substring_batch (
+   const TRIE &trie,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ )
+{{
+ TRIE_VIEW view;
+ get_trie_view ( trie, view );
+
+ run_trie_batch ( view, lpary_patterns, lpary_lengths, st_count, lpary_results, ui32_thread_count, 1 );
+}}
@@ -0,0 +1,79 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To answer millions of independent substring queries against one suffix tree
+ at once, on every core, instead of one find_trie_substring call at a time.
+
+ find_trie_substring_batch and count_trie_substring_batch take an array of patterns and
+ write one answer per pattern (what find_trie_substring or count_trie_substrings would
+ have returned) to the same position in the caller's array. The patterns are claimed
+ TRIE_BATCH_CHUNK_SIZE at a time by ui32_thread_count threads (the calling thread is one of
+ them), which share the tree without locking, since nothing writes to it.
+
+ Each search is a walk down the tree where every step waits on a cache miss (the child's
+ container, then the child's node, then its edge in the text), and a tree that's much
+ bigger than the cache misses on almost every step. So each thread walks TRIE_BATCH_LANES
+ patterns at a time, taking one step of each in turn: a step prefetches what the lane's
+ next step will read, and by the time the other lanes have had their turns, it has
+ usually arrived. (find_map_nodes_data in map.c does the same for hash lookups.)
+
+ The tree can be a TRIE or a TRIE_VIEW, such as a mapped snapshot (suffix_tree_snapshot.h).
+
+ Usage:
+ const char *lpary_patterns [  ] = { "GATTACA", "TATA", "CCCC" };
+ size_t ary_lengths [  ] = { 7, 4, 4 };
+ size_t ary_counts [ 3 ];
+ count_trie_substring_batch ( trie, lpary_patterns, ary_lengths, 3, ary_counts, 0 ); //0 = one thread per hardware thread.
+
+ See suffix_tree_batch.cpp for the implementation and suffix_tree_batch_benchmark.cpp for measurements.
+
+ To compile:
+   g++ -O2 -pthread suffix_tree.cpp suffix_tree_batch.cpp suffix_tree_batch_benchmark.cpp -o suffix_tree_batch_benchmark
+*/
+#ifndef SUFFIX_TREE_BATCH_HEADER_DEFINED
+#define SUFFIX_TREE_BATCH_HEADER_DEFINED 1
+ #include "suffix_tree.h"
+
+ //How many searches each thread interleaves. There should be enough to keep the processor's
+ //outstanding cache misses busy, but not so many that the first prefetched lines are evicted before they're used.
+ #ifndef TRIE_BATCH_LANES
+   #define TRIE_BATCH_LANES 16
+ #endif
+ //How many patterns a thread claims at a time. (Smaller chunks balance the threads better, but they contend more.)
+ #ifndef TRIE_BATCH_CHUNK_SIZE
+   #define TRIE_BATCH_CHUNK_SIZE 4096
+ #endif
+
+ void find_trie_substring_batch (
+   const TRIE_VIEW &view,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ );
+ void find_trie_substring_batch (
+   const TRIE &trie,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ );
+ void count_trie_substring_batch (
+   const TRIE_VIEW &view,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ );
+ void count_trie_substring_batch (
+   const TRIE &trie,
+   const char **lpary_patterns,
+   const size_t *lpary_lengths,
+   size_t st_count,
+   size_t *lpary_results,
+   uint32_t ui32_thread_count
+ );
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure how much faster the batched queries in suffix_tree_batch.h are than
+ calling find_trie_substring once per pattern: first on one thread (where the only
+ difference is interleaving the searches), and then on 1, 2, 4, ... threads, up to the
+ number of hardware threads (or the number given). Every answer is checked against
+ find_trie_substring's and count_trie_substrings'.
+
+ The text is random DNA, so that the tree is much bigger than the processor's cache (about
+ 60 bytes per byte of text). Half of the patterns are substrings of the text, and half
+ are random (and mostly miss after a dozen bytes or so).
+
+ Usage: suffix_tree_batch_benchmark [text size in MB (default: 4)] [pattern count (default: 2000000)] [maximum thread count]
+
+ To compile:
+   g++ -O2 -pthread suffix_tree.cpp suffix_tree_batch.cpp suffix_tree_batch_benchmark.cpp -o suffix_tree_batch_benchmark
+*/
+ #include "suffix_tree_batch.h"
+ #include "benchmark.h"
+ #include <thread>
+
+ int main ( int argc, char **argv )
+{{
+ size_t st_length = 4000000;
+ size_t st_query_count = 2000000;
+ uint32_t ui32_maximum_threads = std::thread::hardware_concurrency (  );
+ if ( argc > 1 ) {
+   st_length = (size_t) (strtod ( argv [ 1 ], 0 ) * 1e6);
+ }
+ if ( argc > 2 ) {
+   st_query_count = (size_t) strtoull ( argv [ 2 ], 0, 10 );
+ }
+ if ( argc > 3 ) {
+   ui32_maximum_threads = (uint32_t) strtoul ( argv [ 3 ], 0, 10 );
+ }
+ //The node positions are 32-bit, and the text needs room for its terminator's leaf.
+ if ( st_length < 64 || st_length >= UINT32_MAX / 2 - 2 ) {
+   fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+   return 1;
+ }
+ if ( ! st_query_count ) {
+   fprintf ( stderr, "Error: The pattern count must be at least one.\n" );
+   return 1;
+ }
+ if ( ! ui32_maximum_threads ) {
+   ui32_maximum_threads = 1;
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text, str_random;
+ generate_dna_text ( str_text, st_length, &ui64_state );
+
+ //The patterns are 8 to 24 bytes long, all in one buffer.
+ std::string str_patterns;
+ std::vector<size_t> vec_offsets ( st_query_count ), vec_lengths ( st_query_count );
+ str_patterns .reserve ( st_query_count * 16 );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   size_t st_query_length = 8 + get_benchmark_random ( &ui64_state ) % 17;
+   vec_offsets [ st_i ] = str_patterns .size (  );
+   vec_lengths [ st_i ] = st_query_length;
+   if ( st_i & 1 ) {
+     generate_dna_text ( str_random, st_query_length, &ui64_state );
+     str_patterns += str_random;
+   }
+   else {
+     str_patterns .append ( str_text, get_benchmark_random ( &ui64_state ) % (st_length - st_query_length + 1), st_query_length );
+   }
+ }
+ std::vector<const char *> vec_patterns ( st_query_count );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   vec_patterns [ st_i ] = str_patterns .data (  ) + vec_offsets [ st_i ];
+ }
+
+ TRIE trie;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_trie ( trie, str_text .data (  ), str_text .size (  ) );
+ fprintf (
+   stdout,
+   "%.1f MB of DNA (a %.0f MB tree, built in %.2f s), %zu patterns, %u hardware threads:\n",
+   st_length / 1e6,
+   get_trie_memory_usage ( trie ) / 1e6,
+   get_benchmark_seconds (  ) - dbl_start,
+   st_query_count,
+   std::thread::hardware_concurrency (  )
+ );
+
+ //The baseline: one pattern at a time, on one thread.
+ std::vector<size_t> vec_expected_finds ( st_query_count ), vec_expected_counts ( st_query_count );
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   vec_expected_finds [ st_i ] = find_trie_substring ( trie, vec_patterns [ st_i ], vec_lengths [ st_i ] );
+ }
+ double dbl_single = get_benchmark_seconds (  ) - dbl_start;
+ for ( size_t st_i = 0; st_i < st_query_count; st_i ++ ) {
+   vec_expected_counts [ st_i ] = count_trie_substrings ( trie, vec_patterns [ st_i ], vec_lengths [ st_i ] );
+ }
+ fprintf ( stdout, "  find_trie_substring, one at a time: %7.3f Mops/s\n", st_query_count / dbl_single / 1e6 );
+
+ std::vector<size_t> vec_results ( st_query_count );
+ uint8_t b_correct = 1;
+ for ( uint32_t ui32_threads = 1; ; ui32_threads = ui32_threads * 2 < ui32_maximum_threads ? ui32_threads * 2 : ui32_maximum_threads ) {
+   memset ( vec_results .data (  ), 0xff, st_query_count * sizeof ( size_t ) );
+   dbl_start = get_benchmark_seconds (  );
+   find_trie_substring_batch ( trie, vec_patterns .data (  ), vec_lengths .data (  ), st_query_count, vec_results .data (  ), ui32_threads );
+   double dbl_find = get_benchmark_seconds (  ) - dbl_start;
+   b_correct = b_correct && vec_results == vec_expected_finds;
+
+   memset ( vec_results .data (  ), 0xff, st_query_count * sizeof ( size_t ) );
+   dbl_start = get_benchmark_seconds (  );
+   count_trie_substring_batch ( trie, vec_patterns .data (  ), vec_lengths .data (  ), st_query_count, vec_results .data (  ), ui32_threads );
+   double dbl_count = get_benchmark_seconds (  ) - dbl_start;
+   b_correct = b_correct && vec_results == vec_expected_counts;
+
+   fprintf (
+     stdout,
+     "  batch, %2u thread%s: find %7.3f Mops/s (%5.2fx), count %7.3f Mops/s%s\n",
+     ui32_threads,
+     ui32_threads == 1 ? " " : "s",
+     st_query_count / dbl_find / 1e6,
+     dbl_single / dbl_find,
+     st_query_count / dbl_count / 1e6,
+     b_correct ? "" : " (INCORRECT RESULTS)"
+   );
+   if ( ui32_threads == ui32_maximum_threads ) {
+     break;
+   }
+ }
+
+ return 0;
+}}
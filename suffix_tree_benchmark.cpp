@@ -0,0 +1,112 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To measure how long generate_trie takes to build suffix trees of large texts,
+ how much memory they take per byte of text, and how quickly they match substrings.
+
+ Three kinds of text are generated: random DNA (4 symbols, so the tree is deep and narrow),
+ English-like text (random words from a small vocabulary, so the tree is wider near the
+ root), and binary data (every byte value, with runs of zeroes like executables have, so
+ the nodes near the root have up to 256 children). Every match is checked against the
+ text, so a wrong result can't go unnoticed. The number of nodes that use each kind of
+ child container (sorted/bitmap/direct) is shown with each tree.
+
+ Usage: suffix_tree_benchmark [text size in MB]... (default: 1 10 30)
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_tree_benchmark.cpp -o suffix_tree_benchmark
+*/
+ #include "suffix_tree.h"
+ #include "benchmark.h"
+
+ #define BENCHMARK_QUERY_COUNT 1000000
+
+ static void run_suffix_tree_benchmark ( const char *lpsz_name, const std::string &str_text, uint64_t *lpui64_state )
+{{
+ TRIE trie;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_trie ( trie, str_text .data (  ), str_text .size (  ) );
+ double dbl_build = get_benchmark_seconds (  ) - dbl_start;
+
+ //Half of the queries are substrings of the text (hits); the other half are random and mostly miss.
+ const size_t st_length = str_text .size (  );
+ std::vector<std::string> vec_queries ( BENCHMARK_QUERY_COUNT );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   size_t st_query_length = 8 + get_benchmark_random ( lpui64_state ) % 25;
+   if ( st_i & 1 ) {
+     vec_queries [ st_i ] .resize ( st_query_length );
+     for ( size_t st_j = 0; st_j < st_query_length; st_j ++ ) {
+       vec_queries [ st_i ] [ st_j ] = str_text [ get_benchmark_random ( lpui64_state ) % st_length ];
+     }
+   }
+   else {
+     vec_queries [ st_i ] = str_text .substr ( get_benchmark_random ( lpui64_state ) % (st_length - st_query_length), st_query_length );
+   }
+ }
+
+ size_t st_found = 0, st_wrong = 0;
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   size_t st_index = find_trie_substring ( trie, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+   if ( st_index ) {
+     st_found ++;
+     st_wrong += memcmp ( str_text .data (  ) + st_index - 1, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) ) != 0;
+   }
+   else {
+     st_wrong += ! (st_i & 1); //Every substring of the text must be found.
+   }
+ }
+ double dbl_query = get_benchmark_seconds (  ) - dbl_start;
+
+ size_t ary_types [ 4 ] = { 0, 0, 0, 0 };
+ for ( std::vector<TRIE_NODE>::const_iterator it_node = trie .vec_nodes .cbegin (  ); it_node != trie .vec_nodes .cend (  ); it_node ++ ) {
+   ary_types [ it_node ->ui8_child_type & TRIE_CHILDREN_TYPE ] ++;
+ }
+
+ fprintf (
+   stdout,
+   "%-8s %6.1f MB: build %7.2f s (%6.2f MB/s); %10zu nodes (%zu/%zu/%zu); %6.1f bytes per input byte; query %6.3f Mops/s (%zu found)%s\n",
+   lpsz_name,
+   st_length / 1e6,
+   dbl_build,
+   st_length / dbl_build / 1e6,
+   trie .vec_nodes .size (  ),
+   ary_types [ TRIE_CHILDREN_SORTED ],
+   ary_types [ TRIE_CHILDREN_BITMAP ],
+   ary_types [ TRIE_CHILDREN_DIRECT ],
+   (double) get_trie_memory_usage ( trie ) / st_length,
+   BENCHMARK_QUERY_COUNT / dbl_query / 1e6,
+   st_found,
+   st_wrong ? " (INCORRECT RESULTS)" : ""
+ );
+}}
+
+ int main ( int argc, char **argv )
+{{
+ std::vector<size_t> vec_sizes;
+ for ( int i = 1; i < argc; i ++ ) {
+   vec_sizes .push_back ( (size_t) (strtod ( argv [ i ], 0 ) * 1e6) );
+ }
+ if ( vec_sizes .empty (  ) ) {
+   vec_sizes .push_back ( 1000000 );
+   vec_sizes .push_back ( 10000000 );
+   vec_sizes .push_back ( 30000000 );
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text;
+ for ( std::vector<size_t>::const_iterator it_size = vec_sizes .cbegin (  ); it_size != vec_sizes .cend (  ); it_size ++ ) {
+   if ( *it_size < 64 || *it_size > TRIE_MAXIMUM_LENGTH ) {
+     fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+     return 1;
+   }
+
+   generate_dna_text ( str_text, *it_size, &ui64_state );
+   run_suffix_tree_benchmark ( "DNA", str_text, &ui64_state );
+   generate_english_text ( str_text, *it_size, &ui64_state );
+   run_suffix_tree_benchmark ( "English", str_text, &ui64_state );
+   generate_binary_text ( str_text, *it_size, &ui64_state );
+   run_suffix_tree_benchmark ( "binary", str_text, &ui64_state );
+ }
+
+ return 0;
+}}
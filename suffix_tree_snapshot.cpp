@@ -0,0 +1,211 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To implement the suffix tree snapshot files described in suffix_tree_snapshot.h.
+
+ To compile (with the benchmark):
+   g++ -O2 suffix_tree.cpp mapped_file.c suffix_tree_snapshot.cpp suffix_tree_snapshot_benchmark.cpp -o suffix_tree_snapshot_benchmark
+*/
+ #include "suffix_tree_snapshot.h"
+
+ //Round X up to the next multiple of TRIE_SNAPSHOT_ALIGNMENT.
+ #define TRIE_SNAPSHOT_ALIGN(X) ( ((X) + TRIE_SNAPSHOT_ALIGNMENT - 1) & ~(uint64_t) (TRIE_SNAPSHOT_ALIGNMENT - 1) )
+
+ //How many nodes are copied (and written) at a time.
+ #define TRIE_SNAPSHOT_NODE_BATCH 4096
+
+ //This will write ui64_count zeroes to the file. Returns 0, if they couldn't be written.
+ static uint8_t write_trie_snapshot_padding ( FILE *lp_file, uint64_t ui64_count )
+{{
+ static const char sz_zeroes [ TRIE_SNAPSHOT_ALIGNMENT ] = { 0 };
+
+ return ! ui64_count || fwrite ( sz_zeroes, (size_t) ui64_count, 1, lp_file ) == 1;
+}}
+
+/*
+ This will write one array at *lpui64_offset (recording that in *lpui64_section_offset),
+ padded to the next multiple of TRIE_SNAPSHOT_ALIGNMENT, and move *lpui64_offset past it.
+ Returns 0, if it couldn't be written.
+*/
+ static uint8_t write_trie_snapshot_section (
+   FILE *lp_file,
+   const void *lpv_data,
+   uint64_t ui64_size,
+   uint64_t *lpui64_offset,
+   uint64_t *lpui64_section_offset
+ )
+{{
+ *lpui64_section_offset = *lpui64_offset;
+ *lpui64_offset += TRIE_SNAPSHOT_ALIGN ( ui64_size );
+
+ return ( ! ui64_size || fwrite ( lpv_data, (size_t) ui64_size, 1, lp_file ) == 1 ) &&
+        write_trie_snapshot_padding ( lp_file, TRIE_SNAPSHOT_ALIGN ( ui64_size ) - ui64_size );
+}}
+
+/*
+ This will write the nodes like write_trie_snapshot_section, but a field at a time, so that
+ the padding inside of TRIE_NODE is always zeroes (and the same tree always makes the same file).
+*/
+ static uint8_t write_trie_snapshot_nodes ( FILE *lp_file, const TRIE &trie, uint64_t *lpui64_offset, uint64_t *lpui64_section_offset )
+{{
+ TRIE_NODE *lpary_batch = (TRIE_NODE *) calloc ( TRIE_SNAPSHOT_NODE_BATCH, sizeof ( TRIE_NODE ) );
+ const size_t st_count = trie .vec_nodes .size (  );
+ uint8_t b_success = lpary_batch != 0;
+
+ for ( size_t st_first = 0; b_success && st_first < st_count; st_first += TRIE_SNAPSHOT_NODE_BATCH ) {
+   size_t st_batch = st_count - st_first < TRIE_SNAPSHOT_NODE_BATCH ? st_count - st_first : TRIE_SNAPSHOT_NODE_BATCH;
+   for ( size_t st_i = 0; st_i < st_batch; st_i ++ ) {
+     const TRIE_NODE &node = trie .vec_nodes [ st_first + st_i ];
+     TRIE_NODE &copy = lpary_batch [ st_i ];
+     copy .ui32_start = node .ui32_start;
+     copy .ui32_end = node .ui32_end;
+     copy .ui32_index = node .ui32_index;
+     copy .ui32_children = node .ui32_children;
+     copy .ui16_child_count = node .ui16_child_count;
+     copy .ui8_child_type = node .ui8_child_type;
+     copy .ui32_first_leaf = node .ui32_first_leaf;
+     copy .ui32_leaf_count = node .ui32_leaf_count;
+   }
+   b_success = fwrite ( lpary_batch, sizeof ( TRIE_NODE ), st_batch, lp_file ) == st_batch;
+ }
+ free ( lpary_batch );
+
+ uint64_t ui64_size = (uint64_t) st_count * sizeof ( TRIE_NODE );
+ *lpui64_section_offset = *lpui64_offset;
+ *lpui64_offset += TRIE_SNAPSHOT_ALIGN ( ui64_size );
+
+ return b_success && write_trie_snapshot_padding ( lp_file, TRIE_SNAPSHOT_ALIGN ( ui64_size ) - ui64_size );
+}}
+
+/*
+ This will write the tree to a temporary file and then rename it over lpsz_path (see
+ create_mapped_file), so processes that have the old snapshot open keep reading it, and the
+ old snapshot is only replaced once the new one is complete.
+ Returns 0 (leaving any old file alone), if the file couldn't be written.
+*/
+ uint8_t save_trie_snapshot ( const TRIE &trie, const char *lpsz_path )
+{{
+ if ( ! lpsz_path ) {
+   return 0;
+ }
+
+ TRIE_SNAPSHOT_HEADER header;
+ memset ( &header, 0, sizeof ( TRIE_SNAPSHOT_HEADER ) );
+ set_mapped_file_signature ( &header .signature, TRIE_SNAPSHOT_MAGIC, TRIE_SNAPSHOT_VERSION );
+ header .ui32_node_size = sizeof ( TRIE_NODE );
+ header .ui32_bitmap_size = sizeof ( TRIE_CHILD_BITMAP );
+ header .ui64_text_length = trie .str_text .size (  );
+ header .ui64_node_count = trie .vec_nodes .size (  );
+ header .ui64_child_count = trie .vec_children .size (  );
+ header .ui64_bitmap_count = trie .vec_child_bitmaps .size (  );
+ header .ui64_leaf_count = trie .vec_leaves .size (  );
+
+ MAPPED_FILE_WRITER writer;
+ FILE *lp_file = create_mapped_file ( &writer, lpsz_path );
+ uint8_t b_success = lp_file != 0;
+
+ //Leave room for the header (zeroed out, so it has no magic number yet), which is
+ //filled in once everything else has been written.
+ uint64_t ui64_offset = TRIE_SNAPSHOT_ALIGN ( sizeof ( TRIE_SNAPSHOT_HEADER ) );
+ for ( uint64_t ui64_i = 0; b_success && ui64_i < ui64_offset; ui64_i += TRIE_SNAPSHOT_ALIGNMENT ) {
+   b_success = write_trie_snapshot_padding ( lp_file, TRIE_SNAPSHOT_ALIGNMENT );
+ }
+
+ b_success = b_success &&
+   write_trie_snapshot_section ( lp_file, trie .str_text .data (  ), header .ui64_text_length, &ui64_offset, &header .ui64_text_offset ) &&
+   write_trie_snapshot_nodes ( lp_file, trie, &ui64_offset, &header .ui64_nodes_offset ) &&
+   write_trie_snapshot_section (
+     lp_file, trie .vec_children .data (  ), header .ui64_child_count * sizeof ( uint32_t ), &ui64_offset, &header .ui64_children_offset
+   ) &&
+   write_trie_snapshot_section (
+     lp_file, trie .vec_child_symbols .data (  ), trie .vec_child_symbols .size (  ), &ui64_offset, &header .ui64_child_symbols_offset
+   ) &&
+   write_trie_snapshot_section (
+     lp_file, trie .vec_child_bitmaps .data (  ), header .ui64_bitmap_count * sizeof ( TRIE_CHILD_BITMAP ), &ui64_offset, &header .ui64_bitmaps_offset
+   ) &&
+   write_trie_snapshot_section (
+     lp_file, trie .vec_leaves .data (  ), header .ui64_leaf_count * sizeof ( uint32_t ), &ui64_offset, &header .ui64_leaves_offset
+   );
+ header .ui64_file_size = ui64_offset;
+
+ //Now that the file is complete, the header can say so.
+ b_success = b_success && ! fseek ( lp_file, 0, SEEK_SET ) &&
+             fwrite ( &header, sizeof ( TRIE_SNAPSHOT_HEADER ), 1, lp_file ) == 1;
+
+ //This replaces the old file (if any) only if everything was written.
+ b_success = finish_mapped_file ( &writer, b_success );
+ if ( ! b_success ) {
+   fprintf ( stderr, "save_trie_snapshot: Error: We couldn't write \"%s\".\n", lpsz_path );
+ }
+
+ return b_success;
+}}
+
+ //Whether an array of ui64_count elements of ui64_element_size bytes at ui64_offset is aligned and inside of a file of st_size bytes.
+ static uint8_t is_trie_snapshot_section_valid ( uint64_t ui64_offset, uint64_t ui64_count, uint64_t ui64_element_size, size_t st_size )
+{{
+ return ! (ui64_offset % TRIE_SNAPSHOT_ALIGNMENT) &&
+        ui64_offset <= st_size &&
+        (st_size - ui64_offset) / ui64_element_size >= ui64_count;
+}}
+
+/*
+ This will map the file at lpsz_path into memory and point lp_snapshot->view at the tree in it,
+ so that it can be searched right away. Nothing but the header is read.
+ Returns 0, if the file couldn't be opened or isn't a snapshot that this version can read.
+*/
+ uint8_t open_trie_snapshot ( TRIE_SNAPSHOT *lp_snapshot, const char *lpsz_path )
+{{
+ if ( ! lp_snapshot || ! lpsz_path ) {
+   return 0;
+ }
+
+ memset ( lp_snapshot, 0, sizeof ( TRIE_SNAPSHOT ) );
+ if ( ! open_mapped_file ( &lp_snapshot ->file, lpsz_path, sizeof ( TRIE_SNAPSHOT_HEADER ) ) ) {
+   return 0;
+ }
+
+ //Make sure that every array the header points to is inside of the file before trusting it.
+ const size_t st_size = lp_snapshot ->file .st_size;
+ const TRIE_SNAPSHOT_HEADER *lp_header = (const TRIE_SNAPSHOT_HEADER *) lp_snapshot ->file .lp_base;
+ uint8_t b_valid = is_mapped_file_signature ( &lp_header ->signature, TRIE_SNAPSHOT_MAGIC, TRIE_SNAPSHOT_VERSION ) &&
+                   lp_header ->ui32_node_size == sizeof ( TRIE_NODE ) &&
+                   lp_header ->ui32_bitmap_size == sizeof ( TRIE_CHILD_BITMAP ) &&
+                   lp_header ->ui64_file_size == st_size &&
+                   lp_header ->ui64_node_count && lp_header ->ui64_node_count <= UINT32_MAX &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_text_offset, lp_header ->ui64_text_length, 1, st_size ) &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_nodes_offset, lp_header ->ui64_node_count, sizeof ( TRIE_NODE ), st_size ) &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_children_offset, lp_header ->ui64_child_count, sizeof ( uint32_t ), st_size ) &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_child_symbols_offset, lp_header ->ui64_child_count, 1, st_size ) &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_bitmaps_offset, lp_header ->ui64_bitmap_count, sizeof ( TRIE_CHILD_BITMAP ), st_size ) &&
+                   is_trie_snapshot_section_valid ( lp_header ->ui64_leaves_offset, lp_header ->ui64_leaf_count, sizeof ( uint32_t ), st_size );
+ if ( ! b_valid ) {
+   fprintf ( stderr, "open_trie_snapshot: Error: \"%s\" isn't a snapshot that we can read.\n", lpsz_path );
+   close_mapped_file ( &lp_snapshot ->file );
+   return 0;
+ }
+
+ lp_snapshot ->lp_header = lp_header;
+ lp_snapshot ->view .lp_text = lp_snapshot ->file .lp_base + lp_header ->ui64_text_offset;
+ lp_snapshot ->view .st_text_length = (size_t) lp_header ->ui64_text_length;
+ lp_snapshot ->view .lp_nodes = (const TRIE_NODE *) (lp_snapshot ->file .lp_base + lp_header ->ui64_nodes_offset);
+ lp_snapshot ->view .st_node_count = (size_t) lp_header ->ui64_node_count;
+ lp_snapshot ->view .lp_children = (const uint32_t *) (lp_snapshot ->file .lp_base + lp_header ->ui64_children_offset);
+ lp_snapshot ->view .lp_child_symbols = (const uint8_t *) (lp_snapshot ->file .lp_base + lp_header ->ui64_child_symbols_offset);
+ lp_snapshot ->view .lp_child_bitmaps = (const TRIE_CHILD_BITMAP *) (lp_snapshot ->file .lp_base + lp_header ->ui64_bitmaps_offset);
+ lp_snapshot ->view .lp_leaves = (const uint32_t *) (lp_snapshot ->file .lp_base + lp_header ->ui64_leaves_offset);
+
+ return 1;
+}}
+
+ //This will unmap the file. Returns 0, if nothing was open.
+ uint8_t close_trie_snapshot ( TRIE_SNAPSHOT *lp_snapshot )
+{{
+ if ( ! lp_snapshot || ! lp_snapshot ->file .lp_base ) {
+   return 0;
+ }
+
+ close_mapped_file ( &lp_snapshot ->file );
+ memset ( lp_snapshot, 0, sizeof ( TRIE_SNAPSHOT ) );
+
+ return 1;
+}}
@@ -0,0 +1,77 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To save a built suffix tree to a file that can be opened again instantly, instead
+ of rebuilding the tree from its text every time a program starts.
+
+ The tree has no pointers: every node refers to other nodes, children, and text by their
+ positions in its arrays. save_trie_snapshot writes those arrays as they are, each at an
+ offset (from the start of the file) that the header records, so open_trie_snapshot only
+ has to map the file into memory (read-only) and point a TRIE_VIEW at them; it takes the
+ same time for any size of tree. The queries in suffix_tree.h that take a TRIE_VIEW then
+ run straight from the mapped pages, which are read from the disk as they're touched.
+ Every process that opens the same file shares one copy of its pages (the operating
+ system's file cache). Saving to the same path again writes a new file and renames it over
+ the old one, so processes that have the old one open keep using it.
+
+ Only the header and the positions of the arrays are checked when a file is opened;
+ checking every link in the tree would take as long as reading it. The nodes are saved
+ byte for byte, so the file can only be opened on a machine with the same byte order and
+ the same layout of TRIE_NODE (both are recorded in the header).
+
+ File layout (every offset is from the start of the file and a multiple of 64):
+   TRIE_SNAPSHOT_HEADER
+   text: the indexed text
+   nodes: TRIE_NODE[ui64_node_count]
+   children: uint32_t[ui64_child_count]
+   child symbols: uint8_t[ui64_child_count]
+   bitmaps: TRIE_CHILD_BITMAP[ui64_bitmap_count]
+   leaves: uint32_t[ui64_leaf_count]
+
+ Usage:
+ TRIE_SNAPSHOT snapshot;
+ if ( open_trie_snapshot ( &snapshot, "reference.trie" ) ) {
+   size_t st_count = count_trie_substrings ( snapshot .view, "GATTACA", 7 );
+   close_trie_snapshot ( &snapshot );
+ }
+
+ See suffix_tree_snapshot.cpp for the implementation and
+ suffix_tree_snapshot_benchmark.cpp for startup measurements.
+*/
+#ifndef SUFFIX_TREE_SNAPSHOT_HEADER_DEFINED
+#define SUFFIX_TREE_SNAPSHOT_HEADER_DEFINED 1
+ #include "suffix_tree.h"
+ #include "mapped_file.h"
+
+ #define TRIE_SNAPSHOT_MAGIC "TRIESNP"
+ #define TRIE_SNAPSHOT_VERSION 1
+ #define TRIE_SNAPSHOT_ALIGNMENT 64 //A cache line, so that no node straddles more lines than it has to.
+
+ typedef struct TRIE_SNAPSHOT_HEADER {
+   MAPPED_FILE_SIGNATURE signature; //TRIE_SNAPSHOT_MAGIC and TRIE_SNAPSHOT_VERSION
+   uint32_t ui32_node_size; //sizeof ( TRIE_NODE )
+   uint32_t ui32_bitmap_size; //sizeof ( TRIE_CHILD_BITMAP )
+   uint64_t ui64_text_offset;
+   uint64_t ui64_text_length;
+   uint64_t ui64_nodes_offset;
+   uint64_t ui64_node_count;
+   uint64_t ui64_children_offset;
+   uint64_t ui64_child_symbols_offset;
+   uint64_t ui64_child_count;
+   uint64_t ui64_bitmaps_offset;
+   uint64_t ui64_bitmap_count;
+   uint64_t ui64_leaves_offset;
+   uint64_t ui64_leaf_count;
+   uint64_t ui64_file_size;
+ } TRIE_SNAPSHOT_HEADER;
+
+ typedef struct TRIE_SNAPSHOT {
+   MAPPED_FILE file;
+   const TRIE_SNAPSHOT_HEADER *lp_header;
+   TRIE_VIEW view; //The tree's arrays, in the mapped file.
+ } TRIE_SNAPSHOT;
+
+ uint8_t save_trie_snapshot ( const TRIE &trie, const char *lpsz_path );
+ uint8_t open_trie_snapshot ( TRIE_SNAPSHOT *lp_snapshot, const char *lpsz_path );
+ uint8_t close_trie_snapshot ( TRIE_SNAPSHOT *lp_snapshot );
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ Created on 2026-10-19 by agent
+ Purpose: To compare starting up by rebuilding a suffix tree from its text against
+ starting up by opening a snapshot of it (see suffix_tree_snapshot.h), and to check that
+ the mapped tree answers every query the same way as the one in memory.
+
+ On Linux, a second process then opens the same snapshot and touches all of it, and reads
+ how much of the mapping it has resident (Rss) against its share of it (Pss): when both
+ processes share the pages, its share is about half.
+
+ Usage: suffix_tree_snapshot_benchmark [text size in MB (default: 8)] [snapshot path (default: suffix_tree_snapshot_benchmark.snapshot)]
+ The snapshot file is removed when the benchmark is done. It was just written, so
+ it's probably still in the operating system's cache; the first queries after a
+ reboot will be slower while its pages are read from the disk.
+
+ To compile:
+   g++ -O2 suffix_tree.cpp mapped_file.c suffix_tree_snapshot.cpp suffix_tree_snapshot_benchmark.cpp -o suffix_tree_snapshot_benchmark
+*/
+ #include "suffix_tree_snapshot.h"
+ #include "benchmark.h"
+#ifdef __linux__
+ #include "unistd.h"
+ #include "sys/wait.h"
+#endif
+
+ #define BENCHMARK_QUERY_COUNT 200000
+
+ //This will read every page of the mapped file, so that all of it is resident. Returns a checksum, so the reads aren't optimized away.
+ static uint64_t touch_benchmark_snapshot ( const TRIE_SNAPSHOT &snapshot )
+{{
+ uint64_t ui64_sum = 0;
+ for ( size_t st_i = 0; st_i < snapshot .file .st_size; st_i += 4096 ) {
+   ui64_sum += (uint8_t) snapshot .file .lp_base [ st_i ];
+ }
+
+ return ui64_sum;
+}}
+
+#ifdef __linux__
+/*
+ This will find the mapping that starts at lpv_base in /proc/self/smaps and read how many
+ kB of it are resident (Rss) and this process's share of those (Pss).
+ Returns 0, if it isn't there.
+*/
+ static uint8_t get_benchmark_mapping_usage ( const void *lpv_base, size_t *lpst_rss, size_t *lpst_pss )
+{{
+ FILE *lp_file = fopen ( "/proc/self/smaps", "r" );
+ if ( ! lp_file ) {
+   return 0;
+ }
+
+ char sz_line [ 512 ];
+ uint8_t b_inside = 0, b_found = 0;
+ *lpst_rss = *lpst_pss = 0;
+ while ( fgets ( sz_line, sizeof ( sz_line ), lp_file ) ) {
+   unsigned long long ull_start, ull_end;
+   //Each mapping starts with a line like "7f8b7f3d1000-7f8b7f3d3000 r--s ...", followed by its fields.
+   if ( sscanf ( sz_line, "%llx-%llx ", &ull_start, &ull_end ) == 2 ) {
+     b_inside = ull_start == (unsigned long long) (uintptr_t) lpv_base;
+     b_found = b_found || b_inside;
+   }
+   else if ( b_inside ) {
+     sscanf ( sz_line, "Rss: %zu kB", lpst_rss );
+     sscanf ( sz_line, "Pss: %zu kB", lpst_pss );
+   }
+ }
+ fclose ( lp_file );
+
+ return b_found;
+}}
+#endif
+
+ int main ( int argc, char **argv )
+{{
+ size_t st_length = 8000000;
+ const char *lpsz_path = "suffix_tree_snapshot_benchmark.snapshot";
+ if ( argc > 1 ) {
+   st_length = (size_t) (strtod ( argv [ 1 ], 0 ) * 1e6);
+ }
+ if ( argc > 2 ) {
+   lpsz_path = argv [ 2 ];
+ }
+ //The node positions are 32-bit, and the text needs room for its terminator's leaf.
+ if ( st_length < 64 || st_length >= UINT32_MAX / 2 - 2 ) {
+   fprintf ( stderr, "Error: The text must be between 64 bytes and 2 GB long.\n" );
+   return 1;
+ }
+
+ uint64_t ui64_state = 0x2545f4914f6cdd1dULL;
+ std::string str_text;
+ generate_dna_text ( str_text, st_length, &ui64_state );
+
+ //Half of the patterns are substrings of the text, and half are random (and mostly miss).
+ std::vector<std::string> vec_queries ( BENCHMARK_QUERY_COUNT );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   size_t st_query_length = 4 + get_benchmark_random ( &ui64_state ) % 13;
+   if ( st_i & 1 ) {
+     generate_dna_text ( vec_queries [ st_i ], st_query_length, &ui64_state );
+   }
+   else {
+     vec_queries [ st_i ] = str_text .substr ( get_benchmark_random ( &ui64_state ) % (st_length - st_query_length), st_query_length );
+   }
+ }
+
+ //Starting up the slow way: building the tree from its text.
+ TRIE trie;
+ double dbl_start = get_benchmark_seconds (  );
+ generate_trie ( trie, str_text .data (  ), str_text .size (  ) );
+ double dbl_rebuild = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ uint8_t b_saved = save_trie_snapshot ( trie, lpsz_path );
+ double dbl_save = get_benchmark_seconds (  ) - dbl_start;
+ if ( ! b_saved ) {
+   return 1;
+ }
+
+ //Starting up the fast way: mapping the snapshot and searching it right away.
+ TRIE_SNAPSHOT snapshot;
+ dbl_start = get_benchmark_seconds (  );
+ if ( ! open_trie_snapshot ( &snapshot, lpsz_path ) ) {
+   fprintf ( stderr, "Error: We couldn't open \"%s\".\n", lpsz_path );
+   remove ( lpsz_path );
+   return 1;
+ }
+ double dbl_open = get_benchmark_seconds (  ) - dbl_start;
+
+ dbl_start = get_benchmark_seconds (  );
+ size_t st_first = find_trie_substring ( snapshot .view, vec_queries [ 0 ] .data (  ), vec_queries [ 0 ] .size (  ) );
+ double dbl_first_query = get_benchmark_seconds (  ) - dbl_start;
+ uint8_t b_correct = st_first == find_trie_substring ( trie, vec_queries [ 0 ] .data (  ), vec_queries [ 0 ] .size (  ) );
+
+ //The same queries, against the tree in memory and then against the mapped one.
+ std::vector<size_t> vec_memory_finds ( BENCHMARK_QUERY_COUNT ), vec_memory_counts ( BENCHMARK_QUERY_COUNT );
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   vec_memory_finds [ st_i ] = find_trie_substring ( trie, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+   vec_memory_counts [ st_i ] = count_trie_substrings ( trie, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_memory = get_benchmark_seconds (  ) - dbl_start;
+
+ std::vector<size_t> vec_mapped_finds ( BENCHMARK_QUERY_COUNT ), vec_mapped_counts ( BENCHMARK_QUERY_COUNT );
+ dbl_start = get_benchmark_seconds (  );
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i ++ ) {
+   vec_mapped_finds [ st_i ] = find_trie_substring ( snapshot .view, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+   vec_mapped_counts [ st_i ] = count_trie_substrings ( snapshot .view, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+ }
+ double dbl_mapped = get_benchmark_seconds (  ) - dbl_start;
+
+ //Every occurrence that the mapped tree lists has to be in the text.
+ std::vector<uint32_t> vec_positions;
+ for ( size_t st_i = 0; st_i < BENCHMARK_QUERY_COUNT; st_i += 97 ) {
+   vec_positions .clear (  );
+   size_t st_found = find_trie_substrings ( snapshot .view, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ), vec_positions );
+   b_correct = b_correct && st_found == vec_memory_counts [ st_i ] && st_found == vec_positions .size (  );
+   for ( std::vector<uint32_t>::const_iterator it_position = vec_positions .cbegin (  ); it_position != vec_positions .cend (  ); it_position ++ ) {
+     b_correct = b_correct && ! memcmp ( str_text .data (  ) + *it_position, vec_queries [ st_i ] .data (  ), vec_queries [ st_i ] .size (  ) );
+   }
+ }
+ b_correct = b_correct && vec_memory_finds == vec_mapped_finds && vec_memory_counts == vec_mapped_counts;
+
+ fprintf (
+   stdout,
+   "%.1f MB of DNA: rebuild %.3f s; save %.3f s (%.1f MB); open %.6f s; first query %.6f s\n"
+   "  %d finds and counts: in memory %.3f Mops/s; from the snapshot %.3f Mops/s%s\n",
+   st_length / 1e6,
+   dbl_rebuild,
+   dbl_save,
+   snapshot .file .st_size / 1e6,
+   dbl_open,
+   dbl_first_query,
+   BENCHMARK_QUERY_COUNT,
+   2.0 * BENCHMARK_QUERY_COUNT / dbl_memory / 1e6,
+   2.0 * BENCHMARK_QUERY_COUNT / dbl_mapped / 1e6,
+   b_correct ? "" : " (INCORRECT RESULTS)"
+ );
+ fflush ( stdout );
+
+#ifdef __linux__
+ //This process has the whole file resident; a second one that opens it shouldn't need its own copy.
+ uint64_t ui64_sum = touch_benchmark_snapshot ( snapshot );
+ pid_t pid_child = fork (  );
+ if ( ! pid_child ) {
+   TRIE_SNAPSHOT child_snapshot;
+   size_t st_rss, st_pss;
+   if ( ! open_trie_snapshot ( &child_snapshot, lpsz_path ) ) {
+     _exit ( 1 );
+   }
+   uint8_t b_same = touch_benchmark_snapshot ( child_snapshot ) == ui64_sum &&
+     count_trie_substrings ( child_snapshot .view, vec_queries [ 0 ] .data (  ), vec_queries [ 0 ] .size (  ) ) == vec_memory_counts [ 0 ];
+   if ( get_benchmark_mapping_usage ( child_snapshot .file .lp_base, &st_rss, &st_pss ) ) {
+     fprintf (
+       stdout,
+       "  a second process that opened it: %zu kB resident, %zu kB of them its own share (%.0f%%)%s\n",
+       st_rss,
+       st_pss,
+       st_rss ? 100.0 * st_pss / st_rss : 0.0,
+       b_same ? "" : " (INCORRECT RESULTS)"
+     );
+   }
+   close_trie_snapshot ( &child_snapshot );
+   fflush ( stdout ); //(_exit doesn't.)
+   _exit ( b_same ? 0 : 1 );
+ }
+ if ( pid_child > 0 ) {
+   waitpid ( pid_child, 0, 0 );
+ }
+#endif
+
+ close_trie_snapshot ( &snapshot );
+ remove ( lpsz_path );
+
+ return 0;
+}}
@@ -0,0 +1,67 @@
+/*
+ Created on 2022-04-28 by Jacob Bethany
+ Purpose: An example of building a suffix tree and matching a substring with it.
+
+ To compile:
+   g++ -O2 suffix_tree.cpp suffix_tree_test.cpp -o suffix_tree
+*/
+ #include "suffix_tree.h"
+
+/*
+ Takes two arguments from stdin during application execution:
+ 1.) The string to match against (haystack).
+ 2.) A substring to match with the trie that was generated from the first argument.
+
+ Displays the offset of the match, the generated trie, and debugging information if DEBUG_MODE != 0.
+*/
+ int main ( int argc, char **argv )
+{{
+ TRIE trie;
+
+ //Prevent the user from invoking the application without any arguments.
+ if ( argc < 3 ) {
+   fprintf (
+     stderr,
+     "Error: Two arguments expected:\n"
+     "1.) A string to break into a trie.\n"
+     "2.) A substring to match with the trie.\n"
+   );
+   return 0;
+ }
+
+ fprintf (
+   stdout,
+   "Creating trie from string: \"%s\"\n\n",
+   argv [ 1 ]
+ );
+
+ generate_trie ( trie, argv [ 1 ] );
+ dump_tries ( trie );
+
+ fprintf (
+   stdout,
+   "Attempting to match the trie with the substring, \"%s\"\n",
+   argv [ 2 ]
+ );
+
+ size_t st_index = find_trie_substring (
+   trie,
+   argv [ 2 ]
+ );
+ if ( st_index ) {
+   fprintf (
+     stdout,
+     "Match found @ index: %zu.\n",
+     st_index - 1 //subtract one because its one-based in the trie.
+   );
+ }
+ else {
+   fprintf (
+     stderr,
+     "Error: The substring, \"%s,\" couldn't be found.\n",
+     argv [ 2 ]
+   );
+ }
+
+ return 0;
+}}